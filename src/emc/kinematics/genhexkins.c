@@ -103,6 +103,31 @@
   genhexkins.max-iterations - maximum number of iterations spent for
                     a converged solution during current session.
 
+  Each iteration normally inverts the full 6x6 Jacobian.  Two pins make
+  the forward kinematics cheaper when it runs every servo cycle on a
+  moving machine:
+
+  genhexkins.predict - start iterating from the last solution plus the
+                    change between the last two, instead of from the
+                    last solution, whenever motion passes the last
+                    solution back in;
+
+  genhexkins.fast-solver - keep the inverted Jacobian from one iteration
+                    and one cycle to the next, correcting it with a
+                    rank-one (Broyden) update from each step taken.  As
+                    soon as an iteration fails to halve the error, the
+                    rest of the solution falls back to inverting the
+                    Jacobian every iteration, so it never needs more
+                    iterations than that would, plus one.
+
+  genhexkins.last-inversions - number of Jacobian inversions spent for
+                    the last forward kinematics solution;
+
+  genhexkins.last-solve-ns, genhexkins.max-solve-ns - time spent for the
+                    last forward kinematics solution and the longest
+                    time for a converged solution during current
+                    session, in nanoseconds.
+
  ----------------------------------------------------------------------------*/
 
 #include "rtapi.h"
@@ -133,6 +158,11 @@ static struct haldata {
     hal_u32_t   *last_iter;
     hal_u32_t   *max_iter;
     hal_u32_t   *iter_limit;
+    hal_u32_t   *last_inversions;
+    hal_u32_t   *last_solve_ns;
+    hal_u32_t   *max_solve_ns;
+    hal_bit_t   *predict;
+    hal_bit_t   *fast_solver;
     hal_float_t *max_error;
     hal_float_t *conv_criterion;
     hal_float_t *tool_offset;
@@ -260,6 +290,57 @@ static void MatMult(double J[][6], const double x[], double Ans[])
   }
 } // MatMult()
 
+/******************************* Broyden() *********************************/
+
+/*---------------------------------------------------------------------------
+  Rank-one update of the inverted Jacobian J after the estimate moved by
+  step[] and the strut length differences changed by diff[] (Sherman-
+  Morrison form of Broyden's method):
+
+     J += (step - J diff) (step' J) / (step' J diff)
+
+  Returns -1 and leaves J alone if the denominator is too small to trust.
+  ---------------------------------------------------------------------------*/
+
+static int Broyden(double J[][NUM_STRUTS], const double step[], const double diff[])
+{
+  double Jdiff[NUM_STRUTS], stepJ[NUM_STRUTS], denom = 0.0, scale = 0.0;
+  int j, k;
+
+  MatMult(J, diff, Jdiff);
+  for (k = 0; k < NUM_STRUTS; k++) {
+    stepJ[k] = 0.0;
+    for (j = 0; j < NUM_STRUTS; j++) {
+      stepJ[k] += step[j] * J[j][k];
+    }
+  }
+  for (j = 0; j < NUM_STRUTS; j++) {
+    denom += step[j] * Jdiff[j];
+    scale += step[j] * step[j];
+  }
+  if (fabs(denom) < 1e-12 * scale || denom == 0.0) {
+    return -1;
+  }
+  for (j = 0; j < NUM_STRUTS; j++) {
+    double m = (step[j] - Jdiff[j]) / denom;
+    for (k = 0; k < NUM_STRUTS; k++) {
+      J[j][k] += m * stepJ[k];
+    }
+  }
+  return 0;
+} // Broyden()
+
+/* state carried from one forward kinematics call to the next: the last
+   two converged solutions (x, y, z, roll, pitch, yaw) for the predictor
+   and the inverted Jacobian for the fast solver */
+static struct {
+  int    solutions;
+  double q[NUM_STRUTS];
+  double q_prev[NUM_STRUTS];
+  int    have_jacobian;
+  double Jacobian[NUM_STRUTS][NUM_STRUTS];
+} warm;
+
 /* declare arrays for base and platform coordinates */
 static PmCartesian b[NUM_STRUTS];
 static PmCartesian a[NUM_STRUTS];
@@ -333,19 +414,24 @@ static int genhexKinematicsForward(const double * joints,
   PmCartesian InvKinStrutVect,InvKinStrutVectUnit;
   PmCartesian q_trans, RMatrix_a, RMatrix_a_cross_Strut;
 
-  double Jacobian[NUM_STRUTS][NUM_STRUTS];
   double InverseJacobian[NUM_STRUTS][NUM_STRUTS];
   double InvKinStrutLength, StrutLengthDiff[NUM_STRUTS];
+  double LastStrutLengthDiff[NUM_STRUTS], step[NUM_STRUTS];
   double delta[NUM_STRUTS];
-  double conv_err = 1.0;
+  double q[NUM_STRUTS];
+  double conv_err = 1.0, last_conv_err = 0.0;
   double corr;
 
   PmRotationMatrix RMatrix;
   PmRpy q_RPY;
 
+  long long int start = rtapi_get_time();
   int iterate = 1;
+  int refresh, fallback = !*haldata->fast_solver;
   int i;
   int iteration = 0;
+  int inversions = 0;
+  int result = 0;
 
   genhex_read_hal_pins();
 
@@ -371,14 +457,34 @@ static int genhexKinematicsForward(const double * joints,
   q_trans.y = pos->tran.y;
   q_trans.z = pos->tran.z;
 
+  /* if motion passed back the last solution, extrapolate from the last
+     two to where the platform is likely to be now */
+  if (*haldata->predict && warm.solutions >= 2) {
+    q[0] = q_trans.x; q[1] = q_trans.y; q[2] = q_trans.z;
+    q[3] = q_RPY.r;   q[4] = q_RPY.p;   q[5] = q_RPY.y;
+    for (i = 0; i < NUM_STRUTS; i++) {
+      if (fabs(q[i] - warm.q[i]) > 1e-9 * (1.0 + fabs(q[i]))) {
+        break;
+      }
+    }
+    if (i == NUM_STRUTS) {
+      q_trans.x += warm.q[0] - warm.q_prev[0];
+      q_trans.y += warm.q[1] - warm.q_prev[1];
+      q_trans.z += warm.q[2] - warm.q_prev[2];
+      q_RPY.r   += warm.q[3] - warm.q_prev[3];
+      q_RPY.p   += warm.q[4] - warm.q_prev[4];
+      q_RPY.y   += warm.q[5] - warm.q_prev[5];
+    }
+  }
+
   /* Enter Newton-Raphson iterative method   */
   while (iterate) {
     /* check for large error and return error flag if no convergence */
     if ((conv_err > +(*haldata->max_error)) ||
         (conv_err < -(*haldata->max_error))) {
       /* we can't converge */
-      *haldata->fwd_kins_fail = 1;
-      return -2;
+      result = -2;
+      goto fail;
     };
 
     iteration++;
@@ -387,8 +493,8 @@ static int genhexKinematicsForward(const double * joints,
        convergence criterion and return error flag if it can't */
     if (iteration > *haldata->iter_limit) {
       /* we can't converge */
-      *haldata->fwd_kins_fail = 1;
-      return -5;
+      result = -5;
+      goto fail;
     }
 
     /* Convert q_RPY to Rotation Matrix */
@@ -402,8 +508,8 @@ static int genhexKinematicsForward(const double * joints,
       pmCartCartAdd(&q_trans, &RMatrix_a, &aw);
       pmCartCartSub(&aw, &b[i], &InvKinStrutVect);
       if (0 != pmCartUnit(&InvKinStrutVect, &InvKinStrutVectUnit)) {
-        *haldata->fwd_kins_fail = 1;
-        return -1;
+        result = -1;
+        goto fail;
       }
       pmCartMag(&InvKinStrutVect, &InvKinStrutLength);
 
@@ -428,11 +534,46 @@ static int genhexKinematicsForward(const double * joints,
       InverseJacobian[i][5] = RMatrix_a_cross_Strut.z;
     }
 
+    /* determine value of conv_error (used to determine if no convergence) */
+    conv_err = 0.0;
+    for (i = 0; i < NUM_STRUTS; i++) {
+      conv_err += fabs(StrutLengthDiff[i]);
+    }
+
+    /* enter loop to determine if a strut needs another iteration */
+    iterate = 0;            /*assume iteration is done */
+    for (i = 0; i < NUM_STRUTS; i++) {
+      if (fabs(StrutLengthDiff[i]) > *haldata->conv_criterion) {
+    iterate = 1;
+      }
+    }
+
+    /* the fast solver keeps the Jacobian it has as long as every step
+       at least halves the error, else it falls back to inverting it
+       every iteration */
+    refresh = fallback || !warm.have_jacobian;
+    if (!refresh && iterate && iteration > 1) {
+      if (conv_err > 0.5 * last_conv_err) {
+        refresh = fallback = 1;
+      } else {
+        for (i = 0; i < NUM_STRUTS; i++) {
+          LastStrutLengthDiff[i] = StrutLengthDiff[i] - LastStrutLengthDiff[i];
+        }
+        if (Broyden(warm.Jacobian, step, LastStrutLengthDiff)) {
+          refresh = fallback = 1;
+        }
+      }
+    }
+
     /* invert Inverse Jacobian */
-    MatInvert(InverseJacobian, Jacobian);
+    if (refresh) {
+      MatInvert(InverseJacobian, warm.Jacobian);
+      warm.have_jacobian = 1;
+      inversions++;
+    }
 
     /* multiply Jacobian by LegLengthDiff */
-    MatMult(Jacobian, StrutLengthDiff, delta);
+    MatMult(warm.Jacobian, StrutLengthDiff, delta);
 
     /* subtract delta from last iterations pos values */
     q_trans.x -= delta[0];
@@ -442,19 +583,11 @@ static int genhexKinematicsForward(const double * joints,
     q_RPY.p   -= delta[4];
     q_RPY.y   -= delta[5];
 
-    /* determine value of conv_error (used to determine if no convergence) */
-    conv_err = 0.0;
-    for (i = 0; i < NUM_STRUTS; i++) {
-      conv_err += fabs(StrutLengthDiff[i]);
-    }
-
-    /* enter loop to determine if a strut needs another iteration */
-    iterate = 0;            /*assume iteration is done */
     for (i = 0; i < NUM_STRUTS; i++) {
-      if (fabs(StrutLengthDiff[i]) > *haldata->conv_criterion) {
-    iterate = 1;
-      }
+      step[i] = -delta[i];
+      LastStrutLengthDiff[i] = StrutLengthDiff[i];
     }
+    last_conv_err = conv_err;
   } /* exit Newton-Raphson Iterative loop */
 
   /* assign r,p,y to a,b,c */
@@ -467,16 +600,44 @@ static int genhexKinematicsForward(const double * joints,
   pos->tran.y = q_trans.y;
   pos->tran.z = q_trans.z;
 
+  /* remember the solution as motion will pass it back next time */
+  for (i = 0; i < NUM_STRUTS; i++) {
+    warm.q_prev[i] = warm.q[i];
+  }
+  warm.q[0] = pos->tran.x;
+  warm.q[1] = pos->tran.y;
+  warm.q[2] = pos->tran.z;
+  warm.q[3] = pos->a * PM_PI / 180.0;
+  warm.q[4] = pos->b * PM_PI / 180.0;
+  warm.q[5] = pos->c * PM_PI / 180.0;
+  if (warm.solutions < 2) {
+    warm.solutions++;
+  }
+
   *haldata->last_iter = iteration;
+  *haldata->last_inversions = inversions;
+  *haldata->last_solve_ns = rtapi_get_time() - start;
 
   if (iteration > *haldata->max_iter){
     *haldata->max_iter = iteration;
   }
+  if (*haldata->last_solve_ns > *haldata->max_solve_ns) {
+    *haldata->max_solve_ns = *haldata->last_solve_ns;
+  }
   *haldata->fwd_kins_fail = 0;
 
   genhex_gui_forward_kins(pos);
 
   return 0;
+
+fail:
+  /* start over from whatever motion passes in next time */
+  warm.solutions = 0;
+  warm.have_jacobian = 0;
+  *haldata->last_inversions = inversions;
+  *haldata->last_solve_ns = rtapi_get_time() - start;
+  *haldata->fwd_kins_fail = 1;
+  return result;
 } // genhexKinematicsForward()
 
 
@@ -596,6 +757,21 @@ int genhexKinematicsSetup(const  int   comp_id,
     res += hal_pin_u32_newf(HAL_IN, &haldata->iter_limit, comp_id,
         "genhexkins.limit-iterations");
     *haldata->iter_limit = 120;
+    res += hal_pin_u32_newf(HAL_OUT, &haldata->last_inversions, comp_id,
+        "genhexkins.last-inversions");
+    *haldata->last_inversions = 0;
+    res += hal_pin_u32_newf(HAL_OUT, &haldata->last_solve_ns, comp_id,
+        "genhexkins.last-solve-ns");
+    *haldata->last_solve_ns = 0;
+    res += hal_pin_u32_newf(HAL_OUT, &haldata->max_solve_ns, comp_id,
+        "genhexkins.max-solve-ns");
+    *haldata->max_solve_ns = 0;
+    res += hal_pin_bit_newf(HAL_IN, &haldata->predict, comp_id,
+        "genhexkins.predict");
+    *haldata->predict = 0;
+    res += hal_pin_bit_newf(HAL_IN, &haldata->fast_solver, comp_id,
+        "genhexkins.fast-solver");
+    *haldata->fast_solver = 0;
     res += hal_pin_float_newf(HAL_IN, &haldata->tool_offset, comp_id,
         "genhexkins.tool-offset");
     *haldata->tool_offset = 0.0;
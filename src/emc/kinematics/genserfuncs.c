@@ -28,6 +28,15 @@
   Currently the type of the joints is hardcoded to ANGULAR, although
   the kins support both ANGULAR and LINEAR axes.
 
+  The inverse kinematics iterate from the joint positions passed in.
+  Like genhexkins, the predict pin starts them from the last solution
+  plus the change between the last two instead, and the fast-solver pin
+  keeps the inverse Jacobian from one iteration and one call to the
+  next, correcting it with a rank-one (Broyden) update from each step
+  taken, until a step fails to halve the remaining error.  From then on
+  the rest of that solution recomputes it every iteration, as without
+  fast-solver.
+
   TODO:
     * make number of joints a loadtime parameter
     * add HAL pins for all settable parameters, including joint type: ANGULAR / LINEAR
@@ -47,6 +56,11 @@
 static struct haldata {
     hal_u32_t     *max_iterations;
     hal_u32_t     *last_iterations;
+    hal_u32_t     *last_inversions;
+    hal_u32_t     *last_solve_ns;
+    hal_u32_t     *max_solve_ns;
+    hal_bit_t     *predict;
+    hal_bit_t     *fast_solver;
     hal_float_t   *a[GENSER_MAX_JOINTS];
     hal_float_t   *alpha[GENSER_MAX_JOINTS];
     hal_float_t   *d[GENSER_MAX_JOINTS];
@@ -71,6 +85,53 @@ double j[GENSER_MAX_JOINTS];
 
 static int genser_hal_inited = 0;
 
+/* state carried from one inverse kinematics call to the next: the last
+   two converged joint estimates (radians) and what was returned for the
+   latest, for the predictor, and the inverse Jacobian for the fast
+   solver */
+static struct {
+    int solutions;
+    go_real jest[GENSER_MAX_JOINTS];
+    go_real jest_prev[GENSER_MAX_JOINTS];
+    go_real joints[GENSER_MAX_JOINTS];
+    int have_jinv;
+    go_real jinv[GENSER_MAX_JOINTS][6];
+} warm;
+
+/* Rank-one update of the square inverse Jacobian jinv after a joint
+   step dj changed the Cartesian error by ddvw, so that afterwards
+   jinv * ddvw == -dj.  Returns -1 and leaves jinv alone if the
+   denominator is too small to trust. */
+static int genser_broyden(go_real jinv[][6], int n,
+                          const go_real * dj, const go_real * ddvw)
+{
+    go_real Jy[GENSER_MAX_JOINTS], sJ[6], denom = 0, scale = 0, m;
+    int row, col;
+
+    for (row = 0; row < n; row++) {
+        Jy[row] = 0;
+        for (col = 0; col < 6; col++)
+            Jy[row] += jinv[row][col] * ddvw[col];
+    }
+    for (col = 0; col < 6; col++) {
+        sJ[col] = 0;
+        for (row = 0; row < n; row++)
+            sJ[col] += dj[row] * jinv[row][col];
+    }
+    for (row = 0; row < n; row++) {
+        denom += dj[row] * Jy[row];
+        scale += dj[row] * dj[row];
+    }
+    if (denom == 0 || fabs(denom) < 1e-12 * scale)
+        return -1;
+    for (row = 0; row < n; row++) {
+        m = (dj[row] + Jy[row]) / denom;
+        for (col = 0; col < 6; col++)
+            jinv[row][col] -= m * sJ[col];
+    }
+    return 0;
+}
+
 int genser_kin_init(void) {
     genser_struct *genser = KINS_PTR;
     int t;
@@ -403,6 +464,13 @@ int genser_kin_fwd(void *kins, const go_real * joints, go_pose * pos)
     return GO_RESULT_OK;
 }
 
+static void genser_solve_time(long long int start)
+{
+    *haldata->last_solve_ns = rtapi_get_time() - start;
+    if (*haldata->last_solve_ns > *haldata->max_solve_ns)
+        *haldata->max_solve_ns = *haldata->last_solve_ns;
+}
+
 int genserKinematicsInverse(const EmcPose * world,
                             double *joints,
                             const KINEMATICS_INVERSE_FLAGS * iflags,
@@ -420,10 +488,14 @@ int genserKinematicsInverse(const EmcPose * world,
     go_rpy rpy;
     go_rvec rvec;
     go_cart cart;
+    go_real last_dvw[6], ddvw[6], err, last_err = 0;
     go_link linkout[GENSER_MAX_JOINTS];
-    int link;
+    long long int start = rtapi_get_time();
+    int link, col;
     int smalls;
     int retval;
+    int refresh, fallback;
+    int inversions = 0;
 
     // rtapi_print("kineInverse(joints: %f %f %f %f %f %f)\n",
     //      joints[0],joints[1],joints[2],joints[3],joints[4],joints[5]);
@@ -458,26 +530,30 @@ int genserKinematicsInverse(const EmcPose * world,
         jest[link] = joints[link] * (PM_PI / 180);
     }
 
+    /* if motion passed back the last solution, extrapolate from the last
+       two to where the joints are likely to be now */
+    if (*haldata->predict && warm.solutions >= 2) {
+        for (link = 0; link < genser->link_num; link++) {
+            if (joints[link] != warm.joints[link])
+                break;
+        }
+        if (link == genser->link_num) {
+            for (link = 0; link < genser->link_num; link++)
+                jest[link] = 2 * warm.jest[link] - warm.jest_prev[link];
+        }
+    }
+
+    /* the cached inverse Jacobian is only updated in place when square */
+    fallback = !*haldata->fast_solver || genser->link_num != 6;
+
     for (genser->iterations = 0;
          genser->iterations < *haldata->max_iterations;
          genser->iterations++) {
          *(haldata->last_iterations) = genser->iterations;
-        /* update the Jacobians */
+        /* update the links */
         for (link = 0; link < genser->link_num; link++) {
             go_link_joint_set(&genser->links[link], jest[link], &linkout[link]);
         }
-        retval = compute_jfwd(linkout, genser->link_num, &Jfwd, &T_L_0);
-        if (GO_RESULT_OK != retval) {
-            rtapi_print("ERR kI - compute_jfwd (joints: %f %f %f %f %f %f), (iterations=%d)\n",
-                 joints[0],joints[1],joints[2],joints[3],joints[4],joints[5], genser->iterations);
-            return retval;
-        }
-        retval = compute_jinv(&Jfwd, &Jinv);
-        if (GO_RESULT_OK != retval) {
-            rtapi_print("ERR kI - compute_jinv (joints: %f %f %f %f %f %f), (iterations=%d)\n",
-                 joints[0],joints[1],joints[2],joints[3],joints[4],joints[5], genser->iterations);
-            return retval;
-        }
 
         /* pest is the resulting pose estimate given joint estimate */
         genser_kin_fwd(KINS_PTR, jest, &pest);
@@ -520,8 +596,57 @@ int genserKinematicsInverse(const EmcPose * world,
         dvw[4] = cart.y;
         dvw[5] = cart.z;
 
+        err = 0;
+        for (link = 0; link < 6; link++)
+            err += fabs(dvw[link]);
+
+        /* the fast solver keeps the inverse Jacobian it has as long as
+           every step at least halves the error, else it falls back to
+           recomputing it every iteration */
+        refresh = fallback || !warm.have_jinv;
+        if (!refresh && genser->iterations > 0) {
+            if (err > 0.5 * last_err) {
+                refresh = fallback = 1;
+            } else {
+                for (link = 0; link < 6; link++)
+                    ddvw[link] = dvw[link] - last_dvw[link];
+                if (genser_broyden(warm.jinv, genser->link_num, dj, ddvw))
+                    refresh = fallback = 1;
+            }
+        }
+
+        if (refresh) {
+            /* update the Jacobians */
+            retval = compute_jfwd(linkout, genser->link_num, &Jfwd, &T_L_0);
+            if (GO_RESULT_OK != retval) {
+                rtapi_print("ERR kI - compute_jfwd (joints: %f %f %f %f %f %f), (iterations=%d)\n",
+                     joints[0],joints[1],joints[2],joints[3],joints[4],joints[5], genser->iterations);
+                goto fail;
+            }
+            retval = compute_jinv(&Jfwd, &Jinv);
+            if (GO_RESULT_OK != retval) {
+                rtapi_print("ERR kI - compute_jinv (joints: %f %f %f %f %f %f), (iterations=%d)\n",
+                     joints[0],joints[1],joints[2],joints[3],joints[4],joints[5], genser->iterations);
+                goto fail;
+            }
+            inversions++;
+            if (genser->link_num == 6) {
+                for (link = 0; link < 6; link++)
+                    for (col = 0; col < 6; col++)
+                        warm.jinv[link][col] = Jinv.el[link][col];
+                warm.have_jinv = 1;
+            }
+        } else {
+            for (link = 0; link < 6; link++)
+                for (col = 0; col < 6; col++)
+                    Jinv.el[link][col] = warm.jinv[link][col];
+        }
+
         /* push the Cartesian velocity vector through the inverse Jacobian */
         go_matrix_vector_mult(&Jinv, dvw, dj);
+        for (link = 0; link < 6; link++)
+            last_dvw[link] = dvw[link];
+        last_err = err;
 
         //pass through 678 as uvw
         if (total_joints > 6) joints[6] = world->u;
@@ -545,7 +670,14 @@ int genserKinematicsInverse(const EmcPose * world,
                 joints[link] = jest[link] * 180 / PM_PI;
                 if ((link) && *(haldata->unrotate[link]))
                     joints[link] += *(haldata->unrotate[link]) * joints[link-1];
+                warm.jest_prev[link] = warm.jest[link];
+                warm.jest[link] = jest[link];
+                warm.joints[link] = joints[link];
             }
+            if (warm.solutions < 2)
+                warm.solutions++;
+            *haldata->last_inversions = inversions;
+            genser_solve_time(start);
             //rtapi_print("DONEkineInverse(joints: %f %f %f %f %f %f), (iterations=%d)\n",
             //     joints[0],joints[1],joints[2],joints[3],joints[4],joints[5], genser->iterations);
             //rtapi_print("OKkineInverse: %.2f %.2f %.2f %.2f %.2f %.2f)\n",
@@ -560,7 +692,15 @@ int genserKinematicsInverse(const EmcPose * world,
 
     rtapi_print("ERRkineInverse(joints: %f %f %f %f %f %f), (iterations=%d)\n",
          joints[0],joints[1],joints[2],joints[3],joints[4],joints[5], genser->iterations);
-    return GO_RESULT_ERROR;
+    retval = GO_RESULT_ERROR;
+
+fail:
+    /* start over from whatever motion passes in next time */
+    warm.solutions = 0;
+    warm.have_jinv = 0;
+    *haldata->last_inversions = inversions;
+    *haldata->last_solve_ns = rtapi_get_time() - start;
+    return retval;
 }
 
 /*
@@ -614,6 +754,16 @@ int genserKinematicsSetup(const int comp_id,
     }
     res += hal_pin_u32_newf(HAL_OUT, &(haldata->last_iterations), comp_id,
           "%s.last-iterations",kp->halprefix);
+    res += hal_pin_u32_newf(HAL_OUT, &(haldata->last_inversions), comp_id,
+          "%s.last-inversions",kp->halprefix);
+    res += hal_pin_u32_newf(HAL_OUT, &(haldata->last_solve_ns), comp_id,
+          "%s.last-solve-ns",kp->halprefix);
+    res += hal_pin_u32_newf(HAL_OUT, &(haldata->max_solve_ns), comp_id,
+          "%s.max-solve-ns",kp->halprefix);
+    res += hal_pin_bit_newf(HAL_IN, &(haldata->predict), comp_id,
+          "%s.predict",kp->halprefix);
+    res += hal_pin_bit_newf(HAL_IN, &(haldata->fast_solver), comp_id,
+          "%s.fast-solver",kp->halprefix);
 
     KINS_PTR = hal_malloc(sizeof(genser_struct));
     haldata->pos = (go_pose *) hal_malloc(sizeof(go_pose));
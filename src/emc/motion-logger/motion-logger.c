@@ -459,6 +459,26 @@ int main(int argc, char* argv[]) {
                 );
                 break;
 
+            case EMCMOT_SET_SPLINE:
+                log_print("SET_SPLINE:\n");
+                log_print(
+                    "    pos: x=%.6g, y=%.6g, z=%.6g, a=%.6g, b=%.6g, c=%.6g, u=%.6g, v=%.6g, w=%.6g\n",
+                    c->pos.tran.x, c->pos.tran.y, c->pos.tran.z,
+                    c->pos.a, c->pos.b, c->pos.c,
+                    c->pos.u, c->pos.v, c->pos.w
+                );
+                log_print("    control: x=%.6g, y=%.6g, z=%.6g; x=%.6g, y=%.6g, z=%.6g\n",
+                    c->control[0].x, c->control[0].y, c->control[0].z,
+                    c->control[1].x, c->control[1].y, c->control[1].z);
+                log_print("    weight: %.6g %.6g %.6g %.6g\n",
+                    c->weight[0], c->weight[1], c->weight[2], c->weight[3]);
+                log_print("    id=%d, motion_type=%d, vel=%.6g, ini_maxvel=%.6g, acc=%.6g\n",
+                    c->id, c->motion_type,
+                    c->vel, c->ini_maxvel,
+                    c->acc
+                );
+                break;
+
             case EMCMOT_SET_TELEOP_VECTOR:
                 log_print("SET_TELEOP_VECTOR\n");
                 break;
@@ -505,6 +505,9 @@ void emcmotCommandHandler_locked(void *arg, long servo_period)
 	    if (GET_MOTION_TELEOP_FLAG()) {
                 axis_jog_abort_all(0);
 	    } else if (GET_MOTION_COORD_FLAG()) {
+		if (emcmotStatus->depth) {
+		    flightrec_trigger("abort");
+		}
 		tpAbort(&emcmotInternal->coord_tp);
 	    } else {
 		for (joint_num = 0; joint_num < ALL_JOINTS; joint_num++) {
@@ -1115,6 +1118,60 @@ void emcmotCommandHandler_locked(void *arg, long servo_period)
 	    }
 	    break;
 
+	case EMCMOT_SET_SPLINE:
+	    /* emcmotInternal->coord_tp up a spline move */
+	    /* requires coordinated mode, enable on, not on limits */
+	    rtapi_print_msg(RTAPI_MSG_DBG, "SET_SPLINE");
+	    if (!GET_MOTION_COORD_FLAG() || !GET_MOTION_ENABLE_FLAG()) {
+		reportError(_("need to be enabled, in coord mode for spline move"));
+		emcmotStatus->commandStatus = EMCMOT_COMMAND_INVALID_COMMAND;
+		SET_MOTION_ERROR_FLAG(1);
+		break;
+	    } else if (!inRange(emcmotCommand->pos, emcmotCommand->id, "Spline")) {
+		emcmotStatus->commandStatus = EMCMOT_COMMAND_INVALID_PARAMS;
+		tpAbort(&emcmotInternal->coord_tp);
+		SET_MOTION_ERROR_FLAG(1);
+		break;
+	    } else if (!limits_ok()) {
+		reportError(_("can't do spline move with limits exceeded"));
+		emcmotStatus->commandStatus = EMCMOT_COMMAND_INVALID_PARAMS;
+		tpAbort(&emcmotInternal->coord_tp);
+		SET_MOTION_ERROR_FLAG(1);
+		break;
+	    }
+            if(emcmotStatus->atspeed_next_feed) {
+                issue_atspeed = 1;
+                emcmotStatus->atspeed_next_feed = 0;
+            }
+	    /* append it to the emcmotInternal->coord_tp */
+	    tpSetId(&emcmotInternal->coord_tp, emcmotCommand->id);
+	    int res_addspline = tpAddSpline(&emcmotInternal->coord_tp, emcmotCommand->pos,
+                            emcmotCommand->control[0], emcmotCommand->control[1],
+                            emcmotCommand->weight, emcmotCommand->motion_type,
+                            emcmotCommand->vel, emcmotCommand->ini_maxvel,
+                            emcmotCommand->acc, emcmotStatus->enables_new,
+			    issue_atspeed, emcmotCommand->tag);
+        if (res_addspline < 0) {
+            reportError(_("can't add spline move at line %d, error code %d"),
+                    emcmotCommand->id, res_addspline);
+		emcmotStatus->commandStatus = EMCMOT_COMMAND_BAD_EXEC;
+		tpAbort(&emcmotInternal->coord_tp);
+		SET_MOTION_ERROR_FLAG(1);
+		break;
+        } else if (res_addspline != 0) {
+            //FIXME! Same band-aid as for EMCMOT_SET_CIRCLE above
+            if (issue_atspeed) {
+                emcmotStatus->atspeed_next_feed = 1;
+            }
+        } else {
+		SET_MOTION_ERROR_FLAG(0);
+		/* set flag that indicates all joints need rehoming, if any
+		   joint is moved in joint mode, for machines with no forward
+		   kins */
+		rehomeAll = 1;
+	    }
+	    break;
+
 	case EMCMOT_SET_VEL:
 	    /* set the velocity for subsequent moves */
 	    /* can do it at any time */
@@ -269,6 +269,8 @@ void emcmotController(void *arg, long period)
     output_to_hal();
     write_homing_out_pins(ALL_JOINTS);
     update_status();
+    flightrec_record();
+    pathring_record();
     /* here ends the core of the controller */
     emcmotStatus->heartbeat++;
     /* set tail to head, to indicate work complete */
@@ -785,6 +787,7 @@ static void check_for_faults(void)
     if ( GET_MOTION_ENABLE_FLAG() != 0 ) {
 	if ( *(emcmot_hal_data->enable) == 0 ) {
 	    reportError(_("motion stopped by enable input"));
+	    flightrec_trigger("enable input");
 	    emcmotInternal->enabling = 0;
 	}
     }
@@ -792,6 +795,7 @@ static void check_for_faults(void)
     for (spindle_num = 0; spindle_num < emcmotConfig->numSpindles; spindle_num++){
         if(emcmotStatus->spindle_status[spindle_num].fault && GET_MOTION_ENABLE_FLAG()){
             reportError(_("spindle %d amplifier fault"), spindle_num);
+            flightrec_trigger("spindle %d amplifier fault", spindle_num);
             emcmotInternal->enabling = 0;
         }
     }
@@ -816,6 +820,7 @@ static void check_for_faults(void)
 			/* report the error just this once */
 			reportError(_("joint %d on limit switch error"),
 			    joint_num);
+			flightrec_trigger("joint %d on limit switch", joint_num);
 		    }
 		    SET_JOINT_ERROR_FLAG(joint, 1);
 		    emcmotInternal->enabling = 0;
@@ -827,6 +832,7 @@ static void check_for_faults(void)
 		if (!GET_JOINT_ERROR_FLAG(joint)) {
 		    /* report the error just this once */
 		    reportError(_("joint %d amplifier fault"), joint_num);
+		    flightrec_trigger("joint %d amplifier fault", joint_num);
 		}
 		SET_JOINT_ERROR_FLAG(joint, 1);
 		emcmotInternal->enabling = 0;
@@ -836,6 +842,7 @@ static void check_for_faults(void)
 		if (!GET_JOINT_ERROR_FLAG(joint)) {
 		    /* report the error just this once */
 		    reportError(_("joint %d following error"), joint_num);
+		    flightrec_trigger("joint %d following error", joint_num);
 		}
 		SET_JOINT_ERROR_FLAG(joint, 1);
 		emcmotInternal->enabling = 0;
@@ -849,6 +856,7 @@ static void check_for_faults(void)
     for (error_num=0; error_num < emcmotConfig->numMiscError; error_num++){
       if(emcmotStatus->misc_error[error_num] && GET_MOTION_ENABLE_FLAG()) {
         reportError(_("Motion Stopped by misc error %d"), error_num);
+        flightrec_trigger("misc error %d", error_num);
         emcmotInternal->enabling = 0;
       }
     }
@@ -1254,6 +1262,7 @@ static void get_pos_cmds(long period)
             //still show the acceleration from the interpolation.
             //it's delayed, but that's ok during jogging or homing.
             joint->acc_cmd = 0.0;
+            joint->jerk_cmd = 0.0;
             joint->coarse_pos = joint->free_tp.curr_pos;
             /* update joint status flag and overall status flag */
             if ( joint->free_tp.active ) {
@@ -1382,7 +1391,7 @@ static void get_pos_cmds(long period)
 	    /* point to joint struct */
 	    joint = &joints[joint_num];
 	    /* interpolate to get new position and velocity */
-	    joint->pos_cmd = cubicInterpolate(&(joint->cubic), 0, &(joint->vel_cmd), &(joint->acc_cmd), 0);
+	    joint->pos_cmd = cubicInterpolate(&(joint->cubic), 0, &(joint->vel_cmd), &(joint->acc_cmd), &(joint->jerk_cmd));
 	}
 	/* report motion status */
 	SET_MOTION_INPOS_FLAG(0);
@@ -1425,7 +1434,7 @@ static void get_pos_cmds(long period)
 		       this cycle so it doesn't really matter */
 		cubicAddPoint(&(joint->cubic), joint->coarse_pos);
 		/* interpolate to get new position and velocity */
-		joint->pos_cmd = cubicInterpolate(&(joint->cubic), 0, &(joint->vel_cmd), &(joint->acc_cmd), 0);
+		joint->pos_cmd = cubicInterpolate(&(joint->cubic), 0, &(joint->vel_cmd), &(joint->acc_cmd), &(joint->jerk_cmd));
 	    }
 	}
 	else
@@ -1454,6 +1463,7 @@ static void get_pos_cmds(long period)
 	    /* set joint velocity and acceleration to zero */
 	    joint->vel_cmd = 0.0;
 	    joint->acc_cmd = 0.0;
+	    joint->jerk_cmd = 0.0;
 	}
 
 	break;
@@ -2002,6 +2012,7 @@ static void output_to_hal(void)
 	*(joint_data->coarse_pos_cmd) = joint->coarse_pos;
 	*(joint_data->joint_vel_cmd) = joint->vel_cmd;
 	*(joint_data->joint_acc_cmd) = joint->acc_cmd;
+	*(joint_data->joint_jerk_cmd) = joint->jerk_cmd;
 	*(joint_data->backlash_corr) = joint->backlash_corr;
 	*(joint_data->backlash_filt) = joint->backlash_filt;
 	*(joint_data->backlash_vel) = joint->backlash_vel;
@@ -65,8 +65,8 @@
 #define DEFAULT_MISC_ERROR 0
 
 /* size of motion queue
- * a TC_STRUCT is about 512 bytes so this queue is
- * about a megabyte.  */
+ * a TC_STRUCT is about 1.2 kilobytes so this queue is
+ * about 2.5 megabytes.  */
 #define DEFAULT_TC_QUEUE_SIZE 2000
 
 /* max following error */
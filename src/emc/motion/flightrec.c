@@ -0,0 +1,117 @@
+/********************************************************************
+* Description: flightrec.c
+*   The realtime side of the motion flight recorder.  Every servo
+*   cycle, the commanded and actual position, commanded velocity and
+*   flags of each joint, the executing TP segment and the motion state
+*   go into a ring in shared memory.  A fault or abort lets the ring
+*   run on for a quarter of its length and then freezes it, until
+*   motion-flightrec has written it to a file and rearms it.
+*
+* License: GPL Version 2
+* System: Linux
+*
+* Copyright (c) 2026 All rights reserved.
+********************************************************************/
+
+#include <stdarg.h>
+#include "rtapi.h"
+#include "rtapi_atomic.h"
+#include "rtapi_string.h"
+#include "hal.h"
+#include "motion.h"
+#include "mot_priv.h"
+#include "flightrec.h"
+
+static flightrec_t *fr;
+static int fr_shmem_id = -1;
+
+int flightrec_init(int comp_id, int samples, int num_joints, long period)
+{
+    unsigned long size;
+    int retval;
+
+    if (samples <= 0)
+	return 0;
+    size = sizeof(flightrec_t) + samples * (unsigned long) flightrec_sample_size(num_joints);
+    fr_shmem_id = rtapi_shmem_new(FLIGHTREC_SHMEM_KEY, comp_id, size);
+    if (fr_shmem_id < 0) {
+	rtapi_print_msg(RTAPI_MSG_ERR,
+	    "MOTION: flight recorder rtapi_shmem_new failed, returned %d\n", fr_shmem_id);
+	return -1;
+    }
+    retval = rtapi_shmem_getptr(fr_shmem_id, (void **) &fr);
+    if (retval < 0) {
+	rtapi_print_msg(RTAPI_MSG_ERR,
+	    "MOTION: flight recorder rtapi_shmem_getptr failed, returned %d\n", retval);
+	fr = 0;
+	return -1;
+    }
+    memset(fr, 0, sizeof(flightrec_t));
+    fr->size = size;
+    fr->num_joints = num_joints;
+    fr->samples = samples;
+    fr->sample_size = flightrec_sample_size(num_joints);
+    fr->period = period;
+    atomic_store(&fr->magic, FLIGHTREC_MAGIC);
+    return 0;
+}
+
+void flightrec_exit(int comp_id)
+{
+    if (fr_shmem_id >= 0)
+	rtapi_shmem_delete(fr_shmem_id, comp_id);
+    fr = 0;
+    fr_shmem_id = -1;
+}
+
+void flightrec_trigger(const char *fmt, ...)
+{
+    va_list ap;
+
+    /* keep the first fault; what follows is usually a consequence */
+    if (!fr || fr->frozen || fr->post)
+	return;
+    va_start(ap, fmt);
+    rtapi_vsnprintf(fr->reason, sizeof(fr->reason), fmt, ap);
+    va_end(ap);
+    fr->trigger = fr->count;
+    fr->post = fr->samples / 4 + 1;
+}
+
+void flightrec_record(void)
+{
+    flightrec_sample_t *s;
+    emcmot_joint_t *joint;
+    int n;
+
+    if (!fr)
+	return;
+    if (fr->frozen) {
+	if (!atomic_load(&fr->rearm))
+	    return;
+	fr->rearm = 0;
+	fr->post = 0;
+	atomic_store(&fr->frozen, 0);
+    }
+    if (fr->request) {
+	fr->request = 0;
+	flightrec_trigger("requested");
+    }
+
+    s = flightrec_sample(fr, fr->count);
+    s->time = rtapi_get_time();
+    s->id = emcmotStatus->id;
+    s->motion_state = emcmotStatus->motion_state;
+    s->motion_flag = emcmotStatus->motionFlag;
+    for (n = 0; n < fr->num_joints; n++) {
+	joint = &joints[n];
+	s->joint[n].pos_cmd = joint->pos_cmd;
+	s->joint[n].pos_fb = joint->pos_fb;
+	s->joint[n].vel_cmd = joint->vel_cmd;
+	s->joint[n].flag = joint->flag;
+    }
+    fr->count++;
+
+    if (fr->post && --fr->post == 0)
+	atomic_store(&fr->frozen, 1);
+}
@@ -0,0 +1,64 @@
+/********************************************************************
+* Description: flightrec.h
+*   Layout of the motion flight recorder: a ring of per servo cycle
+*   samples in its own shared memory segment, which motion freezes
+*   shortly after a fault and motion-flightrec writes to a file.
+*
+* License: GPL Version 2
+* System: Linux
+*
+* Copyright (c) 2026 All rights reserved.
+********************************************************************/
+#ifndef FLIGHTREC_H
+#define FLIGHTREC_H
+
+#define FLIGHTREC_SHMEM_KEY	0x464c5452	/* "FLTR" */
+#define FLIGHTREC_MAGIC		0x464c5201
+#define FLIGHTREC_REASON_LEN	64
+
+typedef struct {
+    double pos_cmd;		/* commanded joint position */
+    double pos_fb;		/* joint position feedback */
+    double vel_cmd;		/* commanded joint velocity */
+    unsigned int flag;		/* EMCMOT_JOINT_FLAG bits */
+} flightrec_joint_t;
+
+typedef struct {
+    long long time;		/* rtapi_get_time() at the end of the cycle */
+    int id;			/* id of the executing TP segment */
+    unsigned short motion_state;
+    unsigned short motion_flag;	/* EMCMOT_MOTION_FLAG bits */
+    flightrec_joint_t joint[];	/* num_joints of these */
+} flightrec_sample_t;
+
+typedef struct {
+    unsigned int magic;
+    unsigned int size;		/* of the whole segment */
+    int num_joints;
+    int samples;		/* in the ring */
+    unsigned int sample_size;
+    long period;		/* servo period, ns */
+    /* written by motion */
+    unsigned long count;	/* samples recorded since loading */
+    int post;			/* samples still to record after the trigger */
+    int frozen;			/* set when the ring holds a fault */
+    unsigned long trigger;	/* value of count at the fault */
+    char reason[FLIGHTREC_REASON_LEN];
+    /* written by motion-flightrec */
+    int rearm;			/* the dump is written, record again */
+    int request;		/* freeze now, as if a fault happened */
+    /* the ring of samples follows */
+} flightrec_t;
+
+static inline flightrec_sample_t *flightrec_sample(flightrec_t *fr, unsigned long n)
+{
+    return (flightrec_sample_t *) ((char *) (fr + 1)
+	+ (n % fr->samples) * (unsigned long) fr->sample_size);
+}
+
+static inline unsigned int flightrec_sample_size(int num_joints)
+{
+    return sizeof(flightrec_sample_t) + num_joints * sizeof(flightrec_joint_t);
+}
+
+#endif
@@ -0,0 +1,156 @@
+/********************************************************************
+* Description: flightrec_usr.c
+*   motion-flightrec: waits for motion to freeze its flight recorder
+*   after a fault or abort, and writes the recorded servo cycles to a
+*   file.
+*
+*   Invoking:
+*
+*   motion-flightrec [-d dir] [-1] [-t]
+*
+*   Dumps go to 'dir' (default: the current directory), named
+*   flightrec-<date>-<time>.txt.  With -1 it exits after the first
+*   dump; -t freezes the recorder right away, writes it and exits.
+*
+* License: GPL Version 2
+* System: Linux
+*
+* Copyright (c) 2026 All rights reserved.
+********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <time.h>
+
+#include "rtapi.h"
+#include "rtapi_atomic.h"
+#include "flightrec.h"
+
+static sig_atomic_t stop;
+static void quit(int sig)
+{
+    stop = 1;
+}
+
+static int dump(flightrec_t *fr, const char *dir)
+{
+    char name[4096], stamp[32];
+    time_t now = time(NULL);
+    unsigned long first, n;
+    FILE *f;
+    int j;
+
+    strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", localtime(&now));
+    snprintf(name, sizeof(name), "%s/flightrec-%s.txt", dir, stamp);
+    f = fopen(name, "w");
+    if (!f) {
+	perror(name);
+	return -1;
+    }
+
+    first = fr->count > (unsigned long) fr->samples ? fr->count - fr->samples : 0;
+    fprintf(f, "# motion flight recorder, %s\n", stamp);
+    fprintf(f, "# reason: %s\n", fr->reason);
+    fprintf(f, "# servo period: %ld ns, joints: %d, samples: %lu\n",
+	fr->period, fr->num_joints, fr->count - first);
+    fprintf(f, "# time is in seconds from the trigger; per joint: pos-cmd pos-fb vel-cmd flags\n");
+    fprintf(f, "# time id motion-state motion-flags");
+    for (j = 0; j < fr->num_joints; j++)
+	fprintf(f, " j%d", j);
+    fprintf(f, "\n");
+
+    flightrec_sample_t *t = flightrec_sample(fr, fr->trigger);
+    for (n = first; n < fr->count; n++) {
+	flightrec_sample_t *s = flightrec_sample(fr, n);
+	fprintf(f, "%.6f %d %u 0x%04x", (s->time - t->time) * 1e-9,
+	    s->id, s->motion_state, s->motion_flag);
+	for (j = 0; j < fr->num_joints; j++)
+	    fprintf(f, " %.9g %.9g %.9g 0x%04x", s->joint[j].pos_cmd,
+		s->joint[j].pos_fb, s->joint[j].vel_cmd, s->joint[j].flag);
+	fprintf(f, "\n");
+    }
+    if (fclose(f)) {
+	perror(name);
+	return -1;
+    }
+    printf("motion-flightrec: %s: %s\n", name, fr->reason);
+    fflush(stdout);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    const char *dir = ".";
+    int once = 0, now = 0, opt, id, shmem_id, exitval = 1;
+    void *mem;
+    flightrec_t *fr;
+    unsigned int size;
+
+    while ((opt = getopt(argc, argv, "d:1t")) != -1) {
+	switch (opt) {
+	case 'd':
+	    dir = optarg;
+	    break;
+	case '1':
+	    once = 1;
+	    break;
+	case 't':
+	    now = once = 1;
+	    break;
+	default:
+	    fprintf(stderr, "usage: motion-flightrec [-d dir] [-1] [-t]\n");
+	    return 1;
+	}
+    }
+
+    signal(SIGINT, quit);
+    signal(SIGTERM, quit);
+
+    id = rtapi_init("motion-flightrec");
+    if (id < 0) {
+	fprintf(stderr, "motion-flightrec: rtapi_init() failed: %d\n", id);
+	return 1;
+    }
+    /* map the header to learn the size of the whole segment */
+    shmem_id = rtapi_shmem_new(FLIGHTREC_SHMEM_KEY, id, sizeof(flightrec_t));
+    if (shmem_id < 0 || rtapi_shmem_getptr(shmem_id, &mem) < 0) {
+	fprintf(stderr, "motion-flightrec: motion's flight recorder is not there\n");
+	goto out;
+    }
+    fr = mem;
+    size = fr->size;
+    if (atomic_load(&fr->magic) != FLIGHTREC_MAGIC || size < sizeof(flightrec_t)) {
+	fprintf(stderr, "motion-flightrec: motion's flight recorder is not there\n");
+	goto out;
+    }
+    rtapi_shmem_delete(shmem_id, id);
+    shmem_id = rtapi_shmem_new(FLIGHTREC_SHMEM_KEY, id, size);
+    if (shmem_id < 0 || rtapi_shmem_getptr(shmem_id, &mem) < 0) {
+	fprintf(stderr, "motion-flightrec: can't map the flight recorder\n");
+	goto out;
+    }
+    fr = mem;
+
+    if (now)
+	atomic_store(&fr->request, 1);
+    while (!stop) {
+	if (atomic_load(&fr->frozen)) {
+	    if (dump(fr, dir) < 0)
+		goto out;
+	    atomic_store(&fr->rearm, 1);
+	    if (once)
+		break;
+	}
+	usleep(100000);
+    }
+    exitval = 0;
+
+out:
+    if (shmem_id >= 0)
+	rtapi_shmem_delete(shmem_id, id);
+    rtapi_exit(id);
+    return exitval;
+}
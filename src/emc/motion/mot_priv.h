@@ -76,6 +76,7 @@ typedef struct {
     hal_float_t *coarse_pos_cmd;/* RPI: commanded position, w/o comp */
     hal_float_t *joint_vel_cmd;	/* RPI: commanded velocity, w/o comp */
     hal_float_t *joint_acc_cmd;	/* RPI: commanded acceleration, w/o comp */
+    hal_float_t *joint_jerk_cmd;	/* RPI: commanded jerk, w/o comp */
     hal_float_t *backlash_corr;	/* RPI: correction for backlash */
     hal_float_t *backlash_filt;	/* RPI: filtered backlash correction */
     hal_float_t *backlash_vel;	/* RPI: backlash speed variable */
@@ -259,6 +260,17 @@ extern void clearHomes(int joint_num);
 extern void emcmot_config_change(void);
 extern void reportError(const char *fmt, ...) __attribute__((format(printf,1,2))); /* Use the rtapi_print call */
 
+/* the flight recorder, see flightrec.c */
+extern int flightrec_init(int comp_id, int samples, int num_joints, long period);
+extern void flightrec_exit(int comp_id);
+extern void flightrec_record(void);
+extern void flightrec_trigger(const char *fmt, ...) __attribute__((format(printf,1,2)));
+
+/* the tool path ring, see pathring.c */
+extern int pathring_init(int comp_id, int samples, long period);
+extern void pathring_exit(int comp_id);
+extern void pathring_record(void);
+
 
 int joint_is_lockable(int joint_num);
 
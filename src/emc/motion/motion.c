@@ -79,6 +79,12 @@ RTAPI_MP_ARRAY_STRING(names_misc_errors, EMCMOT_MAX_MISC_ERROR, "names of errors
 
 static int unlock_joints_mask = 0;/* mask to select joints for unlock pins */
 RTAPI_MP_INT(unlock_joints_mask, "mask to select joints for unlock pins");
+
+static int flightrec_samples = 4096; /* servo cycles kept for post-mortems */
+RTAPI_MP_INT(flightrec_samples, "servo cycles in the flight recorder, 0 to disable");
+
+static int pathring_samples = 4096; /* servo cycles of tool path for the GUIs */
+RTAPI_MP_INT(pathring_samples, "servo cycles in the tool path ring, 0 to disable");
 /***********************************************************************
 *                  GLOBAL VARIABLE DEFINITIONS                         *
 ************************************************************************/
@@ -402,6 +408,15 @@ int rtapi_app_main(void)
 	return -1;
     }
 
+    /* motion runs without it, if there's no room for it */
+    if (flightrec_init(mot_comp_id, flightrec_samples, num_joints, servo_period_nsec)) {
+	rtapi_print_msg(RTAPI_MSG_ERR, _("MOTION: flight recorder disabled\n"));
+    }
+    /* the backplot falls back to sampling the status buffer without it */
+    if (pathring_init(mot_comp_id, pathring_samples, servo_period_nsec)) {
+	rtapi_print_msg(RTAPI_MSG_ERR, _("MOTION: tool path ring disabled\n"));
+    }
+
     rtapi_print_msg(RTAPI_MSG_INFO, "MOTION: rtapi_app_main() complete\n");
 
     hal_ready(mot_comp_id);
@@ -425,6 +440,8 @@ void rtapi_app_exit(void)
 	    _("MOTION: hal_stop_threads() failed, returned %d\n"), retval);
     }
     /* free shared memory */
+    flightrec_exit(mot_comp_id);
+    pathring_exit(mot_comp_id);
     retval = rtapi_shmem_delete(emc_shmem_id, mot_comp_id);
     if (retval < 0) {
 	rtapi_print_msg(RTAPI_MSG_ERR,
@@ -753,6 +770,7 @@ static int export_joint(int num, joint_hal_t * addr)
     if ((retval = hal_pin_bit_newf(HAL_IN,   &(addr->jjog_vel_mode), mot_comp_id, "joint.%d.jog-vel-mode", num)) != 0) return retval;
     if ((retval = hal_pin_float_newf(HAL_OUT, &(addr->joint_vel_cmd), mot_comp_id, "joint.%d.vel-cmd", num)) != 0) return retval;
     if ((retval = hal_pin_float_newf(HAL_OUT, &(addr->joint_acc_cmd), mot_comp_id, "joint.%d.acc-cmd", num)) != 0) return retval;
+    if ((retval = hal_pin_float_newf(HAL_OUT, &(addr->joint_jerk_cmd), mot_comp_id, "joint.%d.jerk-cmd", num)) != 0) return retval;
     if ((retval = hal_pin_float_newf(HAL_OUT, &(addr->backlash_corr), mot_comp_id, "joint.%d.backlash-corr", num)) != 0) return retval;
     if ((retval = hal_pin_float_newf(HAL_OUT, &(addr->backlash_filt), mot_comp_id, "joint.%d.backlash-filt", num)) != 0) return retval;
     if ((retval = hal_pin_float_newf(HAL_OUT, &(addr->backlash_vel), mot_comp_id, "joint.%d.backlash-vel", num)) != 0) return retval;
@@ -941,6 +959,7 @@ static int init_comm_buffers(void)
 	joint->pos_cmd = 0.0;
 	joint->vel_cmd = 0.0;
 	joint->acc_cmd = 0.0;
+	joint->jerk_cmd = 0.0;
 	joint->backlash_corr = 0.0;
 	joint->backlash_filt = 0.0;
 	joint->backlash_vel = 0.0;
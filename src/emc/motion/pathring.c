@@ -0,0 +1,88 @@
+/********************************************************************
+* Description: pathring.c
+*   The realtime side of the tool path ring.  Every servo cycle the
+*   commanded Cartesian position less the tool offset, with the id and
+*   motion type of the executing segment, goes into a ring in shared
+*   memory.  The GUI backplot drains it in bulk instead of sampling the
+*   status buffer at its own, much lower, rate.
+*
+* License: GPL Version 2
+* System: Linux
+*
+* Copyright (c) 2026 All rights reserved.
+********************************************************************/
+
+#include "rtapi.h"
+#include "rtapi_atomic.h"
+#include "rtapi_string.h"
+#include "hal.h"
+#include "motion.h"
+#include "mot_priv.h"
+#include "pathring.h"
+
+static pathring_t *pr;
+static int pr_shmem_id = -1;
+
+int pathring_init(int comp_id, int samples, long period)
+{
+    unsigned long size;
+    int retval;
+
+    if (samples <= 0)
+	return 0;
+    size = sizeof(pathring_t) + samples * (unsigned long) sizeof(pathring_sample_t);
+    pr_shmem_id = rtapi_shmem_new(PATHRING_SHMEM_KEY, comp_id, size);
+    if (pr_shmem_id < 0) {
+	rtapi_print_msg(RTAPI_MSG_ERR,
+	    "MOTION: path ring rtapi_shmem_new failed, returned %d\n", pr_shmem_id);
+	return -1;
+    }
+    retval = rtapi_shmem_getptr(pr_shmem_id, (void **) &pr);
+    if (retval < 0) {
+	rtapi_print_msg(RTAPI_MSG_ERR,
+	    "MOTION: path ring rtapi_shmem_getptr failed, returned %d\n", retval);
+	pr = 0;
+	return -1;
+    }
+    memset(pr, 0, sizeof(pathring_t));
+    pr->size = size;
+    pr->samples = samples;
+    pr->period = period;
+    atomic_store(&pr->magic, PATHRING_MAGIC);
+    return 0;
+}
+
+void pathring_exit(int comp_id)
+{
+    if (pr_shmem_id >= 0)
+	rtapi_shmem_delete(pr_shmem_id, comp_id);
+    pr = 0;
+    pr_shmem_id = -1;
+}
+
+void pathring_record(void)
+{
+    pathring_sample_t *s;
+    EmcPose *p, *o;
+
+    if (!pr)
+	return;
+    p = &emcmotStatus->carte_pos_cmd;
+    o = &emcmotStatus->tool_offset;
+    s = pathring_sample(pr, pr->head);
+    s->pos[0] = p->tran.x - o->tran.x;
+    s->pos[1] = p->tran.y - o->tran.y;
+    s->pos[2] = p->tran.z - o->tran.z;
+    s->pos[3] = p->a - o->a;
+    s->pos[4] = p->b - o->b;
+    s->pos[5] = p->c - o->c;
+    s->pos[6] = p->u - o->u;
+    s->pos[7] = p->v - o->v;
+    s->pos[8] = p->w - o->w;
+    s->id = emcmotStatus->id;
+    s->motion_type = emcmotStatus->motionType;
+    atomic_store(&pr->head, pr->head + 1);
+    /* the next cycle overwrites the oldest sample; a reader must not see
+       any of that before it sees this head */
+    atomic_thread_fence(memory_order_release);
+}
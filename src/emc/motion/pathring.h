@@ -0,0 +1,42 @@
+/********************************************************************
+* Description: pathring.h
+*   Layout of the tool path ring: the commanded tool tip position of
+*   every servo cycle, in its own shared memory segment, for the live
+*   backplot of the GUIs.  Motion is the only writer; any number of
+*   readers follow 'head' at their own pace.
+*
+* License: GPL Version 2
+* System: Linux
+*
+* Copyright (c) 2026 All rights reserved.
+********************************************************************/
+#ifndef PATHRING_H
+#define PATHRING_H
+
+#define PATHRING_SHMEM_KEY	0x50415448	/* "PATH" */
+#define PATHRING_MAGIC		0x50415401
+
+typedef struct {
+    double pos[9];		/* x y z a b c u v w, tool offset removed */
+    int id;			/* id of the executing TP segment */
+    int motion_type;		/* EMC_MOTION_TYPE_ of that segment */
+} pathring_sample_t;
+
+typedef struct {
+    unsigned int magic;
+    unsigned int size;		/* of the whole segment */
+    int samples;		/* in the ring */
+    long period;		/* servo period, ns */
+    /* samples written since loading.  Motion fills the slot of sample
+       'head' and only then advances it; a reader that finds 'head' more
+       than 'samples' past what it copied has lost the difference. */
+    unsigned long head;
+    /* the ring of samples follows */
+} pathring_t;
+
+static inline pathring_sample_t *pathring_sample(pathring_t *pr, unsigned long n)
+{
+    return (pathring_sample_t *) (pr + 1) + n % pr->samples;
+}
+
+#endif
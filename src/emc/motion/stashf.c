@@ -49,8 +49,18 @@ static int get_code(const char **fmt_io, int *modifier_l) {
     for(; *fmt; fmt++) {
         switch(*fmt) {
             case 'l':
+                // %ll* only fits in a long when long is 64 bits
+                if(*modifier_l && sizeof(long) != sizeof(long long))
+                    goto format_end;
                 *modifier_l = 1;
                 break;
+            // size_t and ptrdiff_t are long-sized
+            case 'z': case 't':
+                *modifier_l = 1;
+                break;
+            // not stashable: '*' width, intmax_t, long double, %n
+            case '*': case 'j': case 'L': case 'n':
+                goto format_end;
             // integers
             case 'd': case 'i': case 'x': case 'u': case 'X':
             // doubles
@@ -70,8 +80,10 @@ format_end:
 
 int vstashf(struct dbuf_iter *o, const char *fmt, va_list ap) {
     int modifier_l;
+    int result;
 
-    dbuf_put_string(o, fmt);
+    result = dbuf_put_string(o, fmt);
+    if(result < 0) return SET_ERRNO(result);
 
     while((fmt = strchr(fmt, '%'))) {
         int code = get_code(&fmt, &modifier_l);
@@ -82,21 +94,26 @@ int vstashf(struct dbuf_iter *o, const char *fmt, va_list ap) {
         case 'c': case 'd': case 'i': case 'x': case 'u': case 'X':
             if(modifier_l) {
         case 'p':
-                dbuf_put_long(o, va_arg(ap, long));
+                result = dbuf_put_long(o, va_arg(ap, long));
             } else {
-                dbuf_put_int(o, va_arg(ap, int));
+                result = dbuf_put_int(o, va_arg(ap, int));
             }
             break;
         case 'e': case 'E': case 'f': case 'F': case 'g': case 'G':
-            dbuf_put_double(o, va_arg(ap, double));
+            result = dbuf_put_double(o, va_arg(ap, double));
             break;
         case 's':
-            dbuf_put_string(o, va_arg(ap, const char *));
+            {
+                const char *s = va_arg(ap, const char *);
+                result = dbuf_put_string(o, s ? s : "(null)");
+            }
             break;
         default:
             return SET_ERRNO(-EINVAL);
             break;
         }
+        // -ENOSPC: the caller's buffer is too small for this message
+        if(result < 0) return SET_ERRNO(result);
     }
     return 0;
 }
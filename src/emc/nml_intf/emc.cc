@@ -264,6 +264,9 @@ int emcFormat(NMLTYPE type, void *buffer, CMS * cms)
     case EMC_TRAJ_CIRCULAR_MOVE_TYPE:
 	((EMC_TRAJ_CIRCULAR_MOVE *) buffer)->update(cms);
 	break;
+    case EMC_TRAJ_SPLINE_MOVE_TYPE:
+	((EMC_TRAJ_SPLINE_MOVE *) buffer)->update(cms);
+	break;
     case EMC_TRAJ_RIGID_TAP_TYPE:
 	((EMC_TRAJ_RIGID_TAP *) buffer)->update(cms);
         break;
@@ -541,6 +544,8 @@ const char *emc_symbol_lookup(uint32_t type)
 	return "EMC_TRAJ_SET_SPINDLESYNC";
     case EMC_TRAJ_SET_VELOCITY_TYPE:
 	return "EMC_TRAJ_SET_VELOCITY";
+    case EMC_TRAJ_SPLINE_MOVE_TYPE:
+	return "EMC_TRAJ_SPLINE_MOVE";
     case EMC_TRAJ_STAT_TYPE:
 	return "EMC_TRAJ_STAT";
     default:
@@ -1055,6 +1060,20 @@ void EMC_TRAJ_CIRCULAR_MOVE::update(CMS * cms)
     cms->update(feed_mode);
 }
 
+void EMC_TRAJ_SPLINE_MOVE::update(CMS * cms)
+{
+    EMC_TRAJ_CMD_MSG::update(cms);
+    EmcPose_update(cms, &end);
+    cms->update(control1);
+    cms->update(control2);
+    cms->update(weight, 4);
+    cms->update(type);
+    cms->update(vel);
+    cms->update(ini_maxvel);
+    cms->update(acc);
+    cms->update(feed_mode);
+}
+
 /*
 *	NML/CMS Update function for EMC_TRAJ_SET_TERM_COND
 *	Automatically generated by NML CodeGen Java Applet.
@@ -1327,6 +1346,7 @@ void EMC_TASK_STAT::update(CMS * cms)
     cms->update(motionLine);
     cms->update(currentLine);
     cms->update(readLine);
+    cms->update(readaheadFill);
     cms->update(optional_stop_state);
     cms->update(block_delete_state);
     cms->update(input_timeout);
@@ -125,6 +125,7 @@ EMC_TASK_STAT_MSG(EMC_TASK_STAT_TYPE, sizeof(EMC_TASK_STAT))
     motionLine = 0;
     currentLine = 0;
     readLine = 0;
+    readaheadFill = 0;
     optional_stop_state = OFF;
     block_delete_state = OFF;
     input_timeout = OFF;
@@ -48,6 +48,10 @@ int NML_INTERP_LIST::append(std::unique_ptr<NMLmsg>&& nml_msg_ptr)
         return -1;
     }
 
+    if (recorder) {
+        recorder(next_line_number, nml_msg_ptr.get());
+    }
+
     NML_INTERP_LIST_NODE node {next_line_number, std::move(nml_msg_ptr)};
 
     // stick it on the list
@@ -114,6 +118,11 @@ int NML_INTERP_LIST::len()
     return ((int)linked_list.size());
 }
 
+void NML_INTERP_LIST::set_recorder(void (*r)(int line, const NMLmsg *msg))
+{
+    recorder = r;
+}
+
 int NML_INTERP_LIST::get_line_number()
 {
     return line_number;
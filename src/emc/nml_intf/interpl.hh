@@ -41,8 +41,11 @@ public:
     void clear();
     void print();
     int len();
+    // while set, 'recorder' sees each message as it is appended
+    void set_recorder(void (*recorder)(int line, const NMLmsg *msg));
 
 private:
+    void (*recorder)(int line, const NMLmsg *msg) = nullptr;
     std::deque<NML_INTERP_LIST_NODE> linked_list;
     int next_line_number = 0;  // line number used to fill temp_node
     int line_number = 0;       // line number of node from get()
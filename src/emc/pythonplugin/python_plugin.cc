@@ -108,36 +108,40 @@ int PythonPlugin::call_method(bp::object method, bp::object &retval)
 
 }
 
-int PythonPlugin::call(const char *module, const char *callable,
-		       bp::object tupleargs, bp::object kwargs, bp::object &retval)
+int PythonPlugin::lookup(const char *module, const char *funcname,
+			 bp::object &function)
 {
-    bp::object function;
-
-    if (callable == NULL)
+    if ((status < PLUGIN_OK) || (funcname == NULL))
 	return PLUGIN_NO_CALLABLE;
 
-    reload();
+    // KeyError propagates to the caller if not found
+    if (module == NULL) {  // default to function in toplevel module
+	function = main_namespace[funcname];
+    } else {
+	bp::object submod =  main_namespace[module];
+	bp::object submod_namespace = submod.attr("__dict__");
+	function = submod_namespace[funcname];
+    }
+    return PyCallable_Check(function.ptr()) ? PLUGIN_OK : PLUGIN_NO_CALLABLE;
+}
 
+int PythonPlugin::call_object(bp::object function, bp::object tupleargs,
+			      bp::object kwargs, bp::object &retval)
+{
     if (status < PLUGIN_OK)
 	return status;
 
     try {
-	if (module == NULL) {  // default to function in toplevel module
-	    function = main_namespace[callable];
-	} else {
-	    bp::object submod =  main_namespace[module];
-	    bp::object submod_namespace = submod.attr("__dict__");
-	    function = submod_namespace[callable];
-	}
 	// this wont work with boost-python1.34 - needs 1.40
 	//retval = function(*tupleargs, **kwargs);
 
-	// this does
-	PyObject *rv = PyObject_Call(function.ptr(), tupleargs.ptr(), kwargs.ptr());
+	// this does. A None kwargs means no keyword arguments.
+	PyObject *rv = PyObject_Call(function.ptr(), tupleargs.ptr(),
+				     kwargs.is_none() ? NULL : kwargs.ptr());
 	if (PyErr_Occurred()) 
 	    bp::throw_error_already_set();
 	if (rv) 
-	    retval = bp::object(bp::borrowed(rv));
+	    retval = bp::object(bp::handle<>(rv));
 	else
 	    retval = bp::object();
 	status = PLUGIN_OK;
@@ -152,12 +156,44 @@ int PythonPlugin::call(const char *module, const char *callable,
 	PyErr_Clear();
     }
     if (status == PLUGIN_EXCEPTION) {
+	logPP(0, "call(%s): \n%s",
+	      PyEval_GetFuncName(function.ptr()), exception_msg.c_str());
+    }
+    return status;
+}
+
+int PythonPlugin::call(const char *module, const char *callable,
+		       bp::object tupleargs, bp::object kwargs, bp::object &retval)
+{
+    bp::object function;
+
+    if (callable == NULL)
+	return PLUGIN_NO_CALLABLE;
+
+    reload();
+
+    if (status < PLUGIN_OK)
+	return status;
+
+    try {
+	lookup(module, callable, function);
+    }
+    catch (bp::error_already_set &) {
+	if (PyErr_Occurred()) {
+	   exception_msg = handle_pyerror();
+	} else
+	    exception_msg = "unknown exception";
+	status = PLUGIN_EXCEPTION;
+	bp::handle_exception();
+	PyErr_Clear();
 	logPP(0, "call(%s%s%s): \n%s",
 	      module ? module : "",
 	      module ? "." : "",
 	      callable, exception_msg.c_str());
+	return status;
     }
-    return status;
+    // logs its own exceptions
+    return call_object(function, tupleargs, kwargs, retval);
 }
 
 bool PythonPlugin::is_callable(const char *module,
@@ -173,14 +209,7 @@ bool PythonPlugin::is_callable(const char *module,
 	return false;
     }
     try {
-	if (module == NULL) {  // default to function in toplevel module
-	   function = main_namespace[funcname];
-	} else {
-	    bp::object submod =  main_namespace[module];
-	    bp::object submod_namespace = submod.attr("__dict__");
-	    function = submod_namespace[funcname];
-	}
-	result = PyCallable_Check(function.ptr());
+	result = (lookup(module, funcname, function) == PLUGIN_OK);
     }
     catch (bp::error_already_set &) {
 	// KeyError expected if not callable
@@ -253,6 +282,7 @@ std::string handle_pyerror()
 int PythonPlugin::initialize()
 {
     std::string msg;
+    load_count++; // invalidates callables resolved by lookup()
     if (Py_IsInitialized()) {
 	try {
 	    bp::object module = bp::import("__main__");
@@ -287,6 +317,7 @@ int PythonPlugin::initialize()
 
 PythonPlugin::PythonPlugin(struct _inittab *inittab) :
     status(0),
+    load_count(0),
     module_mtime(0),
     reload_on_change(0),
     toplevel(0),
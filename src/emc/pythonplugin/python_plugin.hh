@@ -67,6 +67,16 @@ public:
     int run_string(const char *cmd, boost::python::object &retval, bool as_file = false);
     int call_method(boost::python::object method, boost::python::object &retval);
 
+    // pre-resolved callables: lookup() resolves [module.]funcname without
+    // calling it, call_object() calls the result. Neither checks for
+    // changes to the toplevel module, call refresh() first; a callable
+    // must be looked up again whenever generation() changes.
+    int refresh() { return reload(); }
+    int lookup(const char *module, const char *funcname, boost::python::object &function);
+    int call_object(boost::python::object function,
+		    boost::python::object tupleargs, boost::python::object kwargs, boost::python::object &retval);
+    unsigned generation() { return load_count; }
+
     int plugin_status() { return status; };
     bool usable() { return (status >= PLUGIN_OK); }
     int initialize();
@@ -83,6 +93,7 @@ private:
     int reload();
     std::vector<std::string> inittab_entries;
     int status;
+    unsigned load_count;                  // incremented by every initialize()
     time_t module_mtime;                  // toplevel module - last modification time
     bool reload_on_change;                // auto-reload if toplevel module was changed
     const char *toplevel;          // toplevel script
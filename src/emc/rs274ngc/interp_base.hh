@@ -21,6 +21,8 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string>
+#include <vector>
 #include <boost/noncopyable.hpp>
 #include <emcpos.h>
 #include <modal_state.hh>
@@ -67,6 +69,13 @@ public:
     virtual void print_state_tag(StateTag const &tag) = 0;
     virtual void set_loglevel(int level) = 0;
     virtual void set_loop_on_main_m99(bool state) = 0;
+    // number of lines read ahead of the one being executed
+    virtual int readahead_fill() { return 0; }
+    // for caching a program's canon output: a digest of the state the
+    // output depends on, and the files the last run read.  Both return
+    // false when the run cannot be cached.
+    virtual bool state_digest(unsigned long long *digest) { (void)digest; return false; }
+    virtual bool run_dependencies(std::vector<std::string> &files) { (void)files; return false; }
     FILE* get_stdout() { return stdout; };
 };
 
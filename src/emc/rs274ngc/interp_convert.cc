@@ -319,6 +319,8 @@ int Interp::convert_nurbs(int mode,
 		     _
 		     ("You must specify a number of control points at least equal to the order L = %d"),
 		     nurbs_order);
+		CHKS((settings->feed_mode == FEED_MODE::INVERSE_TIME && !block->f_flag),
+		     NCE_F_WORD_MISSING_WITH_INVERSE_TIME_ARC_MOVE);
 
 		if (settings->plane == CANON_PLANE::XY) {
 			settings->current_x =
@@ -354,6 +356,8 @@ int Interp::convert_nurbs(int mode,
 			}
 		printf("*----------------------------------------- hier sind alle nurbs-Punkte da (%s %d)\n", __FILE__,__LINE__);
 */
+		inverse_time_rate_nurbs(nurbs_g5_control_points, nurbs_order,
+					block, settings);
 		NURBS_G5_FEED(block->line_number, nurbs_g5_control_points,
 			      nurbs_order, settings->plane);
 		nurbs_g5_control_points.clear();
@@ -668,6 +672,8 @@ int Interp::convert_spline(int mode, block_pointer block,	//!< pointer to a bloc
 		    ("*----------------------------------------- (%s %d)\n",
 		     __FILE__, __LINE__);
 
+		inverse_time_rate_nurbs(nurbs_g5_control_points, 3, block,
+					settings);
 		NURBS_G5_FEED(block->line_number, nurbs_g5_control_points,
 			      3, settings->plane);
 		nurbs_g5_control_points.clear();
@@ -826,6 +832,8 @@ int Interp::convert_spline(int mode, block_pointer block,	//!< pointer to a bloc
         }
         printf("*----------------------------------------- (%s %d)\n", __FILE__,__LINE__);
 */
+		inverse_time_rate_nurbs(nurbs_g5_control_points, 4, block,
+					settings);
 		NURBS_G5_FEED(block->line_number, nurbs_g5_control_points,
 			      4, settings->plane);
 		nurbs_g5_control_points.clear();
@@ -5233,6 +5241,7 @@ int Interp::convert_stop(block_pointer block,    //!< pointer to a block of RS27
       PALLET_SHUTTLE();
     PROGRAM_END();
     if (_setup.percent_flag && _setup.file_pointer) {
+      readahead_sync();
       line = _setup.linetext;
       for (;;) {                /* check for ending percent sign and comment if missing */
         if (fgets(line, LINELEN, _setup.file_pointer) == NULL) {
@@ -68,6 +68,23 @@ The KT and NGC manuals say nothing about case or spaces and tabs.
 */
 
 int Interp::close_and_downcase(char *line)       //!< string: one line of NC code
+{
+    switch (downcase_line(line)) {
+    case DOWNCASE_NESTED_COMMENT:
+	ERS(NCE_NESTED_COMMENT_FOUND);
+    case DOWNCASE_NULL_MISSING:
+	ERS(NCE_NULL_MISSING_AFTER_NEWLINE);
+    case DOWNCASE_UNCLOSED_COMMENT:
+	ERS(NCE_UNCLOSED_COMMENT_FOUND);
+    default:
+	return INTERP_OK;
+    }
+}
+
+/* The work of close_and_downcase(), without reporting errors through
+   the interpreter, so that the readahead thread can do it too.  Returns
+   DOWNCASE_OK, or which error close_and_downcase() reports. */
+int downcase_line(char *line)
 {
     int m;
     int n;
@@ -87,11 +104,12 @@ int Interp::close_and_downcase(char *line)       //!< string: one line of NC cod
 	    if (item == ')') {
 		comment = 0;
 	    } else if (item == '(')
-		ERS(NCE_NESTED_COMMENT_FOUND);
+		return DOWNCASE_NESTED_COMMENT;
 	} else if ((item == ' ') || (item == '\t') || (item == '\r'));
 	/* don't copy blank or tab or CR */
 	else if (item == '\n') {    /* don't copy newline            *//* but check null follows        */
-	    CHKS((line[m + 1] != 0), NCE_NULL_MISSING_AFTER_NEWLINE);
+	    if (line[m + 1] != 0)
+		return DOWNCASE_NULL_MISSING;
 	} else if ((64 < item) && (item < 91)) {    /* downcase upper case letters */
 	    line[n++] = (32 + item);
 	} else if ((item == '(') && !semicomment) {   /* (comment is starting */
@@ -101,9 +119,10 @@ int Interp::close_and_downcase(char *line)       //!< string: one line of NC cod
 	    line[n++] = item;         /* copy anything else */
 	}
     }
-    CHKS((comment), NCE_UNCLOSED_COMMENT_FOUND);
+    if (comment)
+	return DOWNCASE_UNCLOSED_COMMENT;
     line[n] = 0;
-    return INTERP_OK;
+    return DOWNCASE_OK;
 }
 
 
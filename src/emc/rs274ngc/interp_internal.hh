@@ -18,6 +18,7 @@
 #include "linuxcnc.h"
 #include <limits.h>
 #include <stdio.h>
+#include <sys/stat.h>
 #include <set>
 #include <map>
 #include <bitset>
@@ -325,6 +326,11 @@ enum class RETRACT_MODE
 // string table - to get rid of strdup/free
 const char *strstore(const char *s);
 
+// close_and_downcase() minus the error reporting, usable off the interp thread
+enum { DOWNCASE_OK, DOWNCASE_NESTED_COMMENT, DOWNCASE_NULL_MISSING,
+       DOWNCASE_UNCLOSED_COMMENT };
+int downcase_line(char *line);
+
 
 // Block execution phases in execution order
 // very carefully check code for sequencing when
@@ -707,6 +713,11 @@ struct setup
   double feed_rate;             // feed rate in current units/min
   char filename[PATH_MAX];      // name of currently open NC code file
   FILE *file_pointer;           // file pointer for open NC code file
+  class ReadAhead *readahead;   // reads lines of the open file ahead, or NULL
+  long readahead_pos;           // offset of next line, if readahead_pending
+  bool readahead_pending;       // file_pointer lags lines taken from readahead
+  std::vector<std::string> run_files; // files opened since open()
+  bool run_external;            // this run read HAL or called Python
   bool flood;                 // whether flood coolant is on
   CANON_UNITS length_units;     // millimeters or inches
   double center_arc_radius_tolerance_inch; // modify with INI setting
@@ -721,6 +732,10 @@ struct setup
   double origin_offset_z;       // g5x offset z
   double rotation_xy;         // rotation of coordinate system around Z, in degrees
   double parameters[interp_param_global::RS274NGC_MAX_PARAMETERS];   // system parameters
+  std::string parameter_file;   // var file last read or written, if any
+  struct stat parameter_file_stat;        // of parameter_file back then
+  std::vector<int> parameter_file_numbers;      // parameters it holds
+  std::vector<double> parameter_file_values;    // and their values
   int parameter_occurrence;     // parameter buffer index
   int parameter_numbers[MAX_NAMED_PARAMETERS];    // parameter number buffer
   double parameter_values[MAX_NAMED_PARAMETERS];  // parameter value buffer
@@ -819,6 +834,9 @@ struct setup
 #define FEATURE_OWORD_WARNONLY       0x00000020
 
     boost::python::object *pythis;  // boost::cref to 'this'
+    boost::python::object *pyselfargs; // (self,) argument tuple for handlers
+    boost::python::object *pyblocks; // persistent 'blocks' view onto blocks[]
+    boost::python::object *pyparams; // persistent 'params' view
     const char *on_abort_command;
     int_remap_map  g_remapped,m_remapped;
     remap_map remaps;
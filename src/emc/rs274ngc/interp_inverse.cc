@@ -134,3 +134,57 @@ int Interp::inverse_time_rate_straight(double end_x,     //!< x coordinate of en
 
   return INTERP_OK;
 }
+
+/****************************************************************************/
+
+/*! inverse_time_rate_nurbs
+
+Returned Value: int (INTERP_OK)
+
+Side effects: a call is made to SET_FEED_RATE and _setup.feed_rate is set.
+
+Called by:
+  convert_nurbs
+  convert_spline
+
+This finds the feed rate needed by an inverse time G5, G5.1 or G5.3
+move, which canon runs at one feed rate along the whole curve. The
+length of the curve is found from chords between points sampled along
+it, 16 for each knot interval.
+
+*/
+
+int Interp::inverse_time_rate_nurbs(std::vector<NURBS_CONTROL_POINT> nurbs_control_points,      //!< control points of the curve
+                                    unsigned int nurbs_order,  //!< order of the curve
+                                    block_pointer block,       //!< pointer to a block of RS274 instructions
+                                    setup_pointer settings)    //!< pointer to machine settings
+{
+  double length;
+  double rate;
+  unsigned int n, div;
+  double umax;
+
+  if (settings->feed_mode != FEED_MODE::INVERSE_TIME) return -1;
+
+  n = nurbs_control_points.size() - 1;
+  umax = n - nurbs_order + 2;
+  div = 16 * (n - nurbs_order + 2);
+  std::vector<unsigned int> knot_vector =
+      nurbs_G5_knot_vector_creator(n, nurbs_order);
+  NURBS_PLANE_POINT P0 = nurbs_G5_point(0, nurbs_order, nurbs_control_points, knot_vector);
+  length = 0;
+  for (unsigned int i = 1; i <= div; i++) {
+    NURBS_PLANE_POINT P1 = nurbs_G5_point(umax * i / div, nurbs_order,
+                                          nurbs_control_points, knot_vector);
+    length += hypot(P1.NURBS_X - P0.NURBS_X, P1.NURBS_Y - P0.NURBS_Y);
+    P0 = P1;
+  }
+  if (length == 0){
+    rate = 0.1; // See https://github.com/LinuxCNC/linuxcnc/issues/2410
+  } else {
+    rate = length * block->f_number;
+  }
+  enqueue_SET_FEED_RATE(rate);
+  settings->feed_rate = rate;
+  return INTERP_OK;
+}
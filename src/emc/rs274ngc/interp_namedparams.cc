@@ -249,6 +249,7 @@ int Interp::fetch_hal_param( const char *nameBuf, int *status, double *value)
     char hal_name[HAL_NAME_LEN];
 
     *status = 0;
+    _setup.run_external = true;
     if (!comp_id) {
 	char hal_comp[HAL_NAME_LEN];
 	snprintf(hal_comp, sizeof(hal_comp),"interp%d",getpid());
@@ -361,6 +362,7 @@ int Interp::find_named_param(
 	  bp::object retval, tupleargs, kwargs;
 	  bp::list plist;
 
+	  _setup.run_external = true;
 	  plist.append(*_setup.pythis); // self
 	  tupleargs = bp::tuple(plist);
 	  kwargs = bp::dict();
@@ -229,7 +229,7 @@ int Interp::execute_call(setup_pointer settings,
 	    // reopen it on return.
 	    previous_frame->position = -1;
 	else
-	    previous_frame->position = ftell(settings->file_pointer);
+	    previous_frame->position = file_tell();
 	previous_frame->filename = strstore(settings->filename);
 	previous_frame->sequence_number = settings->sequence_number;
 	logOword("saving return location[cl=%d]: %s:%d offset=%ld", 
@@ -327,9 +327,10 @@ int Interp::execute_call(setup_pointer settings,
 	    if (remap->remap_py || remap->prolog_func || remap->epilog_func) {
 		CHKS(!PYUSABLE, "%s (remapped) uses Python functions, but the Python plugin is not available", 
 		     remap->name);
-		plist.append(*settings->pythis);   //self
-		current_frame->pystuff.impl->tupleargs = bp::tuple(plist);
-		current_frame->pystuff.impl->kwargs = bp::dict();
+		// self only, shared tuple. kwargs is None unless
+		// add_parameters() has words to pass
+		current_frame->pystuff.impl->tupleargs = *settings->pyselfargs;
+		current_frame->pystuff.impl->kwargs = bp::object();
 	    }
 	    if (remap->argspec && (strchr(remap->argspec, '@') == NULL)) {
 		// add_parameters will decorate kwargs as per argspec
@@ -453,6 +454,7 @@ int Interp::execute_return(setup_pointer settings, context_pointer current_frame
 
 	    // file at this level was marked as closed, so dont reopen.
 	    if (previous_frame->position == -1) {
+		readahead_sync();
 		if (settings->file_pointer) fclose(settings->file_pointer);
 		settings->file_pointer = NULL;
 		rtapi_strxcpy(settings->filename, "");
@@ -460,6 +462,7 @@ int Interp::execute_return(setup_pointer settings, context_pointer current_frame
 		if(settings->file_pointer == NULL) {
 		    ERS(NCE_FILE_NOT_OPEN);
 		}
+		readahead_sync();
 		//!!!KL must open the new file, if changed
 		if (0 != strcmp(settings->filename, previous_frame->filename))  {
 		    fclose(settings->file_pointer);
@@ -522,6 +525,7 @@ void Interp::loop_to_beginning(setup_pointer settings)
 	     settings->filename);
 
     // scroll back to beginning of file/first block
+    readahead_sync();
     fseek(settings->file_pointer, 0, SEEK_SET);
     settings->sequence_number = 0;
 }
@@ -546,6 +550,7 @@ int Interp::control_back_to( block_pointer block, // pointer to block
     offset_map_iterator it;
     offset_pointer op;
     logOword("Entered:%s %s", name,basename(block->o_name));
+    readahead_sync();
     it = settings->offset_map.find(basename(block->o_name));
 
     // #1 already defined
@@ -567,6 +572,7 @@ int Interp::control_back_to( block_pointer block, // pointer to block
                 ERS(NCE_UNABLE_TO_OPEN_FILE, op->filename);
             }
             strncpy(settings->filename, op->filename, sizeof(settings->filename));
+	    settings->run_files.push_back(op->filename);
 
 	    if (newFP) {
 		// close the old file...
@@ -602,6 +608,7 @@ int Interp::control_back_to( block_pointer block, // pointer to block
             ERS(NCE_UNABLE_TO_OPEN_FILE, newFileName);
         }
         strncpy(settings->filename, newFileName, sizeof(settings->filename));
+	settings->run_files.push_back(newFileName);
     } else {
 	char *dirname = getcwd(NULL, 0);
 	logOword("fopen: |%s| failed CWD:|%s|", newFileName,
@@ -33,6 +33,7 @@ namespace bp = boost::python;
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <exception>
+#include <map>
 
 #include "rs274ngc.hh"
 #include "interp_return.hh"
@@ -89,15 +90,68 @@ int Interp::py_reload()
     return INTERP_OK;
 }
 
+// Resolved Python callables, so remap handlers and Python O-word subs
+// are not looked up by name in the module dictionaries on every call.
+// Keyed by the module and function name pointers, which normally come
+// from strstore(); the names are kept to catch a reused buffer.
+// Only callables are cached: a name that is missing now may be defined
+// later by the Python code itself, without a reload.
+// The whole cache is dropped whenever the plugin is (re)loaded. It is
+// never freed, so no Python objects are released during static
+// destruction at exit.
+struct pycallable_entry {
+    std::string module, funcname;
+    bp::object function;
+};
+typedef std::map<std::pair<const char *, const char *>, pycallable_entry> pycallable_map;
+static pycallable_map *pycallables;
+static unsigned pycallables_generation;
+
+static bool resolve_pycallable(const char *module, const char *funcname,
+			       bp::object &function)
+{
+    python_plugin->refresh();
+    if (pycallables == NULL)
+	pycallables = new pycallable_map;
+    if (python_plugin->generation() != pycallables_generation) {
+	pycallables->clear();
+	pycallables_generation = python_plugin->generation();
+    }
+    pycallable_map::iterator it = pycallables->find(std::make_pair(module, funcname));
+    if ((it != pycallables->end()) &&
+	(it->second.funcname == funcname) &&
+	(it->second.module == (module ? module : ""))) {
+	function = it->second.function;
+	return true;
+    }
+    bool callable;
+    try {
+	callable = (python_plugin->lookup(module, funcname, function) == PLUGIN_OK);
+    }
+    catch (bp::error_already_set &) {
+	// KeyError expected if not defined
+	callable = false;
+	PyErr_Clear();
+    }
+    if (callable) {
+	pycallable_entry &e = (*pycallables)[std::make_pair(module, funcname)];
+	e.module = module ? module : "";
+	e.funcname = funcname;
+	e.function = function;
+    }
+    return callable;
+}
+
 // determine whether [module.]funcname is callable
 bool Interp::is_pycallable(setup_pointer settings,
 			   const char *module,
 			   const char *funcname)
 {
-    if (!PYUSABLE)
+    if (!PYUSABLE || (funcname == NULL))
       return false;
 
-    return python_plugin->is_callable(module,funcname);
+    bp::object function;
+    return resolve_pycallable(module, funcname, function);
 }
 
 // all parameters to/results from Python calls go through the callframe, which looks a bit awkward
@@ -114,6 +168,7 @@ int Interp::pycall(setup_pointer settings,
     int status = INTERP_OK;
     PyObject *res_str;
 
+    _setup.run_external = true;
     if (_setup.loggingLevel > 4)
 	logPy("pycall(%s.%s) \n", module ? module : "", funcname);
 
@@ -166,7 +221,16 @@ int Interp::pycall(setup_pointer settings,
 	}
 	break;
     default:
-	python_plugin->call(module,funcname, frame->pystuff.impl->tupleargs,frame->pystuff.impl->kwargs,retval);
+	{
+	    if (resolve_pycallable(module, funcname, function)) {
+		python_plugin->call_object(function, frame->pystuff.impl->tupleargs,
+					   frame->pystuff.impl->kwargs, retval);
+	    } else {
+		// not resolvable - let the plugin produce the error message
+		python_plugin->call(module, funcname, frame->pystuff.impl->tupleargs,
+				    frame->pystuff.impl->kwargs, retval);
+	    }
+	}
 	CHKS(python_plugin->plugin_status() == PLUGIN_EXCEPTION,
 	     "pycall(%s):\n%s", funcname,
 	     python_plugin->last_exception().c_str());
@@ -278,6 +342,7 @@ int Interp::py_execute(const char *cmd, bool as_file)
     bp::object retval;
 
     logPy("py_execute(%s)",cmd);
+    _setup.run_external = true;
 
     CHKS(!PYUSABLE, "py_execute(%s): Python plugin not initialized",cmd);
 
@@ -27,6 +27,7 @@
 #include "rs274ngc_return.hh"
 #include "interp_internal.hh"
 #include "rs274ngc_interp.hh"
+#include "interp_readahead.hh"
 #include "rtapi_math.h"
 #include <cmath>
 #include <rtapi_string.h>
@@ -3126,36 +3127,49 @@ int Interp::read_text(
   int index;
 
   if (command == NULL) {
-    if (fgets(raw_line, LINELEN, inport) == NULL) {
-      if(_setup.skipping_to_sub)
-      {
-        ERS(_("EOF in file:%s seeking o-word: o<%s> from line: %d"),
-                 _setup.filename,
-                 _setup.skipping_to_sub,
-                 _setup.skipping_start);
-      }
-      if (_setup.percent_flag)
-      {
-        ERS(NCE_FILE_ENDED_WITH_NO_PERCENT_SIGN);
+    const ReadAhead::line *ahead = NULL;
+    if (_setup.readahead && inport == _setup.file_pointer)
+      ahead = _setup.readahead->take(_setup.filename, file_tell());
+    if (ahead) {
+      // already read and downcased by the readahead thread
+      _setup.readahead_pos = ahead->next;
+      _setup.readahead_pending = true;
+      _setup.sequence_number++;
+      strcpy(raw_line, ahead->raw);
+      strcpy(line, ahead->text);
+    } else {
+      readahead_sync();
+      if (fgets(raw_line, LINELEN, inport) == NULL) {
+        if(_setup.skipping_to_sub)
+        {
+          ERS(_("EOF in file:%s seeking o-word: o<%s> from line: %d"),
+                   _setup.filename,
+                   _setup.skipping_to_sub,
+                   _setup.skipping_start);
+        }
+        if (_setup.percent_flag)
+        {
+          ERS(NCE_FILE_ENDED_WITH_NO_PERCENT_SIGN);
+        }
+        else
+        {
+          ERS(NCE_FILE_ENDED_WITH_NO_PERCENT_SIGN_OR_PROGRAM_END);
+        }
       }
-      else
-      {
-        ERS(NCE_FILE_ENDED_WITH_NO_PERCENT_SIGN_OR_PROGRAM_END);
+      _setup.sequence_number++;   /* moved from version1, was outside if */
+      if (strlen(raw_line) == (LINELEN - 1)) { // line is too long. need to finish reading the line to recover
+        for (; fgetc(inport) != '\n' && !feof(inport) ;) {
+        }
+        ERS(NCE_COMMAND_TOO_LONG);
       }
-    }
-    _setup.sequence_number++;   /* moved from version1, was outside if */
-    if (strlen(raw_line) == (LINELEN - 1)) { // line is too long. need to finish reading the line to recover
-      for (; fgetc(inport) != '\n' && !feof(inport) ;) {
+      for (index = (strlen(raw_line) - 1);        // index set on last char
+           (index >= 0) && (isspace(raw_line[index]));
+           index--) { // remove space at end of raw_line, especially CR & LF
+        raw_line[index] = 0;
       }
-      ERS(NCE_COMMAND_TOO_LONG);
+      strncpy(line, raw_line, LINELEN);
+      CHP(close_and_downcase(line));
     }
-    for (index = (strlen(raw_line) - 1);        // index set on last char
-         (index >= 0) && (isspace(raw_line[index]));
-         index--) { // remove space at end of raw_line, especially CR & LF
-      raw_line[index] = 0;
-    }
-    strncpy(line, raw_line, LINELEN);
-    CHP(close_and_downcase(line));
     if ((line[0] == '%') && (line[1] == 0) && (_setup.percent_flag)) {
         FINISH();
         return INTERP_ENDFILE;
@@ -0,0 +1,201 @@
+/********************************************************************
+* Description: interp_readahead.cc
+*   Reads the lines of an NC code file ahead of the interpreter on a
+*   worker thread.
+*
+*   The worker opens the file itself and reads it sequentially into a
+*   bounded queue, doing what read_text() does to each line up to and
+*   including close_and_downcase().  Parsing cannot move there, since
+*   reading a block evaluates expressions against parameters that the
+*   blocks before it set.
+*
+*   The interpreter's own file_pointer is not advanced for lines taken
+*   from the queue; setup.readahead_pos holds where it would be, and
+*   readahead_sync() catches it up before anything else uses it.  Any
+*   jump (O-word call, return, loop, M99) just makes the next take()
+*   miss, and the worker starts over from there.
+*
+* License: GPL Version 2
+* System: Linux
+*
+* Copyright (c) 2026 All rights reserved.
+*
+********************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include "rs274ngc.hh"
+#include "rs274ngc_return.hh"
+#include "interp_internal.hh"
+#include "rs274ngc_interp.hh"
+#include "interp_readahead.hh"
+
+ReadAhead::ReadAhead(int depth) :
+    ring(depth), head(0), count(0), taken(), start(0), reading_at(0),
+    generation(0), restart(false), stopped(true), quit(false)
+{
+    worker = std::thread(&ReadAhead::run, this);
+}
+
+ReadAhead::~ReadAhead()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        quit = true;
+    }
+    worker_cv.notify_one();
+    worker.join();
+}
+
+// read the line at 'pos' from 'f' the way read_text() does
+static void read_line(FILE *f, long pos, ReadAhead::line &l)
+{
+    int index;
+
+    l.offset = pos;
+    l.usable = false;
+    if (fgets(l.raw, LINELEN, f) == NULL) {
+        l.next = pos;
+        return;
+    }
+    l.next = ftell(f);
+    if (strlen(l.raw) == (LINELEN - 1))
+        return;
+    for (index = (strlen(l.raw) - 1);
+         (index >= 0) && (isspace(l.raw[index]));
+         index--) {
+        l.raw[index] = 0;
+    }
+    memcpy(l.text, l.raw, LINELEN);
+    l.usable = downcase_line(l.text) == DOWNCASE_OK;
+}
+
+void ReadAhead::run()
+{
+    FILE *f = NULL;
+    std::string open_name;
+    unsigned gen = 0;
+    long pos = 0;
+    line l;
+
+    std::unique_lock<std::mutex> lock(mtx);
+    while (!quit) {
+        if (restart) {
+            restart = false;
+            gen = generation;
+            pos = start;
+            if (open_name != file) {
+                if (f) fclose(f);
+                f = file.empty() ? NULL : fopen(file.c_str(), "r");
+                open_name = file;
+            }
+            stopped = !f || fseek(f, pos, SEEK_SET) != 0;
+            if (stopped)
+                taker_cv.notify_one();
+        }
+        if (stopped || count == ring.size()) {
+            worker_cv.wait(lock);
+            continue;
+        }
+        lock.unlock();
+        read_line(f, pos, l);
+        lock.lock();
+        if (restart || gen != generation)
+            continue;           // the interpreter went elsewhere meanwhile
+        ring[(head + count) % ring.size()] = l;
+        count++;
+        pos = reading_at = l.next;
+        if (!l.usable)
+            stopped = true;     // the interpreter reads this one itself
+        taker_cv.notify_one();
+    }
+    if (f) fclose(f);
+}
+
+void ReadAhead::restart_at(const char *filename, long offset)
+{
+    file = filename;
+    start = reading_at = offset;
+    head = count = 0;
+    generation++;
+    restart = true;
+    stopped = false;
+    worker_cv.notify_one();
+}
+
+const ReadAhead::line *ReadAhead::take(const char *filename, long offset)
+{
+    std::unique_lock<std::mutex> lock(mtx);
+
+    if (file != filename) {
+        restart_at(filename, offset);
+        return NULL;
+    }
+    while (true) {
+        // after a restart the worker re-reads lines the interpreter
+        // has already read itself, and a jump forward skips lines; the
+        // worker may be waiting for room in a full queue
+        if (count && ring[head].offset < offset) {
+            while (count && ring[head].offset < offset) {
+                head = (head + 1) % ring.size();
+                count--;
+            }
+            worker_cv.notify_one();
+        }
+        if (count) {
+            if (ring[head].offset != offset)
+                break;
+            bool usable = ring[head].usable;
+            if (usable)
+                taken = ring[head];
+            head = (head + 1) % ring.size();
+            count--;
+            worker_cv.notify_one();
+            return usable ? &taken : NULL;
+        }
+        if (stopped || reading_at != offset)
+            break;
+        // the worker is about to read this line
+        taker_cv.wait(lock);
+    }
+    restart_at(filename, offset);
+    return NULL;
+}
+
+void ReadAhead::stop()
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    restart_at("", 0);
+}
+
+int ReadAhead::fill()
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    return count;
+}
+
+/****************************************************************************/
+
+/* Interp side: where the interpreter's file_pointer really is, and
+   catching it up with the lines taken from the readahead queue. */
+
+long Interp::file_tell()
+{
+    if (_setup.readahead_pending)
+        return _setup.readahead_pos;
+    return ftell(_setup.file_pointer);
+}
+
+void Interp::readahead_sync()
+{
+    if (!_setup.readahead_pending)
+        return;
+    _setup.readahead_pending = false;
+    if (_setup.file_pointer)
+        fseek(_setup.file_pointer, _setup.readahead_pos, SEEK_SET);
+}
+
+int Interp::readahead_fill()
+{
+    return _setup.readahead ? _setup.readahead->fill() : 0;
+}
@@ -0,0 +1,64 @@
+/********************************************************************
+* Description: interp_readahead.hh
+*   Reads the lines of an NC code file ahead of the interpreter on a
+*   worker thread, so that file I/O and downcasing are off the path
+*   that executes blocks.
+*
+* License: GPL Version 2
+* System: Linux
+*
+* Copyright (c) 2026 All rights reserved.
+*
+********************************************************************/
+#ifndef INTERP_READAHEAD_HH
+#define INTERP_READAHEAD_HH
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "linuxcnc.h"
+
+class ReadAhead {
+public:
+    // one line of the file, as read_text() would produce it
+    struct line {
+        long offset;            // where the line starts in the file
+        long next;              // where the line after it starts
+        bool usable;            // false: too long, bad comment or EOF
+        char raw[LINELEN];      // trailing white space removed
+        char text[LINELEN];     // and then close_and_downcase()d
+    };
+
+    explicit ReadAhead(int depth);
+    ~ReadAhead();
+
+    // Returns the line of 'filename' that starts at 'offset', or NULL if
+    // the caller has to read that line itself; in that case the worker
+    // starts over from 'offset'.  The line stays valid until the next
+    // call.
+    const line *take(const char *filename, long offset);
+    // drop the queue and close the file, e.g. when the program is closed
+    void stop();
+    int fill();
+    int depth() const { return (int)ring.size(); }
+
+private:
+    void run();
+    void restart_at(const char *filename, long offset);
+
+    std::mutex mtx;
+    std::condition_variable worker_cv, taker_cv;
+    std::vector<line> ring;
+    size_t head, count;
+    line taken;
+    std::string file;           // file the worker is reading
+    long start;                 // offset the worker (re)starts at
+    long reading_at;            // offset of the next line the worker reads
+    unsigned generation;        // bumped on each restart
+    bool restart, stopped, quit;
+    std::thread worker;
+};
+
+#endif
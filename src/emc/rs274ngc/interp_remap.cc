@@ -16,6 +16,7 @@
 #define BOOST_PYTHON_MAX_ARITY 4
 #include "python_plugin.hh"
 #include "interp_python.hh"
+#include <boost/python/dict.hpp>
 #include <boost/python/list.hpp>
 namespace bp = boost::python;
 
@@ -198,6 +199,8 @@ int Interp::add_parameters(setup_pointer settings,
 
     // if any Python handlers are present, create a kwargs dict
     bool pydict = rptr->remap_py || rptr->prolog_func || rptr->epilog_func;
+    if (pydict && active_frame->pystuff.impl->kwargs.is_none())
+	active_frame->pystuff.impl->kwargs = bp::dict();
 
     std::fill(missing, std::end(missing), 0);
     std::fill(optional, std::end(optional), 0);
@@ -22,6 +22,7 @@
 #endif
 #include <string.h>
 #include "rs274ngc_interp.hh"
+#include "interp_readahead.hh"
 #include <boost/python/object.hpp>
 
 #pragma GCC diagnostic error "-Wmissing-field-initializers"
@@ -88,6 +89,10 @@ setup::setup() :
     feed_rate (0.0),
     filename{},
     file_pointer(NULL),
+    readahead(NULL),
+    readahead_pos(0),
+    readahead_pending(false),
+    run_external(false),
     flood(0),
     length_units(CANON_UNITS_INCHES),
     line_length(0),
@@ -101,6 +106,7 @@ setup::setup() :
     rotation_xy (0.0),
 
     parameters{0},
+    parameter_file_stat{},
     parameter_occurrence(0),
     parameter_numbers{0},
     parameter_values{0},
@@ -178,6 +184,9 @@ setup::setup() :
     loop_on_main_m99(false),
     disable_g92_persistence(0),
     pythis(),
+    pyselfargs(),
+    pyblocks(),
+    pyparams(),
     on_abort_command(NULL),
     init_once(CANON_STOPPED)
 {
@@ -186,5 +195,9 @@ setup::setup() :
 
 setup::~setup() {
     assert(!pythis || Py_IsInitialized());
+    if(pyparams) delete pyparams;
+    if(pyblocks) delete pyblocks;
+    if(pyselfargs) delete pyselfargs;
     if(pythis) delete pythis;
+    delete readahead;
 }
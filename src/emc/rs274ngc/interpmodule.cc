@@ -76,8 +76,13 @@ static  active_settings_array active_settings_wrapper ( Interp & inst) {
     return active_settings_array(inst._setup.active_settings);
 }
 
-static  blocks_array blocks_wrapper ( Interp & inst) {
-    return blocks_array(inst._setup.blocks);
+// blocks[] and the interpreter live as long as each other, so the
+// view is built on first use and handed out again on every access
+// instead of wrapping the array anew for each remap handler call
+static  bp::object blocks_wrapper ( Interp & inst) {
+    if (!inst._setup.pyblocks)
+	inst._setup.pyblocks = new bp::object(blocks_array(inst._setup.blocks));
+    return *inst._setup.pyblocks;
 }
 
 static  parameters_array parameters_wrapper ( Interp & inst) {
@@ -129,8 +134,11 @@ static bp::object wrap_find_tool_pocket(Interp &interp, int toolno)
 
 
 // FIXME not sure if this is really needed
-static  ParamClass param_wrapper ( Interp & inst) {
-    return ParamClass(inst);
+// same as blocks: one view, reused across calls
+static  bp::object param_wrapper ( Interp & inst) {
+    if (!inst._setup.pyparams)
+	inst._setup.pyparams = new bp::object(ParamClass(inst));
+    return *inst._setup.pyparams;
 }
 
 static int get_task(Interp &i) { return _task; };
@@ -1023,9 +1031,7 @@ BOOST_PYTHON_MODULE(interpreter) {
 	.add_property("parameter_g73_peck_clearance", &get_parameter_g73_peck_clearance, &set_parameter_g73_peck_clearance)
     .add_property("parameter_g83_peck_clearance", &get_parameter_g83_peck_clearance, &set_parameter_g83_peck_clearance)
 
-	.add_property( "params",
-		       bp::make_function( &param_wrapper,
-					  bp::with_custodian_and_ward_postcall< 0, 1 >()))
+	.add_property( "params", &param_wrapper)
 
 
 	// _setup arrays
@@ -1046,9 +1052,7 @@ BOOST_PYTHON_MODULE(interpreter) {
 	.add_property( "active_settings",
 		       bp::make_function( active_settings_w(&active_settings_wrapper),
 					  bp::with_custodian_and_ward_postcall< 0, 1 >()))
-	.add_property( "blocks",
-		       bp::make_function( blocks_w(&blocks_wrapper),
-					  bp::with_custodian_and_ward_postcall< 0, 1 >()))
+	.add_property( "blocks", &blocks_wrapper)
 	.add_property( "parameters",
 		       bp::make_function( parameters_w(&parameters_wrapper),
 					  bp::with_custodian_and_ward_postcall< 0, 1 >()))
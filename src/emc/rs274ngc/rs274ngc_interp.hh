@@ -56,6 +56,13 @@ public:
  int read(const char *mdi);
  int read();
 
+// number of lines the readahead worker has queued
+ int readahead_fill();
+
+// what a program's canon output depends on, for the task's program cache
+ bool state_digest(unsigned long long *digest);
+ bool run_dependencies(std::vector<std::string> &files);
+
 // reset yourself
  int reset();
 
@@ -65,6 +72,9 @@ public:
 // save interpreter variables to file
  int save_parameters(const char *filename,
                                     const double parameters[]);
+ void remember_parameter_file(const char *filename, std::vector<int> &numbers,
+                              const double parameters[]);
+ bool parameter_file_current(const char *filename);
 
 // synchronize your internal model with the external world
  int synch();
@@ -406,11 +416,17 @@ public:
                                 double u_end, double v_end, double w_end,
                                 block_pointer block,
                                 setup_pointer settings);
+ int inverse_time_rate_nurbs(std::vector<NURBS_CONTROL_POINT> nurbs_control_points,
+                             unsigned int nurbs_order,
+                             block_pointer block,
+                             setup_pointer settings);
  int move_endpoint_and_flush(setup_pointer, double, double);
  int parse_line(char *line, block_pointer block,
                       setup_pointer settings);
  int precedence(int an_operator);
  int _read(const char *command);
+ long file_tell();
+ void readahead_sync();
  int read_a(char *line, int *counter, block_pointer block,
                   double *parameters);
  int read_atan(char *line, int *counter, double *double_ptr,
@@ -97,6 +97,7 @@ include an option for suppressing superfluous commands.
 #include "rs274ngc_return.hh"
 #include "interp_internal.hh"	// interpreter private definitions
 #include "interp_queue.hh"
+#include "interp_readahead.hh"
 #include "rs274ngc_interp.hh"
 #include <wordexp.h>
 #include "units.h"
@@ -151,6 +152,12 @@ Interp::Interp()
     // tacked onto it, so make sure this is done exactly once
     _setup.pythis = new bp::object(boost::cref(*this));
 
+    // tuples are immutable, so remap handlers which take only 'self'
+    // can all share one argument tuple
+    bp::list selflist;
+    selflist.append(*_setup.pythis);
+    _setup.pyselfargs = new bp::object(bp::tuple(selflist));
+
     // alias to 'interpreter.this' for the sake of ';py, .... ' comments
     // besides 'this', eventually use proper instance names to handle
 	// several instances
@@ -256,6 +263,9 @@ int Interp::close()
     _setup.file_pointer = NULL;
     _setup.percent_flag = false;
   }
+  _setup.readahead_pending = false;
+  if (_setup.readahead)
+    _setup.readahead->stop();
   reset();
 
   return INTERP_OK;
@@ -918,6 +928,18 @@ int Interp::init()
           inifile.Find(&_setup.parameter_g73_peck_clearance, "PARAMETER_G73_PECK_CLEARANCE", "RS274NGC");
           inifile.Find(&_setup.parameter_g83_peck_clearance, "PARAMETER_G83_PECK_CLEARANCE", "RS274NGC");
 
+          // lines to read ahead of the interpreter on a worker thread,
+          // 0 (the default) reads them one at a time as before
+          int readahead_lines = 0;
+          inifile.Find(&readahead_lines, "READAHEAD_LINES", "RS274NGC");
+          if (_setup.readahead && _setup.readahead->depth() != readahead_lines) {
+              delete _setup.readahead;
+              _setup.readahead = NULL;
+          }
+          if (readahead_lines > 0 && !_setup.readahead)
+              _setup.readahead = new ReadAhead(readahead_lines);
+          _setup.readahead_pending = false;
+
           inifile.Find(&_setup.debugmask, "DEBUG", "EMC");
 
 	  _setup.debugmask |= EMC_DEBUG_UNCONDITIONAL;
@@ -1408,8 +1430,14 @@ int Interp::open(const char *filename) //!< string: the name of the input NC-pro
     }
   CHKS((_setup.file_pointer != NULL), NCE_A_FILE_IS_ALREADY_OPEN);
   CHKS((strlen(filename) > (LINELEN - 1)), NCE_FILE_NAME_TOO_LONG);
+  // the file may have been edited since the readahead last saw it
+  _setup.readahead_pending = false;
+  if (_setup.readahead)
+    _setup.readahead->stop();
   _setup.file_pointer = fopen(filename, "r");
   CHKS((_setup.file_pointer == NULL), NCE_UNABLE_TO_OPEN_FILE, filename);
+  _setup.run_files.assign(1, filename);
+  _setup.run_external = false;
 
 	Interp::nurbs_reset_global_variables();	// jf 
 
@@ -1626,7 +1654,7 @@ int Interp::_read(const char *command)  //!< may be NULL or a string to read
 
   if(_setup.file_pointer)
   {
-      EXECUTING_BLOCK(_setup).offset = ftell(_setup.file_pointer);
+      EXECUTING_BLOCK(_setup).offset = file_tell();
   }
 
   read_status =
@@ -1705,6 +1733,7 @@ int Interp::unwind_call(int status, const char *file, int line, const char *func
 
 	// When called from Interp::close via Interp::reset, this one is NULL
 	if (!_setup.file_pointer) continue;
+	readahead_sync();
 
 	// some frames may not have a filename and hence a position to seek to
 	// on return, like Python handlers
@@ -1830,19 +1859,32 @@ array. These are the axis offsets, the origin index (5220), and nine
 sets of origin offsets. Any parameter not given a value in the file
 has its value set to zero.
 
+The numbers and values read are remembered, so that save_parameters
+need not write the file again until one of them changes.
+
+The file is read in one go and its lines parsed in place, which is
+several times faster at startup than reading and scanning it a line
+at a time.
+
 */
 int Interp::restore_parameters(const char *filename)   //!< name of parameter file to read  
 {
   FORCE_LC_NUMERIC_C;
   FILE *infile;
-  char line[256];
+  std::string text;             // the whole file
+  char chunk[65536];
+  size_t got;
+  char *line, *end, *eol, *after;
   int variable;
   double value;
   int required;                 // number of next required parameter
   int index;                    // index into _required_parameters
   double *pars;                 // short name for _setup.parameters
   int k;
+  std::vector<int> numbers;     // parameters in the file
+  bool complete = true;         // no required parameter is missing
 
+  _setup.parameter_file.clear();
   // it's OK if the parameter file doesn't exist yet
   // it'll be created in due course with some default values
   if(access(filename, F_OK) == -1)
@@ -1851,47 +1893,122 @@ int Interp::restore_parameters(const char *filename)   //!< name of parameter fi
   infile = fopen(filename, "r");
   CHKS((infile == NULL), _("Unable to open parameter file: '%s'"), filename);
 
+  while ((got = fread(chunk, 1, sizeof(chunk), infile)) > 0)
+    text.append(chunk, got);
+  fclose(infile);
+
   pars = _setup.parameters;
   k = 0;
   index = 0;
   required = _required_parameters[index++];
-  while (feof(infile) == 0) {
-    if (fgets(line, 256, infile) == NULL) {
-      break;
-    }
-    // try for a variable-value match in the file
-    if (sscanf(line, "%d %lf", &variable, &value) == 2) {
-      CHKS(((variable <= 0)
-           || (variable >= RS274NGC_MAX_PARAMETERS)),
-          NCE_PARAMETER_NUMBER_OUT_OF_RANGE);
-      for (; k < RS274NGC_MAX_PARAMETERS; k++) {
-        if (k > variable) {
-          fclose(infile);
-          ERS(NCE_PARAMETER_FILE_OUT_OF_ORDER);
-        } else if (k == variable) {
-          pars[k] = value;
-          if (k == required)
-            required = _required_parameters[index++];
-          k++;
-          break;
-        } else                  // if (k < variable)
-        {
-          if (k == required)
-            required = _required_parameters[index++];
-          pars[k] = 0;
+  for (line = &text[0], end = line + text.size(); line < end; line = eol + 1) {
+    eol = (char *) memchr(line, '\n', end - line);
+    if (eol == NULL)
+      eol = end;
+    *eol = 0;
+    // try for a variable-value match on the line
+    variable = strtol(line, &after, 10);
+    if (after == line)
+      continue;
+    line = after;
+    value = strtod(line, &after);
+    if (after == line)
+      continue;
+    CHKS(((variable <= 0)
+         || (variable >= RS274NGC_MAX_PARAMETERS)),
+        NCE_PARAMETER_NUMBER_OUT_OF_RANGE);
+    for (; k < RS274NGC_MAX_PARAMETERS; k++) {
+      if (k > variable) {
+        ERS(NCE_PARAMETER_FILE_OUT_OF_ORDER);
+      } else if (k == variable) {
+        pars[k] = value;
+        numbers.push_back(k);
+        if (k == required)
+          required = _required_parameters[index++];
+        k++;
+        break;
+      } else                  // if (k < variable)
+      {
+        if (k == required) {
+          required = _required_parameters[index++];
+          complete = false;
         }
+        pars[k] = 0;
       }
     }
   }
-  fclose(infile);
   for (; k < RS274NGC_MAX_PARAMETERS; k++) {
+    if (k == required) {
+      required = _required_parameters[index++];
+      complete = false;
+    }
     pars[k] = 0;
   }
+  // a file that lacks required parameters is written out in full
+  if (complete)
+    remember_parameter_file(filename, numbers, pars);
   return INTERP_OK;
 }
 
 /***********************************************************************/
 
+/*! Interp::remember_parameter_file
+
+Returned Value: none
+
+Side Effects:
+   The _setup.parameter_file fields describe filename as it is now.
+
+Called By:
+   Interp::restore_parameters
+   Interp::save_parameters
+
+Records which parameters filename holds and their values, and
+the file's inode, size and modification time, so that
+parameter_file_current can tell whether it was changed by someone else
+since.
+
+*/
+void Interp::remember_parameter_file(const char *filename,   //!< file just read or written
+                                     std::vector<int> &numbers, //!< parameters it holds
+                                     const double parameters[]) //!< their values
+{
+  _setup.parameter_file.clear();
+  if (stat(filename, &_setup.parameter_file_stat) != 0)
+    return;
+  _setup.parameter_file = filename;
+  _setup.parameter_file_numbers.swap(numbers);
+  _setup.parameter_file_values.clear();
+  for (int k : _setup.parameter_file_numbers)
+    _setup.parameter_file_values.push_back(parameters[k]);
+}
+
+/***********************************************************************/
+
+/*! Interp::parameter_file_current
+
+Returned Value: bool
+   true if filename is the parameter file last read or written and
+   nobody has touched it since.
+
+Called By: Interp::save_parameters
+
+*/
+bool Interp::parameter_file_current(const char *filename)   //!< parameter file
+{
+  struct stat st;
+  const struct stat &was = _setup.parameter_file_stat;
+
+  return !_setup.parameter_file.empty() && _setup.parameter_file == filename
+      && stat(filename, &st) == 0
+      && st.st_dev == was.st_dev && st.st_ino == was.st_ino
+      && st.st_size == was.st_size
+      && st.st_mtim.tv_sec == was.st_mtim.tv_sec
+      && st.st_mtim.tv_nsec == was.st_mtim.tv_nsec;
+}
+
+/***********************************************************************/
+
 /*! Interp::save_parameters
 
 Returned Value:
@@ -1923,6 +2040,11 @@ e.g.
 If a required parameter is missing from the input file, this does not
 complain, but does write it in the output file.
 
+If the file is the one last read or written here, and nothing else
+changed it since, the parameters it holds are known and it is only
+written when one of their values changed.  Most calls, from synch()
+around every queue buster and at program end, then cost a stat().
+
 */
 int Interp::save_parameters(const char *filename,      //!< name of file to write
                              const double parameters[]) //!< parameters to save   
@@ -1936,57 +2058,70 @@ int Interp::save_parameters(const char *filename,      //!< name of file to writ
   int required;                 // number of next required parameter
   int index;                    // index into _required_parameters
   int k;
-
-  std::string tempfile = std::string(filename) + ".new";
-  outfile = fopen(tempfile.c_str(), "w");
-  CHKS((outfile == NULL), NCE_CANNOT_OPEN_VARIABLE_FILE);
-
-  infile = fopen(filename, "r");
-  if(!infile)
-    infile = fopen("/dev/null", "r");
-
-  k = 0;
-  index = 0;
-  required = _required_parameters[index++];
-  while (feof(infile) == 0) {
-    if (fgets(line, sizeof(line), infile) == NULL) {
-      break;
-    }
-    // try for a variable-value match
-    if (sscanf(line, "%d %lf", &variable, &value) == 2) {
-      CHKS(((variable <= 0)
-           || (variable >= RS274NGC_MAX_PARAMETERS)),
-          NCE_PARAMETER_NUMBER_OUT_OF_RANGE);
-      for (; k < RS274NGC_MAX_PARAMETERS; k++) {
-        if (k > variable) {
+  std::vector<int> numbers;     // parameters to write, in order
+
+  if (parameter_file_current(filename)) {
+    const std::vector<double> &was = _setup.parameter_file_values;
+    numbers = _setup.parameter_file_numbers;
+    size_t n;
+    for (n = 0; n < numbers.size(); n++)
+      if (memcmp(&parameters[numbers[n]], &was[n], sizeof(double)))
+        break;
+    if (n == numbers.size())
+      return INTERP_OK;
+  } else {
+    infile = fopen(filename, "r");
+    if(!infile)
+      infile = fopen("/dev/null", "r");
+
+    k = 0;
+    index = 0;
+    required = _required_parameters[index++];
+    while (feof(infile) == 0) {
+      if (fgets(line, sizeof(line), infile) == NULL) {
+        break;
+      }
+      // try for a variable-value match
+      if (sscanf(line, "%d %lf", &variable, &value) == 2) {
+        if ((variable <= 0) || (variable >= RS274NGC_MAX_PARAMETERS)) {
           fclose(infile);
-          fclose(outfile);
-          ERS(NCE_PARAMETER_FILE_OUT_OF_ORDER);
-        } else if (k == variable) {
-          snprintf(line, sizeof(line), "%d\t%f\n", k, parameters[k]);
-          fputs(line, outfile);
-          if (k == required)
+          ERS(NCE_PARAMETER_NUMBER_OUT_OF_RANGE);
+        }
+        for (; k < RS274NGC_MAX_PARAMETERS; k++) {
+          if (k > variable) {
+            fclose(infile);
+            ERS(NCE_PARAMETER_FILE_OUT_OF_ORDER);
+          } else if (k == variable) {
+            numbers.push_back(k);
+            if (k == required)
+              required = _required_parameters[index++];
+            k++;
+            break;
+          } else if (k == required)       // know (k < variable)
+          {
+            numbers.push_back(k);
             required = _required_parameters[index++];
-          k++;
-          break;
-        } else if (k == required)       // know (k < variable)
-        {
-          snprintf(line, sizeof(line), "%d\t%f\n", k, parameters[k]);
-          fputs(line, outfile);
-          required = _required_parameters[index++];
+          }
         }
       }
     }
-  }
-  fclose(infile);
-  for (; k < RS274NGC_MAX_PARAMETERS; k++) {
-    if (k == required) {
-      snprintf(line, sizeof(line), "%d\t%f\n", k, parameters[k]);
-      fputs(line, outfile);
-      required = _required_parameters[index++];
+    fclose(infile);
+    for (; k < RS274NGC_MAX_PARAMETERS; k++) {
+      if (k == required) {
+        numbers.push_back(k);
+        required = _required_parameters[index++];
+      }
     }
   }
 
+  std::string tempfile = std::string(filename) + ".new";
+  outfile = fopen(tempfile.c_str(), "w");
+  CHKS((outfile == NULL), NCE_CANNOT_OPEN_VARIABLE_FILE);
+  for (int n : numbers) {
+    snprintf(line, sizeof(line), "%d\t%f\n", n, parameters[n]);
+    fputs(line, outfile);
+  }
+
   fflush(outfile);
   fdatasync(fileno(outfile));
   fclose(outfile);
@@ -1997,6 +2132,8 @@ int Interp::save_parameters(const char *filename,      //!< name of file to writ
     perror("link (updating variable file)");
   if(rename(tempfile.c_str(), filename) < 0)
     perror("rename (updating variable file)");
+  else
+    remember_parameter_file(filename, numbers, parameters);
   return INTERP_OK;
 }
 
@@ -2074,6 +2211,87 @@ int Interp::synch()
   return INTERP_OK;
 }
 
+/****************************************************************************/
+
+/*! Interp::state_digest
+
+Returned Value: false if a run from this state should not be cached
+
+Side Effects: none
+
+Called By: the task's program cache, as a run starts
+
+Hashes everything in _setup that the canon calls of a program may
+depend on, apart from the current position: numbered parameters
+(without #5420-#5428), global named parameters, modal codes and
+settings (without the line number they start with), and the active
+tool.  A run is only stored once the next one starts with the same
+digest, so a cached run must leave the interpreter as it found it.
+
+*/
+
+static void fnv1a(unsigned long long *h, const void *data, size_t size)
+{
+    const unsigned char *p = (const unsigned char *) data;
+    while (size--) {
+        *h ^= *p++;
+        *h *= 1099511628211ULL;
+    }
+}
+
+bool Interp::state_digest(unsigned long long *digest)
+{
+    unsigned long long h = 14695981039346656037ULL;
+
+    if (_setup.run_external)
+        return false;
+    for (int n = 0; n < RS274NGC_MAX_PARAMETERS; n++) {
+        if (n >= 5420 && n <= 5428)
+            continue;
+        fnv1a(&h, &_setup.parameters[n], sizeof(double));
+    }
+    for (auto &np : _setup.sub_context[0].named_params) {
+        fnv1a(&h, np.first, strlen(np.first) + 1);
+        fnv1a(&h, &np.second.attr, sizeof(np.second.attr));
+        if (!(np.second.attr & PA_USE_LOOKUP))
+            fnv1a(&h, &np.second.value, sizeof(np.second.value));
+    }
+    fnv1a(&h, &_setup.active_g_codes[1], sizeof(_setup.active_g_codes) - sizeof(int));
+    fnv1a(&h, &_setup.active_m_codes[1], sizeof(_setup.active_m_codes) - sizeof(int));
+    fnv1a(&h, &_setup.active_settings[1], sizeof(_setup.active_settings) - sizeof(double));
+    fnv1a(&h, &_setup.current_pocket, sizeof(_setup.current_pocket));
+    fnv1a(&h, &_setup.selected_pocket, sizeof(_setup.selected_pocket));
+    fnv1a(&h, &_setup.tool_offset, sizeof(_setup.tool_offset));
+    fnv1a(&h, &_setup.tool_table[0], sizeof(_setup.tool_table[0]));
+    *digest = h;
+    return true;
+}
+
+/*! Interp::run_dependencies
+
+Returned Value: false if the run since open() read something other
+than NC code files (HAL pins, Python)
+
+Side Effects: none
+
+Called By: the task's program cache
+
+Lists the NC code files opened since open(), the program first.
+
+*/
+
+bool Interp::run_dependencies(std::vector<std::string> &files)
+{
+    if (_setup.run_external)
+        return false;
+    files.clear();
+    for (auto &f : _setup.run_files) {
+        if (std::find(files.begin(), files.end(), f) == files.end())
+            files.push_back(f);
+    }
+    return true;
+}
+
 /***********************************************************************/
 /***********************************************************************/
 
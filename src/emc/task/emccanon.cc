@@ -1376,6 +1376,162 @@ biarc(int lineno, double p0x, double p0y, double tsx, double tsy,
 	return 1;
 }
 
+/* A point of a NURBS in homogeneous coordinates (w * x, w * y, w) */
+struct nurbs_hpoint {
+	double x, y, w;
+};
+
+static nurbs_hpoint nurbs_lerp(const nurbs_hpoint &p0, const nurbs_hpoint &p1, double t)
+{
+	return { p0.x + t * (p1.x - p0.x), p0.y + t * (p1.y - p0.y),
+		 p0.w + t * (p1.w - p0.w) };
+}
+
+/* Split a G5 NURBS of order 2 to 4 into one rational Bezier span per knot
+   interval, by inserting every inner knot until it has full multiplicity
+   (The NURBS Book, A5.6), and raise each span to a cubic.  Returns four
+   homogeneous control points per span. */
+static std::vector<nurbs_hpoint>
+nurbs_G5_cubic_spans(const std::vector<NURBS_CONTROL_POINT> &nurbs_control_points,
+		     unsigned int nurbs_order)
+{
+	int n = nurbs_control_points.size() - 1;
+	int p = nurbs_order - 1;
+	int m = n + p + 1;		// index of the last knot
+	std::vector<unsigned int> U = nurbs_G5_knot_vector_creator(n, nurbs_order);
+	std::vector<nurbs_hpoint> Pw, Q, Qnext(p + 1), spans;
+	std::vector<double> alphas(p + 1);
+
+	for (const auto &cp : nurbs_control_points)
+		Pw.push_back({ cp.NURBS_X * cp.NURBS_W, cp.NURBS_Y * cp.NURBS_W, cp.NURBS_W });
+	Q.assign(Pw.begin(), Pw.begin() + p + 1);
+
+	int a = p, b = p + 1;
+	while (b < m) {
+		int i = b;
+		while (b < m && U[b + 1] == U[b])
+			b++;
+		int mult = b - i + 1;
+		int r = p - mult;
+		if (r > 0) {
+			double numer = U[b] - U[a];
+			for (int j = p; j > mult; j--)
+				alphas[j - mult - 1] = numer / (U[a + j] - U[a]);
+			for (int j = 1; j <= r; j++) {
+				int save = r - j, s = mult + j;
+				for (int k = p; k >= s; k--)
+					Q[k] = nurbs_lerp(Q[k - 1], Q[k], alphas[k - s]);
+				if (b < m)
+					Qnext[save] = Q[p];
+			}
+		}
+		switch (p) {
+		case 1:
+			spans.insert(spans.end(), { Q[0], nurbs_lerp(Q[0], Q[1], 1.0 / 3),
+				     nurbs_lerp(Q[0], Q[1], 2.0 / 3), Q[1] });
+			break;
+		case 2:
+			spans.insert(spans.end(), { Q[0], nurbs_lerp(Q[0], Q[1], 2.0 / 3),
+				     nurbs_lerp(Q[2], Q[1], 2.0 / 3), Q[2] });
+			break;
+		default:
+			spans.insert(spans.end(), Q.begin(), Q.end());
+			break;
+		}
+		if (b < m) {
+			for (int j = std::max(r, 0); j <= p; j++)
+				Qnext[j] = Pw[b - p + j];
+			Q = Qnext;
+			a = b;
+			b++;
+		}
+	}
+	return spans;
+}
+
+/* Send one span from nurbs_G5_cubic_spans() to motion as a single spline
+   segment.  The first control point is the current position; the others
+   are in program coordinates of the active plane, and the third axis and
+   ABC / UVW stay where they are.  All spans of a curve run at the same
+   feed: for G93 the interpreter sets it from the length of the curve. */
+static void spline_feed(int line_number, const nurbs_hpoint *q)
+{
+	CANON_POSITION p = unoffset_and_unrotate_pos(canon.endPoint);
+	to_prog(p);
+
+	CANON_POSITION pts[3];
+	double weight[4];
+	double dist = 0;
+	weight[0] = q[0].w;
+	for (int i = 1; i < 4; i++) {
+		double x = q[i].x / q[i].w, y = q[i].y / q[i].w;
+		CANON_POSITION pt = p;
+		switch (canon.activePlane) {
+		case CANON_PLANE::YZ:
+			pt.y = x;
+			pt.z = y;
+			break;
+		case CANON_PLANE::XZ:
+			pt.z = x;
+			pt.x = y;
+			break;
+		default:
+			pt.x = x;
+			pt.y = y;
+			break;
+		}
+		from_prog(pt);
+		rotate_and_offset(pt);
+		pts[i - 1] = pt;
+		weight[i] = q[i].w;
+		dist = std::max(dist, mag(pt.xyz() - canon.endPoint.xyz()));
+	}
+	if (dist < getMinLinearDisplacement()) {
+		return;
+	}
+
+	// Only the axes of the plane move, and both X and Y when rotated
+	int axis1 = 0, axis2 = 1;
+	if (canon.activePlane == CANON_PLANE::YZ) {
+		axis1 = 1;
+		axis2 = 2;
+	} else if (canon.activePlane == CANON_PLANE::XZ) {
+		axis2 = 2;
+	}
+	double v_max = std::min(FROM_EXT_LEN(emcAxisGetMaxVelocity(axis1)),
+				FROM_EXT_LEN(emcAxisGetMaxVelocity(axis2)));
+	double a_max = std::min(FROM_EXT_LEN(emcAxisGetMaxAcceleration(axis1)),
+				FROM_EXT_LEN(emcAxisGetMaxAcceleration(axis2)));
+	if (canon.xy_rotation && canon.activePlane != CANON_PLANE::XY) {
+		int axis3 = canon.activePlane == CANON_PLANE::YZ ? 0 : 1;
+		if (axis_valid(axis3)) {
+			v_max = std::min(v_max, FROM_EXT_LEN(emcAxisGetMaxVelocity(axis3)));
+			a_max = std::min(a_max, FROM_EXT_LEN(emcAxisGetMaxAcceleration(axis3)));
+		}
+	}
+	double vel = std::min(canon.linearFeedRate, v_max);
+
+	auto splineMoveMsg = std::make_unique<EMC_TRAJ_SPLINE_MOVE>();
+	splineMoveMsg->end = to_ext_pose(pts[2]);
+	splineMoveMsg->control1 = to_ext_len(pts[0].xyz());
+	splineMoveMsg->control2 = to_ext_len(pts[1].xyz());
+	for (int i = 0; i < 4; i++)
+		splineMoveMsg->weight[i] = weight[i];
+	splineMoveMsg->type = EMC_MOTION_TYPE_ARC;
+	// The TP lowers the velocity further for the curvature
+	splineMoveMsg->vel = toExtVel(vel);
+	splineMoveMsg->ini_maxvel = toExtVel(v_max);
+	splineMoveMsg->acc = toExtAcc(a_max);
+	splineMoveMsg->feed_mode = canon.feed_mode;
+
+	canon.cartesian_move = 1;
+	if (vel && a_max) {
+		interp_list.set_line_number(line_number);
+		tag_and_send(std::move(splineMoveMsg), _tag);
+	}
+	canonUpdateEndPoint(pts[2]);
+}
+
 /* Canon calls */
 
 //-----------------------------------------------------------------------------------------------------------------------------------------
@@ -1387,6 +1543,16 @@ void NURBS_G5_FEED(int lineno,
 	flush_segments();
 
 	unsigned int n = nurbs_control_points.size() - 1;
+
+	// Up to cubics, each knot span runs as one spline segment in the TP
+	if (nurbs_order >= 2 && nurbs_order <= 4 && n + 1 >= nurbs_order) {
+		std::vector<nurbs_hpoint> spans =
+		    nurbs_G5_cubic_spans(nurbs_control_points, nurbs_order);
+		for (size_t i = 0; i + 4 <= spans.size(); i += 4)
+			spline_feed(lineno, &spans[i]);
+		return;
+	}
+
 	double umax = n - nurbs_order + 2;
 	unsigned int div = nurbs_control_points.size() * 4;
 
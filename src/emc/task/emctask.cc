@@ -34,6 +34,7 @@
 #include "task.hh"		// emcTaskCommand etc
 #include "taskclass.hh"
 #include "motion.h"
+#include "programcache.hh"
 #include <rtapi_string.h>
 
 #define USER_DEFINED_FUNCTION_MAX_DIRS 5
@@ -237,6 +238,7 @@ int emcTaskAbort()
     // clear out the pending command
     emcTaskCommand = 0;
     interp_list.clear();
+    program_cache.stop();
 
     // clear out the interpreter state
     emcStatus->task.interpState = EMC_TASK_INTERP::IDLE;
@@ -547,6 +549,7 @@ int emcTaskPlanOpen(const char *file)
 	emcStatus->task.readLine = 0;
     }
 
+    program_cache.stop();
     int retval = interp.open(file);
     if (retval > INTERP_MIN_ERROR) {
 	print_interp_error(retval);
@@ -629,6 +632,7 @@ int emcTaskPlanExecute(const char *command, int line_number)
 
 int emcTaskPlanClose()
 {
+    program_cache.stop();
     int retval = interp.close();
     if (retval > INTERP_MIN_ERROR) {
 	print_interp_error(retval);
@@ -670,6 +674,16 @@ int emcTaskPlanLevel()
     return retval;
 }
 
+int emcTaskPlanStateDigest(unsigned long long *digest)
+{
+    return interp.state_digest(digest) ? 0 : -1;
+}
+
+int emcTaskPlanDependencies(std::vector<std::string> &files)
+{
+    return interp.run_dependencies(files) ? 0 : -1;
+}
+
 int emcTaskPlanCommand(char *cmd)
 {
     char buf[LINELEN];
@@ -704,6 +718,7 @@ int emcTaskUpdate(EMC_TASK_STAT * stat)
     }
     // currentLine set in main
     // readLine set in main
+    stat->readaheadFill = interp.readahead_fill();
 
     char buf[LINELEN];
     rtapi_strxcpy(stat->file, interp.file(buf, LINELEN));
@@ -85,6 +85,7 @@ fpu_control_t __fpu_control = _FPU_IEEE & ~(_FPU_MASK_IM | _FPU_MASK_ZM | _FPU_M
 #include "taskclass.hh"
 #include "motion.h"             // EMCMOT_ORIENT_*
 #include "inihal.hh"
+#include "programcache.hh"
 
 static emcmot_config_t emcmotConfig;
 
@@ -381,6 +382,7 @@ static EMC_TRAJ_SET_VELOCITY *emcTrajSetVelocityMsg;
 static EMC_TRAJ_SET_ACCELERATION *emcTrajSetAccelerationMsg;
 static EMC_TRAJ_LINEAR_MOVE *emcTrajLinearMoveMsg;
 static EMC_TRAJ_CIRCULAR_MOVE *emcTrajCircularMoveMsg;
+static EMC_TRAJ_SPLINE_MOVE *emcTrajSplineMoveMsg;
 static EMC_TRAJ_DELAY *emcTrajDelayMsg;
 static EMC_TRAJ_SET_TERM_COND *emcTrajSetTermCondMsg;
 static EMC_TRAJ_SET_SPINDLESYNC *emcTrajSetSpindlesyncMsg;
@@ -474,6 +476,9 @@ static int checkInterpList(NML_INTERP_LIST * il, EMC_STAT * stat)
 	case EMC_TRAJ_CIRCULAR_MOVE_TYPE:
 	    break;
 
+	case EMC_TRAJ_SPLINE_MOVE_TYPE:
+	    break;
+
 	default:
 	    break;
 	}
@@ -483,11 +488,135 @@ static int checkInterpList(NML_INTERP_LIST * il, EMC_STAT * stat)
 }
 extern int emcTaskMopup();
 
+// messages replayed so far in this run
+static int program_cache_replayed;
+
+// the state a run's canon output depends on, other than the NC files
+static int programCacheKey(unsigned long long *key)
+{
+    unsigned long long h = PROGRAM_CACHE_HASH_INIT, digest;
+    CANON_TOOL_TABLE tdata;
+
+    if (emcTaskPlanStateDigest(&digest) != 0)
+	return -1;
+    program_cache_hash(&h, &digest, sizeof(digest));
+    for (int idx = 0; idx <= tooldata_last_index_get(); idx++) {
+	if (tooldata_get(&tdata, idx) != IDX_OK)
+	    break;
+	program_cache_hash(&h, &tdata, sizeof(tdata));
+    }
+    program_cache_hash(&h, &emcStatus->motion.traj.position, sizeof(EmcPose));
+    program_cache_hash(&h, &emcStatus->motion.traj.maxVelocity, sizeof(double));
+    for (int axis = 0; axis < EMCMOT_MAX_AXIS; axis++) {
+	double v = emcAxisGetMaxVelocity(axis);
+	double a = emcAxisGetMaxAcceleration(axis);
+	program_cache_hash(&h, &v, sizeof(v));
+	program_cache_hash(&h, &a, sizeof(a));
+    }
+    program_cache_hash(&h, &emcStatus->task.block_delete_state, sizeof(bool));
+    program_cache_hash(&h, &emcStatus->task.optional_stop_state, sizeof(bool));
+    *key = h;
+    return 0;
+}
+
+static void programCacheRecord(int line, const NMLmsg *msg)
+{
+    program_cache.record(line, msg);
+}
+
+// the recorded run reached its end.  The interpreter and canon are
+// resynched after it, so whether it left them as it found them shows
+// when the next run starts: program_cache.start() stores it then.
+static void programCacheFinish(void)
+{
+    std::vector<std::string> files;
+
+    if (emcTaskPlanDependencies(files) == 0) {
+	program_cache.finish(files);
+    } else {
+	program_cache.stop();
+    }
+}
+
+// put the next stored messages on the interp list, as readahead_reading()
+// would have after interpreting their lines
+static void programCacheReplay(void)
+{
+    int line;
+
+    while (interp_list.len() <= emc_task_interp_max_len) {
+	auto msg = program_cache.next(&line);
+	if (!msg) {
+	    // as if the interpreter hit M2
+	    emcStatus->task.interpState = EMC_TASK_INTERP::WAITING;
+	    return;
+	}
+	emcStatus->task.readLine = line;
+	interp_list.set_line_number(line);
+	interp_list.append(std::move(msg));
+	program_cache_replayed++;
+    }
+}
+
+// Stepping needs the interpreter to go line by line, so stop replaying:
+// interpret the lines replayed so far, dropping the messages they make
+// (the replayed ones are on the interp list already), and go on from
+// there.  Cached runs don't wait on the machine, so the interpreter
+// makes the same messages again.
+static int programCacheHandOver(void)
+{
+    NML_INTERP_LIST replayed;
+    int skip = program_cache_replayed;
+    int retval = 0;
+
+    program_cache.stop();
+    std::swap(replayed, interp_list);
+    while (skip > 0 && retval == 0) {
+	retval = emcTaskPlanRead();
+	if (retval == INTERP_OK) {
+	    retval = emcTaskPlanExecute(0);
+	}
+	for (; skip > 0 && interp_list.len() > 0; skip--) {
+	    interp_list.get();
+	}
+    }
+    // anything the last line made beyond the replayed messages is new
+    while (interp_list.len() > 0) {
+	auto msg = interp_list.get();
+	replayed.set_line_number(interp_list.get_line_number());
+	replayed.append(std::move(msg));
+    }
+    std::swap(replayed, interp_list);
+    emcStatus->task.readLine = emcTaskPlanLine();
+    if (skip > 0)
+	return -1;
+    if (retval != 0) {
+	// the last replayed line ended the program
+	emcStatus->task.interpState = EMC_TASK_INTERP::WAITING;
+    }
+    return 0;
+}
+
 void readahead_reading(void)
 {
     int readRetval;
     int execRetval;
 
+		if (program_cache.replaying()) {
+		    if (!stepping) {
+			programCacheReplay();
+			return;
+		    }
+		    if (programCacheHandOver() != 0) {
+			emcStatus->task.interpState =
+			    EMC_TASK_INTERP::WAITING;
+			interp_list.clear();
+			emcAbortCleanup(EMC_ABORT_INTERPRETER_ERROR,
+					"interpreter error");
+		    }
+		    if (emcStatus->task.interpState != EMC_TASK_INTERP::READING)
+			return;
+		}
 		if (interp_list.len() <= emc_task_interp_max_len) {
                     int count = 0;
 interpret_again:
@@ -500,6 +629,8 @@ interpret_again:
 			    emcTaskPlanClearWait();
 			 }
 		    } else {
+			if (program_cache.recording() && stepping)
+			    program_cache.stop();
 			readRetval = emcTaskPlanRead();
 			/*! \todo MGS FIXME
 			   This if() actually evaluates to if (readRetval != INTERP_OK)...
@@ -517,6 +648,12 @@ interpret_again:
 			       (N.B. Watch for negative error codes.) */
 			    emcStatus->task.interpState =
 				EMC_TASK_INTERP::WAITING;
+			    if (readRetval == INTERP_ENDFILE
+				    || readRetval == INTERP_EXIT) {
+				programCacheFinish();
+			    } else {
+				program_cache.stop();
+			    }
 			} else {
 			    // got a good line
 			    // record the line number and command
@@ -525,7 +662,10 @@ interpret_again:
 			    emcTaskPlanCommand((char *) &emcStatus->task.
 					       command);
 			    // and execute it
+			    interp_list.set_recorder(program_cache.recording() ?
+						     programCacheRecord : NULL);
 			    execRetval = emcTaskPlanExecute(0);
+			    interp_list.set_recorder(NULL);
 			    // line number may need update after
 			    // returns from subprograms in external
 			    // files
@@ -534,13 +674,17 @@ interpret_again:
 				emcStatus->task.interpState =
 				    EMC_TASK_INTERP::WAITING;
 				interp_list.clear();
+				program_cache.stop();
 				emcAbortCleanup(EMC_ABORT_INTERPRETER_ERROR,
 						"interpreter error"); 
 			    } else if (execRetval == -1
 				    || execRetval == INTERP_EXIT ) {
 				emcStatus->task.interpState =
 				    EMC_TASK_INTERP::WAITING;
+				programCacheFinish();
 			    } else if (execRetval == INTERP_EXECUTE_FINISH) {
+				// depends on the machine, can't be cached
+				program_cache.stop();
 				// INTERP_EXECUTE_FINISH signifies
 				// that no more reading should be done until
 				// everything
@@ -555,6 +699,7 @@ interpret_again:
 				    EMC_TASK_INTERP::WAITING;
                                 emcStatus->task.motionLine = 0;
                                 emcStatus->task.readLine = 0;
+				programCacheFinish();
 			    } else {
 
 				// executed a good line
@@ -1515,6 +1660,7 @@ static EMC_TASK_EXEC emcTaskCheckPreconditions(NMLmsg * cmd)
 
     case EMC_TRAJ_LINEAR_MOVE_TYPE:
     case EMC_TRAJ_CIRCULAR_MOVE_TYPE:
+    case EMC_TRAJ_SPLINE_MOVE_TYPE:
     case EMC_TRAJ_SET_VELOCITY_TYPE:
     case EMC_TRAJ_SET_ACCELERATION_TYPE:
     case EMC_TRAJ_SET_TERM_COND_TYPE:
@@ -1833,6 +1979,17 @@ static int emcTaskIssueCommand(NMLmsg * cmd)
                 emcTrajCircularMoveMsg->acc);
 	break;
 
+    case EMC_TRAJ_SPLINE_MOVE_TYPE:
+	emcTrajUpdateTag(((EMC_TRAJ_SPLINE_MOVE *) cmd)->tag);
+	emcTrajSplineMoveMsg = (EMC_TRAJ_SPLINE_MOVE *) cmd;
+        retval = emcTrajSplineMove(emcTrajSplineMoveMsg->end,
+                emcTrajSplineMoveMsg->control1, emcTrajSplineMoveMsg->control2,
+                emcTrajSplineMoveMsg->weight, emcTrajSplineMoveMsg->type,
+                emcTrajSplineMoveMsg->vel,
+                emcTrajSplineMoveMsg->ini_maxvel,
+                emcTrajSplineMoveMsg->acc);
+	break;
+
     case EMC_TRAJ_PAUSE_TYPE:
 	emcStatus->task.task_paused = 1;
 	retval = emcTrajPause();
@@ -2314,10 +2471,20 @@ static int emcTaskIssueCommand(NMLmsg * cmd)
         }
 	stepping = 0;
 	steppingWait = 0;
+	run_msg = (EMC_TASK_PLAN_RUN *) cmd;
 	if (!taskplanopen && emcStatus->task.file[0] != 0) {
 	    emcTaskPlanOpen(emcStatus->task.file);
 	}
-	run_msg = (EMC_TASK_PLAN_RUN *) cmd;
+	// a run from the top of a program nothing has been read from yet
+	// may replay or record canon output
+	if (taskplanopen && run_msg->line == 0 && program_cache.enabled()
+		&& emcTaskPlanLine() == 0 && emcTaskPlanLevel() == 0) {
+	    unsigned long long key;
+	    if (programCacheKey(&key) == 0) {
+		program_cache.start(emcStatus->task.file, key);
+		program_cache_replayed = 0;
+	    }
+	}
 	programStartLine = run_msg->line;
 	emcStatus->task.interpState = EMC_TASK_INTERP::READING;
 	emcStatus->task.task_paused = 0;
@@ -2446,6 +2613,7 @@ static EMC_TASK_EXEC emcTaskCheckPostconditions(NMLmsg * cmd)
 
     case EMC_TRAJ_LINEAR_MOVE_TYPE:
     case EMC_TRAJ_CIRCULAR_MOVE_TYPE:
+    case EMC_TRAJ_SPLINE_MOVE_TYPE:
     case EMC_TRAJ_SET_VELOCITY_TYPE:
     case EMC_TRAJ_SET_ACCELERATION_TYPE:
     case EMC_TRAJ_SET_TERM_COND_TYPE:
@@ -3260,6 +3428,11 @@ static int iniLoad(const char *filename)
 	max_mdi_queued_commands = atoi(*inistring);
     }
 
+    // where to keep the canon output of programs for replaying
+    if ((inistring = inifile.Find("PROGRAM_CACHE", "TASK"))) {
+	program_cache.set_directory(*inistring);
+    }
+
     // close it
     inifile.Close();
 
@@ -0,0 +1,247 @@
+/********************************************************************
+* Description: programcache.cc
+*   Stores the canon messages a program run puts on the interp list,
+*   and replays them on the next run of the unchanged program from the
+*   same state instead of interpreting it again.
+*
+*   A run is stored only if it went from the first line to the end
+*   without waiting on the machine (INTERP_EXECUTE_FINISH), without
+*   reading HAL pins or calling Python, and the next run of the program
+*   starts from the state it started from, which a replay would leave
+*   unchanged.  The cache file records the key of the starting state
+*   and a hash of every NC file the run opened; if any of them differ
+*   on the next run, it is interpreted (and recorded) again.
+*
+* License: GPL Version 2
+* System: Linux
+*
+* Copyright (c) 2026 All rights reserved.
+*
+********************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "nmlmsg.hh"
+#include "rcs_print.hh"
+#include "emcglb.h"
+#include "programcache.hh"
+
+ProgramCache program_cache;
+
+#define CACHE_MAGIC "LCNCCAN1"
+// stop recording runs that would make a bigger file than this
+#define CACHE_MAX_BYTES (256UL << 20)
+
+struct record_header {
+    int line;
+    int size;
+};
+
+void program_cache_hash(unsigned long long *h, const void *data, size_t size)
+{
+    const unsigned char *p = (const unsigned char *) data;
+    while (size--) {
+        *h ^= *p++;
+        *h *= 1099511628211ULL;
+    }
+}
+
+static bool hash_file(const char *name, unsigned long long *h)
+{
+    char buf[65536];
+    size_t n;
+    FILE *f = fopen(name, "r");
+
+    if (!f)
+        return false;
+    *h = PROGRAM_CACHE_HASH_INIT;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+        program_cache_hash(h, buf, n);
+    bool ok = !ferror(f);
+    fclose(f);
+    return ok;
+}
+
+template <class T> static bool get(FILE *f, T *v)
+{
+    return fread(v, sizeof(*v), 1, f) == 1;
+}
+
+static void put(std::vector<char> &b, const void *data, size_t size)
+{
+    b.insert(b.end(), (const char *) data, (const char *) data + size);
+}
+
+template <class T> static void put(std::vector<char> &b, const T &v)
+{
+    put(b, &v, sizeof(v));
+}
+
+void ProgramCache::set_directory(const char *d)
+{
+    stop();
+    pending.clear();
+    dir = d ? d : "";
+}
+
+// write the finished run out, now that it is known to be replayable
+void ProgramCache::store()
+{
+    std::string tmp = pending_path + ".tmp";
+    FILE *f = fopen(tmp.c_str(), "w");
+    bool ok = f && fwrite(pending.data(), 1, pending.size(), f) == pending.size();
+
+    if (f && fclose(f))
+        ok = false;
+    if (ok && rename(tmp.c_str(), pending_path.c_str()) == 0) {
+        if (emc_debug & EMC_DEBUG_INTERP)
+            rcs_print("program cache: stored %s (%zu bytes)\n", pending_path.c_str(),
+                      pending.size());
+    } else {
+        rcs_print("program cache: can't write %s\n", pending_path.c_str());
+        unlink(tmp.c_str());
+    }
+}
+
+bool ProgramCache::start(const char *file, unsigned long long k)
+{
+    char name[32], magic[8];
+    unsigned long long h = PROGRAM_CACHE_HASH_INIT, stored_key, bytes;
+    unsigned nfiles;
+    bool hit = false;
+    FILE *f;
+
+    stop();
+    if (!enabled())
+        return false;
+    program_cache_hash(&h, file, strlen(file));
+    snprintf(name, sizeof(name), "/%016llx.canon", h);
+    path = dir + name;
+    key = k;
+
+    // the last run of this program is worth keeping if this one starts
+    // from the same state
+    if (!pending.empty()) {
+        if (pending_path == path && pending_key == key)
+            store();
+        pending.clear();
+    }
+
+    f = fopen(path.c_str(), "r");
+    if (f && get(f, &magic) && !memcmp(magic, CACHE_MAGIC, sizeof(magic))
+            && get(f, &stored_key) && stored_key == key && get(f, &nfiles)) {
+        hit = true;
+        for (unsigned n = 0; hit && n < nfiles; n++) {
+            unsigned len;
+            unsigned long long stored, now;
+            hit = get(f, &len) && len < 4096;
+            std::string dep(hit ? len : 0, '\0');
+            hit = hit && fread(&dep[0], 1, len, f) == len && get(f, &stored)
+                && (n > 0 || dep == file)
+                && hash_file(dep.c_str(), &now) && now == stored;
+        }
+        hit = hit && get(f, &bytes) && bytes <= CACHE_MAX_BYTES;
+        if (hit) {
+            records.resize(bytes);
+            hit = fread(records.data(), 1, bytes, f) == bytes;
+        }
+        // every record has to fit, so next() need not check
+        for (pos = 0; hit && pos < records.size(); ) {
+            record_header r;
+            hit = records.size() - pos >= sizeof(r);
+            if (hit) {
+                memcpy(&r, &records[pos], sizeof(r));
+                hit = r.size >= (int) sizeof(NMLmsg)
+                    && records.size() - pos - sizeof(r) >= (size_t) r.size;
+                pos += sizeof(r) + r.size;
+            }
+        }
+    }
+    if (f)
+        fclose(f);
+
+    pos = 0;
+    if (hit) {
+        if (emc_debug & EMC_DEBUG_INTERP)
+            rcs_print("program cache: replaying %s from %s\n", file, path.c_str());
+        playing = true;
+    } else {
+        records.clear();
+        taping = hash_file(file, &file_hash);
+    }
+    return playing;
+}
+
+std::unique_ptr<NMLmsg> ProgramCache::next(int *line)
+{
+    record_header r;
+
+    if (!playing || pos >= records.size()) {
+        stop();
+        return nullptr;
+    }
+    memcpy(&r, &records[pos], sizeof(r));
+    // NMLmsg has no virtual members, so a copy of the bytes is the
+    // message, whatever its derived type
+    NMLmsg *msg = (NMLmsg *) ::operator new(r.size);
+    memcpy((void *) msg, &records[pos + sizeof(r)], r.size);
+    pos += sizeof(r) + r.size;
+    *line = r.line;
+    return std::unique_ptr<NMLmsg>(msg);
+}
+
+void ProgramCache::record(int line, const NMLmsg *msg)
+{
+    record_header r = { line, (int) msg->size };
+
+    if (!taping)
+        return;
+    if (records.size() + sizeof(r) + r.size > CACHE_MAX_BYTES) {
+        stop();
+        return;
+    }
+    records.insert(records.end(), (const char *) &r, (const char *) (&r + 1));
+    records.insert(records.end(), (const char *) msg, (const char *) msg + r.size);
+}
+
+void ProgramCache::finish(const std::vector<std::string> &files)
+{
+    unsigned nfiles = files.size();
+    unsigned long long bytes = records.size();
+    bool ok = true;
+
+    if (!taping)
+        return;
+    taping = false;
+    pending.clear();
+    put(pending, CACHE_MAGIC, 8);
+    put(pending, key);
+    put(pending, nfiles);
+    for (auto &dep : files) {
+        unsigned len = dep.size();
+        unsigned long long h = file_hash;
+        // the program itself is hashed as it was when the run started,
+        // in case it was saved again meanwhile
+        ok = ok && (&dep == &files[0] || hash_file(dep.c_str(), &h));
+        put(pending, len);
+        put(pending, dep.data(), len);
+        put(pending, h);
+    }
+    put(pending, bytes);
+    put(pending, records.data(), bytes);
+    if (ok) {
+        pending_path = path;
+        pending_key = key;
+    } else {
+        pending.clear();
+    }
+    records.clear();
+}
+
+void ProgramCache::stop()
+{
+    playing = taping = false;
+    records.clear();
+    pos = 0;
+}
@@ -0,0 +1,72 @@
+/********************************************************************
+* Description: programcache.hh
+*   Stores the canon messages a program run puts on the interp list,
+*   and replays them on the next run of the unchanged program from the
+*   same state instead of interpreting it again.
+*
+* License: GPL Version 2
+* System: Linux
+*
+* Copyright (c) 2026 All rights reserved.
+*
+********************************************************************/
+#ifndef PROGRAMCACHE_HH
+#define PROGRAMCACHE_HH
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class NMLmsg;
+
+// FNV-1a, for building cache keys
+void program_cache_hash(unsigned long long *h, const void *data, size_t size);
+#define PROGRAM_CACHE_HASH_INIT 14695981039346656037ULL
+
+class ProgramCache
+{
+public:
+    // store runs in 'dir'; NULL or "" disables the cache
+    void set_directory(const char *dir);
+    bool enabled() const { return !dir.empty(); }
+
+    // a run of 'file' starts from its first line in the state 'key'
+    // describes.  Returns true if a stored run is to be replayed,
+    // otherwise recording starts.
+    bool start(const char *file, unsigned long long key);
+
+    // the next stored message and the line it came from, or NULL once
+    // the replay is done
+    bool replaying() const { return playing; }
+    std::unique_ptr<NMLmsg> next(int *line);
+
+    // what the interpreter appends to the interp list while recording
+    bool recording() const { return taping; }
+    void record(int line, const NMLmsg *msg);
+
+    // the recorded run ended normally after reading 'files'.  It is
+    // stored when the next run of the program starts in the same state.
+    void finish(const std::vector<std::string> &files);
+
+    // give up replaying or recording
+    void stop();
+
+private:
+    std::string dir;
+    std::string path;           // cache file of the current run
+    unsigned long long key = 0;
+    unsigned long long file_hash = 0; // of the program, as the run began
+    bool playing = false;
+    bool taping = false;
+    std::vector<char> records;  // {int line, int size, message} ...
+    size_t pos = 0;             // next record to replay
+    std::vector<char> pending;  // cache file of the last finished run
+    std::string pending_path;
+    unsigned long long pending_key = 0;
+
+    void store();
+};
+
+extern ProgramCache program_cache;
+
+#endif
@@ -18,6 +18,8 @@
 #include "taskclass.hh"
 #include "emc_nml.hh"
 #include <memory>
+#include <string>
+#include <vector>
 
 extern std::unique_ptr<NMLmsg> emcTaskCommand;
 extern int stepping;
@@ -55,6 +57,8 @@ int emcTaskPlanReset();
 int emcTaskPlanLine();
 int emcTaskPlanLevel();
 int emcTaskPlanCommand(char *cmd);
+int emcTaskPlanStateDigest(unsigned long long *digest);
+int emcTaskPlanDependencies(std::vector<std::string> &files);
 
 int emcTaskUpdate(EMC_TASK_STAT * stat);
 
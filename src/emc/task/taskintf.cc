@@ -1442,6 +1442,48 @@ int emcTrajCircularMove(EmcPose end, PM_CARTESIAN center,
     return usrmotWriteEmcmotCommand(&emcmotCommand);
 }
 
+int emcTrajSplineMove(EmcPose end, PM_CARTESIAN control1,
+		      PM_CARTESIAN control2, const double weight[4], int type,
+		      double vel, double ini_maxvel, double acc)
+{
+#ifdef ISNAN_TRAP
+    if (std::isnan(end.tran.x) || std::isnan(end.tran.y) || std::isnan(end.tran.z) ||
+	std::isnan(end.a) || std::isnan(end.b) || std::isnan(end.c) ||
+	std::isnan(end.u) || std::isnan(end.v) || std::isnan(end.w) ||
+	std::isnan(control1.x) || std::isnan(control1.y) || std::isnan(control1.z) ||
+	std::isnan(control2.x) || std::isnan(control2.y) || std::isnan(control2.z)) {
+	printf("std::isnan error in emcTrajSplineMove()\n");
+	return 0;		// ignore it for now, just don't send it
+    }
+#endif
+
+    emcmotCommand.command = EMCMOT_SET_SPLINE;
+
+    emcmotCommand.pos = end;
+    emcmotCommand.motion_type = type;
+
+    emcmotCommand.control[0].x = control1.x;
+    emcmotCommand.control[0].y = control1.y;
+    emcmotCommand.control[0].z = control1.z;
+
+    emcmotCommand.control[1].x = control2.x;
+    emcmotCommand.control[1].y = control2.y;
+    emcmotCommand.control[1].z = control2.z;
+
+    for (int i = 0; i < 4; i++) {
+	emcmotCommand.weight[i] = weight[i];
+    }
+
+    emcmotCommand.id = TrajConfig.MotionId;
+    emcmotCommand.tag = localEmcTrajTag;
+
+    emcmotCommand.vel = vel;
+    emcmotCommand.ini_maxvel = ini_maxvel;
+    emcmotCommand.acc = acc;
+
+    return usrmotWriteEmcmotCommand(&emcmotCommand);
+}
+
 int emcTrajClearProbeTrippedFlag()
 {
     emcmotCommand.command = EMCMOT_CLEAR_PROBE_FLAGS;
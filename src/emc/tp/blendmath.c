@@ -1637,13 +1637,17 @@ double pmCartAbsMax(PmCartesian const * const v)
 }
 
 
-PmCircleLimits pmCircleActualMaxVel(PmCircle const * circle,
+/**
+ * Find the maximum velocity along a curve with the given smallest radius of
+ * curvature, and the share of acceleration left for the tangential
+ * direction at that velocity.
+ */
+PmCircleLimits pmCurveActualMaxVel(double eff_radius,
         double v_max,
         double a_max)
 {
     double a_n_max_cutoff = BLEND_ACC_RATIO_NORMAL * a_max;
 
-    double eff_radius = pmCircleEffectiveMinRadius(circle);
     // Find the acceleration necessary to reach the maximum velocity
     double a_n_vmax = pmSq(v_max) / fmax(eff_radius, DOUBLE_FUZZ);
     // Find the maximum velocity that still obeys our desired tangential / total acceleration ratio
@@ -1658,7 +1662,7 @@ PmCircleLimits pmCircleActualMaxVel(PmCircle const * circle,
         acc_ratio_tan = pmSqrt(1.0 - pmSq(a_n_vmax / a_max));
     }
 
-    tp_debug_json_start(pmCircleActualMaxVel);
+    tp_debug_json_start(pmCurveActualMaxVel);
     tp_debug_json_double(eff_radius);
     tp_debug_json_double(v_max);
     tp_debug_json_double(v_max_cutoff);
@@ -1676,6 +1680,16 @@ PmCircleLimits pmCircleActualMaxVel(PmCircle const * circle,
 }
 
 
+PmCircleLimits pmCircleActualMaxVel(PmCircle const * circle,
+        double v_max,
+        double a_max)
+{
+    return pmCurveActualMaxVel(pmCircleEffectiveMinRadius(circle),
+            v_max,
+            a_max);
+}
+
+
 /** @section spiralfuncs Functions to approximate spiral arc length */
 
 /**
@@ -247,6 +247,10 @@ typedef struct {
     double acc_ratio;
 } PmCircleLimits;
 
+PmCircleLimits pmCurveActualMaxVel(double eff_radius,
+        double v_max_nominal,
+        double a_max_nominal);
+
 PmCircleLimits pmCircleActualMaxVel(const PmCircle *circle,
         double v_max_nominal,
         double a_max_nominal);
@@ -0,0 +1,283 @@
+/********************************************************************
+ * Description: spline.c
+ *
+ * Rational cubic Bezier curves with an arc length table, so that the
+ * trajectory planner can run a spline (one span of a G5 / G5.1 / G5.2
+ * NURBS) as a single segment.
+ *
+ * License: GPL Version 2
+ * System: Linux
+ *
+ * Copyright (c) 2026 All rights reserved.
+ *
+ ********************************************************************/
+
+#include "posemath.h"
+#include "spline.h"
+#include "tp_types.h"
+#include "rtapi_math.h"
+
+#include "tp_debug.h"
+
+#define SPLINE_NEWTON_ITERATIONS 4
+// Curvature samples per interval of the arc length table
+#define SPLINE_CURVATURE_SAMPLES 4
+
+/* 5 point Gauss-Legendre rule on [-1, 1] */
+static const double gl_node[5] = {
+    0.0,
+    -0.53846931010568309104, 0.53846931010568309104,
+    -0.90617984593866399280, 0.90617984593866399280
+};
+static const double gl_weight[5] = {
+    0.56888888888888888889,
+    0.47862867049936646804, 0.47862867049936646804,
+    0.23692688505618908751, 0.23692688505618908751
+};
+
+/**
+ * Evaluate the curve and its first two derivatives with respect to the
+ * parameter u. Any of the outputs may be NULL.
+ *
+ * The curve is A(u) / W(u), where A and W are the Bernstein sums of the
+ * weighted control points w_i * P_i and of the weights. The derivatives
+ * follow from differentiating A = W * C twice.
+ */
+static void splineEval(Spline const * const spline, double u,
+        PmCartesian * const pt, PmCartesian * const d1, PmCartesian * const d2)
+{
+    double t = 1.0 - u;
+    PmCartesian Q[4];
+    int i;
+
+    for (i = 0; i < 4; ++i) {
+        pmCartScalMult(&spline->P[i], spline->w[i], &Q[i]);
+    }
+
+    double b[4] = {t * t * t, 3.0 * u * t * t, 3.0 * u * u * t, u * u * u};
+    PmCartesian A = {0.0, 0.0, 0.0}, C, tmp;
+    double W = 0.0;
+    for (i = 0; i < 4; ++i) {
+        pmCartScalMult(&Q[i], b[i], &tmp);
+        pmCartCartAddEq(&A, &tmp);
+        W += b[i] * spline->w[i];
+    }
+    pmCartScalMult(&A, 1.0 / W, &C);
+    if (pt) {
+        *pt = C;
+    }
+    if (!d1 && !d2) {
+        return;
+    }
+
+    double b1[3] = {3.0 * t * t, 6.0 * u * t, 3.0 * u * u};
+    PmCartesian A1 = {0.0, 0.0, 0.0}, C1;
+    double W1 = 0.0;
+    for (i = 0; i < 3; ++i) {
+        pmCartCartSub(&Q[i + 1], &Q[i], &tmp);
+        pmCartScalMultEq(&tmp, b1[i]);
+        pmCartCartAddEq(&A1, &tmp);
+        W1 += b1[i] * (spline->w[i + 1] - spline->w[i]);
+    }
+    // C' = (A' - W' C) / W
+    pmCartScalMult(&C, W1, &tmp);
+    pmCartCartSub(&A1, &tmp, &C1);
+    pmCartScalMultEq(&C1, 1.0 / W);
+    if (d1) {
+        *d1 = C1;
+    }
+    if (!d2) {
+        return;
+    }
+
+    double b2[2] = {6.0 * t, 6.0 * u};
+    PmCartesian A2 = {0.0, 0.0, 0.0};
+    double W2 = 0.0;
+    for (i = 0; i < 2; ++i) {
+        PmCartesian diff;
+        pmCartCartSub(&Q[i + 2], &Q[i + 1], &diff);
+        pmCartCartSub(&diff, &Q[i + 1], &diff);
+        pmCartCartAdd(&diff, &Q[i], &diff);
+        pmCartScalMultEq(&diff, b2[i]);
+        pmCartCartAddEq(&A2, &diff);
+        W2 += b2[i] * (spline->w[i + 2] - 2.0 * spline->w[i + 1] + spline->w[i]);
+    }
+    // C'' = (A'' - 2 W' C' - W'' C) / W
+    pmCartScalMult(&C1, 2.0 * W1, &tmp);
+    pmCartCartSubEq(&A2, &tmp);
+    pmCartScalMult(&C, W2, &tmp);
+    pmCartCartSubEq(&A2, &tmp);
+    pmCartScalMult(&A2, 1.0 / W, d2);
+}
+
+static double splineSpeed(Spline const * const spline, double u)
+{
+    PmCartesian d1;
+    double speed;
+
+    splineEval(spline, u, NULL, &d1, NULL);
+    pmCartMag(&d1, &speed);
+    return speed;
+}
+
+/**
+ * Arc length of the curve between parameters u0 and u1.
+ */
+static double splineArcLength(Spline const * const spline, double u0, double u1)
+{
+    double half = 0.5 * (u1 - u0);
+    double mid = 0.5 * (u1 + u0);
+    double sum = 0.0;
+    int i;
+
+    for (i = 0; i < 5; ++i) {
+        sum += gl_weight[i] * splineSpeed(spline, mid + half * gl_node[i]);
+    }
+    return sum * half;
+}
+
+int splineInit(Spline * const spline, PmCartesian const * const P,
+        double const * const w)
+{
+    int i;
+
+    for (i = 0; i < 4; ++i) {
+        // Written so that a NaN weight fails too
+        if (!(w[i] > SPLINE_MIN_WEIGHT)) {
+            tp_debug_print("spline weight %d = %g is not positive\n", i, w[i]);
+            return TP_ERR_INVALID;
+        }
+        spline->P[i] = P[i];
+        spline->w[i] = w[i];
+    }
+
+    spline->s[0] = 0.0;
+    for (i = 0; i < SPLINE_TABLE_SIZE; ++i) {
+        spline->s[i + 1] = spline->s[i] + splineArcLength(spline,
+                (double)i / SPLINE_TABLE_SIZE,
+                (double)(i + 1) / SPLINE_TABLE_SIZE);
+    }
+    tp_debug_print("spline length = %g\n", spline->s[SPLINE_TABLE_SIZE]);
+
+    /* The radius of curvature is |C'|^3 / |C' x C''|. Points where the
+     * curve stops (a control point repeated at an end) have no defined
+     * curvature and are skipped. */
+    double min_radius = TP_BIG_NUM;
+    const int samples = SPLINE_TABLE_SIZE * SPLINE_CURVATURE_SAMPLES;
+    for (i = 0; i <= samples; ++i) {
+        PmCartesian d1, d2, cross;
+        double speed, cross_mag;
+
+        splineEval(spline, (double)i / samples, NULL, &d1, &d2);
+        pmCartMag(&d1, &speed);
+        if (speed < TP_POS_EPSILON) {
+            continue;
+        }
+        pmCartCartCross(&d1, &d2, &cross);
+        pmCartMag(&cross, &cross_mag);
+        double speed3 = speed * speed * speed;
+        if (cross_mag * min_radius > speed3) {
+            min_radius = speed3 / cross_mag;
+        }
+    }
+    spline->min_radius = min_radius;
+    tp_debug_print("spline min radius = %g\n", min_radius);
+
+    return TP_ERR_OK;
+}
+
+int splinePoint(Spline const * const spline, double u, PmCartesian * const out)
+{
+    // The ends are the end control points, exactly
+    if (u <= 0.0) {
+        *out = spline->P[0];
+    } else if (u >= 1.0) {
+        *out = spline->P[3];
+    } else {
+        splineEval(spline, u, out, NULL, NULL);
+    }
+    return TP_ERR_OK;
+}
+
+/**
+ * Unit tangent vector in the direction of travel at parameter u.
+ */
+int splineTangent(Spline const * const spline, double u, PmCartesian * const out)
+{
+    PmCartesian d1, d2;
+    double speed;
+
+    u = fmax(fmin(u, 1.0), 0.0);
+    splineEval(spline, u, NULL, &d1, &d2);
+    pmCartMag(&d1, &speed);
+    if (speed > TP_POS_EPSILON) {
+        pmCartScalMult(&d1, 1.0 / speed, out);
+        return TP_ERR_OK;
+    }
+
+    /* The curve stops here, which happens at an end whose neighbouring
+     * control point is the same point. Near such an end C(u) - C(end) goes
+     * as C''(end) * (u - end)^2 / 2, so the travel direction is along
+     * C'' leaving the start and against it arriving at the end. */
+    if (u > 0.5) {
+        pmCartScalMultEq(&d2, -1.0);
+    }
+    return pmCartUnit(&d2, out) ? TP_ERR_GEOM : TP_ERR_OK;
+}
+
+/**
+ * Find the curve parameter at which the arc length from the start is
+ * progress. The table gives the interval and a first guess by linear
+ * interpolation, Newton iteration on the arc length within that interval
+ * does the rest.
+ */
+int splineParamFromProgress(Spline const * const spline, double progress,
+        double * const u)
+{
+    double const * const s = spline->s;
+
+    if (progress <= 0.0) {
+        *u = 0.0;
+        return TP_ERR_OK;
+    }
+    if (progress >= s[SPLINE_TABLE_SIZE]) {
+        *u = 1.0;
+        return TP_ERR_OK;
+    }
+
+    int lo = 0, hi = SPLINE_TABLE_SIZE;
+    while (hi - lo > 1) {
+        int mid = (lo + hi) / 2;
+        if (s[mid] <= progress) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+
+    double u0 = (double)lo / SPLINE_TABLE_SIZE;
+    double u1 = (double)hi / SPLINE_TABLE_SIZE;
+    double ds = s[hi] - s[lo];
+    if (ds <= 0.0) {
+        *u = u0;
+        return TP_ERR_OK;
+    }
+    double u_k = u0 + (u1 - u0) * (progress - s[lo]) / ds;
+
+    int iter;
+    for (iter = 0; iter < SPLINE_NEWTON_ITERATIONS; ++iter) {
+        double err = s[lo] + splineArcLength(spline, u0, u_k) - progress;
+        double speed = splineSpeed(spline, u_k);
+        if (fabs(err) < TP_POS_EPSILON || speed < TP_POS_EPSILON) {
+            break;
+        }
+        u_k = fmax(fmin(u_k - err / speed, u1), u0);
+    }
+    *u = u_k;
+    return TP_ERR_OK;
+}
+
+double splineLength(Spline const * const spline)
+{
+    return spline->s[SPLINE_TABLE_SIZE];
+}
@@ -0,0 +1,47 @@
+/********************************************************************
+ * Description: spline.h
+ *
+ * Rational cubic Bezier curves with an arc length table, so that the
+ * trajectory planner can run a spline (one span of a G5 / G5.1 / G5.2
+ * NURBS) as a single segment.
+ *
+ * License: GPL Version 2
+ * System: Linux
+ *
+ * Copyright (c) 2026 All rights reserved.
+ *
+ ********************************************************************/
+#ifndef SPLINE_H
+#define SPLINE_H
+
+#include "posemath.h"
+
+/* Number of intervals of the arc length table. The curve parameter is
+ * split evenly, the length of each interval is found by Gauss-Legendre
+ * quadrature, and a lookup refines the parameter by Newton iteration
+ * within its interval, so a small table is enough for a smooth span. */
+#define SPLINE_TABLE_SIZE 16
+#define SPLINE_MIN_WEIGHT 1e-9
+
+typedef struct {
+    // Control points and their weights, the curve runs from P[0] to P[3]
+    PmCartesian P[4];
+    double w[4];
+    // Arc length from the start to parameter i / SPLINE_TABLE_SIZE
+    double s[SPLINE_TABLE_SIZE + 1];
+    // Smallest radius of curvature along the curve
+    double min_radius;
+} Spline;
+
+int splineInit(Spline * const spline, PmCartesian const * const P,
+        double const * const w);
+
+int splinePoint(Spline const * const spline, double u, PmCartesian * const out);
+
+int splineTangent(Spline const * const spline, double u, PmCartesian * const out);
+
+int splineParamFromProgress(Spline const * const spline, double progress,
+        double * const u);
+
+double splineLength(Spline const * const spline);
+#endif
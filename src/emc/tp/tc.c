@@ -22,6 +22,7 @@
 #include "tc.h"
 #include "tp_types.h"
 #include "spherical_arc.h"
+#include "spline.h"
 #include "motion_types.h"
 
 //Debug output
@@ -77,7 +78,8 @@ double tcGetTangentialMaxAccel(TC_STRUCT const * const tc)
     // Reduce allowed tangential acceleration in circular motions to stay
     // within overall limits (accounts for centripetal acceleration while
     // moving along the circular path).
-    if (tc->motion_type == TC_CIRCULAR || tc->motion_type == TC_SPHERICAL) {
+    if (tc->motion_type == TC_CIRCULAR || tc->motion_type == TC_SPHERICAL
+            || tc->motion_type == TC_SPLINE) {
         //Limit acceleration for circular arcs to allow for normal acceleration
         a_scale *= tc->acc_ratio_tan;
     }
@@ -161,6 +163,9 @@ int tcGetStartAccelUnitVector(TC_STRUCT const * const tc, PmCartesian * const ou
         case TC_CIRCULAR:
             tcCircleStartAccelUnitVector(tc,out);
             break;
+        case TC_SPLINE:
+            splineTangent(&tc->coords.spline.xyz, 0.0, out);
+            break;
         case TC_SPHERICAL:
             return -1;
         default:
@@ -185,6 +190,9 @@ int tcGetEndAccelUnitVector(TC_STRUCT const * const tc, PmCartesian * const out)
         case TC_CIRCULAR:
             tcCircleEndAccelUnitVector(tc,out);
             break;
+        case TC_SPLINE:
+            splineTangent(&tc->coords.spline.xyz, 1.0, out);
+            break;
        case TC_SPHERICAL:
             return -1;
        default:
@@ -204,6 +212,8 @@ int tcGetIntersectionPoint(TC_STRUCT const * const prev_tc,
         *point = prev_tc->coords.line.xyz.end;
     } else if (tc->motion_type == TC_CIRCULAR){
         pmCirclePoint(&tc->coords.circle.xyz, 0.0, point);
+    } else if (tc->motion_type == TC_SPLINE) {
+        splinePoint(&tc->coords.spline.xyz, 0.0, point);
     } else {
         return TP_ERR_FAIL;
     }
@@ -287,6 +297,9 @@ int tcGetStartTangentUnitVector(TC_STRUCT const * const tc, PmCartesian * const
         case TC_CIRCULAR:
             pmCircleTangentVector(&tc->coords.circle.xyz, 0.0, out);
             break;
+        case TC_SPLINE:
+            splineTangent(&tc->coords.spline.xyz, 0.0, out);
+            break;
         default:
             rtapi_print_msg(RTAPI_MSG_ERR, "Invalid motion type %d!\n",tc->motion_type);
             return -1;
@@ -310,6 +323,9 @@ int tcGetEndTangentUnitVector(TC_STRUCT const * const tc, PmCartesian * const ou
             pmCircleTangentVector(&tc->coords.circle.xyz,
                     tc->coords.circle.xyz.angle, out);
             break;
+        case TC_SPLINE:
+            splineTangent(&tc->coords.spline.xyz, 1.0, out);
+            break;
         default:
             rtapi_print_msg(RTAPI_MSG_ERR, "Invalid motion type %d!\n",tc->motion_type);
             return -1;
@@ -317,6 +333,68 @@ int tcGetEndTangentUnitVector(TC_STRUCT const * const tc, PmCartesian * const ou
     return 0;
 }
 
+/**
+ * Rate of change of one line part of a segment per unit of progress.
+ * ABC and UVW (and XYZ of a line) move linearly with the progress along the
+ * segment, so this is the same all along it.
+ */
+static void tcLineRate(PmCartLine const * const line, double target, PmCartesian * const out)
+{
+    if (line->tmag_zero) {
+        out->x = out->y = out->z = 0.0;
+    } else {
+        pmCartScalMult(&line->uVec, line->tmag / target, out);
+    }
+}
+
+/**
+ * Calculate how fast each of the 9 axes moves per unit of progress, at the
+ * start or at the end of a segment. This is the direction of motion in the
+ * combined XYZ / ABC / UVW space, scaled so that an axis that alone
+ * determines the segment length has a rate of 1.
+ */
+static int tcGetAxisRates(TC_STRUCT const * const tc, int at_end, EmcPose * const out)
+{
+    PmCartesian xyz, abc = {0}, uvw = {0};
+    int res = 0;
+
+    if (tc->target < TP_POS_EPSILON) {
+        return -1;
+    }
+    switch (tc->motion_type) {
+        case TC_LINEAR:
+            tcLineRate(&tc->coords.line.xyz, tc->target, &xyz);
+            tcLineRate(&tc->coords.line.abc, tc->target, &abc);
+            tcLineRate(&tc->coords.line.uvw, tc->target, &uvw);
+            break;
+        case TC_CIRCULAR:
+            pmCircleTangentVector(&tc->coords.circle.xyz,
+                    at_end ? tc->coords.circle.xyz.angle : 0.0, &xyz);
+            tcLineRate(&tc->coords.circle.abc, tc->target, &abc);
+            tcLineRate(&tc->coords.circle.uvw, tc->target, &uvw);
+            break;
+        case TC_SPLINE:
+            splineTangent(&tc->coords.spline.xyz, at_end ? 1.0 : 0.0, &xyz);
+            tcLineRate(&tc->coords.spline.abc, tc->target, &abc);
+            tcLineRate(&tc->coords.spline.uvw, tc->target, &uvw);
+            break;
+        default:
+            // Other segment types only move XYZ
+            res = at_end ? tcGetEndTangentUnitVector(tc, &xyz)
+                : tcGetStartTangentUnitVector(tc, &xyz);
+            break;
+    }
+    pmCartesianToEmcPose(&xyz, &abc, &uvw, out);
+    return res;
+}
+
+int tcGetStartAxisRates(TC_STRUCT const * const tc, EmcPose * const out) {
+    return tcGetAxisRates(tc, 0, out);
+}
+
+int tcGetEndAxisRates(TC_STRUCT const * const tc, EmcPose * const out) {
+    return tcGetAxisRates(tc, 1, out);
+}
 
 
 /**
@@ -388,7 +466,8 @@ int tcGetPosReal(TC_STRUCT const * const tc, int of_point, EmcPose * const pos)
     }
 
 
-    // Used for arc-length to angle conversion with spiral segments
+    // Used for arc-length to angle conversion with spiral segments, and to
+    // the curve parameter with splines
     double angle = 0.0;
     int res_fit = TP_ERR_OK;
 
@@ -435,6 +514,17 @@ int tcGetPosReal(TC_STRUCT const * const tc, int of_point, EmcPose * const pos)
             abc = tc->coords.arc.abc;
             uvw = tc->coords.arc.uvw;
             break;
+        case TC_SPLINE:
+            res_fit = splineParamFromProgress(&tc->coords.spline.xyz,
+                    progress, &angle);
+            splinePoint(&tc->coords.spline.xyz, angle, &xyz);
+            pmCartLinePoint(&tc->coords.spline.abc,
+                    progress * tc->coords.spline.abc.tmag / tc->target,
+                    &abc);
+            pmCartLinePoint(&tc->coords.spline.uvw,
+                    progress * tc->coords.spline.uvw.tmag / tc->target,
+                    &uvw);
+            break;
     }
 
     if (res_fit == TP_ERR_OK) {
@@ -745,6 +835,44 @@ double pmCircle9Target(PmCircle9 const * const circ9)
     return helical_length;
 }
 
+/**
+ * Set up a spline segment from the current position to end. P1 and P2 are
+ * the inner control points of the XYZ curve, w its four weights. ABC and
+ * UVW move linearly along the curve.
+ */
+int pmSpline9Init(Spline9 * const spline9,
+        EmcPose const * const start,
+        EmcPose const * const end,
+        PmCartesian const * const P1,
+        PmCartesian const * const P2,
+        double const * const w)
+{
+    PmCartesian P[4];
+    PmCartesian start_uvw, end_uvw;
+    PmCartesian start_abc, end_abc;
+
+    emcPoseToPmCartesian(start, &P[0], &start_abc, &start_uvw);
+    emcPoseToPmCartesian(end, &P[3], &end_abc, &end_uvw);
+    P[1] = *P1;
+    P[2] = *P2;
+
+    int xyz_fail = splineInit(&spline9->xyz, P, w);
+    int abc_fail = pmCartLineInit(&spline9->abc, &start_abc, &end_abc);
+    int uvw_fail = pmCartLineInit(&spline9->uvw, &start_uvw, &end_uvw);
+
+    if (xyz_fail || abc_fail || uvw_fail) {
+        rtapi_print_msg(RTAPI_MSG_ERR,"Failed to initialize Spline9, err codes %d, %d, %d\n",
+                xyz_fail, abc_fail, uvw_fail);
+        return TP_ERR_FAIL;
+    }
+    return TP_ERR_OK;
+}
+
+double pmSpline9Target(Spline9 const * const spline9)
+{
+    return splineLength(&spline9->xyz);
+}
+
 int tcUpdateCircleAccRatio(TC_STRUCT * tc)
 {
     if (tc->motion_type == TC_CIRCULAR) {
@@ -754,6 +882,13 @@ int tcUpdateCircleAccRatio(TC_STRUCT * tc)
         tc->maxvel = limits.v_max;
         tc->acc_ratio_tan = limits.acc_ratio;
         return 0;
+    } else if (tc->motion_type == TC_SPLINE) {
+        PmCircleLimits limits = pmCurveActualMaxVel(tc->coords.spline.xyz.min_radius,
+                             tc->maxvel,
+                             tcGetOverallMaxAccel(tc));
+        tc->maxvel = limits.v_max;
+        tc->acc_ratio_tan = limits.acc_ratio;
+        return 0;
     }
     // TODO handle blend arc here too?
     return 1; //nothing to do, but not an error
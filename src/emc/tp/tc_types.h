@@ -14,6 +14,7 @@
 #define TC_TYPES_H
 
 #include "spherical_arc.h"
+#include "spline.h"
 #include "posemath.h"
 #include "emcpos.h"
 #include "emcmotcfg.h"
@@ -32,7 +33,8 @@ typedef enum {
     TC_LINEAR = 1,
     TC_CIRCULAR = 2,
     TC_RIGIDTAP = 3,
-    TC_SPHERICAL = 4
+    TC_SPHERICAL = 4,
+    TC_SPLINE = 5
 } tc_motion_type_t;
 
 typedef enum {
@@ -89,6 +91,12 @@ typedef struct {
     PmCartesian uvw;
 } Arc9;
 
+typedef struct {
+    Spline xyz;
+    PmCartLine abc;
+    PmCartLine uvw;
+} Spline9;
+
 typedef enum {
     RIGIDTAP_START,
     TAPPING, REVERSING, RETRACTION, FINAL_REVERSAL, FINAL_PLACEMENT
@@ -116,12 +124,19 @@ typedef struct {
     RIGIDTAP_STATE state;
 } PmRigidTap;
 
+/* The fields are grouped by how often they are touched. The first group
+ * is read and written every servo cycle, both for the active segment and
+ * by the look-ahead over the queue, and is kept together at the front of
+ * the struct so that it spans as few cache lines as possible. Geometry
+ * and setup data follow; they are written when the segment is queued and
+ * read by the active segment only. syncdio must stay last, see tcqPut().
+ */
 typedef struct {
+    /* per-cycle state */
     double cycle_time;
     //Position stuff
     double target;          // actual segment length
     double progress;        // where are we in the segment?  0..target
-    double nominal_length;
 
     //Velocity
     double reqvel;          // vel requested by F word, calc'd by task
@@ -137,37 +152,24 @@ typedef struct {
     //Acceleration
     double maxaccel;        // accel calc'd by task
     double acc_ratio_tan;// ratio between normal and tangential accel
-    
-    int id;                 // segment's serial number
-    struct state_tag_t tag; // state tag corresponding to running motion
 
-    union {                 // describes the segment's start and end positions
-        PmLine9 line;
-        PmCircle9 circle;
-        PmRigidTap rigidtap;
-        Arc9 arc;
-    } coords;
+    double blend_vel;       // velocity below which we should start blending
+    double uu_per_rev;      // for sync, user units per rev (e.g. 0.0625 for 16tpi)
+    double vel_at_blend_start;
 
+    int id;                 // segment's serial number
     int motion_type;       // TC_LINEAR (coords.line) or
                             // TC_CIRCULAR (coords.circle) or
-                            // TC_RIGIDTAP (coords.rigidtap)
+                            // TC_RIGIDTAP (coords.rigidtap) or
+                            // TC_SPLINE (coords.spline)
     int active;            // this motion is being executed
-    int canon_motion_type;  // this motion is due to which canon function?
     int term_cond;          // gcode requests continuous feed at the end of
                             // this segment (g64 mode)
-
     int blending_next;      // segment is being blended into following segment
-    double blend_vel;       // velocity below which we should start blending
-    double tolerance;       // during the blend at the end of this move,
-                            // stay within this distance from the path.
     int synchronized;       // spindle sync state
-    double uu_per_rev;      // for sync, user units per rev (e.g. 0.0625 for 16tpi)
-    double vel_at_blend_start;
     int sync_accel;         // we're accelerating up to sync with the spindle
     unsigned char enables;  // Feed scale, etc, enable bits for this move
     int atspeed;           // wait for the spindle to be at-speed before starting this move
-    syncdio_t syncdio;      // synched DIO's for this move. what to turn on/off
-    int indexer_jnum;  // which joint to unlock (for a locking indexer) to make this move, -1 for none
     int optimization_state;             // At peak velocity during blends)
     int on_final_decel;
     int blend_prev;
@@ -182,6 +184,24 @@ typedef struct {
 
     // Temporary status flags (reset each cycle)
     int is_blending;
+
+    /* geometry and setup */
+    double nominal_length;
+    double tolerance;       // during the blend at the end of this move,
+                            // stay within this distance from the path.
+    int canon_motion_type;  // this motion is due to which canon function?
+    int indexer_jnum;  // which joint to unlock (for a locking indexer) to make this move, -1 for none
+    struct state_tag_t tag; // state tag corresponding to running motion
+
+    union {                 // describes the segment's start and end positions
+        PmLine9 line;
+        PmCircle9 circle;
+        PmRigidTap rigidtap;
+        Arc9 arc;
+        Spline9 spline;
+    } coords;
+
+    syncdio_t syncdio;      // synched DIO's for this move. what to turn on/off
 } TC_STRUCT;
 
 #endif				/* TC_TYPES_H */
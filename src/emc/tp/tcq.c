@@ -18,6 +18,7 @@
  ********************************************************************/
 
 #include "tcq.h"
+#include "rtapi_string.h"
 #include <stddef.h>
 
 /** Return 0 if queue is valid, -1 if not */
@@ -125,8 +126,14 @@ int tcqPut(TC_QUEUE_STRUCT * const tcq, TC_STRUCT const * const tc)
 	    return -1;
     }
 
-    /* add it */
-    tcq->queue[tcq->end] = *tc;
+    /* add it. Most segments carry no synched I/O, so the big syncdio
+       table at the end of the struct is only copied when it is used */
+    if (tc->syncdio.anychanged) {
+        tcq->queue[tcq->end] = *tc;
+    } else {
+        memcpy(&tcq->queue[tcq->end], tc, offsetof(TC_STRUCT, syncdio));
+        tcq->queue[tcq->end].syncdio.anychanged = 0;
+    }
     tcq->_len++;
 
     /* update end ptr, modulo size of queue */
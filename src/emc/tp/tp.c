@@ -145,6 +145,12 @@ STATIC int tcRotaryMotionCheck(TC_STRUCT const * const tc) {
             } else {
                 return true;
             }
+        case TC_SPLINE:
+            if (tc->coords.spline.abc.tmag_zero && tc->coords.spline.uvw.tmag_zero) {
+                return false;
+            } else {
+                return true;
+            }
         case TC_SPHERICAL:
             return true;
         default:
@@ -185,6 +191,21 @@ STATIC int tpGetMachineAccelBounds(PmCartesian  * const acc_bound) {
 }
 
 
+/**
+ * Get the acceleration bounds of all 9 axes, as XYZ, ABC and UVW.
+ */
+STATIC int tpGetMachineAccelBounds9(PmCartesian acc_bound[3]) {
+    int i;
+
+    for (i = 0; i < 3; ++i) {
+        acc_bound[i].x = _axis_get_acc_limit(3 * i);
+        acc_bound[i].y = _axis_get_acc_limit(3 * i + 1);
+        acc_bound[i].z = _axis_get_acc_limit(3 * i + 2);
+    }
+    return TP_ERR_OK;
+}
+
+
 STATIC int tpGetMachineVelBounds(PmCartesian  * const vel_bound) {
     if (!vel_bound) {
         return TP_ERR_FAIL;
@@ -1641,7 +1662,9 @@ STATIC blend_type_t tpCheckBlendArcType(
         return BLEND_NONE;
     }
 
-    //If we have any rotary axis motion, then don't create a blend arc
+    //If we have any rotary axis motion, then don't create a blend arc (the
+    //arc geometry is XYZ only). Such segments are still blended as tangent or
+    //parabolic by tpChooseBestBlend.
     if (tcRotaryMotionCheck(tc) || tcRotaryMotionCheck(prev_tc)) {
         tp_debug_print("One of the segments has rotary motion, aborting blend arc\n");
         return BLEND_NONE;
@@ -1830,6 +1853,40 @@ STATIC int tpRunOptimization(TP_STRUCT * const tp) {
 }
 
 
+/**
+ * Checks if the directions of motion given by two sets of axis rates are
+ * anti-parallel to the given tolerance, in the combined space of all 9 axes.
+ * @see pmCartCartAntiParallel
+ */
+STATIC int tpAxisRatesAntiParallel(EmcPose const * const r1,
+        EmcPose const * const r2, double tol)
+{
+    double mag1, mag2;
+    emcPoseMagnitude(r1, &mag1);
+    emcPoseMagnitude(r2, &mag2);
+    if (mag1 < TP_POS_EPSILON || mag2 < TP_POS_EPSILON) {
+        return false;
+    }
+
+    PmCartesian u1[3], u2[3];
+    emcPoseToPmCartesian(r1, &u1[0], &u1[1], &u1[2]);
+    emcPoseToPmCartesian(r2, &u2[0], &u2[1], &u2[2]);
+
+    double d_sum = 0.0;
+    int i;
+    for (i = 0; i < 3; ++i) {
+        PmCartesian u_sum;
+        double d;
+        pmCartScalMultEq(&u1[i], 1.0 / mag1);
+        pmCartScalMultEq(&u2[i], 1.0 / mag2);
+        pmCartCartAdd(&u1[i], &u2[i], &u_sum);
+        pmCartMagSq(&u_sum, &d);
+        d_sum += d;
+    }
+    return d_sum < tol;
+}
+
+
 /**
  * Check for tangency between the current segment and previous segment.
  * If the current and previous segment are tangent, then flag the previous
@@ -1842,9 +1899,9 @@ STATIC int tpSetupTangent(TP_STRUCT const * const tp,
         tp_debug_print("missing tc or prev tc in tangent check\n");
         return TP_ERR_FAIL;
     }
-    //If we have ABCUVW movement, then don't check for tangency
-    if (tcRotaryMotionCheck(tc) || tcRotaryMotionCheck(prev_tc)) {
-        tp_debug_print("found rotary axis motion\n");
+    // A locking indexer has to stop to unlock, so it can't be blended into
+    if (tc->indexer_jnum != -1 || prev_tc->indexer_jnum != -1) {
+        tp_debug_print("found indexer motion\n");
         return TP_ERR_FAIL;
     }
 
@@ -1859,22 +1916,29 @@ STATIC int tpSetupTangent(TP_STRUCT const * const tp,
         return TP_ERR_FAIL;
     }
 
-    PmCartesian prev_tan, this_tan;
+    // Work with the direction of motion of all 9 axes, so that segments with
+    // ABC / UVW motion can be blended too. For XYZ-only segments these are
+    // the unit tangent vectors.
+    EmcPose prev_rates, this_rates;
 
-    int res_endtan = tcGetEndTangentUnitVector(prev_tc, &prev_tan);
-    int res_starttan = tcGetStartTangentUnitVector(tc, &this_tan);
+    int res_endtan = tcGetEndAxisRates(prev_tc, &prev_rates);
+    int res_starttan = tcGetStartAxisRates(tc, &this_rates);
     if (res_endtan || res_starttan) {
         tp_debug_print("Got %d and %d from tangent vector calc\n",
                 res_endtan, res_starttan);
     }
 
-    tp_debug_print("prev tangent vector: %f %f %f\n", prev_tan.x, prev_tan.y, prev_tan.z);
-    tp_debug_print("this tangent vector: %f %f %f\n", this_tan.x, this_tan.y, this_tan.z);
+    PmCartesian prev_tan[3], this_tan[3];
+    emcPoseToPmCartesian(&prev_rates, &prev_tan[0], &prev_tan[1], &prev_tan[2]);
+    emcPoseToPmCartesian(&this_rates, &this_tan[0], &this_tan[1], &this_tan[2]);
+
+    tp_debug_print("prev tangent vector: %f %f %f\n", prev_tan[0].x, prev_tan[0].y, prev_tan[0].z);
+    tp_debug_print("this tangent vector: %f %f %f\n", this_tan[0].x, this_tan[0].y, this_tan[0].z);
 
     // Assume small angle approximation here
     const double SHARP_CORNER_DEG = 2.0;
     const double SHARP_CORNER_EPSILON = pmSq(PM_PI * ( SHARP_CORNER_DEG / 180.0));
-    if (pmCartCartAntiParallel(&prev_tan, &this_tan, SHARP_CORNER_EPSILON))
+    if (tpAxisRatesAntiParallel(&prev_rates, &this_rates, SHARP_CORNER_EPSILON))
     {
         tp_debug_print("Found sharp corner\n");
         tcSetTermCond(prev_tc, tc, TC_TERM_COND_STOP);
@@ -1897,30 +1961,35 @@ STATIC int tpSetupTangent(TP_STRUCT const * const tp,
     // Compute the actual magnitude of acceleration required given the tangent directions
     // Do this by assuming that we decelerate to a stop on the previous segment,
     // and simultaneously accelerate up to the maximum speed on the next one.
-    PmCartesian acc1, acc2, acc_diff;
-    pmCartScalMult(&prev_tan, a_inst, &acc1);
-    pmCartScalMult(&this_tan, a_inst, &acc2);
-    pmCartCartSub(&acc2,&acc1,&acc_diff);
+    // Each axis is held to its own acceleration limit.
 
     //TODO store this in TP struct instead?
-    PmCartesian acc_bound;
-    tpGetMachineAccelBounds(&acc_bound);
-
-    PmCartesian acc_scale;
-    findAccelScale(&acc_diff,&acc_bound,&acc_scale);
-    tp_debug_print("acc_diff: %f %f %f\n",
-            acc_diff.x,
-            acc_diff.y,
-            acc_diff.z);
-    tp_debug_print("acc_scale: %f %f %f\n",
-            acc_scale.x,
-            acc_scale.y,
-            acc_scale.z);
+    PmCartesian acc_bound[3];
+    tpGetMachineAccelBounds9(acc_bound);
 
     //FIXME this ratio is arbitrary, should be more easily tunable
-    double acc_scale_max = pmCartAbsMax(&acc_scale);
+    double acc_scale_max = 0.0;
+    int i;
+    for (i = 0; i < 3; ++i) {
+        PmCartesian acc1, acc2, acc_diff, acc_scale;
+        pmCartScalMult(&prev_tan[i], a_inst, &acc1);
+        pmCartScalMult(&this_tan[i], a_inst, &acc2);
+        pmCartCartSub(&acc2,&acc1,&acc_diff);
+
+        findAccelScale(&acc_diff,&acc_bound[i],&acc_scale);
+        tp_debug_print("acc_diff: %f %f %f\n",
+                acc_diff.x,
+                acc_diff.y,
+                acc_diff.z);
+        tp_debug_print("acc_scale: %f %f %f\n",
+                acc_scale.x,
+                acc_scale.y,
+                acc_scale.z);
+        acc_scale_max = fmax(acc_scale_max, pmCartAbsMax(&acc_scale));
+    }
     //KLUDGE lumping a few calculations together here
-    if (prev_tc->motion_type == TC_CIRCULAR || tc->motion_type == TC_CIRCULAR) {
+    if (prev_tc->motion_type == TC_CIRCULAR || tc->motion_type == TC_CIRCULAR
+            || prev_tc->motion_type == TC_SPLINE || tc->motion_type == TC_SPLINE) {
         acc_scale_max /= BLEND_ACC_RATIO_TANGENTIAL;
     }
 
@@ -1933,6 +2002,18 @@ STATIC int tpSetupTangent(TP_STRUCT const * const tp,
         tcSetTermCond(prev_tc, tc, TC_TERM_COND_TANGENT);
         tcSetKinkProperties(prev_tc, tc, v_max, acc_scale_max);
         return TP_ERR_OK;
+    } else if (tcRotaryMotionCheck(tc) || tcRotaryMotionCheck(prev_tc)) {
+        // No blend arc is possible here, only a parabolic blend, which
+        // gives up the same share of both segments' acceleration. Reserve
+        // that much for the kink so the tangent blend can compete with it.
+        double rotary_ratio = BLEND_ACC_RATIO_TANGENTIAL;
+        tcSetKinkProperties(prev_tc, tc,
+                v_max * fmin(rotary_ratio / acc_scale_max, 1.0),
+                fmin(rotary_ratio, acc_scale_max));
+        tp_debug_print("Kink acceleration scale %f with rotary motion, kink vel = %f\n",
+                acc_scale_max,
+                prev_tc->kink_vel);
+        return TP_ERR_NO_ACTION;
     } else {
         tcSetKinkProperties(prev_tc, tc, v_max * kink_ratio / acc_scale_max, kink_ratio);
         tp_debug_print("Kink acceleration scale %f above %f, kink vel = %f, blend arc may be faster\n",
@@ -2197,6 +2278,93 @@ int tpAddCircle(TP_STRUCT * const tp,
 }
 
 
+/**
+ * Adds a spline move from the end of the last move to this new position.
+ *
+ * The XYZ path is a rational cubic Bezier curve from the current position
+ * to end, with inner control points P1 and P2 and weights w of all four
+ * control points. ABC and UVW move linearly along it. Blend arcs are not
+ * made to or from a spline; consecutive spline segments from the same
+ * NURBS meet tangentially and are blended as tangent.
+ */
+int tpAddSpline(TP_STRUCT * const tp,
+        EmcPose end,
+        PmCartesian P1,
+        PmCartesian P2,
+        double const * const w,
+        int canon_motion_type,
+        double vel,
+        double ini_maxvel,
+        double acc,
+        unsigned char enables,
+        char atspeed,
+        struct state_tag_t tag)
+{
+    if (tpErrorCheck(tp)<0) {
+        return TP_ERR_FAIL;
+    }
+
+    tp_info_print("== AddSpline ==\n");
+    tp_debug_print("ini_maxvel = %f\n",ini_maxvel);
+
+    TC_STRUCT tc = {0};
+
+    tcInit(&tc,
+            TC_SPLINE,
+            canon_motion_type,
+            tp->cycleTime,
+            enables,
+            atspeed);
+    tc.tag = tag;
+    // Setup any synced IO for this move
+    tpSetupSyncedIO(tp, &tc);
+
+    // Copy over state data from the trajectory planner
+    tcSetupState(&tc, tp);
+
+    // Setup spline geometry and its arc length table
+    int res_init = pmSpline9Init(&tc.coords.spline,
+            &tp->goalPos,
+            &end,
+            &P1,
+            &P2,
+            w);
+
+    if (res_init) return res_init;
+
+    tc.target = pmSpline9Target(&tc.coords.spline);
+    if (tc.target < TP_POS_EPSILON) {
+        return TP_ERR_ZERO_LENGTH;
+    }
+    tp_debug_print("tc.target = %f\n",tc.target);
+    tc.nominal_length = tc.target;
+
+    // Copy in motion parameters
+    tcSetupMotion(&tc,
+            vel,
+            ini_maxvel,
+            acc);
+
+    //Reduce max velocity to match sample rate
+    tcClampVelocityByLength(&tc);
+
+    TC_STRUCT *prev_tc;
+    prev_tc = tcqLast(&tp->queue);
+
+    handleModeChange(prev_tc, &tc);
+    if (emcmotConfig->arcBlendEnable){
+        tpHandleBlendArc(tp, &tc);
+    }
+    tcFinalizeLength(prev_tc);
+    tcFlagEarlyStop(prev_tc, &tc);
+
+    int retval = tpAddSegmentToQueue(tp, &tc, true);
+
+    tpRunOptimization(tp);
+    return retval;
+}
+
+
 /**
  * Adjusts blend velocity and acceleration to safe limits.
  * If we are blending between tc and nexttc, then we need to figure out what a
@@ -35,9 +35,12 @@
 #include "rcs_print.hh"
 #include <rtapi_string.h>
 #include <sys/types.h>
+#include <sys/shm.h>
 #include <unistd.h>
 
 #include "tooldata.hh"
+#include "rtapi.h"
+#include "pathring.h"
 
 #include <cmath>
 
@@ -82,10 +85,34 @@ struct pyIniFile {
     IniFile *i;
 };
 
+// The parts of EMC_STAT that the tuple and dict attributes of
+// linuxcnc.stat are converted from.  poll() compares each with what it
+// held before and drops the converted values of those that changed.
+enum stat_group {
+    STAT_TASK, STAT_TRAJ, STAT_JOINT, STAT_AXIS, STAT_SPINDLE,
+    STAT_DIN, STAT_DOUT, STAT_AIN, STAT_AOUT, STAT_MISC_ERROR, STAT_GROUPS
+};
+
+// the attributes whose converted values are kept between polls
+enum stat_cache_slot {
+    CACHE_G5X_OFFSET, CACHE_G92_OFFSET, CACHE_TOOL_OFFSET,
+    CACHE_GCODES, CACHE_MCODES, CACHE_SETTINGS,
+    CACHE_POSITION, CACHE_DTG, CACHE_ACTUAL, CACHE_PROBED,
+    CACHE_JOINT, CACHE_JOINT_POSITION, CACHE_JOINT_ACTUAL,
+    CACHE_LIMIT, CACHE_HOMED, CACHE_AXIS, CACHE_SPINDLE,
+    CACHE_DIN, CACHE_DOUT, CACHE_AIN, CACHE_AOUT, CACHE_MISC_ERROR,
+    CACHE_TOOL_TABLE, CACHE_SLOTS
+};
+
 struct pyStatChannel {
     PyObject_HEAD
     RCS_STAT_CHANNEL *c;
     EMC_STAT status;
+    int msg_count;              // write count of the status buffer at
+                                // the last poll(), 0 before the first
+    PyObject *cache[CACHE_SLOTS];
+    CANON_TOOL_TABLE *tools;    // what cache[CACHE_TOOL_TABLE] was made from
+    int ntools;
 };
 
 struct pyCommandChannel {
@@ -272,7 +299,11 @@ static int Stat_init(pyStatChannel *self, PyObject *a, PyObject *k) {
 }
 
 static void Stat_dealloc(PyObject *self) {
-    delete ((pyStatChannel*)self)->c;
+    pyStatChannel *s = (pyStatChannel*)self;
+    for(int i = 0; i < CACHE_SLOTS; i++)
+        Py_XDECREF(s->cache[i]);
+    free(s->tools);
+    delete s->c;
     PyObject_Del(self);
 }
 
@@ -286,6 +317,32 @@ static bool check_stat(RCS_STAT_CHANNEL *emcStatusBuffer) {
 
 static bool initialized=0;
 
+#define G(x) {offsetof(EMC_STAT, x), sizeof(((EMC_STAT*)0)->x)}
+static const struct { size_t offset, size; } stat_groups[STAT_GROUPS] = {
+    G(task),
+    G(motion.traj),
+    G(motion.joint),
+    G(motion.axis),
+    G(motion.spindle),
+    G(motion.synch_di),
+    G(motion.synch_do),
+    G(motion.analog_input),
+    G(motion.analog_output),
+    G(motion.misc_error),
+};
+#undef G
+
+// STAT_GROUPS: the tool table is checked by Stat_tool_table() itself
+static const int cache_group[CACHE_SLOTS] = {
+    STAT_TASK, STAT_TASK, STAT_TASK,
+    STAT_TASK, STAT_TASK, STAT_TASK,
+    STAT_TRAJ, STAT_TRAJ, STAT_TRAJ, STAT_TRAJ,
+    STAT_JOINT, STAT_JOINT, STAT_JOINT,
+    STAT_JOINT, STAT_JOINT, STAT_AXIS, STAT_SPINDLE,
+    STAT_DIN, STAT_DOUT, STAT_AIN, STAT_AOUT, STAT_MISC_ERROR,
+    STAT_GROUPS
+};
+
 static PyObject *poll(pyStatChannel *s, PyObject *o) {
 #ifdef TOOL_NML //{
     if (!initialized) {
@@ -305,8 +362,23 @@ static PyObject *poll(pyStatChannel *s, PyObject *o) {
     }
 #endif //}
     if(!check_stat(s->c)) return NULL;
+    // nothing was written since the last poll(), so nothing can differ
+    int msg_count = s->c->get_msg_count();
+    if(msg_count > 0 && msg_count == s->msg_count) {
+        Py_INCREF(Py_None);
+        return Py_None;
+    }
     if(s->c->peek() == EMC_STAT_TYPE) {
         EMC_STAT *emcStatus = static_cast<EMC_STAT*>(s->c->get_address());
+        s->msg_count = msg_count;
+        for(int g = 0; g < STAT_GROUPS; g++) {
+            const char *was = (const char*)&s->status + stat_groups[g].offset;
+            const char *now = (const char*)emcStatus + stat_groups[g].offset;
+            if(!memcmp(was, now, stat_groups[g].size)) continue;
+            for(int i = 0; i < CACHE_SLOTS; i++) {
+                if(cache_group[i] == g) Py_CLEAR(s->cache[i]);
+            }
+        }
         memcpy((char*)&s->status, emcStatus, sizeof(EMC_STAT));
     }
     Py_INCREF(Py_None);
@@ -423,6 +495,7 @@ static PyMemberDef Stat_members[] = {
     {(char*)"interp_state", T_INT, O(task.interpState), READONLY},
     {(char*)"call_level", T_INT, O(task.callLevel), READONLY},
     {(char*)"read_line", T_INT, O(task.readLine), READONLY},
+    {(char*)"readahead_fill", T_INT, O(task.readaheadFill), READONLY},
     {(char*)"motion_line", T_INT, O(task.motionLine), READONLY},
     {(char*)"current_line", T_INT, O(task.currentLine), READONLY},
     {(char*)"file", T_STRING_INPLACE, O(task.file), READONLY},
@@ -762,14 +835,31 @@ static PyObject *Stat_tool_table(pyStatChannel *s) {
         return res;
     }
 
+    // the tool data does not come with the status, so compare it with
+    // what the cached tuple was made from
     int idxmax = tooldata_last_index_get() + 1;
-    res = PyTuple_New(idxmax);
+    CANON_TOOL_TABLE *tools =
+        (CANON_TOOL_TABLE*)malloc(sizeof(CANON_TOOL_TABLE) * (idxmax ? idxmax : 1));
+    if(!tools) return PyErr_NoMemory();
     for(int idx=0; idx < idxmax; idx++) {
-        struct CANON_TOOL_TABLE tdata;
-        if (tooldata_get(&tdata,idx) != IDX_OK) {
+        tools[idx] = tooldata_entry_init();
+        if (tooldata_get(&tools[idx],idx) != IDX_OK) {
             fprintf(stderr,"UNEXPECTED idx %s %d\n",__FILE__,__LINE__);
         }
-        struct CANON_TOOL_TABLE &t = tdata;
+    }
+    if(s->cache[CACHE_TOOL_TABLE] && idxmax == s->ntools
+            && !memcmp(tools, s->tools, sizeof(CANON_TOOL_TABLE) * idxmax)) {
+        free(tools);
+        Py_INCREF(s->cache[CACHE_TOOL_TABLE]);
+        return s->cache[CACHE_TOOL_TABLE];
+    }
+    free(s->tools);
+    s->tools = tools;
+    s->ntools = idxmax;
+
+    res = PyTuple_New(idxmax);
+    for(int idx=0; idx < idxmax; idx++) {
+        struct CANON_TOOL_TABLE &t = tools[idx];
         PyObject *tool = PyStructSequence_New(&ToolResultType);
         PyStructSequence_SET_ITEM(tool,  0, PyLong_FromLong(t.toolno));
         PyStructSequence_SET_ITEM(tool,  1, PyFloat_FromDouble(t.offset.tran.x));
@@ -789,44 +879,89 @@ static PyObject *Stat_tool_table(pyStatChannel *s) {
         j++;
     }
     _PyTuple_Resize(&res, j);
+    Py_XSETREF(s->cache[CACHE_TOOL_TABLE], res);
+    Py_XINCREF(res);
     return res;
 }
 
+struct stat_cached_attr {
+    PyObject *(*make)(pyStatChannel *);
+    bool dicts;         // a tuple of dicts, handed out as fresh copies
+};
+
+static const stat_cached_attr cached_attrs[CACHE_SLOTS] = {
+    {Stat_g5x_offset}, {Stat_g92_offset}, {Stat_tool_offset},
+    {Stat_activegcodes}, {Stat_activemcodes}, {Stat_activesettings},
+    {Stat_position}, {Stat_dtg}, {Stat_actual}, {Stat_probed},
+    {Stat_joint, true}, {Stat_joint_position}, {Stat_joint_actual},
+    {Stat_limit}, {Stat_homed}, {Stat_axis, true}, {Stat_spindle, true},
+    {Stat_din}, {Stat_dout}, {Stat_ain}, {Stat_aout}, {Stat_misc_error},
+    {Stat_tool_table},
+};
+
+// getter for the attributes that are converted once per change of the
+// status they come from
+static PyObject *Stat_cached(pyStatChannel *s, void *closure) {
+    int slot = (const stat_cached_attr *)closure - cached_attrs;
+    PyObject *&v = s->cache[slot];
+    if(!v && !(v = cached_attrs[slot].make(s))) return NULL;
+    if(!cached_attrs[slot].dicts) {
+        Py_INCREF(v);
+        return v;
+    }
+    Py_ssize_t n = PyTuple_GET_SIZE(v);
+    PyObject *res = PyTuple_New(n);
+    if(!res) return NULL;
+    for(Py_ssize_t i = 0; i < n; i++) {
+        PyObject *d = PyDict_Copy(PyTuple_GET_ITEM(v, i));
+        if(!d) {
+            Py_DECREF(res);
+            return NULL;
+        }
+        PyTuple_SET_ITEM(res, i, d);
+    }
+    return res;
+}
+#define CACHED(slot) (getter)Stat_cached, (setter)NULL, NULL, (void*)&cached_attrs[slot]
+
 static PyGetSetDef Stat_getsetlist[] = {
-    {(char*)"actual_position", (getter)Stat_actual},
-    {(char*)"ain", (getter)Stat_ain},
-    {(char*)"aout", (getter)Stat_aout},
-    {(char*)"joint", (getter)Stat_joint},
-    {(char*)"axis", (getter)Stat_axis},
-    {(char*)"spindle", (getter)Stat_spindle},
-    {(char*)"din", (getter)Stat_din},
-    {(char*)"dout", (getter)Stat_dout},
-    {(char*)"gcodes", (getter)Stat_activegcodes},
-    {(char*)"homed", (getter)Stat_homed, (setter)NULL,
-        (char*)"An array of integers indicating the 'homed' status of each joint (0 or 1)."
+    {(char*)"actual_position", CACHED(CACHE_ACTUAL)},
+    {(char*)"ain", CACHED(CACHE_AIN)},
+    {(char*)"aout", CACHED(CACHE_AOUT)},
+    {(char*)"joint", CACHED(CACHE_JOINT)},
+    {(char*)"axis", CACHED(CACHE_AXIS)},
+    {(char*)"spindle", CACHED(CACHE_SPINDLE)},
+    {(char*)"din", CACHED(CACHE_DIN)},
+    {(char*)"dout", CACHED(CACHE_DOUT)},
+    {(char*)"gcodes", CACHED(CACHE_GCODES)},
+    {(char*)"homed", (getter)Stat_cached, (setter)NULL,
+        (char*)"An array of integers indicating the 'homed' status of each joint (0 or 1).",
+        (void*)&cached_attrs[CACHE_HOMED]
     },
-    {(char*)"limit", (getter)Stat_limit},
-    {(char*)"mcodes", (getter)Stat_activemcodes},
-    {(char*)"misc_error", (getter)Stat_misc_error},
-    {(char*)"g5x_offset", (getter)Stat_g5x_offset},
+    {(char*)"limit", CACHED(CACHE_LIMIT)},
+    {(char*)"mcodes", CACHED(CACHE_MCODES)},
+    {(char*)"misc_error", CACHED(CACHE_MISC_ERROR)},
+    {(char*)"g5x_offset", CACHED(CACHE_G5X_OFFSET)},
     {(char*)"g5x_index", (getter)Stat_g5x_index},
-    {(char*)"g92_offset", (getter)Stat_g92_offset},
-    {(char*)"position", (getter)Stat_position},
-    {(char*)"dtg", (getter)Stat_dtg},
-    {(char*)"joint_position", (getter)Stat_joint_position},
-    {(char*)"joint_actual_position", (getter)Stat_joint_actual},
-    {(char*)"probed_position", (getter)Stat_probed},
-    {(char*)"settings", (getter)Stat_activesettings, (setter)NULL,
+    {(char*)"g92_offset", CACHED(CACHE_G92_OFFSET)},
+    {(char*)"position", CACHED(CACHE_POSITION)},
+    {(char*)"dtg", CACHED(CACHE_DTG)},
+    {(char*)"joint_position", CACHED(CACHE_JOINT_POSITION)},
+    {(char*)"joint_actual_position", CACHED(CACHE_JOINT_ACTUAL)},
+    {(char*)"probed_position", CACHED(CACHE_PROBED)},
+    {(char*)"settings", (getter)Stat_cached, (setter)NULL,
         (char*)"This is an array containing the Interp active settings: sequence number,\n"
-        "feed rate, spindle speed, and G64 blend and naive CAM tolerances."
+        "feed rate, spindle speed, and G64 blend and naive CAM tolerances.",
+        (void*)&cached_attrs[CACHE_SETTINGS]
     },
-    {(char*)"tool_offset", (getter)Stat_tool_offset},
+    {(char*)"tool_offset", CACHED(CACHE_TOOL_OFFSET)},
     {(char*)"tool_table", (getter)Stat_tool_table, (setter)NULL,
         (char*)"The tooltable, expressed as a list of tools.  Each tool is a dict with the\n"
         "tool id (tool number), diameter, offsets, etc."
     },
     {NULL}
 };
+#undef CACHED
 
 static PyTypeObject Stat_Type = {
     PyVarObject_HEAD_INIT(NULL, 0)
@@ -2099,23 +2234,49 @@ struct logger_point {
 };
 
 #define NUMCOLORS (6)
-#define MAX_POINTS (100000)
+// Points are kept in chunks that are never moved or resized, so each
+// can sit in a GL buffer of its own and only the last one, still being
+// filled, has to be uploaded again.  A chunk starts with a copy of the
+// last point of the one before, which joins up their line strips.
+#define CHUNK_POINTS (8192)
+// There is no cap on the number of points.  Instead, when there are
+// more than the budget, the tolerance of the thinning doubles and the
+// points so far are thinned again with it.
+#define POINT_BUDGET (1000000)
+#define MAX_EPSILON (1e-2)
+
+struct logger_chunk {
+    int n;
+    GLuint vbo;
+    int uploaded; // points in vbo, -1 when it needs uploading
+    struct logger_point p[CHUNK_POINTS];
+};
+
 typedef struct {
     PyObject_HEAD
-    int npts, mpts, lpts;
-    struct logger_point *p;
+    int npts, lpts;
+    struct logger_chunk **chunks;
+    int nchunks, mchunks; // in use, allocated (kept over a clear)
+    int budget;
+    double epsilon;
     struct color colors[NUMCOLORS];
-    bool exit, clear, changed;
+    bool exit, clear;
     char *geometry;
     int is_xyuv;
     double foam_z, foam_w;
     pyStatChannel *st;
+    // the tool path ring of motion, when there is one
+    pathring_t *ring;
+    int ring_module, ring_shmem;
+    unsigned long ring_tail;
+    pathring_sample_t *ring_copy;
+    GLXContext vbo_context; // where the chunk buffers were made
 } pyPositionLogger;
 
-static const double epsilon = 1e-4; // 1-cos(1 deg) ~= 1e-4
+static const double initial_epsilon = 1e-4; // 1-cos(1 deg) ~= 1e-4
 static const double tiny = 1e-10;
 
-static inline bool colinear(float xa, float ya, float za, float xb, float yb, float zb, float xc, float yc, float zc) {
+static inline bool colinear(float xa, float ya, float za, float xb, float yb, float zb, float xc, float yc, float zc, double epsilon) {
     double dx1 = xa-xb, dx2 = xb-xc;
     double dy1 = ya-yb, dy2 = yb-yc;
     double dz1 = za-zb, dz2 = zb-zc;
@@ -2135,11 +2296,15 @@ static void UNLOCK() { pthread_mutex_unlock(&mutex); }
 static int Logger_init(pyPositionLogger *self, PyObject *a, PyObject *k) {
     char *geometry;
     struct color *c = self->colors;
-    self->p = (logger_point*)malloc(0);
-    self->npts = self->mpts = 0;
+    self->chunks = 0;
+    self->npts = self->lpts = self->nchunks = self->mchunks = 0;
+    self->budget = POINT_BUDGET;
+    self->epsilon = initial_epsilon;
     self->exit = self->clear = 0;
-    self->changed = 1;
     self->st = 0;
+    self->ring = 0;
+    self->ring_copy = 0;
+    self->vbo_context = 0;
     self->is_xyuv = 0;
     self->foam_z = 0;
     self->foam_w = 1.5;  // temporarily hard-code
@@ -2160,7 +2325,15 @@ static int Logger_init(pyPositionLogger *self, PyObject *a, PyObject *k) {
 }
 
 static void Logger_dealloc(pyPositionLogger *s) {
-    free(s->p);
+    // without their context current, the GL buffers go with the context
+    bool delete_vbos = s->vbo_context && glXGetCurrentContext() == s->vbo_context;
+    for(int i = 0; i < s->mchunks; i++) {
+        if(delete_vbos && s->chunks[i]->vbo)
+            glDeleteBuffers(1, &s->chunks[i]->vbo);
+        free(s->chunks[i]);
+    }
+    free(s->chunks);
+    free(s->ring_copy);
     Py_XDECREF(s->st);
     free(s->geometry);
     PyObject_Del(s);
@@ -2210,6 +2383,239 @@ static double dist2(double x1, double y1, double x2, double y2) {
     return dx*dx + dy*dy;
 }
 
+// the k-th point from the end, k >= 1; there must be at least k points
+static struct logger_point *logger_back(pyPositionLogger *s, int k) {
+    int i = s->nchunks - 1;
+    // but for the first, the points of a chunk are its own
+    while(k > s->chunks[i]->n) {
+        k -= s->chunks[i]->n - 1;
+        i--;
+    }
+    return &s->chunks[i]->p[s->chunks[i]->n - k];
+}
+
+// add a point at the end, false when out of memory.  The point is in
+// place before the count that makes Logger_call draw it goes up.
+static bool logger_append(pyPositionLogger *s, const struct logger_point &p) {
+    struct logger_chunk *c = s->nchunks ? s->chunks[s->nchunks-1] : 0;
+    if(!c || c->n == CHUNK_POINTS) {
+        if(s->nchunks == s->mchunks) {
+            struct logger_chunk *nc = (struct logger_chunk*)
+                malloc(sizeof(struct logger_chunk));
+            if(!nc) return false;
+            nc->vbo = 0;
+            LOCK();
+            struct logger_chunk **chunks = (struct logger_chunk**)
+                realloc(s->chunks, sizeof(*chunks) * (s->mchunks + 1));
+            if(chunks) {
+                s->chunks = chunks;
+                s->chunks[s->mchunks++] = nc;
+            }
+            UNLOCK();
+            if(!chunks) {
+                free(nc);
+                return false;
+            }
+        }
+        struct logger_chunk *nc = s->chunks[s->nchunks];
+        nc->n = 0;
+        nc->uploaded = -1;
+        if(c) nc->p[nc->n++] = c->p[c->n-1];
+        LOCK();
+        s->nchunks++;
+        UNLOCK();
+        c = nc;
+    }
+    c->p[c->n] = p;
+    LOCK();
+    c->n++;
+    UNLOCK();
+    s->npts++;
+    return true;
+}
+
+// whether b adds nothing to the line from a to c
+static bool logger_redundant(pyPositionLogger *s, struct logger_point *a,
+        struct logger_point *b, struct logger_point *c) {
+    if(a->c != b->c || b->c != c->c) return false;
+    if(!colinear(c->x, c->y, c->z, b->x, b->y, b->z, a->x, a->y, a->z,
+                s->epsilon))
+        return false;
+    if(s->is_xyuv) {
+        if(dist2(c->x, c->y, a->x, a->y) > .01
+                || dist2(c->rx, c->ry, a->rx, a->ry) > .01)
+            return false;
+        if(!colinear(c->rx, c->ry, c->rz, b->rx, b->ry, b->rz,
+                    a->rx, a->ry, a->rz, s->epsilon))
+            return false;
+    }
+    return true;
+}
+
+// thin all points with the current tolerance, with the lock held
+static void logger_thin(pyPositionLogger *s) {
+    for(int i = 0; i < s->nchunks; i++) {
+        struct logger_chunk *c = s->chunks[i];
+        // the first and last point are shared with the chunks around
+        int k = 1;
+        for(int j = 1; j < c->n - 1; j++)
+            if(!logger_redundant(s, &c->p[k-1], &c->p[j], &c->p[j+1]))
+                c->p[k++] = c->p[j];
+        if(c->n > 1) c->p[k++] = c->p[c->n-1];
+        s->npts -= c->n - k;
+        c->n = k;
+        c->uploaded = -1;
+    }
+}
+
+static void logger_add(pyPositionLogger *s, const double pt[9], int motion_type) {
+    int colornum = motion_type;
+    if(colornum < 0 || colornum > NUMCOLORS) colornum = 0;
+    struct color c = s->colors[colornum];
+    struct logger_point *op = s->npts > 0 ? logger_back(s, 1) : 0;
+    struct logger_point *oop = s->npts > 1 ? logger_back(s, 2) : 0;
+    bool add_point = s->npts < 2 || c != op->c;
+    double x, y, z, rx, ry, rz;
+    if(s->is_xyuv) {
+        x = pt[0], y = pt[1], z = s->foam_z;
+        rx = pt[6], ry = pt[7], rz = s->foam_w;
+        /* TODO .01, the distance at which a preview line is dropped,
+         * should either be dependent on units or configurable, because
+         * 0.1 is inappropriate for mm systems
+         */
+        add_point = add_point || (dist2(x, y, oop->x, oop->y) > .01)
+            || (dist2(rx, ry, oop->rx, oop->ry) > .01);
+        add_point = add_point || !colinear( x, y, z,
+                        op->x, op->y, op->z,
+                        oop->x, oop->y, oop->z, s->epsilon);
+        add_point = add_point || !colinear( rx, ry, rz,
+                        op->rx, op->ry, op->rz,
+                        oop->rx, oop->ry, oop->rz, s->epsilon);
+    } else {
+        double p[3];
+        vertex9(pt, p, s->geometry);
+        x = p[0]; y = p[1]; z = p[2];
+        rx = pt[3]; ry = -pt[4]; rz = pt[5];
+
+        add_point = add_point || !colinear( x, y, z,
+                        op->x, op->y, op->z,
+                        oop->x, oop->y, oop->z, s->epsilon);
+    }
+    if(add_point) {
+        struct logger_point np;
+        if(s->npts && c != op->c) {
+            np.x = op->x; np.y = op->y; np.z = op->z;
+            np.rx = rx; np.ry = ry; np.rz = rz;
+            np.c = np.c2 = c;
+            if(!logger_append(s, np)) return;
+        }
+        np.x = x; np.y = y; np.z = z;
+        np.rx = rx; np.ry = ry; np.rz = rz;
+        np.c = np.c2 = c;
+        if(!logger_append(s, np)) return;
+        if(s->npts > s->budget) {
+            LOCK();
+            if(s->epsilon < MAX_EPSILON) {
+                s->epsilon *= 2;
+                logger_thin(s);
+            }
+            // what thinning does not get much smaller needs the memory
+            if(s->npts > s->budget / 4 * 3)
+                s->budget *= 2;
+            UNLOCK();
+        }
+    } else {
+        // the number of points stays the same, so Logger_call has to be
+        // told the chunks holding the moved point need uploading again
+        LOCK();
+        op->x = x; op->y = y; op->z = z;
+        op->rx = rx; op->ry = ry; op->rz = rz;
+        struct logger_chunk *last = s->chunks[s->nchunks-1];
+        last->uploaded = -1;
+        // op is the copy that starts the last chunk; keep the original
+        // at the end of the chunk before in step
+        if(last->n == 1 && s->nchunks > 1) {
+            struct logger_chunk *prev = s->chunks[s->nchunks-2];
+            prev->p[prev->n-1] = *op;
+            prev->uploaded = -1;
+        }
+        UNLOCK();
+    }
+}
+
+// whether motion's tool path ring exists: 1 yes, 0 no, -1 can't tell.
+// Mapping it with rtapi_shmem_new() would create it, too small for
+// motion to use; only with uspace can it be looked up without that.
+static int logger_ring_exists() {
+#if defined(RTAPI_USPACE)
+    return shmget(PATHRING_SHMEM_KEY, 0, 0) != -1;
+#else
+    return -1;
+#endif
+}
+
+// map motion's tool path ring, if it has one
+static void logger_attach(pyPositionLogger *s) {
+    void *mem;
+    int id = rtapi_init("backplot");
+    if(id < 0) return;
+    // map the header to learn the size of the whole segment
+    int shmem_id = rtapi_shmem_new(PATHRING_SHMEM_KEY, id, sizeof(pathring_t));
+    if(shmem_id >= 0 && rtapi_shmem_getptr(shmem_id, &mem) == 0) {
+        pathring_t *pr = (pathring_t*)mem;
+        unsigned int size = pr->size;
+        if(__atomic_load_n(&pr->magic, __ATOMIC_ACQUIRE) == PATHRING_MAGIC
+                && size > sizeof(pathring_t)) {
+            rtapi_shmem_delete(shmem_id, id);
+            shmem_id = rtapi_shmem_new(PATHRING_SHMEM_KEY, id, size);
+            if(shmem_id >= 0 && rtapi_shmem_getptr(shmem_id, &mem) == 0) {
+                pr = (pathring_t*)mem;
+                s->ring_copy = (pathring_sample_t*)realloc(s->ring_copy,
+                        sizeof(pathring_sample_t) * pr->samples);
+                if(s->ring_copy) {
+                    s->ring = pr;
+                    s->ring_module = id;
+                    s->ring_shmem = shmem_id;
+                    s->ring_tail = __atomic_load_n(&pr->head, __ATOMIC_ACQUIRE);
+                    return;
+                }
+            }
+        }
+    }
+    if(shmem_id >= 0) rtapi_shmem_delete(shmem_id, id);
+    rtapi_exit(id);
+}
+
+static void logger_detach(pyPositionLogger *s) {
+    if(!s->ring) return;
+    rtapi_shmem_delete(s->ring_shmem, s->ring_module);
+    rtapi_exit(s->ring_module);
+    s->ring = 0;
+}
+
+// add what motion put in the ring since the last call
+static void logger_drain(pyPositionLogger *s) {
+    pathring_t *pr = s->ring;
+    unsigned long n = pr->samples;
+    unsigned long head = __atomic_load_n(&pr->head, __ATOMIC_ACQUIRE);
+    unsigned long tail = s->ring_tail;
+    // more than a ring behind, the path gets a straight line over the gap
+    if(tail > head || head - tail > n)
+        tail = head > n ? head - n : 0;
+    unsigned long count = head - tail;
+    unsigned long first = tail % n;
+    unsigned long part = std::min(count, n - first);
+    memcpy(s->ring_copy, pathring_sample(pr, tail), part * sizeof(pathring_sample_t));
+    memcpy(s->ring_copy + part, pathring_sample(pr, 0), (count - part) * sizeof(pathring_sample_t));
+    // motion may have been writing over the oldest of them meanwhile
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    unsigned long now = __atomic_load_n(&pr->head, __ATOMIC_ACQUIRE);
+    unsigned long skip = now - tail >= n ? now - tail - n + 1 : 0;
+    for(unsigned long i = std::min(skip, count); i < count; i++)
+        logger_add(s, s->ring_copy[i].pos, s->ring_copy[i].motion_type);
+    s->ring_tail = head;
+}
+
 static PyObject *Logger_start(pyPositionLogger *s, PyObject *o) {
     double interval;
     struct timespec ts;
@@ -2224,114 +2630,47 @@ static PyObject *Logger_start(pyPositionLogger *s, PyObject *o) {
     s->clear = 0;
     s->npts = 0;
 
+    // motion may be loaded after the GUI starts, so look for its ring
+    // about once a second until there is one
+    int attach_every = interval > 0 && interval < 1 ? (int)(1 / interval) : 1;
+    int attach_wait = 0; // cycles to the next look, -1 for no more
+
     Py_BEGIN_ALLOW_THREADS
     while(!s->exit) {
+        if(!s->ring && attach_wait >= 0 && attach_wait-- == 0) {
+            int exists = logger_ring_exists();
+            if(exists) logger_attach(s);
+            attach_wait = exists < 0 ? -1 : attach_every;
+        }
         if(s->clear) {
+            LOCK();
             s->npts = 0;
             s->lpts = 0;
+            s->nchunks = 0;
+            s->budget = POINT_BUDGET;
+            s->epsilon = initial_epsilon;
             s->clear = 0;
+            UNLOCK();
         }
-        if(s->st->c->valid() && s->st->c->peek() == EMC_STAT_TYPE) {
+        if(s->ring) {
+            logger_drain(s);
+        } else if(s->st->c->valid() && s->st->c->peek() == EMC_STAT_TYPE) {
             EMC_STAT *status = static_cast<EMC_STAT*>(s->st->c->get_address());
-            int colornum = 2;
-            colornum = status->motion.traj.motion_type;
-            if(colornum < 0 || colornum > NUMCOLORS) colornum = 0;
-            struct color c = s->colors[colornum];
-            struct logger_point *op = &s->p[s->npts-1];
-            struct logger_point *oop = &s->p[s->npts-2];
-            bool add_point = s->npts < 2 || c != op->c;
-            double x, y, z, rx, ry, rz;
-            if(s->is_xyuv) {
-                x = status->motion.traj.position.tran.x - status->task.toolOffset.tran.x,
-                y = status->motion.traj.position.tran.y - status->task.toolOffset.tran.y,
-                z = s->foam_z;
-                rx = status->motion.traj.position.u - status->task.toolOffset.u,
-                ry = status->motion.traj.position.v - status->task.toolOffset.v,
-                rz = s->foam_w;
-                /* TODO .01, the distance at which a preview line is dropped,
-                 * should either be dependent on units or configurable, because
-                 * 0.1 is inappropriate for mm systems
-                 */
-                add_point = add_point || (dist2(x, y, oop->x, oop->y) > .01)
-                    || (dist2(rx, ry, oop->rx, oop->ry) > .01);
-                add_point = add_point || !colinear( x, y, z,
-                                op->x, op->y, op->z,
-                                oop->x, oop->y, oop->z);
-                add_point = add_point || !colinear( rx, ry, rz,
-                                op->rx, op->ry, op->rz,
-                                oop->rx, oop->ry, oop->rz);
-            } else {
-                double pt[9] = {
-                    status->motion.traj.position.tran.x - status->task.toolOffset.tran.x,
-                    status->motion.traj.position.tran.y - status->task.toolOffset.tran.y,
-                    status->motion.traj.position.tran.z - status->task.toolOffset.tran.z,
-                    status->motion.traj.position.a - status->task.toolOffset.a,
-                    status->motion.traj.position.b - status->task.toolOffset.b,
-                    status->motion.traj.position.c - status->task.toolOffset.c,
-                    status->motion.traj.position.u - status->task.toolOffset.u,
-                    status->motion.traj.position.v - status->task.toolOffset.v,
-                    status->motion.traj.position.w - status->task.toolOffset.w};
-
-                double p[3];
-                vertex9(pt, p, s->geometry);
-                x = p[0]; y = p[1]; z = p[2];
-                rx = pt[3]; ry = -pt[4]; rz = pt[5];
-
-                add_point = add_point || !colinear( x, y, z,
-                                op->x, op->y, op->z,
-                                oop->x, oop->y, oop->z);
-            }
-            if(add_point) {
-                // 1 or 2 points may be added, make room whenever
-                // fewer than 2 are left
-                bool changed_color = s->npts && c != op->c;
-                if(s->npts+2 > s->mpts) {
-                    LOCK();
-                    if(s->mpts >= MAX_POINTS) {
-                        int adjust = MAX_POINTS / 10;
-                        if(adjust < 2) adjust = 2;
-                        s->npts -= adjust;
-                        memmove(s->p, s->p + adjust,
-                                sizeof(struct logger_point) * s->npts);
-                    } else {
-                        s->mpts = 2 * s->mpts + 2;
-                        s->changed = 1;
-                        s->p = (struct logger_point*) realloc(s->p,
-                                    sizeof(struct logger_point) * s->mpts);
-                    }
-                    UNLOCK();
-                    op = &s->p[s->npts-1];
-                    oop = &s->p[s->npts-2];
-                }
-                if(changed_color) {
-                    {
-                    struct logger_point &np = s->p[s->npts];
-                    np.x = op->x; np.y = op->y; np.z = op->z;
-                    np.rx = rx; np.ry = ry; np.rz = rz;
-                    np.c = np.c2 = c;
-                    }
-                    {
-                    struct logger_point &np = s->p[s->npts+1];
-                    np.x = x; np.y = y; np.z = z;
-                    np.rx = rx; np.ry = ry; np.rz = rz;
-                    np.c = np.c2 = c;
-                    }
-                    s->npts += 2;
-                } else {
-                    struct logger_point &np = s->p[s->npts];
-                    np.x = x; np.y = y; np.z = z;
-                    np.rx = rx; np.ry = ry; np.rz = rz;
-                    np.c = np.c2 = c;
-                    s->npts++;
-                }
-            } else {
-                struct logger_point &np = s->p[s->npts-1];
-                np.x = x; np.y = y; np.z = z;
-                np.rx = rx; np.ry = ry; np.rz = rz;
-            }
+            double pt[9] = {
+                status->motion.traj.position.tran.x - status->task.toolOffset.tran.x,
+                status->motion.traj.position.tran.y - status->task.toolOffset.tran.y,
+                status->motion.traj.position.tran.z - status->task.toolOffset.tran.z,
+                status->motion.traj.position.a - status->task.toolOffset.a,
+                status->motion.traj.position.b - status->task.toolOffset.b,
+                status->motion.traj.position.c - status->task.toolOffset.c,
+                status->motion.traj.position.u - status->task.toolOffset.u,
+                status->motion.traj.position.v - status->task.toolOffset.v,
+                status->motion.traj.position.w - status->task.toolOffset.w};
+            logger_add(s, pt, status->motion.traj.motion_type);
         }
         nanosleep(&ts, NULL);
     }
+    logger_detach(s);
     Py_END_ALLOW_THREADS
     Py_DECREF(s->st);
     Py_INCREF(Py_None);
@@ -2353,31 +2692,37 @@ static PyObject* Logger_stop(pyPositionLogger *s, PyObject *o) {
 static PyObject* Logger_call(pyPositionLogger *s, PyObject *o) {
     if(!s->clear) {
         LOCK();
-        if(s->is_xyuv) {
-            if(s->changed) {
-                glVertexPointer(3, GL_FLOAT,
-                        sizeof(struct logger_point)/2, &s->p->x);
-                glColorPointer(4, GL_UNSIGNED_BYTE,
-                        sizeof(struct logger_point)/2, &s->p->c);
-                glEnableClientState(GL_COLOR_ARRAY);
-                glEnableClientState(GL_VERTEX_ARRAY);
-                s->changed = 0;
+        // in xyuv mode each point is a line from xyz to uvw
+        GLsizei stride = s->is_xyuv ? sizeof(struct logger_point)/2
+                : sizeof(struct logger_point);
+        glEnableClientState(GL_COLOR_ARRAY);
+        glEnableClientState(GL_VERTEX_ARRAY);
+        for(int i = 0; i < s->nchunks; i++) {
+            struct logger_chunk *c = s->chunks[i];
+            int n = c->n;
+            if(!c->vbo) {
+                glGenBuffers(1, &c->vbo);
+                s->vbo_context = glXGetCurrentContext();
             }
-            s->lpts = s->npts;
-            glDrawArrays(GL_LINES, 0, 2*s->npts);
-        } else {
-            if(s->changed) {
-                glVertexPointer(3, GL_FLOAT,
-                        sizeof(struct logger_point), &s->p->x);
-                glColorPointer(4, GL_UNSIGNED_BYTE,
-                        sizeof(struct logger_point), &s->p->c);
-                glEnableClientState(GL_COLOR_ARRAY);
-                glEnableClientState(GL_VERTEX_ARRAY);
-                s->changed = 0;
+            glBindBuffer(GL_ARRAY_BUFFER, c->vbo);
+            if(c->uploaded != n) {
+                glBufferData(GL_ARRAY_BUFFER, sizeof(struct logger_point) * n,
+                        c->p, i == s->nchunks-1 ? GL_STREAM_DRAW : GL_STATIC_DRAW);
+                c->uploaded = n;
             }
-            s->lpts = s->npts;
-            glDrawArrays(GL_LINE_STRIP, 0, s->npts);
+            glVertexPointer(3, GL_FLOAT, stride,
+                    (void*)offsetof(struct logger_point, x));
+            glColorPointer(4, GL_UNSIGNED_BYTE, stride,
+                    (void*)offsetof(struct logger_point, c));
+            if(s->is_xyuv)
+                glDrawArrays(GL_LINES, 0, 2*n);
+            else
+                glDrawArrays(GL_LINE_STRIP, 0, n);
         }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glDisableClientState(GL_VERTEX_ARRAY);
+        glDisableClientState(GL_COLOR_ARRAY);
+        s->lpts = s->npts;
         UNLOCK();
     }
     Py_INCREF(Py_None);
@@ -2390,12 +2735,12 @@ static PyObject *Logger_last(pyPositionLogger *s, PyObject *o) {
     PyObject *result = NULL;
     LOCK();
     int idx = flag ? s->lpts : s->npts;
-    if(!idx) {
+    if(!idx || idx > s->npts) {
         Py_INCREF(Py_None);
         result = Py_None;
     } else {
         result = PyTuple_New(6);
-        struct logger_point &p = s->p[idx-1];
+        struct logger_point &p = *logger_back(s, s->npts - idx + 1);
         PyTuple_SET_ITEM(result, 0, PyFloat_FromDouble(p.x));
         PyTuple_SET_ITEM(result, 1, PyFloat_FromDouble(p.y));
         PyTuple_SET_ITEM(result, 2, PyFloat_FromDouble(p.z));
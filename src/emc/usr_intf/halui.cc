@@ -200,6 +200,7 @@ static int axis_mask = 0;
     ARRAY(hal_bit_t,mdi_commands,MDI_MAX) \
 \
     FIELD(hal_float_t,units_per_mm) \
+    FIELD(hal_float_t,command_latency) /* seconds until Task echoed the last command */ \
 
 struct PTR {
     template<class T>
@@ -266,6 +267,16 @@ static double receiveTimeout = 10.0;
 // how long to wait for Task to finish running our command
 static double doneTimeout = 60.;
 
+// How often to look for HAL input changes and Task progress: every
+// pollMin seconds after something happened, backing off to every pollMax
+// seconds while nothing does.  [HALUI]POLL_MIN, [HALUI]POLL_MAX
+static double pollMin = 0.001;
+static double pollMax = 0.02;
+static double pollInterval = 0.001;
+
+// when the change that led to the command being sent was seen
+static double commandStart = 0.;
+
 static void quit(int sig)
 {
     done = 1;
@@ -399,12 +410,23 @@ static int updateStatus()
 }
 
 
-#define EMC_COMMAND_DELAY   0.1	// how long to sleep between checks
+static void pollActivity()
+{
+    pollInterval = pollMin;
+}
+
+static void pollSleep()
+{
+    esleep(pollInterval);
+    pollInterval *= 2;
+    if (pollInterval > pollMax) pollInterval = pollMax;
+}
 
 static int emcCommandWaitDone()
 {
-    double end;
-    for (end = 0.0; end < doneTimeout; end += EMC_COMMAND_DELAY) {
+    double start = etime();
+    pollActivity();
+    for (; etime() - start < doneTimeout; pollSleep()) {
 	updateStatus();
 	int serial_diff = emcStatus->echo_serial_number - emcCommandSerialNumber;
 
@@ -423,8 +445,6 @@ static int emcCommandWaitDone()
 	if (emcStatus->status == RCS_STATUS::ERROR) {
 	    return -1;
 	}
-
-	esleep(EMC_COMMAND_DELAY);
     }
 
     return -1;
@@ -440,16 +460,16 @@ static int emcCommandSend(RCS_CMD_MSG & cmd)
     emcCommandSerialNumber = cmd.serial_number;
 
     // wait for receive
-    double end;
-    for (end = 0.0; end < receiveTimeout; end += EMC_COMMAND_DELAY) {
+    double start = etime();
+    pollActivity();
+    for (; etime() - start < receiveTimeout; pollSleep()) {
 	updateStatus();
 	int serial_diff = emcStatus->echo_serial_number - emcCommandSerialNumber;
 
 	if (serial_diff >= 0) {
+	    *(halui_data->command_latency) = etime() - commandStart;
 	    return 0;
 	}
-
-	esleep(EMC_COMMAND_DELAY);
     }
 
     rtapi_print("halui: %s: no echo from Task after %.3f seconds\n", __func__, receiveTimeout);
@@ -576,6 +596,8 @@ int halui_hal_init(void)
 
     retval =  hal_pin_float_newf(HAL_OUT, &(halui_data->units_per_mm), comp_id, "halui.machine.units-per-mm");
     if (retval < 0) return retval;
+    retval =  hal_pin_float_newf(HAL_OUT, &(halui_data->command_latency), comp_id, "halui.command-latency");
+    if (retval < 0) return retval;
     retval = halui_export_pin_OUT_bit(&(halui_data->machine_is_on), "halui.machine.is-on");
     if (retval < 0) return retval;
     retval = halui_export_pin_OUT_bit(&(halui_data->estop_is_activated), "halui.estop.is-activated");
@@ -1539,6 +1561,11 @@ static int iniLoad(const char *filename)
 	}
     }
 
+    inifile.Find(&pollMin, "POLL_MIN", "HALUI");
+    inifile.Find(&pollMax, "POLL_MAX", "HALUI");
+    if (pollMin <= 0.0) pollMin = 0.001;
+    if (pollMax < pollMin) pollMax = pollMin;
+
     std::optional<const char*> mc;
     while(num_mdi_commands < MDI_MAX && (mc = inifile.Find("MDI_COMMAND", "HALUI", num_mdi_commands+1))) {
         mdi_commands[num_mdi_commands++] = strdup(*mc);
@@ -1661,6 +1688,58 @@ static bool jogging_selected_axis(local_halui_str &hal) {
 
 // this function looks if any of the hal pins has changed
 // and sends appropriate messages if so
+// Compares the pin values bitwise, so a NaN doesn't count as a change.
+static bool hal_data_changed(const local_halui_str &a, const local_halui_str &b)
+{
+    int x;
+#define FIELD(t,f) if (memcmp(&a.f, &b.f, sizeof(a.f))) return true;
+#define ARRAY(t,f,n) for (x = 0; x < n; x++) if (memcmp(&a.f[x], &b.f[x], sizeof(a.f[x]))) return true;
+    HAL_FIELDS
+#undef FIELD
+#undef ARRAY
+    return false;
+}
+
+// the pin values check_hal_changes() last acted on
+static local_halui_str checked_halui_data;
+
+// Returns once a HAL pin changes, Task makes progress on a command or
+// changes state, or pollMax has passed since the pins were last
+// updated.  Only halui writes its output pins, so any change is an
+// input changing.  Returns true if the pins need checking again.
+static bool wait_for_changes()
+{
+    local_halui_str seen, now;
+    int serial = emcStatus->echo_serial_number;
+    RCS_STATUS status = emcStatus->status;
+    EMC_TASK_STATE state = emcStatus->task.state;
+    EMC_TASK_MODE mode = emcStatus->task.mode;
+    EMC_TASK_INTERP interp = emcStatus->task.interpState;
+    double start = etime();
+
+    copy_hal_data(*halui_data, seen);
+    // modify_hal_pins() changed outputs since check_hal_changes() looked,
+    // and can't be told apart from an input that changed meanwhile
+    bool changed = hal_data_changed(seen, checked_halui_data);
+    while (!done) {
+        pollSleep();
+        copy_hal_data(*halui_data, now);
+        if (hal_data_changed(now, seen)) {
+            changed = true;
+            break;
+        }
+        updateStatus();
+        if (emcStatus->echo_serial_number != serial
+                || emcStatus->status != status
+                || emcStatus->task.state != state
+                || emcStatus->task.mode != mode
+                || emcStatus->task.interpState != interp) break;
+        if (etime() - start >= pollMax) return changed;
+    }
+    pollActivity();
+    return changed;
+}
+
 static void check_hal_changes()
 {
     hal_s32_t counts;
@@ -1675,6 +1754,7 @@ static void check_hal_changes()
     local_halui_str new_halui_data_mutable;
     copy_hal_data(*halui_data, new_halui_data_mutable);
     const local_halui_str &new_halui_data = new_halui_data_mutable;
+    checked_halui_data = new_halui_data;
 
 
     //check if machine_on pin has changed (the rest work exactly the same)
@@ -2377,6 +2457,7 @@ int main(int argc, char *argv[])
     /* catch SIGTERM too - the run script uses it to shut things down */
     signal(SIGTERM, quit);
 
+    bool pins_changed = true;
     while (!done) {
         static bool task_start_synced = 0;
         if (!task_start_synced) {
@@ -2387,9 +2468,12 @@ int main(int argc, char *argv[])
               task_start_synced = 1;
            }
         }
-        check_hal_changes(); //if anything changed send NML messages
+        if (pins_changed) {
+            commandStart = etime();
+            check_hal_changes(); //if anything changed send NML messages
+        }
         modify_hal_pins(); //if status changed modify HAL too
-        esleep(0.02); //sleep for a while
+        pins_changed = wait_for_changes(); //until something happens, or for a while
         updateStatus();
     }
     thisQuit();
@@ -0,0 +1,171 @@
+/********************************************************************
+* Description: nmlload.cc
+*   nml-tcp-load: puts a load of remote status readers on an NML
+*   server.  Each reader is a process of its own with its own
+*   connection, peeking emcStatus as fast as it can or at a fixed
+*   interval; at the end the reads, errors and peek latencies of all
+*   of them are summed up.
+*
+*   nml-tcp-load [-n readers] [-t seconds] [-i interval-ms]
+*                [-p process] nmlfile
+*
+*   The process (default xemc) must name the emcStatus buffer as REMOTE
+*   in nmlfile, as in configs/common/client.nml.
+*
+* License: GPL Version 2
+* System: Linux
+*
+* Copyright (c) 2026 All rights reserved.
+********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "rcs.hh"
+#include "emc.hh"
+#include "emc_nml.hh"
+#include "timer.hh"
+
+// latencies go into buckets of powers of two microseconds
+#define LATENCY_BUCKETS 32
+
+struct reader_result {
+    int connected;
+    long reads;
+    long errors;
+    double total_latency;
+    double max_latency;
+    long buckets[LATENCY_BUCKETS];
+};
+
+static void reader(const char *nmlfile, const char *process, double seconds,
+                   double interval, int fd)
+{
+    reader_result r;
+    memset(&r, 0, sizeof(r));
+
+    RCS_STAT_CHANNEL *stat =
+        new RCS_STAT_CHANNEL(emcFormat, "emcStatus", process, nmlfile);
+    if (stat->valid()) {
+        r.connected = 1;
+        double end = etime() + seconds;
+        while (etime() < end) {
+            double start = etime();
+            int type = stat->peek();
+            double latency = etime() - start;
+            if (type < 0) {
+                r.errors++;
+            } else {
+                r.reads++;
+            }
+            r.total_latency += latency;
+            if (latency > r.max_latency)
+                r.max_latency = latency;
+            int b = 0;
+            for (long us = (long) (latency * 1e6); us > 1 && b < LATENCY_BUCKETS - 1; us >>= 1)
+                b++;
+            r.buckets[b]++;
+            if (interval > latency)
+                esleep(interval - latency);
+        }
+    }
+    delete stat;
+    // smaller than PIPE_BUF, so results of readers do not interleave
+    if (write(fd, &r, sizeof(r)) != sizeof(r))
+        perror("nml-tcp-load: write");
+}
+
+// upper bound of the bucket the given fraction of peeks falls in, in us
+static long percentile(const reader_result &sum, long count, double fraction)
+{
+    long seen = 0;
+    for (int b = 0; b < LATENCY_BUCKETS; b++) {
+        seen += sum.buckets[b];
+        if (seen >= fraction * count)
+            return 2L << b;
+    }
+    return 2L << (LATENCY_BUCKETS - 1);
+}
+
+static void usage()
+{
+    fprintf(stderr, "usage: nml-tcp-load [-n readers] [-t seconds] "
+            "[-i interval-ms] [-p process] nmlfile\n");
+    exit(1);
+}
+
+int main(int argc, char **argv)
+{
+    int readers = 8;
+    double seconds = 5.0, interval = 0.0;
+    const char *process = "xemc";
+    int opt, fds[2];
+
+    while ((opt = getopt(argc, argv, "n:t:i:p:")) != -1) {
+        switch (opt) {
+        case 'n':
+            readers = atoi(optarg);
+            break;
+        case 't':
+            seconds = atof(optarg);
+            break;
+        case 'i':
+            interval = atof(optarg) / 1000.0;
+            break;
+        case 'p':
+            process = optarg;
+            break;
+        default:
+            usage();
+        }
+    }
+    if (optind != argc - 1 || readers < 1 || seconds <= 0)
+        usage();
+
+    if (pipe(fds) < 0) {
+        perror("nml-tcp-load: pipe");
+        return 1;
+    }
+    for (int i = 0; i < readers; i++) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("nml-tcp-load: fork");
+            return 1;
+        }
+        if (pid == 0) {
+            close(fds[0]);
+            reader(argv[optind], process, seconds, interval, fds[1]);
+            _exit(0);
+        }
+    }
+    close(fds[1]);
+
+    reader_result sum, r;
+    memset(&sum, 0, sizeof(sum));
+    while (read(fds[0], &r, sizeof(r)) == sizeof(r)) {
+        sum.connected += r.connected;
+        sum.reads += r.reads;
+        sum.errors += r.errors;
+        sum.total_latency += r.total_latency;
+        if (r.max_latency > sum.max_latency)
+            sum.max_latency = r.max_latency;
+        for (int b = 0; b < LATENCY_BUCKETS; b++)
+            sum.buckets[b] += r.buckets[b];
+    }
+    while (wait(NULL) > 0)
+        ;
+
+    long count = sum.reads + sum.errors;
+    printf("readers: %d connected of %d\n", sum.connected, readers);
+    printf("peeks: %ld (%.0f/s), errors: %ld\n", count, count / seconds, sum.errors);
+    if (count) {
+        printf("latency: mean %.0f us, 50%% < %ld us, 99%% < %ld us, max %.0f us\n",
+               sum.total_latency / count * 1e6, percentile(sum, count, 0.5),
+               percentile(sum, count, 0.99), sum.max_latency * 1e6);
+    }
+    return sum.connected == readers && sum.errors == 0 ? 0 : 1;
+}
@@ -30,7 +30,12 @@
     to configure up to 16 channels.  A second command line parameter
     "ctrl_type", selects between position and velocity control modes
     for each step generator.  (ctrl_type is optional, the default
-    control type is position.)
+    control type is position.)  A third control type, cubic, is
+    position control where the velocity, acceleration and jerk at the
+    start of each servo period come along with the position command,
+    as motion provides them.  'make_pulses' then follows that cubic
+    within the period, instead of a velocity that only changes once
+    per servo period.
 
     So a command line like this:
 
@@ -299,6 +304,7 @@
 
 #include "rtapi.h"		/* RTAPI realtime OS API */
 #include "rtapi_app.h"		/* RTAPI realtime module decls */
+#include "rtapi_atomic.h"
 #include "hal.h"		/* HAL public API decls */
 
 #include <float.h>
@@ -315,7 +321,7 @@ MODULE_LICENSE("GPL");
 int step_type[] = { [0 ... MAX_CHAN-1] = -1 } ;
 RTAPI_MP_ARRAY_INT(step_type,MAX_CHAN,"stepping types for up to 16 channels");
 char *ctrl_type[MAX_CHAN];
-RTAPI_MP_ARRAY_STRING(ctrl_type,MAX_CHAN,"control type (pos or vel) for up to 16 channels");
+RTAPI_MP_ARRAY_STRING(ctrl_type,MAX_CHAN,"control type (pos, vel or cubic) for up to 16 channels");
 int user_step_type[] = { [0 ... MAX_CYCLE-1] = -1 };
 RTAPI_MP_ARRAY_INT(user_step_type, MAX_CYCLE,
 	"lookup table for user-defined step type");
@@ -340,10 +346,22 @@ typedef struct {
     hal_s32_t rawcount;		/* param: position feedback in counts */
     int curr_dir;		/* current direction */
     int state;			/* current position in state table */
+    int poly_on;		/* addval follows poly_addval (cubic mode) */
+    long poly_addval;		/* addval for the next period */
+    long poly_d1;		/* change of poly_addval per period */
+    long poly_d2;		/* change of poly_d1 per period */
+    long poly_left;		/* periods until the polynomial runs out */
+    unsigned int poly_seq_used;	/* last polynomial taken from update_freq */
     /* stuff that is read but not written by makepulses */
     hal_bit_t *enable;		/* pin for enable stepgen */
     long target_addval;		/* desired freq generator add value */
     long deltalim;		/* max allowed change per period */
+    int next_poly_on;		/* polynomial for the coming servo period, */
+    long next_addval;		/* handed to makepulses under poly_seq, */
+    long next_d1;		/* which is odd while update_freq writes */
+    long next_d2;		/* them and even again once they are */
+    long next_periods;		/* complete */
+    unsigned int poly_seq;
     hal_u32_t step_len;		/* parameter: step pulse length */
     hal_u32_t dir_hold_dly;	/* param: direction hold time or delay */
     hal_u32_t dir_setup;	/* param: direction setup time */
@@ -354,6 +372,7 @@ typedef struct {
     const unsigned char *lut;	/* pointer to state lookup table */
     /* stuff that is not accessed by makepulses */
     int pos_mode;		/* 1 = position mode, 0 = velocity mode */
+    int cubic;			/* position mode following the cubic */
     hal_u32_t step_space;	/* parameter: min step pulse spacing */
     double old_pos_cmd;		/* previous position command (counts) */
     hal_s32_t *count;		/* pin: captured feedback in counts */
@@ -361,6 +380,8 @@ typedef struct {
     double old_scale;		/* stored scale value */
     double scale_recip;		/* reciprocal value used for scaling */
     hal_float_t *vel_cmd;	/* pin: velocity command (pos units/sec) */
+    hal_float_t *acc_cmd;	/* pin: acceleration command (cubic mode) */
+    hal_float_t *jerk_cmd;	/* pin: jerk command (cubic mode) */
     hal_float_t *pos_cmd;	/* pin: position command (position units) */
     hal_float_t *pos_fb;	/* pin: position feedback (position units) */
     hal_float_t freq;		/* param: frequency command */
@@ -424,13 +445,13 @@ static long old_dtns;		/* update_freq funct period in nsec */
 static double dt;		/* update_freq period in seconds */
 static double recip_dt;		/* recprocal of period, avoids divides */
 
-typedef enum CONTROL { POSITION, VELOCITY, INVALID } CONTROL;
+typedef enum CONTROL { POSITION, VELOCITY, CUBIC, INVALID } CONTROL;
 
 /***********************************************************************
 *                  LOCAL FUNCTION DECLARATIONS                         *
 ************************************************************************/
 
-static int export_stepgen(int num, stepgen_t * addr, int step_type, int pos_mode);
+static int export_stepgen(int num, stepgen_t * addr, int step_type, CONTROL ctrl);
 static void make_pulses(void *arg, long period);
 static void update_freq(void *arg, long period);
 static void update_pos(void *arg, long period);
@@ -460,7 +481,7 @@ int rtapi_app_main(void)
 	}
 	if(parse_ctrl_type(ctrl_type[n]) == INVALID) {
 	    rtapi_print_msg(RTAPI_MSG_ERR,
-			    "STEPGEN: ERROR: bad control type '%s' for axis %i (must be 'p' or 'v')\n",
+			    "STEPGEN: ERROR: bad control type '%s' for axis %i (must be 'p', 'v' or 'c')\n",
 			    ctrl_type[n], n);
 	    return -1;
 	}
@@ -502,7 +523,7 @@ int rtapi_app_main(void)
     for (n = 0; n < num_chan; n++) {
 	/* export all vars */
 	retval = export_stepgen(n, &(stepgen_array[n]),
-	    step_type[n], (parse_ctrl_type(ctrl_type[n]) == POSITION));
+	    step_type[n], parse_ctrl_type(ctrl_type[n]));
 	if (retval != 0) {
 	    rtapi_print_msg(RTAPI_MSG_ERR,
 		"STEPGEN: ERROR: stepgen %d var export failed\n", n);
@@ -560,6 +581,7 @@ static void make_pulses(void *arg, long period)
     stepgen_t *stepgen;
     long old_addval, target_addval, new_addval, step_now;
     int n, p;
+    unsigned int seq;
     unsigned char outbits;
 
     /* store period so scaling constants can be (re)calculated */
@@ -592,11 +614,43 @@ static void make_pulses(void *arg, long period)
 		stepgen->hold_dds = 0;
 	    }
 	}
+	/* take over a new polynomial from update_freq, if there is one.
+	   If update_freq is writing it right now, or wrote it again while
+	   we copied it, keep the old one and try again next period; on a
+	   single CPU update_freq can't finish while we wait for it */
+	seq = atomic_load_explicit(&stepgen->poly_seq, memory_order_acquire);
+	if ( seq != stepgen->poly_seq_used && !(seq & 1) ) {
+	    int on = stepgen->next_poly_on;
+	    long addval = stepgen->next_addval;
+	    long d1 = stepgen->next_d1;
+	    long d2 = stepgen->next_d2;
+	    long periods = stepgen->next_periods;
+	    atomic_thread_fence(memory_order_acquire);
+	    if ( atomic_load_explicit(&stepgen->poly_seq, memory_order_relaxed) == seq ) {
+		stepgen->poly_seq_used = seq;
+		stepgen->poly_on = on;
+		stepgen->poly_addval = addval;
+		stepgen->poly_d1 = d1;
+		stepgen->poly_d2 = d2;
+		stepgen->poly_left = periods;
+	    }
+	}
+	/* a cubic is only good for one servo period; if no new one came,
+	   don't extrapolate it but hold its end velocity with the ramp */
+	if ( stepgen->poly_on && stepgen->poly_left <= 0 ) {
+	    stepgen->poly_on = 0;
+	}
 	if ( !stepgen->hold_dds && *(stepgen->enable) ) {
 	    /* update addval (ramping) */
 	    old_addval = stepgen->addval;
 	    target_addval = stepgen->target_addval;
-	    if (stepgen->deltalim != 0) {
+	    if (stepgen->poly_on) {
+		/* follow the cubic, by forward differences */
+		new_addval = stepgen->poly_addval;
+		stepgen->poly_addval += stepgen->poly_d1;
+		stepgen->poly_d1 += stepgen->poly_d2;
+		stepgen->poly_left--;
+	    } else if (stepgen->deltalim != 0) {
 		/* implement accel/decel limit */
 		if (target_addval > (old_addval + stepgen->deltalim)) {
 		    /* new value is too high, increase addval as far as possible */
@@ -762,6 +816,57 @@ static unsigned long ulceil(unsigned long value, unsigned long increment)
     return increment*(((value-1)/increment)+1);
 }
 
+/* helper function - hands a polynomial (or none, with on = 0) to
+   make_pulses, which picks it up when it sees poly_seq change to a new
+   even value.  It is good for one period of this thread */
+static void publish_poly(stepgen_t *stepgen, int on, long addval, long d1, long d2)
+{
+    unsigned int seq = stepgen->poly_seq;
+
+    atomic_store_explicit(&stepgen->poly_seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    stepgen->next_poly_on = on;
+    stepgen->next_addval = addval;
+    stepgen->next_d1 = d1;
+    stepgen->next_d2 = d2;
+    /* the ratio of the thread periods is usually a whole number, which
+       rounding error must not push up to the next one */
+    stepgen->next_periods = ceil(dt / periodfp - 0.001);
+    atomic_store_explicit(&stepgen->poly_seq, seq + 2, memory_order_release);
+}
+
+/* helper function - sets up make_pulses to follow the cubic given by the
+   command pins over the coming servo period.  All values are in counts.
+   Returns 0 if the cubic can't be followed within the limits, from where
+   the motor is now; the position loop then takes over for this period */
+static int update_cubic(stepgen_t *stepgen, double pos_cmd, double curr_pos,
+    double max_freq, double max_ac)
+{
+    double vel, acc, jerk, vel_end, acc_end;
+
+    vel = *stepgen->vel_cmd * stepgen->pos_scale;
+    acc = *stepgen->acc_cmd * stepgen->pos_scale;
+    jerk = *stepgen->jerk_cmd * stepgen->pos_scale;
+    /* take up the position error (from step quantization, a direction
+       change hold, or a late thread) over this period */
+    vel += (pos_cmd - curr_pos) * recip_dt;
+    vel_end = vel + (acc + 0.5 * jerk * dt) * dt;
+    acc_end = acc + jerk * dt;
+    if (fabs(vel) > max_freq || fabs(vel_end) > max_freq ||
+	fabs(acc) > max_ac || fabs(acc_end) > max_ac ||
+	fabs(vel - stepgen->freq) > max_ac * dt) {
+	return 0;
+    }
+    /* addval is the distance moved in one makepulses period; for a cubic
+       its second difference changes linearly and the third is constant */
+    publish_poly(stepgen, 1,
+	(vel + (0.5 * acc + jerk * periodfp * (1.0 / 6.0)) * periodfp) * freqscale,
+	(acc + jerk * periodfp) * accelscale,
+	jerk * periodfp * accelscale);
+    stepgen->freq = vel_end;
+    return 1;
+}
+
 static void update_freq(void *arg, long period)
 {
     stepgen_t *stepgen;
@@ -869,6 +974,9 @@ static void update_freq(void *arg, long period)
 	    stepgen->freq = 0;
 	    stepgen->addval = 0;
 	    stepgen->target_addval = 0;
+	    if (stepgen->next_poly_on) {
+		publish_poly(stepgen, 0, 0, 0, 0);
+	    }
 	    /* and skip to next one */
 	    stepgen++;
 	    continue;
@@ -936,6 +1044,17 @@ static void update_freq(void *arg, long period)
 	    /* convert from fixed point to double, after subtracting
 	       the one-half step offset */
 	    curr_pos = (accum_a-(1<< (PICKOFF-1))) * (1.0 / (1L << PICKOFF));
+	    if (stepgen->cubic && update_cubic(stepgen, pos_cmd, curr_pos,
+		    max_freq, max_ac)) {
+		/* make_pulses follows the cubic for this period */
+		stepgen->deltalim = max_ac * accelscale;
+		stepgen->target_addval = stepgen->freq * freqscale;
+		stepgen++;
+		continue;
+	    }
+	    if (stepgen->next_poly_on) {
+		publish_poly(stepgen, 0, 0, 0, 0);
+	    }
 	    /* get velocity in counts/sec */
 	    curr_vel = stepgen->freq;
 	    /* At this point we have good values for pos_cmd, curr_pos,
@@ -1029,9 +1148,10 @@ static void update_freq(void *arg, long period)
 *                   LOCAL FUNCTION DEFINITIONS                         *
 ************************************************************************/
 
-static int export_stepgen(int num, stepgen_t * addr, int step_type, int pos_mode)
+static int export_stepgen(int num, stepgen_t * addr, int step_type, CONTROL ctrl)
 {
     int n, retval, msg;
+    int pos_mode = ctrl != VELOCITY;
 
     /* This function exports a lot of stuff, which results in a lot of
        logging if msg_level is at INFO or ALL. So we save the current value
@@ -1056,11 +1176,22 @@ static int export_stepgen(int num, stepgen_t * addr, int step_type, int pos_mode
     if ( pos_mode ) {
 	retval = hal_pin_float_newf(HAL_IN, &(addr->pos_cmd), comp_id,
 	    "stepgen.%d.position-cmd", num);
-    } else {
+	if (retval != 0) { return retval; }
+    }
+    if ( !pos_mode || ctrl == CUBIC ) {
 	retval = hal_pin_float_newf(HAL_IN, &(addr->vel_cmd), comp_id,
 	    "stepgen.%d.velocity-cmd", num);
+	if (retval != 0) { return retval; }
+    }
+    if ( ctrl == CUBIC ) {
+	/* the rest of the cubic, at the start of the servo period */
+	retval = hal_pin_float_newf(HAL_IN, &(addr->acc_cmd), comp_id,
+	    "stepgen.%d.acceleration-cmd", num);
+	if (retval != 0) { return retval; }
+	retval = hal_pin_float_newf(HAL_IN, &(addr->jerk_cmd), comp_id,
+	    "stepgen.%d.jerk-cmd", num);
+	if (retval != 0) { return retval; }
     }
-    if (retval != 0) { return retval; }
     /* export pin for enable command */
     retval = hal_pin_bit_newf(HAL_IN, &(addr->enable), comp_id,
 	"stepgen.%d.enable", num);
@@ -1145,6 +1276,7 @@ static int export_stepgen(int num, stepgen_t * addr, int step_type, int pos_mode
     addr->maxaccel = 0.0;
     addr->step_type = step_type;
     addr->pos_mode = pos_mode;
+    addr->cubic = ctrl == CUBIC;
     /* timing parameter defaults depend on step type */
     addr->step_len = 1;
     if ( step_type < 2 ) {
@@ -1184,6 +1316,18 @@ static int export_stepgen(int num, stepgen_t * addr, int step_type, int pos_mode
     *(addr->enable) = 0;
     addr->target_addval = 0;
     addr->deltalim = 0;
+    addr->poly_on = 0;
+    addr->poly_addval = 0;
+    addr->poly_d1 = 0;
+    addr->poly_d2 = 0;
+    addr->poly_left = 0;
+    addr->poly_seq_used = 0;
+    addr->next_poly_on = 0;
+    addr->next_addval = 0;
+    addr->next_d1 = 0;
+    addr->next_d2 = 0;
+    addr->next_periods = 0;
+    addr->poly_seq = 0;
     /* other init */
     addr->printed_error = 0;
     addr->old_pos_cmd = 0.0;
@@ -1192,9 +1336,14 @@ static int export_stepgen(int num, stepgen_t * addr, int step_type, int pos_mode
     *(addr->pos_fb) = 0.0;
     if ( pos_mode ) {
 	*(addr->pos_cmd) = 0.0;
-    } else {
+    }
+    if ( !pos_mode || ctrl == CUBIC ) {
 	*(addr->vel_cmd) = 0.0;
     }
+    if ( ctrl == CUBIC ) {
+	*(addr->acc_cmd) = 0.0;
+	*(addr->jerk_cmd) = 0.0;
+    }
     /* restore saved message level */
     rtapi_set_msg_level(msg);
     return 0;
@@ -1231,5 +1380,6 @@ static CONTROL parse_ctrl_type(const char *ctrl)
 {
     if(!ctrl || !*ctrl || *ctrl == 'p' || *ctrl == 'P') return POSITION;
     if(*ctrl == 'v' || *ctrl == 'V') return VELOCITY;
+    if(*ctrl == 'c' || *ctrl == 'C') return CUBIC;
     return INVALID;
 }
@@ -127,7 +127,11 @@ static void hm2_write(void *void_hm2, long period) {
     hostmot2_t *hm2 = void_hm2;
 
     // if there are comm problems, wait for the user to fix it
-    if ((*hm2->llio->io_error) != 0) return;
+    // (and then send all the TRAM registers again)
+    if ((*hm2->llio->io_error) != 0) {
+        hm2->tram_write_countdown = 0;
+        return;
+    }
 
     if (!hm2->ddr_initialized) {
         hm2_ioport_initialize_ddr(hm2);
@@ -407,6 +411,8 @@ static int hm2_parse_config_string(hostmot2_t *hm2, char *config_string) {
     hm2->config.num_oneshots = -1;
     hm2->config.num_periodms = -1;
     hm2->config.enable_raw = 0;
+    hm2->config.tram_read_gap = 0;
+    hm2->config.tram_write_changes = 0;
     hm2->config.firmware = NULL;
 
     if (config_string == NULL) return 0;
@@ -545,6 +551,14 @@ static int hm2_parse_config_string(hostmot2_t *hm2, char *config_string) {
         } else if (strncmp(token, "enable_raw", 10) == 0) {
             hm2->config.enable_raw = 1;
 
+        } else if (strncmp(token, "tram_read_gap=", 14) == 0) {
+            token += 14;
+            hm2->config.tram_read_gap = simple_strtol(token, NULL, 0);
+
+        } else if (strncmp(token, "tram_write_changes=", 19) == 0) {
+            token += 19;
+            hm2->config.tram_write_changes = simple_strtol(token, NULL, 0);
+
         } else if (strncmp(token, "firmware=", 9) == 0) {
             // FIXME: we leak this in hm2_register
             hm2->config.firmware = rtapi_kstrdup(token + 9, RTAPI_GFP_KERNEL);
@@ -585,6 +599,8 @@ static int hm2_parse_config_string(hostmot2_t *hm2, char *config_string) {
     HM2_DBG("    num_uarts=%d\n", hm2->config.num_uarts);
     HM2_DBG("    num_pktuarts=%d\n", hm2->config.num_pktuarts);
     HM2_DBG("    enable_raw=%d\n",   hm2->config.enable_raw);
+    HM2_DBG("    tram_read_gap=%d\n",   hm2->config.tram_read_gap);
+    HM2_DBG("    tram_write_changes=%d\n",   hm2->config.tram_write_changes);
     HM2_DBG("    firmware=%s\n",   hm2->config.firmware ? hm2->config.firmware : "(NULL)");
 
     rtapi_argv_free(argv);
@@ -1594,6 +1610,11 @@ int hm2_register(hm2_lowlevel_io_t *llio, char *config_string) {
         goto fail1;
     }
 
+    r = hm2_tram_export_hal(hm2);
+    if (r != 0) {
+        goto fail1;
+    }
+
 
     //
     // At this point, all non-TRAM register buffers have been initialized
@@ -1843,5 +1864,8 @@ void hm2_force_write(hostmot2_t *hm2) {
     hm2_outm_force_write(hm2);
     if (hm2->llio->set_force_enqueue != NULL)
         hm2->llio->set_force_enqueue(hm2->llio, 0);
+
+    // the FPGA may have been reset, so the next TRAM write sends everything
+    hm2->tram_write_countdown = 0;
 }
 
@@ -1193,12 +1193,15 @@ typedef struct {
         struct {
             hal_float_t *position_cmd;
             hal_float_t *velocity_cmd;
+            hal_float_t *acceleration_cmd;
+            hal_float_t *jerk_cmd;
             hal_s32_t *counts;
             hal_float_t *position_fb;
             hal_float_t *position_latch;
             hal_float_t *velocity_fb;
             hal_bit_t *enable;
             hal_bit_t *control_type;   // 0="position control", 1="velocity control"
+            hal_bit_t *cubic;          // position control following velocity/acceleration/jerk-cmd
             hal_bit_t *position_reset; // reset position when true
             hal_bit_t *index_enable;	
             hal_bit_t *index_polarity;
@@ -1601,14 +1604,52 @@ typedef struct {
 // this struct hold an entry in our Translation RAM region list
 //
 
+// writing a register of this region again with the value it already
+// holds has no effect, so with "tram_write_changes" it's only written
+// when it changes
+#define HM2_TRAM_STATE (1 << 0)
+
 typedef struct {
     rtapi_u16 addr;
     rtapi_u16 size;
     rtapi_u32 **buffer;
+    int flags;
+    int offset;         // of *buffer in the TRAM buffer
     struct rtapi_list_head list;
 } hm2_tram_entry_t;
 
 
+//
+// consecutive TRAM entries with contiguous (or, for reads, nearly
+// contiguous) addresses, merged so they're read or written with one
+// llio command
+//
+
+typedef struct {
+    rtapi_u16 addr;
+    rtapi_u16 size;
+    int flags;
+    int offset;
+    rtapi_u32 *buffer;
+} hm2_tram_burst_t;
+
+
+//
+// how much TRAM traffic the last read and write caused
+//
+
+typedef struct {
+    struct {
+        struct {
+            hal_u32_t *read_commands;
+            hal_u32_t *read_bytes;
+            hal_u32_t *write_commands;
+            hal_u32_t *write_bytes;
+        } pin;
+    } hal;
+} hm2_tram_stats_t;
+
+
 
 
 // 
@@ -1643,6 +1684,8 @@ typedef struct {
         int num_periodms;
         char sserial_modes[4][8];
         int enable_raw;
+        int tram_read_gap;
+        int tram_write_changes;
         char *firmware;
     } config;
 
@@ -1669,6 +1712,18 @@ typedef struct {
     rtapi_u32 *tram_write_buffer;
     rtapi_u16 tram_write_size;
 
+    hm2_tram_burst_t *tram_read_bursts;
+    int num_tram_read_bursts;
+    hm2_tram_burst_t *tram_write_bursts;
+    int num_tram_write_bursts;
+
+    // what the FPGA last got for the HM2_TRAM_STATE regions, and the
+    // number of writes until they're all sent again regardless
+    rtapi_u32 *tram_write_shadow;
+    int tram_write_countdown;
+
+    hm2_tram_stats_t *tram_stats;
+
     // the hostmot2 "Functions"
     hm2_encoder_t encoder;
     hm2_absenc_t absenc;
@@ -1745,7 +1800,9 @@ int hm2_get_pktuart(hostmot2_t **hm2, char *name);
 
 int hm2_register_tram_read_region(hostmot2_t *hm2, rtapi_u16 addr, rtapi_u16 size, rtapi_u32 **buffer);
 int hm2_register_tram_write_region(hostmot2_t *hm2, rtapi_u16 addr, rtapi_u16 size, rtapi_u32 **buffer);
+int hm2_register_tram_state_write_region(hostmot2_t *hm2, rtapi_u16 addr, rtapi_u16 size, rtapi_u32 **buffer);
 int hm2_allocate_tram_regions(hostmot2_t *hm2);
+int hm2_tram_export_hal(hostmot2_t *hm2);
 int hm2_tram_read(hostmot2_t *hm2);
 int hm2_finish_read(hostmot2_t *hm2);
 int hm2_queue_read(hostmot2_t *hm2);
@@ -84,7 +84,7 @@ int hm2_ioport_parse_md(hostmot2_t *hm2, int md_index) {
         goto fail0;
     }
 
-    r = hm2_register_tram_write_region(hm2, hm2->ioport.data_addr, (hm2->ioport.num_instances * sizeof(rtapi_u32)), &hm2->ioport.data_write_reg);
+    r = hm2_register_tram_state_write_region(hm2, hm2->ioport.data_addr, (hm2->ioport.num_instances * sizeof(rtapi_u32)), &hm2->ioport.data_write_reg);
     if (r < 0) {
         HM2_ERR("error registering tram write region for IOPort Data register (%d)\n", r);
         goto fail0;
@@ -219,31 +219,31 @@ int hm2_oneshot_parse_md(hostmot2_t *hm2, int md_index) {
     hm2->oneshot.control_addr = md->base_address + (5 * md->register_stride);
     hm2->oneshot.control_read_addr = md->base_address + (5 * md->register_stride);
 
-    r = hm2_register_tram_write_region(hm2, hm2->oneshot.width1_addr, (hm2->oneshot.num_instances * sizeof(rtapi_u32)), &hm2->oneshot.width1_reg);
+    r = hm2_register_tram_state_write_region(hm2, hm2->oneshot.width1_addr, (hm2->oneshot.num_instances * sizeof(rtapi_u32)), &hm2->oneshot.width1_reg);
     if (r < 0) {
         HM2_ERR("error registering tram write region for Width1 register (%d)\n", r);
         goto fail0;
     }
 
-    r = hm2_register_tram_write_region(hm2, hm2->oneshot.width2_addr, (hm2->oneshot.num_instances * sizeof(rtapi_u32)), &hm2->oneshot.width2_reg);
+    r = hm2_register_tram_state_write_region(hm2, hm2->oneshot.width2_addr, (hm2->oneshot.num_instances * sizeof(rtapi_u32)), &hm2->oneshot.width2_reg);
     if (r < 0) {
         HM2_ERR("error registering tram write region for Width2 register (%d)\n", r);
         goto fail0;
     }
 
-    r = hm2_register_tram_write_region(hm2, hm2->oneshot.filter1_addr, (hm2->oneshot.num_instances * sizeof(rtapi_u32)), &hm2->oneshot.filter1_reg);
+    r = hm2_register_tram_state_write_region(hm2, hm2->oneshot.filter1_addr, (hm2->oneshot.num_instances * sizeof(rtapi_u32)), &hm2->oneshot.filter1_reg);
     if (r < 0) {
         HM2_ERR("error registering tram write region for Filter1 register (%d)\n", r);
         goto fail0;
     }
 
-    r = hm2_register_tram_write_region(hm2, hm2->oneshot.filter2_addr, (hm2->oneshot.num_instances * sizeof(rtapi_u32)), &hm2->oneshot.filter2_reg);
+    r = hm2_register_tram_state_write_region(hm2, hm2->oneshot.filter2_addr, (hm2->oneshot.num_instances * sizeof(rtapi_u32)), &hm2->oneshot.filter2_reg);
     if (r < 0) {
         HM2_ERR("error registering tram write region for Filter2 register (%d)\n", r);
         goto fail0;
     }
 
-    r = hm2_register_tram_write_region(hm2, hm2->oneshot.rate_addr, (hm2->oneshot.num_instances * sizeof(rtapi_u32)), &hm2->oneshot.rate_reg);
+    r = hm2_register_tram_state_write_region(hm2, hm2->oneshot.rate_addr, (hm2->oneshot.num_instances * sizeof(rtapi_u32)), &hm2->oneshot.rate_reg);
     if (r < 0) {
         HM2_ERR("error registering tram write region for Rate register (%d)\n", r);
         goto fail0;
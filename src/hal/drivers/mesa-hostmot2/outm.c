@@ -104,7 +104,7 @@ int hm2_outm_parse_md(hostmot2_t *hm2, int md_index) {
 
 
 
-    r = hm2_register_tram_write_region(hm2, hm2->outm.data_addr, (hm2->outm.num_instances * sizeof(rtapi_u32)), &hm2->outm.data_reg);
+    r = hm2_register_tram_state_write_region(hm2, hm2->outm.data_addr, (hm2->outm.num_instances * sizeof(rtapi_u32)), &hm2->outm.data_reg);
     if (r < 0) {
         HM2_ERR("error registering tram write region for outm Data register (%d)\n", r);
         goto fail0;
@@ -431,7 +431,7 @@ int hm2_pwmgen_parse_md(hostmot2_t *hm2, int md_index) {
     hm2->pwmgen.pdmgen_master_rate_dds_addr = md->base_address + (3 * md->register_stride);
     hm2->pwmgen.enable_addr = md->base_address + (4 * md->register_stride);
 
-    r = hm2_register_tram_write_region(hm2, hm2->pwmgen.pwm_value_addr, (hm2->pwmgen.num_instances * sizeof(rtapi_u32)), &hm2->pwmgen.pwm_value_reg);
+    r = hm2_register_tram_state_write_region(hm2, hm2->pwmgen.pwm_value_addr, (hm2->pwmgen.num_instances * sizeof(rtapi_u32)), &hm2->pwmgen.pwm_value_reg);
     if (r < 0) {
         HM2_ERR("error registering tram write region for PWM Value register (%d)\n", r);
         goto fail0;
@@ -104,7 +104,7 @@ int hm2_rcpwmgen_parse_md(hostmot2_t *hm2, int md_index) {
     hm2->rcpwmgen.rate_addr = md->base_address + (1 * md->register_stride);
     //
 
-    r = hm2_register_tram_write_region(hm2, hm2->rcpwmgen.width_addr, (hm2->rcpwmgen.num_instances * sizeof(rtapi_u32)), &hm2->rcpwmgen.width_reg);
+    r = hm2_register_tram_state_write_region(hm2, hm2->rcpwmgen.width_addr, (hm2->rcpwmgen.num_instances * sizeof(rtapi_u32)), &hm2->rcpwmgen.width_reg);
     if (r < 0) {
         HM2_ERR("error registering tram write region for rcpwmgen width register (%d)\n", r);
         goto fail1;
@@ -236,6 +236,45 @@ static void hm2_stepgen_instance_position_control(hostmot2_t *hm2, long l_period
 }
 
 
+//
+// Position control when the command comes with its velocity, acceleration
+// and jerk at the start of the servo period, as motion provides them.  The
+// step rate can only change once per period, so it is set to the average
+// velocity of that cubic over the period, instead of the velocity of the
+// last period that the controller above estimates from the position
+// commands.  Position error is corrected the same way as above.
+//
+
+static void hm2_stepgen_instance_cubic_control(hostmot2_t *hm2, long l_period_ns, int i, double *new_vel) {
+    double ff_vel;
+    double error;
+    double velocity_cmd;
+
+    hm2_stepgen_instance_t *s = &hm2->stepgen.instance[i];
+
+    (*s->hal.pin.dbg_pos_minus_prev_cmd) = (*s->hal.pin.position_fb) - s->old_position_cmd;
+    s->old_position_cmd = (*s->hal.pin.position_cmd);
+
+    ff_vel = *s->hal.pin.velocity_cmd
+        + (0.5 * (*s->hal.pin.acceleration_cmd) + (*s->hal.pin.jerk_cmd) * f_period_s / 6.0) * f_period_s;
+    (*s->hal.pin.dbg_ff_vel) = ff_vel;
+    error = (*s->hal.pin.position_fb) - (*s->hal.pin.position_cmd);
+    (*s->hal.pin.dbg_err_at_match) = error;
+
+    velocity_cmd = ff_vel - (0.5 * error / f_period_s);
+
+    if (s->hal.param.maxaccel > 0) {
+        if (velocity_cmd > (*s->hal.pin.velocity_fb + (s->hal.param.maxaccel * f_period_s))) {
+            velocity_cmd = *s->hal.pin.velocity_fb + (s->hal.param.maxaccel * f_period_s);
+        } else if (velocity_cmd < (*s->hal.pin.velocity_fb - (s->hal.param.maxaccel * f_period_s))) {
+            velocity_cmd = *s->hal.pin.velocity_fb - (s->hal.param.maxaccel * f_period_s);
+        }
+    }
+
+    *new_vel = velocity_cmd;
+}
+
+
 // This function was invented by Jeff Epler.
 // It forces a floating-point variable to be degraded from native register
 // size (80 bits on x86) to C double size (64 bits).
@@ -293,7 +332,9 @@ static void hm2_stepgen_instance_prepare_tram_write(hostmot2_t *hm2, long l_peri
 
 
     // select the new velocity we want
-    if (*s->hal.pin.control_type == 0) {
+    if (*s->hal.pin.control_type == 0 && *s->hal.pin.cubic) {
+        hm2_stepgen_instance_cubic_control(hm2, l_period_ns, i, &new_vel);
+    } else if (*s->hal.pin.control_type == 0) {
         hm2_stepgen_instance_position_control(hm2, l_period_ns, i, &new_vel);
     } else {
         // velocity-mode control is easy
@@ -785,7 +826,7 @@ int hm2_stepgen_parse_md(hostmot2_t *hm2, int md_index) {
     hm2->stepgen.master_dds_addr = md->base_address + (9 * md->register_stride);
     hm2->stepgen.dpll_timer_num_addr = md->base_address + (10 * md->register_stride);
 
-    r = hm2_register_tram_write_region(hm2, hm2->stepgen.step_rate_addr, (hm2->stepgen.num_instances * sizeof(rtapi_u32)), &hm2->stepgen.step_rate_reg);
+    r = hm2_register_tram_state_write_region(hm2, hm2->stepgen.step_rate_addr, (hm2->stepgen.num_instances * sizeof(rtapi_u32)), &hm2->stepgen.step_rate_reg);
     if (r < 0) {
         HM2_ERR("error registering tram write region for StepGen Step Rate register (%d)\n", r);
         goto fail0;
@@ -896,6 +937,22 @@ int hm2_stepgen_parse_md(hostmot2_t *hm2, int md_index) {
                 goto fail5;
             }
 
+            rtapi_snprintf(name, sizeof(name), "%s.stepgen.%02d.acceleration-cmd", hm2->llio->name, i);
+            r = hal_pin_float_new(name, HAL_IN, &(hm2->stepgen.instance[i].hal.pin.acceleration_cmd), hm2->llio->comp_id);
+            if (r < 0) {
+                HM2_ERR("error adding pin '%s', aborting\n", name);
+                r = -ENOMEM;
+                goto fail5;
+            }
+
+            rtapi_snprintf(name, sizeof(name), "%s.stepgen.%02d.jerk-cmd", hm2->llio->name, i);
+            r = hal_pin_float_new(name, HAL_IN, &(hm2->stepgen.instance[i].hal.pin.jerk_cmd), hm2->llio->comp_id);
+            if (r < 0) {
+                HM2_ERR("error adding pin '%s', aborting\n", name);
+                r = -ENOMEM;
+                goto fail5;
+            }
+
             rtapi_snprintf(name, sizeof(name), "%s.stepgen.%02d.velocity-fb", hm2->llio->name, i);
             r = hal_pin_float_new(name, HAL_OUT, &(hm2->stepgen.instance[i].hal.pin.velocity_fb), hm2->llio->comp_id);
             if (r < 0) {
@@ -936,6 +993,14 @@ int hm2_stepgen_parse_md(hostmot2_t *hm2, int md_index) {
                 goto fail5;
             }
 
+            rtapi_snprintf(name, sizeof(name), "%s.stepgen.%02d.cubic", hm2->llio->name, i);
+            r = hal_pin_bit_new(name, HAL_IN, &(hm2->stepgen.instance[i].hal.pin.cubic), hm2->llio->comp_id);
+            if (r < 0) {
+                HM2_ERR("error adding pin '%s', aborting\n", name);
+                r = -ENOMEM;
+                goto fail5;
+            }
+
             rtapi_snprintf(name, sizeof(name), "%s.stepgen.%02d.position-reset", hm2->llio->name, i);
             r = hal_pin_bit_new(name, HAL_IN, &(hm2->stepgen.instance[i].hal.pin.position_reset), hm2->llio->comp_id);
             if (r < 0) {
@@ -1152,6 +1217,9 @@ int hm2_stepgen_parse_md(hostmot2_t *hm2, int md_index) {
             *(hm2->stepgen.instance[i].hal.pin.velocity_fb) = 0.0;
             *(hm2->stepgen.instance[i].hal.pin.enable) = 0;
             *(hm2->stepgen.instance[i].hal.pin.control_type) = 0;
+            *(hm2->stepgen.instance[i].hal.pin.acceleration_cmd) = 0.0;
+            *(hm2->stepgen.instance[i].hal.pin.jerk_cmd) = 0.0;
+            *(hm2->stepgen.instance[i].hal.pin.cubic) = 0;
             *(hm2->stepgen.instance[i].hal.pin.position_reset) = 0;
             if (hm2->stepgen.firmware_supports_index) {
                 *(hm2->stepgen.instance[i].hal.pin.index_enable) = 0;
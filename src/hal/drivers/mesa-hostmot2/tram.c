@@ -27,6 +27,12 @@
 #include "hal.h"
 
 #include "hal/drivers/mesa-hostmot2/hostmot2.h"
+#include "hal/drivers/mesa-hostmot2/lbp16.h"
+
+
+// hm2_eth sends each burst as one LBP16 command, which counts at most
+// LBP16_MAX_PACKET_DATA_SIZE words, so merged bursts stay below that
+#define HM2_TRAM_MAX_BURST (LBP16_MAX_PACKET_DATA_SIZE * 4)
 
 
 
@@ -43,7 +49,7 @@
 // in the future this function will inform the Translation RAM
 //
 
-int hm2_register_tram_read_region(hostmot2_t *hm2, rtapi_u16 addr, rtapi_u16 size, rtapi_u32 **buffer) {
+static int hm2_register_tram_entry(hostmot2_t *hm2, struct rtapi_list_head *entries, rtapi_u16 addr, rtapi_u16 size, rtapi_u32 **buffer, int flags) {
     hm2_tram_entry_t *tram_entry;
 
     tram_entry = rtapi_kmalloc(sizeof(hm2_tram_entry_t), RTAPI_GFP_KERNEL);
@@ -55,55 +61,121 @@ int hm2_register_tram_read_region(hostmot2_t *hm2, rtapi_u16 addr, rtapi_u16 siz
     tram_entry->addr = addr;
     tram_entry->size = size;
     tram_entry->buffer = buffer;
+    tram_entry->flags = flags;
+    tram_entry->offset = 0;
 
-    rtapi_list_add_tail(&tram_entry->list, &hm2->tram_read_entries);
+    rtapi_list_add_tail(&tram_entry->list, entries);
 
     return 0;
 }
 
 
+int hm2_register_tram_read_region(hostmot2_t *hm2, rtapi_u16 addr, rtapi_u16 size, rtapi_u32 **buffer) {
+    return hm2_register_tram_entry(hm2, &hm2->tram_read_entries, addr, size, buffer, 0);
+}
+
+
 int hm2_register_tram_write_region(hostmot2_t *hm2, rtapi_u16 addr, rtapi_u16 size, rtapi_u32 **buffer) {
-    hm2_tram_entry_t *tram_entry;
+    return hm2_register_tram_entry(hm2, &hm2->tram_write_entries, addr, size, buffer, 0);
+}
 
-    tram_entry = rtapi_kmalloc(sizeof(hm2_tram_entry_t), RTAPI_GFP_KERNEL);
-    if (tram_entry == NULL) {
+
+//
+// Like hm2_register_tram_write_region(), for registers that only hold
+// a value (no FIFOs, strobes or commands), see HM2_TRAM_STATE.
+//
+
+int hm2_register_tram_state_write_region(hostmot2_t *hm2, rtapi_u16 addr, rtapi_u16 size, rtapi_u32 **buffer) {
+    return hm2_register_tram_entry(hm2, &hm2->tram_write_entries, addr, size, buffer, HM2_TRAM_STATE);
+}
+
+
+//
+// Lays the entries out in the TRAM buffer in registration order, merging
+// each entry into the burst before it if it has the same flags and
+// starts where that burst ends, or at most 'gap' bytes after, and the
+// burst does not grow past HM2_TRAM_MAX_BURST bytes.  A merged
+// entry sits as far into the burst's buffer as its address is from the
+// burst's address, so the burst is one contiguous llio transfer.
+// Entries are never reordered, since for some registers the order of
+// the accesses matters.
+//
+// Returns the size of the buffer, or -errno.
+//
+
+static int hm2_tram_layout(hostmot2_t *hm2, struct rtapi_list_head *entries, int gap, hm2_tram_burst_t **bursts, int *num_bursts) {
+    struct rtapi_list_head *ptr;
+    hm2_tram_burst_t *burst = NULL;
+    int num_entries = 0;
+    int size = 0;
+
+    rtapi_list_for_each(ptr, entries) {
+        num_entries ++;
+    }
+
+    *num_bursts = 0;
+    if (num_entries == 0) return 0;
+
+    *bursts = (hm2_tram_burst_t *)rtapi_krealloc(*bursts, num_entries * sizeof(hm2_tram_burst_t), RTAPI_GFP_KERNEL);
+    if (*bursts == NULL) {
         HM2_ERR("out of memory!\n");
         return -ENOMEM;
     }
 
-    tram_entry->addr = addr;
-    tram_entry->size = size;
-    tram_entry->buffer = buffer;
-
-    rtapi_list_add_tail(&tram_entry->list, &hm2->tram_write_entries);
+    rtapi_list_for_each(ptr, entries) {
+        hm2_tram_entry_t *tram_entry = rtapi_list_entry(ptr, hm2_tram_entry_t, list);
+        int burst_end = burst ? burst->addr + burst->size : 0;
+
+        if (
+            (burst != NULL)
+            && (tram_entry->flags == burst->flags)
+            && (tram_entry->addr >= burst_end)
+            && (tram_entry->addr - burst_end <= gap)
+            && (tram_entry->addr + tram_entry->size - burst->addr <= HM2_TRAM_MAX_BURST)
+        ) {
+            burst->size = tram_entry->addr + tram_entry->size - burst->addr;
+            tram_entry->offset = burst->offset + (tram_entry->addr - burst->addr);
+        } else {
+            burst = &(*bursts)[(*num_bursts)++];
+            burst->addr = tram_entry->addr;
+            burst->size = tram_entry->size;
+            burst->flags = tram_entry->flags;
+            burst->offset = size;
+            tram_entry->offset = size;
+        }
+        size = burst->offset + burst->size;
+        if (size > 0xffff) {
+            HM2_ERR("Translation RAM buffer too large (%d bytes)\n", size);
+            return -EINVAL;
+        }
+    }
 
-    return 0;
+    return size;
 }
 
 
 int hm2_allocate_tram_regions(hostmot2_t *hm2) {
     struct rtapi_list_head *ptr;
-    rtapi_u16 offset;
+    int i, r;
     
     int old_tram_read_size = hm2->tram_read_size;
     int old_tram_write_size = hm2->tram_write_size;
 
-    hm2->tram_read_size = 0;
-    rtapi_list_for_each(ptr, &hm2->tram_read_entries) {
-        hm2_tram_entry_t *tram_entry = rtapi_list_entry(ptr, hm2_tram_entry_t, list);
-        hm2->tram_read_size += tram_entry->size;
-    }
+    r = hm2_tram_layout(hm2, &hm2->tram_read_entries, hm2->config.tram_read_gap, &hm2->tram_read_bursts, &hm2->num_tram_read_bursts);
+    if (r < 0) return r;
+    hm2->tram_read_size = r;
 
-    hm2->tram_write_size = 0;
-    rtapi_list_for_each(ptr, &hm2->tram_write_entries) {
-        hm2_tram_entry_t *tram_entry = rtapi_list_entry(ptr, hm2_tram_entry_t, list);
-        hm2->tram_write_size += tram_entry->size;
-    }
+    // writing the gap between two regions would clobber the registers there
+    r = hm2_tram_layout(hm2, &hm2->tram_write_entries, 0, &hm2->tram_write_bursts, &hm2->num_tram_write_bursts);
+    if (r < 0) return r;
+    hm2->tram_write_size = r;
 
     HM2_DBG(
-        "allocating Translation RAM buffers (reading %d bytes, writing %d bytes)\n",
+        "allocating Translation RAM buffers (reading %d bytes in %d bursts, writing %d bytes in %d bursts)\n",
         hm2->tram_read_size,
-        hm2->tram_write_size
+        hm2->num_tram_read_bursts,
+        hm2->tram_write_size,
+        hm2->num_tram_write_bursts
     );
 
     hm2->tram_read_buffer = (rtapi_u32 *)rtapi_krealloc(hm2->tram_read_buffer, hm2->tram_read_size, RTAPI_GFP_KERNEL);
@@ -122,43 +194,91 @@ int hm2_allocate_tram_regions(hostmot2_t *hm2) {
     if(hm2->tram_write_size>old_tram_write_size)
         memset((char*)hm2->tram_write_buffer+old_tram_write_size, 0, hm2->tram_write_size-old_tram_write_size);
 
+    hm2->tram_write_shadow = (rtapi_u32 *)rtapi_krealloc(hm2->tram_write_shadow, hm2->tram_write_size, RTAPI_GFP_KERNEL);
+    if (hm2->tram_write_shadow == NULL) {
+        HM2_ERR("Error while (re)allocating Translation RAM write shadow (%d bytes)\n", hm2->tram_write_size);
+        return -ENOMEM;
+    }
+    // the layout may have changed, so the next write sends everything
+    hm2->tram_write_countdown = 0;
+
     HM2_DBG("buffer address %p\n", &hm2->tram_write_buffer);
     HM2_DBG("Translation RAM read buffer:\n");
-    offset = 0;
     rtapi_list_for_each(ptr, &hm2->tram_read_entries) {
         hm2_tram_entry_t *tram_entry = rtapi_list_entry(ptr, hm2_tram_entry_t, list);
-        *tram_entry->buffer = (rtapi_u32*)((rtapi_u8*)hm2->tram_read_buffer + offset);
-        offset += tram_entry->size;
+        *tram_entry->buffer = (rtapi_u32*)((rtapi_u8*)hm2->tram_read_buffer + tram_entry->offset);
         HM2_DBG("    addr=0x%04x, size=%d, buffer=%p\n", tram_entry->addr, tram_entry->size, *tram_entry->buffer);
     }
+    for (i = 0; i < hm2->num_tram_read_bursts; i ++) {
+        hm2_tram_burst_t *burst = &hm2->tram_read_bursts[i];
+        burst->buffer = (rtapi_u32*)((rtapi_u8*)hm2->tram_read_buffer + burst->offset);
+        HM2_DBG("    burst addr=0x%04x, size=%d\n", burst->addr, burst->size);
+    }
 
     HM2_DBG("Translation RAM write buffer:\n");
-    offset = 0;
     rtapi_list_for_each(ptr, &hm2->tram_write_entries) {
         hm2_tram_entry_t *tram_entry = rtapi_list_entry(ptr, hm2_tram_entry_t, list);
-        *tram_entry->buffer = (rtapi_u32*)((rtapi_u8*)hm2->tram_write_buffer + offset);
-        offset += tram_entry->size;
+        *tram_entry->buffer = (rtapi_u32*)((rtapi_u8*)hm2->tram_write_buffer + tram_entry->offset);
         HM2_DBG("    addr=0x%04x, size=%d, buffer=%p\n", tram_entry->addr, tram_entry->size, *tram_entry->buffer);
     }
+    for (i = 0; i < hm2->num_tram_write_bursts; i ++) {
+        hm2_tram_burst_t *burst = &hm2->tram_write_bursts[i];
+        burst->buffer = (rtapi_u32*)((rtapi_u8*)hm2->tram_write_buffer + burst->offset);
+        HM2_DBG("    burst addr=0x%04x, size=%d%s\n", burst->addr, burst->size, (burst->flags & HM2_TRAM_STATE) ? " (state)" : "");
+    }
     
     return 0;
 }
 
 
+int hm2_tram_export_hal(hostmot2_t *hm2) {
+    int r;
+
+    hm2->tram_stats = (hm2_tram_stats_t *)hal_malloc(sizeof(hm2_tram_stats_t));
+    if (hm2->tram_stats == NULL) {
+        HM2_ERR("out of memory!\n");
+        return -ENOMEM;
+    }
+
+    r = hal_pin_u32_newf(HAL_OUT, &(hm2->tram_stats->hal.pin.read_commands), hm2->llio->comp_id, "%s.tram.read-commands", hm2->llio->name);
+    if (r < 0) goto fail;
+    r = hal_pin_u32_newf(HAL_OUT, &(hm2->tram_stats->hal.pin.read_bytes), hm2->llio->comp_id, "%s.tram.read-bytes", hm2->llio->name);
+    if (r < 0) goto fail;
+    r = hal_pin_u32_newf(HAL_OUT, &(hm2->tram_stats->hal.pin.write_commands), hm2->llio->comp_id, "%s.tram.write-commands", hm2->llio->name);
+    if (r < 0) goto fail;
+    r = hal_pin_u32_newf(HAL_OUT, &(hm2->tram_stats->hal.pin.write_bytes), hm2->llio->comp_id, "%s.tram.write-bytes", hm2->llio->name);
+    if (r < 0) goto fail;
+
+    return 0;
+
+fail:
+    HM2_ERR("error adding tram pins, aborting\n");
+    hm2->tram_stats = NULL;
+    return r;
+}
+
+
 static rtapi_u32 tram_read_iteration = 0;
 int hm2_tram_read(hostmot2_t *hm2) {
-    struct rtapi_list_head *ptr;
+    rtapi_u32 bytes = 0;
+    int i;
 
-    rtapi_list_for_each(ptr, &hm2->tram_read_entries) {
-        hm2_tram_entry_t *tram_entry = rtapi_list_entry(ptr, hm2_tram_entry_t, list);
+    for (i = 0; i < hm2->num_tram_read_bursts; i ++) {
+        hm2_tram_burst_t *burst = &hm2->tram_read_bursts[i];
 
-        if (!hm2->llio->queue_read(hm2->llio, tram_entry->addr, *tram_entry->buffer, tram_entry->size)) {
-            HM2_ERR("TRAM read error! (addr=0x%04x, size=%d, iter=%u)\n", tram_entry->addr, tram_entry->size, tram_read_iteration);
+        if (!hm2->llio->queue_read(hm2->llio, burst->addr, burst->buffer, burst->size)) {
+            HM2_ERR("TRAM read error! (addr=0x%04x, size=%d, iter=%u)\n", burst->addr, burst->size, tram_read_iteration);
             return -EIO;
         }
+        bytes += burst->size;
     }
     tram_read_iteration ++;
 
+    if (hm2->tram_stats != NULL) {
+        *hm2->tram_stats->hal.pin.read_commands = hm2->num_tram_read_bursts;
+        *hm2->tram_stats->hal.pin.read_bytes = bytes;
+    }
+
     return 0;
 }
 
@@ -186,19 +306,76 @@ int hm2_finish_read(hostmot2_t *hm2) {
 
 
 static rtapi_u32 tram_write_iteration = 0;
-int hm2_tram_write(hostmot2_t *hm2) {
-    struct rtapi_list_head *ptr;
 
-    rtapi_list_for_each(ptr, &hm2->tram_write_entries) {
-        hm2_tram_entry_t *tram_entry = rtapi_list_entry(ptr, hm2_tram_entry_t, list);
+static int hm2_tram_queue_write(hostmot2_t *hm2, rtapi_u16 addr, rtapi_u32 *buffer, int size) {
+    if (!hm2->llio->queue_write(hm2->llio, addr, buffer, size)) {
+        HM2_ERR("TRAM write error! (addr=0x%04x, size=%d, iter=%u)\n", addr, size, tram_write_iteration);
+        return -EIO;
+    }
+    return 0;
+}
 
-        if (!hm2->llio->queue_write(hm2->llio, tram_entry->addr, *tram_entry->buffer, tram_entry->size)) {
-            HM2_ERR("TRAM write error! (addr=0x%04x, size=%d, iter=%u)\n", tram_entry->addr, tram_entry->size, tram_write_iteration);
-            return -EIO;
+int hm2_tram_write(hostmot2_t *hm2) {
+    rtapi_u32 commands = 0, bytes = 0;
+    int full;
+    int i;
+
+    // with tram_write_changes=N, the state registers are only written
+    // when they change, and all of them every N writes
+    full = (hm2->config.tram_write_changes <= 0) || (hm2->tram_write_countdown <= 0);
+
+    for (i = 0; i < hm2->num_tram_write_bursts; i ++) {
+        hm2_tram_burst_t *burst = &hm2->tram_write_bursts[i];
+        rtapi_u32 *shadow;
+        int n, w;
+
+        if (full || !(burst->flags & HM2_TRAM_STATE)) {
+            if (hm2_tram_queue_write(hm2, burst->addr, burst->buffer, burst->size)) return -EIO;
+            commands ++;
+            bytes += burst->size;
+            if (burst->flags & HM2_TRAM_STATE) {
+                shadow = (rtapi_u32*)((rtapi_u8*)hm2->tram_write_shadow + burst->offset);
+                memcpy(shadow, burst->buffer, burst->size);
+            }
+            continue;
+        }
+
+        // send each run of changed registers, carrying a single unchanged
+        // register along rather than starting a new command after it
+        shadow = (rtapi_u32*)((rtapi_u8*)hm2->tram_write_shadow + burst->offset);
+        n = burst->size / sizeof(rtapi_u32);
+        w = 0;
+        while (w < n) {
+            int first, last;
+
+            if (burst->buffer[w] == shadow[w]) {
+                w ++;
+                continue;
+            }
+            first = last = w;
+            for (w ++; w < n && w - last <= 2; w ++) {
+                if (burst->buffer[w] != shadow[w]) last = w;
+            }
+            if (hm2_tram_queue_write(hm2, burst->addr + first * sizeof(rtapi_u32), &burst->buffer[first], (last - first + 1) * sizeof(rtapi_u32))) return -EIO;
+            commands ++;
+            bytes += (last - first + 1) * sizeof(rtapi_u32);
+            memcpy(&shadow[first], &burst->buffer[first], (last - first + 1) * sizeof(rtapi_u32));
+            w = last + 1;
         }
     }
     tram_write_iteration ++;
 
+    if (full) {
+        hm2->tram_write_countdown = hm2->config.tram_write_changes - 1;
+    } else {
+        hm2->tram_write_countdown --;
+    }
+
+    if (hm2->tram_stats != NULL) {
+        *hm2->tram_stats->hal.pin.write_commands = commands;
+        *hm2->tram_stats->hal.pin.write_bytes = bytes;
+    }
+
     return 0;
 }
 
@@ -207,6 +384,8 @@ int hm2_finish_write(hostmot2_t *hm2) {
     if (!hm2->llio->send_queued_writes(hm2->llio)) {
         HM2_ERR("error finishing write! iter=%u)\n",
             tram_write_iteration);
+        // the FPGA may have missed some changes
+        hm2->tram_write_countdown = 0;
         return -EIO;
     }
 
@@ -231,5 +410,8 @@ void hm2_tram_cleanup(hostmot2_t *hm2) {
     // free the tram buffers
     if (hm2->tram_read_buffer != NULL) rtapi_kfree(hm2->tram_read_buffer);
     if (hm2->tram_write_buffer != NULL) rtapi_kfree(hm2->tram_write_buffer);
+    if (hm2->tram_write_shadow != NULL) rtapi_kfree(hm2->tram_write_shadow);
+    if (hm2->tram_read_bursts != NULL) rtapi_kfree(hm2->tram_read_bursts);
+    if (hm2->tram_write_bursts != NULL) rtapi_kfree(hm2->tram_write_bursts);
 }
 
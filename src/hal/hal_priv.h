@@ -481,6 +481,17 @@ extern hal_funct_t *halpr_find_funct_by_owner(hal_comp_t * owner,
 */
 extern hal_pin_t *halpr_find_pin_by_sig(hal_sig_t * sig, hal_pin_t * start);
 
+/** 'signal_new()' and 'link()' do the work of hal_signal_new() and
+    hal_link() for a caller that already holds the mutex and has looked
+    up the objects itself, such as halcmd applying a whole batch of
+    commands under one lock.  If 'sigp' is not NULL, 'signal_new()'
+    stores a pointer to the new signal there.  Both return 0 on success
+    or a negative errno, after printing a message.
+*/
+extern int halpr_signal_new(const char *name, hal_type_t type,
+    hal_sig_t ** sigp);
+extern int halpr_link(hal_pin_t * pin, hal_sig_t * sig);
+
 
 /** hal_port_alloc allocates a new empty hal_port having a buffer of size bytes. 
     returns a negative value on failure or a hal_port_t which can be used with
@@ -217,6 +217,8 @@ typedef struct halobject {
     itemmap *items;
 } halobject;
 
+static PyObject * pyhal_group_new(halobject *comp, PyObject *names);
+
 PyObject *pyhal_error_type = NULL;
 
 static PyObject *pyrtapi_error(int code) {
@@ -527,14 +529,32 @@ static PyObject *pyhal_get_pins(PyObject *_self, PyObject *o) {
   EXCEPTION_IF_NOT_LIVE(NULL);
 
   PyObject *d = PyDict_New();
+  if(!d) return NULL;
   for(itemmap::iterator i = self->items->begin(); i != self->items->end(); i++) {
     halitem * pin = &(i->second);
-    name = strdup(i->first.c_str());
-    PyDict_SetItemString(d, name, pyhal_read_common(pin));
+    name = (char*)i->first.c_str();
+    PyObject *v = pyhal_read_common(pin);
+    if(!v || PyDict_SetItemString(d, name, v) < 0) {
+      Py_XDECREF(v);
+      Py_DECREF(d);
+      return NULL;
+    }
+    Py_DECREF(v);
   }
   return d;
 }
 
+static PyObject *pyhal_get_group(PyObject *_self, PyObject *args) {
+    PyObject *names = NULL;
+    halobject *self = (halobject *)_self;
+
+    if(!PyArg_ParseTuple(args, "|O", &names))
+        return NULL;
+    EXCEPTION_IF_NOT_LIVE(NULL);
+
+    return pyhal_group_new(self, names == Py_None ? NULL : names);
+}
+
 
 static PyObject *pyhal_ready(PyObject *_self, PyObject *o) {
     // hal_ready did not exist in EMC 2.0.x, make it a no-op
@@ -578,6 +598,19 @@ static PyObject *pyhal_getattro(PyObject *_self, PyObject *attro)  {
     return pyhal_read_common(find_item(self, PyUnicode_AsUTF8(attro)));
 }
 
+static PyObject *pyhal_getitem(PyObject *_self, PyObject *key)  {
+    halobject *self = (halobject *)_self;
+    EXCEPTION_IF_NOT_LIVE(NULL);
+
+    // Subscripts only name pins and params, no need to try methods first
+    if(!PyUnicode_Check(key)) {
+        PyErr_Format(PyExc_TypeError, "Pin name must be str, not %s",
+                Py_TYPE(key)->tp_name);
+        return NULL;
+    }
+    return pyhal_read_common(find_item(self, PyUnicode_AsUTF8(key)));
+}
+
 static int pyhal_setattro(PyObject *_self, PyObject *attro, PyObject *v) {
     halobject *self = (halobject *)_self;
     EXCEPTION_IF_NOT_LIVE(-1);
@@ -633,6 +666,8 @@ static PyMethodDef hal_methods[] = {
         "Get existing pin object"},
     {"getpins", pyhal_get_pins, METH_VARARGS,
             "Get all pins and values of component"},
+    {"pingroup", pyhal_get_group, METH_VARARGS,
+        "Get a group of pins and params to read or write in one call"},
     {"exit", pyhal_exit, METH_NOARGS,
         "Call hal_exit"},
     {"ready", pyhal_ready, METH_NOARGS,
@@ -644,7 +679,7 @@ static PyMethodDef hal_methods[] = {
 
 static PyMappingMethods halobject_map = {
     pyhal_len,
-    pyhal_getattro,
+    pyhal_getitem,
     pyhal_setattro
 };
 
@@ -853,6 +888,229 @@ static PyObject * pyhal_pin_new(halitem * pin, const char * name) {
     return (PyObject *) pypin;
 }
 
+/* A pin group holds the pins and params of a component, looked up once, so
+ * that a loop can read or write all of them in a single call instead of
+ * one attribute access (and one name lookup) per pin. */
+struct pyhalgroup {
+    PyObject_HEAD
+    halobject *comp;
+    PyObject *names;
+    halitem *items;
+    Py_ssize_t count;
+};
+
+#define GROUP_EXCEPTION_IF_NOT_LIVE(retval) do { \
+    if(self->comp->hal_id <= 0) { \
+        PyErr_SetString(PyExc_RuntimeError, "Invalid operation on closed HAL component"); \
+	return retval; \
+    } \
+} while(0)
+
+static int pyhalgroup_init(PyObject *_self, PyObject *, PyObject *) {
+    PyErr_Format(PyExc_RuntimeError,
+	    "Cannot be constructed directly, use component.pingroup()");
+    return -1;
+}
+
+static void pyhalgroup_delete(PyObject *_self) {
+    pyhalgroup *self = (pyhalgroup *)_self;
+
+    Py_XDECREF(self->comp);
+    Py_XDECREF(self->names);
+    delete [] self->items;
+
+    PyObject_Del(self);
+}
+
+static PyObject *pyhalgroup_repr(PyObject *_self) {
+    pyhalgroup *self = (pyhalgroup *)_self;
+    return PyUnicode_FromFormat("<hal pin group of %s with %d pins and params>",
+            self->comp->name ? self->comp->name : "(closed)", (int)self->count);
+}
+
+static Py_ssize_t pyhalgroup_len(PyObject *_self) {
+    pyhalgroup *self = (pyhalgroup *)_self;
+    return self->count;
+}
+
+static PyObject *pyhalgroup_get(PyObject *_self, PyObject *) {
+    pyhalgroup *self = (pyhalgroup *)_self;
+    GROUP_EXCEPTION_IF_NOT_LIVE(NULL);
+
+    PyObject *l = PyList_New(self->count);
+    if(!l) return NULL;
+    for(Py_ssize_t i = 0; i < self->count; i++) {
+        PyObject *v = pyhal_read_common(&self->items[i]);
+        if(!v) {
+            Py_DECREF(l);
+            return NULL;
+        }
+        PyList_SET_ITEM(l, i, v);
+    }
+    return l;
+}
+
+static PyObject *pyhalgroup_getdict(PyObject *_self, PyObject *) {
+    pyhalgroup *self = (pyhalgroup *)_self;
+    GROUP_EXCEPTION_IF_NOT_LIVE(NULL);
+
+    PyObject *d = PyDict_New();
+    if(!d) return NULL;
+    for(Py_ssize_t i = 0; i < self->count; i++) {
+        PyObject *v = pyhal_read_common(&self->items[i]);
+        if(!v || PyDict_SetItem(d, PyTuple_GET_ITEM(self->names, i), v) < 0) {
+            Py_XDECREF(v);
+            Py_DECREF(d);
+            return NULL;
+        }
+        Py_DECREF(v);
+    }
+    return d;
+}
+
+static PyObject *pyhalgroup_set(PyObject *_self, PyObject *values) {
+    pyhalgroup *self = (pyhalgroup *)_self;
+    GROUP_EXCEPTION_IF_NOT_LIVE(NULL);
+
+    PyObject *seq = PySequence_Fast(values, "Values must be a sequence");
+    if(!seq) return NULL;
+    if(PySequence_Fast_GET_SIZE(seq) != self->count) {
+        PyErr_Format(PyExc_ValueError, "Expected %d values, got %d",
+                (int)self->count, (int)PySequence_Fast_GET_SIZE(seq));
+        Py_DECREF(seq);
+        return NULL;
+    }
+    // A value that does not convert stops here, the pins before it are set
+    PyObject **v = PySequence_Fast_ITEMS(seq);
+    for(Py_ssize_t i = 0; i < self->count; i++) {
+        if(pyhal_write_common(&self->items[i], v[i]) == -1) {
+            Py_DECREF(seq);
+            return NULL;
+        }
+    }
+    Py_DECREF(seq);
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef halgroup_methods[] = {
+    {"get", pyhalgroup_get, METH_NOARGS, "Get the values as a list, in group order"},
+    {"getdict", pyhalgroup_getdict, METH_NOARGS, "Get the values as a dict by name"},
+    {"set", pyhalgroup_set, METH_O, "Set the values from a sequence, in group order"},
+    {NULL},
+};
+
+static PyMemberDef halgroup_members[] = {
+    {(char*)"names", T_OBJECT, offsetof(pyhalgroup, names), READONLY,
+        (char*)"Names of the pins and params in the group"},
+    {NULL},
+};
+
+static PySequenceMethods halgroup_seq = {
+    pyhalgroup_len,            /*sq_length*/
+};
+
+static 
+PyTypeObject halgroup_type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "hal.pingroup",            /*tp_name*/
+    sizeof(pyhalgroup),        /*tp_basicsize*/
+    0,                         /*tp_itemsize*/
+    pyhalgroup_delete,         /*tp_dealloc*/
+    0,                         /*tp_print*/
+    0,                         /*tp_getattr*/
+    0,                         /*tp_setattr*/
+    0,                         /*tp_compare*/
+    pyhalgroup_repr,           /*tp_repr*/
+    0,                         /*tp_as_number*/
+    &halgroup_seq,             /*tp_as_sequence*/
+    0,                         /*tp_as_mapping*/
+    0,                         /*tp_hash */
+    0,                         /*tp_call*/
+    0,                         /*tp_str*/
+    0,                         /*tp_getattro*/
+    0,                         /*tp_setattro*/
+    0,                         /*tp_as_buffer*/
+    Py_TPFLAGS_DEFAULT,        /*tp_flags*/
+    "HAL Pin Group",           /*tp_doc*/
+    0,                         /*tp_traverse*/
+    0,                         /*tp_clear*/
+    0,                         /*tp_richcompare*/
+    0,                         /*tp_weaklistoffset*/
+    0,                         /*tp_iter*/
+    0,                         /*tp_iternext*/
+    halgroup_methods,          /*tp_methods*/
+    halgroup_members,          /*tp_members*/
+    0,                         /*tp_getset*/
+    0,                         /*tp_base*/
+    0,                         /*tp_dict*/
+    0,                         /*tp_descr_get*/
+    0,                         /*tp_descr_set*/
+    0,                         /*tp_dictoffset*/
+    pyhalgroup_init,           /*tp_init*/
+    0,                         /*tp_alloc*/
+    PyType_GenericNew,         /*tp_new*/
+    0,                         /*tp_free*/
+    0,                         /*tp_is_gc*/
+};
+
+/* names is a sequence of pin and param names, or NULL for all of them in
+ * name order */
+static PyObject * pyhal_group_new(halobject *comp, PyObject *names) {
+    PyObject *seq = NULL;
+    Py_ssize_t count;
+
+    if(names) {
+        seq = PySequence_Fast(names, "Names must be a sequence");
+        if(!seq) return NULL;
+        count = PySequence_Fast_GET_SIZE(seq);
+    } else {
+        count = comp->items->size();
+    }
+
+    pyhalgroup *group = PyObject_New(pyhalgroup, &halgroup_type);
+    if(!group) {
+        Py_XDECREF(seq);
+        return NULL;
+    }
+    Py_INCREF(comp);
+    group->comp = comp;
+    group->count = count;
+    group->items = new halitem[count];
+    group->names = PyTuple_New(count);
+    if(!group->names) goto fail;
+
+    if(seq) {
+        for(Py_ssize_t i = 0; i < count; i++) {
+            PyObject *name = PySequence_Fast_GET_ITEM(seq, i);
+            if(!PyUnicode_Check(name)) {
+                PyErr_Format(PyExc_TypeError, "Pin name must be str, not %s",
+                        Py_TYPE(name)->tp_name);
+                goto fail;
+            }
+            halitem *item = find_item(comp, PyUnicode_AsUTF8(name));
+            if(!item) goto fail;
+            group->items[i] = *item;
+            Py_INCREF(name);
+            PyTuple_SET_ITEM(group->names, i, name);
+        }
+        Py_DECREF(seq);
+    } else {
+        Py_ssize_t i = 0;
+        for(itemmap::iterator it = comp->items->begin(); it != comp->items->end(); it++, i++) {
+            PyObject *name = PyUnicode_FromString(it->first.c_str());
+            if(!name) goto fail;
+            group->items[i] = it->second;
+            PyTuple_SET_ITEM(group->names, i, name);
+        }
+    }
+    return (PyObject *) group;
+
+fail:
+    Py_XDECREF(seq);
+    Py_DECREF(group);
+    return NULL;
+}
+
 PyObject *pin_has_writer(PyObject *self, PyObject *args) {
     char *name;
     if(!PyArg_ParseTuple(args, "s", &name)) return NULL;
@@ -1897,10 +2155,12 @@ PyMODINIT_FUNC PyInit__hal(void)
     PyType_Ready(&halobject_type);
     PyType_Ready(&shm_type);
     PyType_Ready(&halpin_type);
+    PyType_Ready(&halgroup_type);
     PyType_Ready(&stream_type);
     PyModule_AddObject(m, "component", (PyObject*)&halobject_type);
     PyModule_AddObject(m, "shm", (PyObject*)&shm_type);
     PyModule_AddObject(m, "item", (PyObject*)&halpin_type);
+    PyModule_AddObject(m, "pingroup", (PyObject*)&halgroup_type);
     PyModule_AddObject(m, "stream", (PyObject*)&stream_type);
 
     PyModule_AddIntConstant(m, "MSG_NONE", RTAPI_MSG_NONE);
@@ -127,8 +127,9 @@ QUIT_CLEANUP:
 void *link_loop_and_logic(void *thrd_link_num)
 {
     char *fnct_name = "link_loop_and_logic";
-    int ret, ret_available, ret_connected;
+    int ret, ret_connected;
     int tx_counter;
+    double wait_time;
     mb_tx_t   *this_mb_tx = NULL;
     int        this_mb_tx_num;
     mb_link_t *this_mb_link = NULL;
@@ -147,127 +148,128 @@ void *link_loop_and_logic(void *thrd_link_num)
 
     while (1) {
 
-        for (tx_counter = 0; tx_counter < gbl.tot_mb_tx; tx_counter++) {
+        if (gbl.quit_flag != 0) { //tell the threads to quit (SIGTERM o SGIQUIT) (unloadusr mb2hal).
+            return NULL;
+        }
 
-            if (gbl.quit_flag != 0) { //tell the threads to quit (SIGTERM o SGIQUIT) (unloadusr mb2hal).
-                return NULL;
+        //the due transaction of this link with the highest priority
+        if (get_next_tx(this_mb_link_num, &this_mb_tx_num, &wait_time) != retOK) {
+            ERR(gbl.init_dbg, "mb_links[%d] thread[%d] fd[%d] get_next_tx ERR",
+                this_mb_link_num, this_mb_link_num, modbus_get_socket(this_mb_link->modbus));
+            return NULL;
+        }
+        if (this_mb_tx_num < 0) { //nothing due, sleep until the first one is (but keep checking quit_flag)
+            if (wait_time > 0.1) {
+                wait_time = 0.1;
             }
+            usleep(wait_time * 1000 * 1000);
+            continue;
+        }
+        this_mb_tx = &gbl.mb_tx[this_mb_tx_num];
 
-            this_mb_tx_num = tx_counter;
-            this_mb_tx = &gbl.mb_tx[this_mb_tx_num];
+        DBGMAX(this_mb_tx->cfg_debug, "mb_tx_num[%d] mb_links[%d] thread[%d] fd[%d] going to TEST connection",
+            this_mb_tx_num, this_mb_tx->mb_link_num, this_mb_link_num, modbus_get_socket(this_mb_link->modbus));
 
-            DBGMAX(this_mb_tx->cfg_debug, "mb_tx_num[%d] mb_links[%d] thread[%d] fd[%d] going to TEST availability",
+        //first time connection or reconnection, run time parameters setting
+        if (get_tx_connection(this_mb_tx_num, &ret_connected) != retOK) {
+            ERR(this_mb_tx->cfg_debug, "mb_tx_num[%d] mb_links[%d] thread[%d] fd[%d] get_tx_connection ERR",
                 this_mb_tx_num, this_mb_tx->mb_link_num, this_mb_link_num, modbus_get_socket(this_mb_link->modbus));
-
-            //corresponding link and time (update_rate)
-            if (is_this_tx_ready(this_mb_link_num, this_mb_tx_num, &ret_available) != retOK) {
-                ERR(this_mb_tx->cfg_debug, "mb_tx_num[%d] mb_links[%d] thread[%d] fd[%d] is_this_tx_ready ERR",
-                    this_mb_tx_num, this_mb_tx->mb_link_num, this_mb_link_num, modbus_get_socket(this_mb_link->modbus));
-                return NULL;
-            }
-            if (ret_available == 0) {
-                DBGMAX(this_mb_tx->cfg_debug, "mb_tx_num[%d] mb_links[%d] thread[%d] fd[%d] NOT available",
-                    this_mb_tx_num, this_mb_tx->mb_link_num, this_mb_link_num, modbus_get_socket(this_mb_link->modbus));
-                usleep(1000);
-                continue;
-            }
-
-            DBGMAX(this_mb_tx->cfg_debug, "mb_tx_num[%d] mb_links[%d] thread[%d] fd[%d] going to TEST connection",
+            return NULL;
+        }
+        if (ret_connected == 0) {
+            DBGMAX(this_mb_tx->cfg_debug, "mb_tx_num[%d] mb_links[%d] thread[%d] fd[%d] NOT connected",
                 this_mb_tx_num, this_mb_tx->mb_link_num, this_mb_link_num, modbus_get_socket(this_mb_link->modbus));
+            usleep(1000);
+            continue;
+        }
 
-            //first time connection or reconnection, run time parameters setting
-            if (get_tx_connection(this_mb_tx_num, &ret_connected) != retOK) {
-                ERR(this_mb_tx->cfg_debug, "mb_tx_num[%d] mb_links[%d] thread[%d] fd[%d] get_tx_connection ERR",
-                    this_mb_tx_num, this_mb_tx->mb_link_num, this_mb_link_num, modbus_get_socket(this_mb_link->modbus));
-                return NULL;
-            }
-            if (ret_connected == 0) {
-                DBGMAX(this_mb_tx->cfg_debug, "mb_tx_num[%d] mb_links[%d] thread[%d] fd[%d] NOT connected",
-                    this_mb_tx_num, this_mb_tx->mb_link_num, this_mb_link_num, modbus_get_socket(this_mb_link->modbus));
-                usleep(1000);
-                continue;
-            }
+        DBGMAX(this_mb_tx->cfg_debug, "mb_tx_num[%d] mb_links[%d] thread[%d] fd[%d] lk_dbg[%d] going to EXECUTE transaction",
+            this_mb_tx_num, this_mb_tx->mb_link_num, this_mb_link_num, modbus_get_socket(this_mb_link->modbus),
+            this_mb_tx->protocol_debug);
+
+        switch (this_mb_tx->mb_tx_fnct) {
+
+        case mbtx_01_READ_COILS:
+            ret = fnct_01_read_coils(this_mb_tx, this_mb_link);
+            break;
+        case mbtx_02_READ_DISCRETE_INPUTS:
+            ret = fnct_02_read_discrete_inputs(this_mb_tx, this_mb_link);
+            break;
+        case mbtx_03_READ_HOLDING_REGISTERS:
+            ret = fnct_03_read_holding_registers(this_mb_tx, this_mb_link);
+            break;
+        case mbtx_04_READ_INPUT_REGISTERS:
+            ret = fnct_04_read_input_registers(this_mb_tx, this_mb_link);
+            break;
+        case mbtx_05_WRITE_SINGLE_COIL:
+            ret = fnct_05_write_single_coil(this_mb_tx, this_mb_link);
+            break;
+        case mbtx_06_WRITE_SINGLE_REGISTER:
+            ret = fnct_06_write_single_register(this_mb_tx, this_mb_link);
+            break;
+        case mbtx_15_WRITE_MULTIPLE_COILS:
+            ret = fnct_15_write_multiple_coils(this_mb_tx, this_mb_link);
+            break;
+        case mbtx_16_WRITE_MULTIPLE_REGISTERS:
+            ret = fnct_16_write_multiple_registers(this_mb_tx, this_mb_link);
+            break;
+        default:
+            ret = -1;
+            ERR(this_mb_tx->cfg_debug, "case error with mb_tx_fnct %d [%s] in mb_tx_num[%d]",
+                this_mb_tx->mb_tx_fnct, this_mb_tx->mb_tx_fnct_name, this_mb_tx_num);
+            break;
+        }
 
-            DBGMAX(this_mb_tx->cfg_debug, "mb_tx_num[%d] mb_links[%d] thread[%d] fd[%d] lk_dbg[%d] going to EXECUTE transaction",
-                this_mb_tx_num, this_mb_tx->mb_link_num, this_mb_link_num, modbus_get_socket(this_mb_link->modbus),
-                this_mb_tx->protocol_debug);
-
-            switch (this_mb_tx->mb_tx_fnct) {
-
-            case mbtx_01_READ_COILS:
-                ret = fnct_01_read_coils(this_mb_tx, this_mb_link);
-                break;
-            case mbtx_02_READ_DISCRETE_INPUTS:
-                ret = fnct_02_read_discrete_inputs(this_mb_tx, this_mb_link);
-                break;
-            case mbtx_03_READ_HOLDING_REGISTERS:
-                ret = fnct_03_read_holding_registers(this_mb_tx, this_mb_link);
-                break;
-            case mbtx_04_READ_INPUT_REGISTERS:
-                ret = fnct_04_read_input_registers(this_mb_tx, this_mb_link);
-                break;
-            case mbtx_05_WRITE_SINGLE_COIL:
-                ret = fnct_05_write_single_coil(this_mb_tx, this_mb_link);
-                break;
-            case mbtx_06_WRITE_SINGLE_REGISTER:
-                ret = fnct_06_write_single_register(this_mb_tx, this_mb_link);
-                break;
-            case mbtx_15_WRITE_MULTIPLE_COILS:
-                ret = fnct_15_write_multiple_coils(this_mb_tx, this_mb_link);
-                break;
-            case mbtx_16_WRITE_MULTIPLE_REGISTERS:
-                ret = fnct_16_write_multiple_registers(this_mb_tx, this_mb_link);
-                break;
-            default:
-                ret = -1;
-                ERR(this_mb_tx->cfg_debug, "case error with mb_tx_fnct %d [%s] in mb_tx_num[%d]",
-                    this_mb_tx->mb_tx_fnct, this_mb_tx->mb_tx_fnct_name, this_mb_tx_num);
-                break;
-            }
+        if (gbl.quit_flag != 0) { //tell the threads to quit (SIGTERM o SGIQUIT) (unloadusr mb2hal).
+            return NULL;
+        }
 
-            if (gbl.quit_flag != 0) { //tell the threads to quit (SIGTERM o SGIQUIT) (unloadusr mb2hal).
-                return NULL;
-            }
+        if (ret != retOK && modbus_get_socket(this_mb_link->modbus) < 0) { //link failure
+            (**this_mb_tx->num_errors)++;
+            ERR(this_mb_tx->cfg_debug, "mb_tx_num[%d] mb_links[%d] thread[%d] fd[%d] link failure, going to close link",
+                this_mb_tx_num, this_mb_tx->mb_link_num, this_mb_link_num, modbus_get_socket(this_mb_link->modbus));
+            modbus_close(this_mb_link->modbus);
+        }
+        else if (ret != retOK) {  //transaction failure but link OK
+            (**this_mb_tx->num_errors)++;
+            ERR(this_mb_tx->cfg_debug, "mb_tx_num[%d] mb_links[%d] thread[%d] fd[%d] transaction failure, num_errors[%d]",
+                this_mb_tx_num, this_mb_tx->mb_link_num, this_mb_link_num, modbus_get_socket(this_mb_link->modbus), **this_mb_tx->num_errors);
+            // Clear any unread data. Otherwise the link might get out of sync
+            modbus_flush(this_mb_link->modbus);
+        }
+        else { //transaction and link OK
+            OK(this_mb_tx->cfg_debug, "mb_tx_num[%d] mb_links[%d] thread[%d] fd[%d] transaction OK, update_HZ[%0.03f]",
+               this_mb_tx_num, this_mb_tx->mb_link_num, this_mb_link_num, modbus_get_socket(this_mb_link->modbus),
+               1.0/(get_time()-this_mb_tx->last_time_ok));
+            this_mb_tx->last_time_ok = get_time();
+            (**this_mb_tx->num_errors) = 0;
+        }
 
-            if (ret != retOK && modbus_get_socket(this_mb_link->modbus) < 0) { //link failure
-                (**this_mb_tx->num_errors)++;
-                ERR(this_mb_tx->cfg_debug, "mb_tx_num[%d] mb_links[%d] thread[%d] fd[%d] link failure, going to close link",
-                    this_mb_tx_num, this_mb_tx->mb_link_num, this_mb_link_num, modbus_get_socket(this_mb_link->modbus));
-                modbus_close(this_mb_link->modbus);
-            }
-            else if (ret != retOK) {  //transaction failure but link OK
-                (**this_mb_tx->num_errors)++;
-                ERR(this_mb_tx->cfg_debug, "mb_tx_num[%d] mb_links[%d] thread[%d] fd[%d] transaction failure, num_errors[%d]",
-                    this_mb_tx_num, this_mb_tx->mb_link_num, this_mb_link_num, modbus_get_socket(this_mb_link->modbus), **this_mb_tx->num_errors);
-                // Clear any unread data. Otherwise the link might get out of sync
-                modbus_flush(this_mb_link->modbus);
-            }
-            else { //transaction and link OK
-                OK(this_mb_tx->cfg_debug, "mb_tx_num[%d] mb_links[%d] thread[%d] fd[%d] transaction OK, update_HZ[%0.03f]",
-                   this_mb_tx_num, this_mb_tx->mb_link_num, this_mb_link_num, modbus_get_socket(this_mb_link->modbus),
-                   1.0/(get_time()-this_mb_tx->last_time_ok));
-                this_mb_tx->last_time_ok = get_time();
-                (**this_mb_tx->num_errors) = 0;
+        //merged transactions share the result of their leader
+        for (tx_counter = 0; tx_counter < gbl.tot_mb_tx; tx_counter++) {
+            if (gbl.mb_tx[tx_counter].merged_into == this_mb_tx_num) {
+                gbl.mb_tx[tx_counter].last_time_ok = this_mb_tx->last_time_ok;
+                (**gbl.mb_tx[tx_counter].num_errors) = (**this_mb_tx->num_errors);
             }
+        }
 
-            //set the next (waiting) time for update rate
-            this_mb_tx->next_time = get_time() + this_mb_tx->time_increment;
+        //set the next (waiting) time for update rate
+        this_mb_tx->next_time = get_time() + this_mb_tx->time_increment;
 
-            //wait time for serial lines
-            if (this_mb_tx->cfg_link_type == linkRTU) {
-                DBG(this_mb_tx->cfg_debug, "mb_tx_num[%d] mb_links[%d] thread[%d] fd[%d] SERIAL_DELAY_MS activated [%d]",
-                    this_mb_tx_num, this_mb_tx->mb_link_num, this_mb_link_num, modbus_get_socket(this_mb_link->modbus),
-                    this_mb_tx->cfg_serial_delay_ms);
-                usleep(this_mb_tx->cfg_serial_delay_ms * 1000);
-            }
+        //wait time for serial lines
+        if (this_mb_tx->cfg_link_type == linkRTU) {
+            DBG(this_mb_tx->cfg_debug, "mb_tx_num[%d] mb_links[%d] thread[%d] fd[%d] SERIAL_DELAY_MS activated [%d]",
+                this_mb_tx_num, this_mb_tx->mb_link_num, this_mb_link_num, modbus_get_socket(this_mb_link->modbus),
+                this_mb_tx->cfg_serial_delay_ms);
+            usleep(this_mb_tx->cfg_serial_delay_ms * 1000);
+        }
 
-            //wait time to gbl.slowdown activity (debugging)
-            if (gbl.slowdown > 0) {
-                DBG(this_mb_tx->cfg_debug, "mb_tx_num[%d] mb_links[%d] thread[%d] fd[%d] gbl.slowdown activated [%0.3f]",
-                    this_mb_tx_num, this_mb_tx->mb_link_num, this_mb_link_num, modbus_get_socket(this_mb_link->modbus), gbl.slowdown);
-                usleep(gbl.slowdown * 1000 * 1000);
-            }
-        }  //end for
+        //wait time to gbl.slowdown activity (debugging)
+        if (gbl.slowdown > 0) {
+            DBG(this_mb_tx->cfg_debug, "mb_tx_num[%d] mb_links[%d] thread[%d] fd[%d] gbl.slowdown activated [%0.3f]",
+                this_mb_tx_num, this_mb_tx->mb_link_num, this_mb_link_num, modbus_get_socket(this_mb_link->modbus), gbl.slowdown);
+            usleep(gbl.slowdown * 1000 * 1000);
+        }
 
     } //end while
 
@@ -275,45 +277,67 @@ void *link_loop_and_logic(void *thrd_link_num)
 }
 
 /*
- * Check if the transaction is available for this link
+ * Pick the next transaction of this link: of all the due transactions
+ * the one with the highest lateness * (PRIORITY + 1). Weighting instead
+ * of strict priority, so a MAX_UPDATE_RATE=0.0 (always due) transaction
+ * with a high PRIORITY can not starve all the others.
+ * If none is due, *next_mb_tx_num is -1 and *wait_time is the time until
+ * the first one will be.
+ * Merged transactions are executed by their leader, never by themselves.
  */
 
-retCode is_this_tx_ready(const int this_mb_link_num, const int this_mb_tx_num, int *ret_available)
+retCode get_next_tx(const int this_mb_link_num, int *next_mb_tx_num, double *wait_time)
 {
-    char *fnct_name = "is_this_tx_available";
-    mb_tx_t *this_mb_tx;
-    int this_mb_tx_link_num;
+    char *fnct_name = "get_next_tx";
+    mb_tx_t *this_mb_tx, *best_mb_tx = NULL;
+    double now, first_time = 0, score, best_score = 0;
+    int tx_counter;
 
-    if (this_mb_tx_num < 0 || this_mb_tx_num > gbl.tot_mb_tx) {
-        ERR(gbl.init_dbg, "parameter out of range this_mb_tx_num[%d]", this_mb_tx_num);
+    if (next_mb_tx_num == NULL || wait_time == NULL) {
+        ERR(gbl.init_dbg, "NULL pointer");
         return retERR;
     }
-    this_mb_tx = &gbl.mb_tx[this_mb_tx_num];
-
-    if (ret_available == NULL) {
-        ERR(this_mb_tx->cfg_debug, "NULL pointer");
+    if (this_mb_link_num < 0 || this_mb_link_num >= gbl.tot_mb_links) {
+        ERR(gbl.init_dbg, "parameter out of range this_mb_link_num[%d]", this_mb_link_num);
         return retERR;
     }
 
-    this_mb_tx_link_num = this_mb_tx->mb_link_num;
-    if (this_mb_tx_link_num < 0 || this_mb_tx_link_num >= gbl.tot_mb_links) {
-        ERR(this_mb_tx->cfg_debug, "parameter out of range this_mb_tx_link_num[%d]", this_mb_tx_link_num);
-        return retERR;
-    }
+    *next_mb_tx_num = -1;
+    *wait_time = 0.1; //no transaction at all in this link, just poll quit_flag
 
-    *ret_available = 0; //defaults to not available
+    now = get_time();
+    for (tx_counter = 0; tx_counter < gbl.tot_mb_tx; tx_counter++) {
+        this_mb_tx = &gbl.mb_tx[tx_counter];
+
+        //the tx is not of this link, or someone else reads it
+        if (this_mb_tx->mb_link_num != this_mb_link_num || this_mb_tx->merged_into >= 0) {
+            continue;
+        }
+
+        //not now
+        if (now < this_mb_tx->next_time) {
+            if (first_time == 0 || this_mb_tx->next_time < first_time) {
+                first_time = this_mb_tx->next_time;
+            }
+            continue;
+        }
 
-    //the tx is not of this link
-    if (this_mb_link_num != this_mb_tx_link_num) {
-        return retOK;
+        score = (now - this_mb_tx->next_time) * (this_mb_tx->cfg_priority + 1);
+        if (best_mb_tx == NULL || score > best_score) {
+            best_mb_tx = this_mb_tx;
+            best_score = score;
+        }
     }
 
-    //not now
-    if (get_time() < this_mb_tx->next_time) {
-        return retOK;
+    if (best_mb_tx != NULL) {
+        *next_mb_tx_num = best_mb_tx->mb_tx_num;
+        DBGMAX(best_mb_tx->cfg_debug, "mb_tx_num[%d] mb_links[%d] is the next one, priority[%d] late[%0.3f]",
+               best_mb_tx->mb_tx_num, this_mb_link_num, best_mb_tx->cfg_priority, now - best_mb_tx->next_time);
+    }
+    else if (first_time > 0) {
+        *wait_time = first_time - now;
     }
 
-    *ret_available = 1; //is available
     return retOK;
 }
 
@@ -324,7 +348,7 @@ retCode is_this_tx_ready(const int this_mb_link_num, const int this_mb_tx_num, i
 retCode get_tx_connection(const int this_mb_tx_num, int *ret_connected)
 {
     char *fnct_name = "get_tx_connection";
-    int ret;
+    int ret, counter;
     mb_tx_t   *this_mb_tx;
     mb_link_t *this_mb_link;
     int        this_mb_link_num;
@@ -361,6 +385,12 @@ retCode get_tx_connection(const int this_mb_tx_num, int *ret_connected)
         }
         DBGMAX(this_mb_tx->cfg_debug, "mb_tx_num[%d] mb_links[%d] new connection -> fd[%d]",
             this_mb_tx_num, this_mb_tx->mb_link_num, modbus_get_socket(this_mb_link->modbus));
+        //the slave may have been restarted, write everything again
+        for (counter = 0; counter < gbl.tot_mb_tx; counter++) {
+            if (gbl.mb_tx[counter].mb_link_num == this_mb_link_num) {
+                gbl.mb_tx[counter].last_written_ok = 0;
+            }
+        }
     }
     else {
         DBGMAX(this_mb_tx->cfg_debug, "mb_tx_num[%d] mb_links[%d] already connected to fd[%d]",
@@ -412,6 +442,7 @@ void set_init_gbl_params()
     gbl.init_dbg     = debugERR; //until read in config file
     gbl.version      = 1000;     //defaults to 1000 (= 1.000) if not set
     gbl.slowdown     = 0;        //until read in config file
+    gbl.merge_reads  = 1;        //until read in config file
     gbl.mb_tx_fncts[mbtxERR]                         = "";
     gbl.mb_tx_fncts[mbtx_01_READ_COILS]              = "fnct_01_read_coils";
     gbl.mb_tx_fncts[mbtx_02_READ_DISCRETE_INPUTS]    = "fnct_02_read_discrete_inputs";
@@ -462,6 +493,9 @@ void quit_cleanup(void)
     gbl.tot_mb_links = 0;
 
     if (gbl.mb_tx != NULL) {
+        for (counter = 0; counter < gbl.tot_mb_tx; counter++) {
+            free(gbl.mb_tx[counter].last_written);
+        }
         free(gbl.mb_tx);
     }
     gbl.mb_tx = NULL;
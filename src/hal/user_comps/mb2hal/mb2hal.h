@@ -90,6 +90,8 @@ typedef struct {
     //cfg_* are others INI config params
     double cfg_update_rate;    //tx update rate
     int    cfg_debug;          //tx debug level (program, may be also protocol)
+    int    cfg_priority;       //weight of the lateness when picking the next tx
+    int    cfg_write_on_change; //write functions only: skip unchanged values
     //Modbus protocol debug
     int  protocol_debug;       //Flag debug Modbus protocol
     //internal processing values
@@ -99,6 +101,13 @@ typedef struct {
     double time_increment; //wait time between tx
     double next_time;      //next time for this tx
     double last_time_ok;   //last OK tx time
+    //read merging (see init_mb_tx_merge)
+    int merged_into;       //tx num of the leader doing our read, -1 = none
+    int rd_1st_addr;       //range really read, the union of all merged tx
+    int rd_nelem;
+    //write on change
+    void *last_written;    //data of the last OK write
+    int   last_written_ok; //0 = must write, even if unchanged
     //HAL related params
     char hal_tx_name[HAL_NAME_LEN + 1];
     hal_float_t **float_value;
@@ -142,6 +151,7 @@ typedef struct {
     int   init_dbg;
     int   version;
     double slowdown;
+    int   merge_reads;
     //HAL related
     int   hal_mod_id;
     char *hal_mod_name;
@@ -160,7 +170,7 @@ extern gbl_t gbl;
 
 //mb2hal.c
 void *link_loop_and_logic(void *thrd_link_num);
-retCode is_this_tx_ready(const int this_mb_link_num, const int this_mb_tx_num, int *ret_available);
+retCode get_next_tx(const int this_mb_link_num, int *next_mb_tx_num, double *wait_time);
 retCode get_tx_connection(const int mb_tx_num, int *ret_connected);
 void set_init_gbl_params();
 double get_time();
@@ -178,12 +188,17 @@ retCode check_int_in(int n_args, const int int_value, ...);
 retCode check_str_in(int n_args, const char *str_value, ...);
 retCode init_mb_links();
 retCode init_mb_tx();
+retCode init_mb_tx_merge();
 
 //mb2hal_hal.c
 retCode create_HAL_pins();
 retCode create_each_mb_tx_hal_pins(mb_tx_t *mb_tx);
 
 //mb2hal_modbus.c
+void set_read_bits(mb_tx_t *this_mb_tx, const uint8_t *bits);
+void set_read_registers(mb_tx_t *this_mb_tx, const uint16_t *data);
+int is_write_unchanged(mb_tx_t *this_mb_tx, const void *data, size_t size);
+void set_last_written(mb_tx_t *this_mb_tx, const void *data, size_t size);
 retCode fnct_01_read_coils(mb_tx_t *this_mb_tx, mb_link_t *this_mb_link);
 retCode fnct_02_read_discrete_inputs(mb_tx_t *this_mb_tx, mb_link_t *this_mb_link);
 retCode fnct_03_read_holding_registers(mb_tx_t *this_mb_tx, mb_link_t *this_mb_link);
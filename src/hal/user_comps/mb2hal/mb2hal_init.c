@@ -110,6 +110,10 @@ retCode parse_common_section()
     iniFindDouble(gbl.ini_file_ptr, tag, section, &gbl.slowdown);
     DBG(gbl.init_dbg, "[%s] [%s] [%0.3f]", section, tag, gbl.slowdown);
 
+    tag     = "MERGE_READS"; //optional
+    iniFindInt(gbl.ini_file_ptr, tag, section, &gbl.merge_reads);
+    DBG(gbl.init_dbg, "[%s] [%s] [%d]", section, tag, gbl.merge_reads);
+
     tag     = "TOTAL_TRANSACTIONS"; //required
     if (iniFindInt(gbl.ini_file_ptr, tag, section, &gbl.tot_mb_tx) != 0) {
         ERR(gbl.init_dbg, "required [%s] [%s] not found", section, tag);
@@ -375,6 +379,32 @@ retCode parse_transaction_section(const int mb_tx_num)
     }
     DBG(gbl.init_dbg, "[%s] [%s] [%s]", section, tag, this_mb_tx->hal_tx_name);
 
+    tag = "PRIORITY"; //optional
+    this_mb_tx->cfg_priority = 0; //default
+    if (iniFindInt(gbl.ini_file_ptr, tag, section, &this_mb_tx->cfg_priority) != 0) { //not found
+        if (mb_tx_num > 0) { //previous value?
+            if (strcasecmp(this_mb_tx->cfg_link_type_str, gbl.mb_tx[mb_tx_num-1].cfg_link_type_str) == 0) {
+                this_mb_tx->cfg_priority = gbl.mb_tx[mb_tx_num-1].cfg_priority;
+            }
+        }
+    }
+    if (this_mb_tx->cfg_priority < 0) {
+        ERR(gbl.init_dbg, "[%s] [%s] [%d] out of range", section, tag, this_mb_tx->cfg_priority);
+        return retERR;
+    }
+    DBG(gbl.init_dbg, "[%s] [%s] [%d]", section, tag, this_mb_tx->cfg_priority);
+
+    tag = "WRITE_ON_CHANGE"; //optional
+    this_mb_tx->cfg_write_on_change = 0; //default
+    if (iniFindInt(gbl.ini_file_ptr, tag, section, &this_mb_tx->cfg_write_on_change) != 0) { //not found
+        if (mb_tx_num > 0) { //previous value?
+            if (strcasecmp(this_mb_tx->cfg_link_type_str, gbl.mb_tx[mb_tx_num-1].cfg_link_type_str) == 0) {
+                this_mb_tx->cfg_write_on_change = gbl.mb_tx[mb_tx_num-1].cfg_write_on_change;
+            }
+        }
+    }
+    DBG(gbl.init_dbg, "[%s] [%s] [%d]", section, tag, this_mb_tx->cfg_write_on_change);
+
     /*
         str = iniFind(gbl.ini_file_ptr, "PINNAME", mb_tx_name);
         if (str != NULL) {
@@ -795,10 +825,119 @@ retCode init_mb_tx()
         }
         this_mb_tx->next_time = 0; //next time for this tx
 
+        this_mb_tx->merged_into = -1; //reads its own range, see init_mb_tx_merge
+        this_mb_tx->rd_1st_addr = this_mb_tx->mb_tx_1st_addr;
+        this_mb_tx->rd_nelem    = this_mb_tx->mb_tx_nelem;
+
+        switch (this_mb_tx->mb_tx_fnct) {
+        case mbtx_05_WRITE_SINGLE_COIL:
+        case mbtx_06_WRITE_SINGLE_REGISTER:
+        case mbtx_15_WRITE_MULTIPLE_COILS:
+        case mbtx_16_WRITE_MULTIPLE_REGISTERS:
+            //big enough for bits or registers
+            this_mb_tx->last_written = malloc(sizeof(uint16_t) * this_mb_tx->mb_tx_nelem);
+            if (this_mb_tx->last_written == NULL) {
+                ERR(gbl.init_dbg, "malloc last_written failed [%s]", strerror(errno));
+                return retERR;
+            }
+            this_mb_tx->last_written_ok = 0;
+            break;
+        default:
+            this_mb_tx->last_written = NULL;
+            break;
+        }
+
         DBG(gbl.init_dbg, "MB_TX %d lk_n[%d] tx_n[%d] cfg_dbg[%d] lk_dbg[%d] t_inc[%0.3f] nxt_t[%0.3f]",
             tx_counter, this_mb_tx->mb_link_num, this_mb_tx->mb_tx_num, this_mb_tx->cfg_debug,
             this_mb_tx->protocol_debug, this_mb_tx->time_increment, this_mb_tx->next_time);
     }
 
+    return init_mb_tx_merge();
+}
+
+/*
+ * Merge read transactions of the same link, slave, function code and
+ * update rate whose ranges are adjacent or overlapping into one Modbus
+ * request. The first one (the leader) reads the union of the ranges and
+ * fills the pins of all of them, the others are never executed.
+ * Ranges with gaps are not merged: the slave may refuse the addresses
+ * in between.
+ */
+retCode init_mb_tx_merge()
+{
+    char *fnct_name="init_mb_tx_merge";
+    int lead_counter, tx_counter;
+    int merged, max_nelem, first, last;
+    mb_tx_t *lead_mb_tx, *this_mb_tx;
+
+    if (gbl.merge_reads == 0) {
+        return retOK;
+    }
+
+    for (lead_counter = 0; lead_counter < gbl.tot_mb_tx; lead_counter++) {
+        lead_mb_tx = &gbl.mb_tx[lead_counter];
+
+        if (lead_mb_tx->merged_into >= 0) {
+            continue;
+        }
+        switch (lead_mb_tx->mb_tx_fnct) {
+        case mbtx_01_READ_COILS:
+            max_nelem = MB2HAL_MAX_FNCT01_ELEMENTS;
+            break;
+        case mbtx_02_READ_DISCRETE_INPUTS:
+            max_nelem = MB2HAL_MAX_FNCT02_ELEMENTS;
+            break;
+        case mbtx_03_READ_HOLDING_REGISTERS:
+            max_nelem = MB2HAL_MAX_FNCT03_ELEMENTS;
+            break;
+        case mbtx_04_READ_INPUT_REGISTERS:
+            max_nelem = MB2HAL_MAX_FNCT04_ELEMENTS;
+            break;
+        default: //writes are never merged
+            continue;
+        }
+
+        do { //until no more range touches the grown one
+            merged = 0;
+            for (tx_counter = lead_counter + 1; tx_counter < gbl.tot_mb_tx; tx_counter++) {
+                this_mb_tx = &gbl.mb_tx[tx_counter];
+
+                if (this_mb_tx->merged_into >= 0
+                        || this_mb_tx->mb_link_num != lead_mb_tx->mb_link_num
+                        || this_mb_tx->mb_tx_slave_id != lead_mb_tx->mb_tx_slave_id
+                        || this_mb_tx->mb_tx_fnct != lead_mb_tx->mb_tx_fnct
+                        || this_mb_tx->cfg_update_rate != lead_mb_tx->cfg_update_rate) {
+                    continue;
+                }
+                if (this_mb_tx->mb_tx_1st_addr > lead_mb_tx->rd_1st_addr + lead_mb_tx->rd_nelem
+                        || this_mb_tx->mb_tx_1st_addr + this_mb_tx->mb_tx_nelem < lead_mb_tx->rd_1st_addr) {
+                    continue;
+                }
+                first = lead_mb_tx->rd_1st_addr;
+                if (this_mb_tx->mb_tx_1st_addr < first) {
+                    first = this_mb_tx->mb_tx_1st_addr;
+                }
+                last = lead_mb_tx->rd_1st_addr + lead_mb_tx->rd_nelem;
+                if (this_mb_tx->mb_tx_1st_addr + this_mb_tx->mb_tx_nelem > last) {
+                    last = this_mb_tx->mb_tx_1st_addr + this_mb_tx->mb_tx_nelem;
+                }
+                if (last - first > max_nelem) {
+                    continue;
+                }
+
+                lead_mb_tx->rd_1st_addr = first;
+                lead_mb_tx->rd_nelem    = last - first;
+                if (this_mb_tx->cfg_priority > lead_mb_tx->cfg_priority) {
+                    lead_mb_tx->cfg_priority = this_mb_tx->cfg_priority;
+                }
+                this_mb_tx->merged_into = lead_counter;
+                merged = 1;
+
+                DBG(gbl.init_dbg, "MB_TX %d merged into MB_TX %d, 1st_addr[%d] nelem[%d]",
+                    tx_counter, lead_counter, lead_mb_tx->rd_1st_addr, lead_mb_tx->rd_nelem);
+            }
+        } while (merged != 0);
+    }
+
     return retOK;
 }
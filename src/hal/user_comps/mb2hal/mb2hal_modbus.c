@@ -4,21 +4,21 @@
 retCode fnct_01_read_coils(mb_tx_t *this_mb_tx, mb_link_t *this_mb_link)
 {
     char *fnct_name = "fnct_01_read_coils";
-    int counter, ret;
+    int ret;
     uint8_t bits[MB2HAL_MAX_FNCT01_ELEMENTS];
 
     if (this_mb_tx == NULL || this_mb_link == NULL) {
         return retERR;
     }
-    if (this_mb_tx->mb_tx_nelem > MB2HAL_MAX_FNCT01_ELEMENTS) {
+    if (this_mb_tx->rd_nelem > MB2HAL_MAX_FNCT01_ELEMENTS) {
         return retERR;
     }
 
     DBG(this_mb_tx->cfg_debug, "mb_tx[%d] mb_links[%d] slave[%d] fd[%d] 1st_addr[%d] nelem[%d]",
         this_mb_tx->mb_tx_num, this_mb_tx->mb_link_num, this_mb_tx->mb_tx_slave_id, modbus_get_socket(this_mb_link->modbus),
-        this_mb_tx->mb_tx_1st_addr, this_mb_tx->mb_tx_nelem);
+        this_mb_tx->rd_1st_addr, this_mb_tx->rd_nelem);
 
-    ret = modbus_read_bits(this_mb_link->modbus, this_mb_tx->mb_tx_1st_addr, this_mb_tx->mb_tx_nelem, bits);
+    ret = modbus_read_bits(this_mb_link->modbus, this_mb_tx->rd_1st_addr, this_mb_tx->rd_nelem, bits);
     if (ret < 0) {
         if (modbus_get_socket(this_mb_link->modbus) < 0) {
             modbus_close(this_mb_link->modbus);
@@ -29,10 +29,7 @@ retCode fnct_01_read_coils(mb_tx_t *this_mb_tx, mb_link_t *this_mb_link)
         return retERR;
     }
 
-    for (counter = 0; counter < this_mb_tx->mb_tx_nelem; counter++) {
-        *(this_mb_tx->bit[counter]) = bits[counter];
-        *(this_mb_tx->bit_inv[counter]) = !bits[counter];
-    }
+    set_read_bits(this_mb_tx, bits);
 
     return retOK;
 }
@@ -40,21 +37,21 @@ retCode fnct_01_read_coils(mb_tx_t *this_mb_tx, mb_link_t *this_mb_link)
 retCode fnct_02_read_discrete_inputs(mb_tx_t *this_mb_tx, mb_link_t *this_mb_link)
 {
     char *fnct_name = "fnct_02_read_discrete_inputs";
-    int counter, ret;
+    int ret;
     uint8_t bits[MB2HAL_MAX_FNCT02_ELEMENTS];
 
     if (this_mb_tx == NULL || this_mb_link == NULL) {
         return retERR;
     }
-    if (this_mb_tx->mb_tx_nelem > MB2HAL_MAX_FNCT02_ELEMENTS) {
+    if (this_mb_tx->rd_nelem > MB2HAL_MAX_FNCT02_ELEMENTS) {
         return retERR;
     }
 
     DBG(this_mb_tx->cfg_debug, "mb_tx[%d] mb_links[%d] slave[%d] fd[%d] 1st_addr[%d] nelem[%d]",
         this_mb_tx->mb_tx_num, this_mb_tx->mb_link_num, this_mb_tx->mb_tx_slave_id, modbus_get_socket(this_mb_link->modbus),
-        this_mb_tx->mb_tx_1st_addr, this_mb_tx->mb_tx_nelem);
+        this_mb_tx->rd_1st_addr, this_mb_tx->rd_nelem);
 
-    ret = modbus_read_input_bits(this_mb_link->modbus, this_mb_tx->mb_tx_1st_addr, this_mb_tx->mb_tx_nelem, bits);
+    ret = modbus_read_input_bits(this_mb_link->modbus, this_mb_tx->rd_1st_addr, this_mb_tx->rd_nelem, bits);
     if (ret < 0) {
         if (modbus_get_socket(this_mb_link->modbus) < 0) {
             modbus_close(this_mb_link->modbus);
@@ -65,11 +62,7 @@ retCode fnct_02_read_discrete_inputs(mb_tx_t *this_mb_tx, mb_link_t *this_mb_lin
         return retERR;
     }
 
-    for (counter = 0; counter < this_mb_tx->mb_tx_nelem; counter++) {
-        *(this_mb_tx->bit[counter]) = bits[counter];
-        if (gbl.version > 1000)
-            *(this_mb_tx->bit_inv[counter]) = !bits[counter];
-    }
+    set_read_bits(this_mb_tx, bits);
 
     return retOK;
 }
@@ -77,21 +70,21 @@ retCode fnct_02_read_discrete_inputs(mb_tx_t *this_mb_tx, mb_link_t *this_mb_lin
 retCode fnct_03_read_holding_registers(mb_tx_t *this_mb_tx, mb_link_t *this_mb_link)
 {
     char *fnct_name = "fnct_03_read_holding_registers";
-    int counter, ret;
+    int ret;
     uint16_t data[MB2HAL_MAX_FNCT03_ELEMENTS];
 
     if (this_mb_tx == NULL || this_mb_link == NULL) {
         return retERR;
     }
-    if (this_mb_tx->mb_tx_nelem > MB2HAL_MAX_FNCT03_ELEMENTS) {
+    if (this_mb_tx->rd_nelem > MB2HAL_MAX_FNCT03_ELEMENTS) {
         return retERR;
     }
 
     DBG(this_mb_tx->cfg_debug, "mb_tx[%d] mb_links[%d] slave[%d] fd[%d] 1st_addr[%d] nelem[%d]",
         this_mb_tx->mb_tx_num, this_mb_tx->mb_link_num, this_mb_tx->mb_tx_slave_id,
-        modbus_get_socket(this_mb_link->modbus), this_mb_tx->mb_tx_1st_addr, this_mb_tx->mb_tx_nelem);
+        modbus_get_socket(this_mb_link->modbus), this_mb_tx->rd_1st_addr, this_mb_tx->rd_nelem);
 
-    ret = modbus_read_registers(this_mb_link->modbus, this_mb_tx->mb_tx_1st_addr, this_mb_tx->mb_tx_nelem, data);
+    ret = modbus_read_registers(this_mb_link->modbus, this_mb_tx->rd_1st_addr, this_mb_tx->rd_nelem, data);
     if (ret < 0) {
         if (modbus_get_socket(this_mb_link->modbus) < 0) {
             modbus_close(this_mb_link->modbus);
@@ -102,13 +95,7 @@ retCode fnct_03_read_holding_registers(mb_tx_t *this_mb_tx, mb_link_t *this_mb_l
         return retERR;
     }
 
-    for (counter = 0; counter < this_mb_tx->mb_tx_nelem; counter++) {
-        float val = data[counter];
-        //val *= this_mb_tx->scale[counter];
-        //val += this_mb_tx->offset[counter];
-        *(this_mb_tx->float_value[counter]) = val;
-        *(this_mb_tx->int_value[counter]) = data[counter];
-    }
+    set_read_registers(this_mb_tx, data);
 
     return retOK;
 }
@@ -116,21 +103,21 @@ retCode fnct_03_read_holding_registers(mb_tx_t *this_mb_tx, mb_link_t *this_mb_l
 retCode fnct_04_read_input_registers(mb_tx_t *this_mb_tx, mb_link_t *this_mb_link)
 {
     char *fnct_name = "fnct_04_read_input_registers";
-    int counter, ret;
+    int ret;
     uint16_t data[MB2HAL_MAX_FNCT04_ELEMENTS];
 
     if (this_mb_tx == NULL || this_mb_link == NULL) {
         return retERR;
     }
-    if (this_mb_tx->mb_tx_nelem > MB2HAL_MAX_FNCT04_ELEMENTS) {
+    if (this_mb_tx->rd_nelem > MB2HAL_MAX_FNCT04_ELEMENTS) {
         return retERR;
     }
 
     DBG(this_mb_tx->cfg_debug, "mb_tx[%d] mb_links[%d] slave[%d] fd[%d] 1st_addr[%d] nelem[%d]",
         this_mb_tx->mb_tx_num, this_mb_tx->mb_link_num, this_mb_tx->mb_tx_slave_id,
-        modbus_get_socket(this_mb_link->modbus), this_mb_tx->mb_tx_1st_addr, this_mb_tx->mb_tx_nelem);
+        modbus_get_socket(this_mb_link->modbus), this_mb_tx->rd_1st_addr, this_mb_tx->rd_nelem);
 
-    ret = modbus_read_input_registers(this_mb_link->modbus, this_mb_tx->mb_tx_1st_addr, this_mb_tx->mb_tx_nelem, data);
+    ret = modbus_read_input_registers(this_mb_link->modbus, this_mb_tx->rd_1st_addr, this_mb_tx->rd_nelem, data);
     if (ret < 0) {
         if (modbus_get_socket(this_mb_link->modbus) < 0) {
             modbus_close(this_mb_link->modbus);
@@ -141,13 +128,7 @@ retCode fnct_04_read_input_registers(mb_tx_t *this_mb_tx, mb_link_t *this_mb_lin
         return retERR;
     }
 
-    for (counter = 0; counter < this_mb_tx->mb_tx_nelem; counter++) {
-        float val = data[counter];
-        //val += this_mb_tx->offset[counter];
-        //val *= this_mb_tx->scale[counter];
-        *(this_mb_tx->float_value[counter]) = val;
-        *(this_mb_tx->int_value[counter]) = data[counter];
-    }
+    set_read_registers(this_mb_tx, data);
 
     return retOK;
 }
@@ -155,7 +136,8 @@ retCode fnct_04_read_input_registers(mb_tx_t *this_mb_tx, mb_link_t *this_mb_lin
 retCode fnct_05_write_single_coil(mb_tx_t *this_mb_tx, mb_link_t *this_mb_link)
 {
     char *fnct_name = "fnct_05_write_single_coil";
-    int ret, bit;
+    int ret;
+    uint8_t bit;
 
     if (this_mb_tx == NULL || this_mb_link == NULL) {
         return retERR;
@@ -166,6 +148,12 @@ retCode fnct_05_write_single_coil(mb_tx_t *this_mb_tx, mb_link_t *this_mb_link)
 
     bit = *(this_mb_tx->bit[0]);
 
+    if (is_write_unchanged(this_mb_tx, &bit, sizeof(bit))) {
+        DBGMAX(this_mb_tx->cfg_debug, "mb_tx[%d] mb_links[%d] slave[%d] unchanged, not written",
+               this_mb_tx->mb_tx_num, this_mb_tx->mb_link_num, this_mb_tx->mb_tx_slave_id);
+        return retOK;
+    }
+
     DBG(this_mb_tx->cfg_debug, "mb_tx[%d] mb_links[%d] slave[%d] fd[%d] 1st_addr[%d] nelem[%d]",
         this_mb_tx->mb_tx_num, this_mb_tx->mb_link_num, this_mb_tx->mb_tx_slave_id,
         modbus_get_socket(this_mb_link->modbus), this_mb_tx->mb_tx_1st_addr, this_mb_tx->mb_tx_nelem);
@@ -178,8 +166,10 @@ retCode fnct_05_write_single_coil(mb_tx_t *this_mb_tx, mb_link_t *this_mb_link)
         ERR(this_mb_tx->cfg_debug, "mb_tx[%d] mb_links[%d] slave[%d] = ret[%d] fd[%d]",
             this_mb_tx->mb_tx_num, this_mb_tx->mb_link_num, this_mb_tx->mb_tx_slave_id, ret,
             modbus_get_socket(this_mb_link->modbus));
+        this_mb_tx->last_written_ok = 0;
         return retERR;
     }
+    set_last_written(this_mb_tx, &bit, sizeof(bit));
 
     return retOK;
 }
@@ -187,7 +177,8 @@ retCode fnct_05_write_single_coil(mb_tx_t *this_mb_tx, mb_link_t *this_mb_link)
 retCode fnct_06_write_single_register(mb_tx_t *this_mb_tx, mb_link_t *this_mb_link)
 {
     char *fnct_name = "fnct_06_write_single_register";
-    int ret, data;
+    int ret, data32;
+    uint16_t data;
 
     if (this_mb_tx == NULL || this_mb_link == NULL) {
         return retERR;
@@ -196,13 +187,20 @@ retCode fnct_06_write_single_register(mb_tx_t *this_mb_tx, mb_link_t *this_mb_li
         return retERR;
     }
 
-    data = *(this_mb_tx->float_value[0]);
+    data32 = *(this_mb_tx->float_value[0]);
     if (gbl.version > 1000)
-        data += *(this_mb_tx->int_value[0]);
-    if(data > UINT16_MAX) { // prevent wrap on overflow
-        data = UINT16_MAX;
+        data32 += *(this_mb_tx->int_value[0]);
+    if(data32 > UINT16_MAX) { // prevent wrap on overflow
+        data32 = UINT16_MAX;
     }
-    
+    data = data32;
+
+    if (is_write_unchanged(this_mb_tx, &data, sizeof(data))) {
+        DBGMAX(this_mb_tx->cfg_debug, "mb_tx[%d] mb_links[%d] slave[%d] unchanged, not written",
+               this_mb_tx->mb_tx_num, this_mb_tx->mb_link_num, this_mb_tx->mb_tx_slave_id);
+        return retOK;
+    }
+
     DBG(this_mb_tx->cfg_debug, "mb_tx[%d] mb_links[%d] slave[%d] fd[%d] 1st_addr[%d] nelem[%d]",
         this_mb_tx->mb_tx_num, this_mb_tx->mb_link_num, this_mb_tx->mb_tx_slave_id,
         modbus_get_socket(this_mb_link->modbus), this_mb_tx->mb_tx_1st_addr, this_mb_tx->mb_tx_nelem);
@@ -215,8 +213,10 @@ retCode fnct_06_write_single_register(mb_tx_t *this_mb_tx, mb_link_t *this_mb_li
         ERR(this_mb_tx->cfg_debug, "mb_tx[%d] mb_links[%d] slave[%d] = ret[%d] fd[%d]",
             this_mb_tx->mb_tx_num, this_mb_tx->mb_link_num, this_mb_tx->mb_tx_slave_id, ret,
             modbus_get_socket(this_mb_link->modbus));
+        this_mb_tx->last_written_ok = 0;
         return retERR;
     }
+    set_last_written(this_mb_tx, &data, sizeof(data));
 
     return retOK;
 }
@@ -238,6 +238,12 @@ retCode fnct_15_write_multiple_coils(mb_tx_t *this_mb_tx, mb_link_t *this_mb_lin
         bits[counter] = *(this_mb_tx->bit[counter]);
     }
 
+    if (is_write_unchanged(this_mb_tx, bits, this_mb_tx->mb_tx_nelem * sizeof(bits[0]))) {
+        DBGMAX(this_mb_tx->cfg_debug, "mb_tx[%d] mb_links[%d] slave[%d] unchanged, not written",
+               this_mb_tx->mb_tx_num, this_mb_tx->mb_link_num, this_mb_tx->mb_tx_slave_id);
+        return retOK;
+    }
+
     DBG(this_mb_tx->cfg_debug, "mb_tx[%d] mb_links[%d] slave[%d] fd[%d] 1st_addr[%d] nelem[%d]",
         this_mb_tx->mb_tx_num, this_mb_tx->mb_link_num, this_mb_tx->mb_tx_slave_id,
         modbus_get_socket(this_mb_link->modbus), this_mb_tx->mb_tx_1st_addr, this_mb_tx->mb_tx_nelem);
@@ -250,8 +256,10 @@ retCode fnct_15_write_multiple_coils(mb_tx_t *this_mb_tx, mb_link_t *this_mb_lin
         ERR(this_mb_tx->cfg_debug, "mb_tx[%d] mb_links[%d] slave[%d] = ret[%d] fd[%d]",
             this_mb_tx->mb_tx_num, this_mb_tx->mb_link_num, this_mb_tx->mb_tx_slave_id, ret,
             modbus_get_socket(this_mb_link->modbus));
+        this_mb_tx->last_written_ok = 0;
         return retERR;
     }
+    set_last_written(this_mb_tx, bits, this_mb_tx->mb_tx_nelem * sizeof(bits[0]));
 
     return retOK;
 }
@@ -283,6 +291,12 @@ retCode fnct_16_write_multiple_registers(mb_tx_t *this_mb_tx, mb_link_t *this_mb
         }
     }
 
+    if (is_write_unchanged(this_mb_tx, data, this_mb_tx->mb_tx_nelem * sizeof(data[0]))) {
+        DBGMAX(this_mb_tx->cfg_debug, "mb_tx[%d] mb_links[%d] slave[%d] unchanged, not written",
+               this_mb_tx->mb_tx_num, this_mb_tx->mb_link_num, this_mb_tx->mb_tx_slave_id);
+        return retOK;
+    }
+
     DBG(this_mb_tx->cfg_debug, "mb_tx[%d] mb_links[%d] slave[%d] fd[%d] 1st_addr[%d] nelem[%d]",
         this_mb_tx->mb_tx_num, this_mb_tx->mb_link_num, this_mb_tx->mb_tx_slave_id,
         modbus_get_socket(this_mb_link->modbus), this_mb_tx->mb_tx_1st_addr, this_mb_tx->mb_tx_nelem);
@@ -295,8 +309,75 @@ retCode fnct_16_write_multiple_registers(mb_tx_t *this_mb_tx, mb_link_t *this_mb
         ERR(this_mb_tx->cfg_debug, "mb_tx[%d] mb_links[%d] slave[%d] = ret[%d] fd[%d]",
             this_mb_tx->mb_tx_num, this_mb_tx->mb_link_num, this_mb_tx->mb_tx_slave_id, ret,
             modbus_get_socket(this_mb_link->modbus));
+        this_mb_tx->last_written_ok = 0;
         return retERR;
     }
+    set_last_written(this_mb_tx, data, this_mb_tx->mb_tx_nelem * sizeof(data[0]));
 
     return retOK;
 }
+
+/*
+ * Copy the bits read by a (maybe merged) transaction to its own pins
+ * and to the pins of the transactions merged into it
+ */
+void set_read_bits(mb_tx_t *this_mb_tx, const uint8_t *bits)
+{
+    int tx_counter, counter, offset;
+    mb_tx_t *dest_mb_tx;
+
+    for (tx_counter = 0; tx_counter < gbl.tot_mb_tx; tx_counter++) {
+        dest_mb_tx = &gbl.mb_tx[tx_counter];
+        if (dest_mb_tx != this_mb_tx && dest_mb_tx->merged_into != this_mb_tx->mb_tx_num) {
+            continue;
+        }
+        offset = dest_mb_tx->mb_tx_1st_addr - this_mb_tx->rd_1st_addr;
+        for (counter = 0; counter < dest_mb_tx->mb_tx_nelem; counter++) {
+            *(dest_mb_tx->bit[counter]) = bits[offset + counter];
+            if (gbl.version > 1000)
+                *(dest_mb_tx->bit_inv[counter]) = !bits[offset + counter];
+        }
+    }
+}
+
+/*
+ * Same as set_read_bits, for registers
+ */
+void set_read_registers(mb_tx_t *this_mb_tx, const uint16_t *data)
+{
+    int tx_counter, counter, offset;
+    mb_tx_t *dest_mb_tx;
+
+    for (tx_counter = 0; tx_counter < gbl.tot_mb_tx; tx_counter++) {
+        dest_mb_tx = &gbl.mb_tx[tx_counter];
+        if (dest_mb_tx != this_mb_tx && dest_mb_tx->merged_into != this_mb_tx->mb_tx_num) {
+            continue;
+        }
+        offset = dest_mb_tx->mb_tx_1st_addr - this_mb_tx->rd_1st_addr;
+        for (counter = 0; counter < dest_mb_tx->mb_tx_nelem; counter++) {
+            float val = data[offset + counter];
+            //val *= this_mb_tx->scale[counter];
+            //val += this_mb_tx->offset[counter];
+            *(dest_mb_tx->float_value[counter]) = val;
+            *(dest_mb_tx->int_value[counter]) = data[offset + counter];
+        }
+    }
+}
+
+/*
+ * WRITE_ON_CHANGE: true if data is what the last OK write sent
+ */
+int is_write_unchanged(mb_tx_t *this_mb_tx, const void *data, size_t size)
+{
+    return this_mb_tx->cfg_write_on_change != 0 && this_mb_tx->last_written_ok != 0
+           && this_mb_tx->last_written != NULL && memcmp(this_mb_tx->last_written, data, size) == 0;
+}
+
+void set_last_written(mb_tx_t *this_mb_tx, const void *data, size_t size)
+{
+    if (this_mb_tx->last_written == NULL) {
+        return;
+    }
+    memcpy(this_mb_tx->last_written, data, size);
+    this_mb_tx->last_written_ok = 1;
+}
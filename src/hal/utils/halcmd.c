@@ -68,6 +68,7 @@ FILE *halcmd_inifile = NULL;
 #include "hal.h"		/* HAL public API decls */
 #include "../hal_priv.h"	/* private HAL decls */
 #include "halcmd_commands.h"
+#include "startup_trace.h"
 
 /***********************************************************************
 *                  LOCAL FUNCTION DECLARATIONS                         *
@@ -316,6 +317,14 @@ static int parse_cmd1(char **argv) {
     if(!command) {
 	// special case: pin/param = newvalue
 	if(argc == 3 && !strcmp(argv[1], "=")) {
+	    if(halcmd_parallel_mode) {
+		int result = halcmd_parallel_flush();
+		if(result != 0) return result;
+	    }
+	    if(halcmd_batch_mode) {
+		char *args[] = {argv[0], argv[2], 0};
+		return halcmd_batch_add("setp", args);
+	    }
 	    return do_setp_cmd(argv[0], argv[2]);
 	} else {
             halcmd_error("Unknown command '%s'\n", argv[0]);
@@ -356,6 +365,26 @@ static int parse_cmd1(char **argv) {
 	    return -EINVAL;
         }
 
+	if(halcmd_parallel_mode && !halcmd_parallel_accepts(command->name)) {
+	    /* everything but loading needs the components loaded so far */
+	    result = halcmd_parallel_flush();
+	    if(result != 0) {
+		return result;
+	    }
+	}
+
+	if(halcmd_batch_mode) {
+	    /* queue the commands a batch can apply, and bring the HAL up
+	       to date before running anything else */
+	    if(halcmd_batch_accepts(command->name)) {
+		return halcmd_batch_add(command->name, REST(1));
+	    }
+	    result = halcmd_batch_flush();
+	    if(result != 0) {
+		return result;
+	    }
+	}
+
 #ifndef NO_INI
 	if(command->type & A_TILDE)
 	{
@@ -457,7 +486,21 @@ int halcmd_parse_cmd(char *tokens[])
     }
 
     hal_flag = 1;
-    retval = parse_cmd1(tokens);
+    if(startup_trace_enabled()) {
+	char name[128], where[LINELEN];
+	const char *file = halcmd_get_filename();
+	double start = startup_trace_now();
+	int n, len = 0;
+	/* the command as written, before parse_cmd1() changes tokens */
+	name[0] = '\0';
+	for(n = 0; n < MAX_TOK && tokens[n] && tokens[n][0] && len < (int)sizeof(name); n++)
+	    len += snprintf(name + len, sizeof(name) - len, "%s%s", n ? " " : "", tokens[n]);
+	snprintf(where, sizeof(where), "%s:%d", file ? file : "", halcmd_get_linenumber());
+	retval = parse_cmd1(tokens);
+	startup_trace_span("halcmd", name, start, 0, where);
+    } else {
+	retval = parse_cmd1(tokens);
+    }
     hal_flag = 0;
     return retval;
 }
@@ -42,6 +42,7 @@
 #include "hal.h"		/* HAL public API decls */
 #include "../hal_priv.h"	/* private HAL decls */
 #include "halcmd_commands.h"
+#include "startup_trace.h"
 #include <rtapi_mutex.h>
 #include <rtapi_string.h>
 
@@ -616,24 +617,35 @@ int do_newinst_cmd(char *comp_name, char *inst_name) {
 }
 #endif /* newinst deferred */
 
+static int parse_sig_type(const char *name, hal_type_t *type)
+{
+    if (strcasecmp(name, "bit") == 0) {
+	*type = HAL_BIT;
+    } else if (strcasecmp(name, "float") == 0) {
+	*type = HAL_FLOAT;
+    } else if (strcasecmp(name, "u32") == 0) {
+	*type = HAL_U32;
+    } else if (strcasecmp(name, "s32") == 0) {
+	*type = HAL_S32;
+    } else if (strcasecmp(name, "u64") == 0) {
+	*type = HAL_U64;
+    } else if (strcasecmp(name, "s64") == 0) {
+	*type = HAL_S64;
+    } else if (strcasecmp(name, "port") == 0) {
+	*type = HAL_PORT;
+    } else {
+	return -EINVAL;
+    }
+    return 0;
+}
+
 int do_newsig_cmd(char *name, char *type)
 {
     int retval;
+    hal_type_t sig_type;
 
-    if (strcasecmp(type, "bit") == 0) {
-	retval = hal_signal_new(name, HAL_BIT);
-    } else if (strcasecmp(type, "float") == 0) {
-	retval = hal_signal_new(name, HAL_FLOAT);
-    } else if (strcasecmp(type, "u32") == 0) {
-	retval = hal_signal_new(name, HAL_U32);
-    } else if (strcasecmp(type, "s32") == 0) {
-	retval = hal_signal_new(name, HAL_S32);
-    } else if (strcasecmp(type, "u64") == 0) {
-    retval = hal_signal_new(name, HAL_U64);
-    } else if (strcasecmp(type, "s64") == 0) {
-    retval = hal_signal_new(name, HAL_S64);
-    } else if (strcasecmp(type, "port") == 0) {
-	retval = hal_signal_new(name, HAL_PORT);
+    if (parse_sig_type(type, &sig_type) == 0) {
+	retval = hal_signal_new(name, sig_type);
     } else {
 	halcmd_error("Unknown signal type '%s'\n", type);
 	retval = -EINVAL;
@@ -1115,14 +1127,19 @@ int do_status_cmd(char *type)
     return 0;
 }
 
+static int loadrt_finish(const char *mod_name, char *args[]);
+#if defined(RTAPI_USPACE)
+static int parallel_add_rt(char *mod_name, char *args[]);
+#endif
+
 int do_loadrt_cmd(char *mod_name, char *args[])
 {
-    char arg_string[MAX_CMD_LEN+1];
     int m=0, n=0, retval;
-    hal_comp_t *comp;
     const char *argv[MAX_TOK+3];
-    char *cp1;
 #if defined(RTAPI_USPACE)
+    if (halcmd_parallel_mode) {
+	return parallel_add_rt(mod_name, args);
+    }
     argv[m++] = "-Wn";
     argv[m++] = mod_name;
     argv[m++] = EMC2_BIN_DIR "/rtapi_app";
@@ -1192,6 +1209,17 @@ int do_loadrt_cmd(char *mod_name, char *args[])
         , mod_name, retval );
 	return -1;
     }
+    return loadrt_finish(mod_name, args);
+}
+
+/* record the arguments of a module that has just been loaded */
+static int loadrt_finish(const char *mod_name, char *args[])
+{
+    char arg_string[MAX_CMD_LEN+1];
+    int n;
+    hal_comp_t *comp;
+    char *cp1;
+
     /* make the args that were passed to the module into a single string */
     n = 0;
     arg_string[0] = '\0';
@@ -1468,8 +1496,10 @@ is not fixed or has regressed by debian jessie)
 #endif
 }
 
+#include <algorithm>
 #include <set>
 #include <string>
+#include <vector>
 
 static std::set<std::string> get_all_comp_names() {
     std::set<std::string> result;
@@ -1490,6 +1520,85 @@ static void warn_newly_loaded_comps(std::set<std::string> &names, const char *ne
     std::swap(new_names, names);
 }
 
+/* a program started by loadusr, or rtapi_app started by loadrt, that
+   is waited for to become ready */
+struct pending_load {
+    std::vector<std::string> argv;	/* for loadrt, until it is started */
+    std::string rt_module;		/* empty for loadusr */
+    std::vector<std::string> rt_args;
+    std::string prog_name, comp_name;
+    std::set<std::string> comp_names_pre;
+    std::string filename;
+    int linenumber;
+    pid_t pid;
+    int exited;
+    double start;			/* startup_trace_now() when started */
+};
+
+static pid_t load_start(pending_load &p, const char *argv[])
+{
+    p.pid = -1;
+    p.exited = 0;
+    p.comp_names_pre = get_all_comp_names();
+    p.start = startup_trace_now();
+    /* start the child process */
+    p.pid = hal_systemv_nowait(argv);
+    /* make sure we reconnected to the HAL */
+    if (comp_id < 0) {
+	fprintf(stderr, "halcmd: hal_init() failed after fork: %d\n",
+	    comp_id );
+	exit(-1);
+    }
+    hal_ready(comp_id);
+    return p.pid;
+}
+
+/* 1 once the component is ready, -1 if the program ended (or can't be
+   waited for) without making it ready, 0 while neither has happened */
+static int load_poll(pending_load &p)
+{
+    int ready = 0, status, retval;
+    hal_comp_t *comp;
+
+    /* check for program ending */
+    if (!p.exited) {
+	retval = waitpid(p.pid, &status, WNOHANG);
+	if (retval < 0) {
+	    halcmd_error("\nwaitpid(%d) failed\n", p.pid);
+	    return -1;
+	}
+	if (retval != 0) {
+	    p.exited = 1;
+	    if (WIFEXITED(status) && WEXITSTATUS(status)) {
+		halcmd_error("waitpid failed %s %s\n", p.prog_name.c_str(),
+		    p.comp_name.c_str());
+		return -1;
+	    }
+	}
+    }
+    /* check for program becoming ready */
+    rtapi_mutex_get(&(hal_data->mutex));
+    comp = halpr_find_comp_by_name(p.comp_name.c_str());
+    if (comp && comp->ready) {
+	ready = 1;
+    }
+    rtapi_mutex_give(&(hal_data->mutex));
+    if (ready) return 1;
+    return p.exited ? -1 : 0;
+}
+
+/* sleep between checks on starting programs: most components are ready
+   within a few milliseconds, so start with 1 mS and back off to 10 mS */
+static void load_nap(long *ns)
+{
+    struct timespec ts = {0, *ns};
+    nanosleep(&ts, NULL);
+    *ns = std::min(*ns * 2, 10 * 1000 * 1000L);
+}
+
+static int parallel_add(pending_load &&p);
+static int parallel_rt_pending(void);
+
 int do_loadusr_cmd(const char *args[])
 {
     int wait_flag, wait_comp_flag, ignore_flag;
@@ -1497,6 +1606,7 @@ int do_loadusr_cmd(const char *args[])
     const char *argv[MAX_TOK+1];
     int n, m, retval, status;
     pid_t pid;
+    pending_load p;
 
     int argc = 0;
     while(args[argc] && *args[argc]) argc++;
@@ -1539,7 +1649,14 @@ int do_loadusr_cmd(const char *args[])
 	new_comp_name = guess_comp_name(prog_name);
     }
 
-    std::set<std::string> comp_names_pre = get_all_comp_names();
+    /* in parallel mode, only waits for a component to become ready
+       overlap; anything else runs once all of those are done.  So does
+       a program queued behind a loadrt, it may look for its pins */
+    if (halcmd_parallel_mode &&
+	    (!(wait_comp_flag && !wait_flag) || parallel_rt_pending())) {
+	retval = halcmd_parallel_flush();
+	if (retval != 0) return retval;
+    }
 
     /* prepare to exec() the program */
     argv[0] = prog_name;
@@ -1551,68 +1668,46 @@ int do_loadusr_cmd(const char *args[])
     }
     /* add a NULL to terminate the argv array */
     argv[m] = NULL;
-    /* start the child process */
-    pid = hal_systemv_nowait(argv);
-    /* make sure we reconnected to the HAL */
-    if (comp_id < 0) {
-	fprintf(stderr, "halcmd: hal_init() failed after fork: %d\n",
-	    comp_id );
-	exit(-1);
+    p.prog_name = prog_name;
+    p.comp_name = new_comp_name;
+    pid = load_start(p, argv);
+    if (pid < 0) return -1;
+    if ( wait_comp_flag && halcmd_parallel_mode && !wait_flag ) {
+	halcmd_info("Program '%s' started\n", prog_name);
+	return parallel_add(std::move(p));
     }
-    hal_ready(comp_id);
     if ( wait_comp_flag ) {
-        int ready = 0, count=0, exited=0;
-        hal_comp_t *comp = NULL;
-	retval = 0;
-        while(!ready && !exited) {
-	    /* sleep for 10mS */
-            struct timespec ts = {0, 10 * 1000 * 1000};
-            nanosleep(&ts, NULL);
-	    /* check for program ending */
-	    retval = waitpid( pid, &status, WNOHANG );
-	    if ( retval != 0 ) {
-		    exited = 1;
-	        if (WIFEXITED(status) && WEXITSTATUS(status)) {
-	            halcmd_error("waitpid failed %s %s\n",prog_name,new_comp_name);
-	            ready = 0;
-	            break;
-	        }
+        int ready = 0, pacified = 0;
+        long ns = 1000 * 1000;
+        double next_dot = p.start + 2e6;
+	while (!ready) {
+	    load_nap(&ns);
+	    ready = load_poll(p);
+	    if (ready < 0) {
+		if (p.exited) {
+		    halcmd_error("%s exited without becoming ready\n", prog_name);
+		}
+		return -1;
 	    }
-	    /* check for program becoming ready */
-            rtapi_mutex_get(&(hal_data->mutex));
-            comp = halpr_find_comp_by_name(new_comp_name);
-            if(comp && comp->ready) {
-                ready = 1;
-            }
-            rtapi_mutex_give(&(hal_data->mutex));
 	    /* pacify the user */
-            count++;
-            if(count == 200) {
-                fprintf(stderr, "Waiting for component '%s' to become ready.",
-                        new_comp_name);
-                warn_newly_loaded_comps(comp_names_pre, new_comp_name);
-                fflush(stderr);
-            } else if(count > 200 && count % 10 == 0) {
-                fprintf(stderr, ".");
-                warn_newly_loaded_comps(comp_names_pre, new_comp_name);
-                fflush(stderr);
-            }
+	    if (!ready && startup_trace_now() >= next_dot) {
+		if (!pacified) {
+		    fprintf(stderr, "Waiting for component '%s' to become ready.",
+			    new_comp_name);
+		    pacified = 1;
+		} else {
+		    fprintf(stderr, ".");
+		}
+		warn_newly_loaded_comps(p.comp_names_pre, new_comp_name);
+		fflush(stderr);
+		next_dot += 1e5;
+	    }
         }
-        if (count >= 100) {
+        if (pacified) {
 	    /* terminate pacifier */
 	    fprintf(stderr, "\n");
 	}
-	/* did it work? */
-	if (ready) {
-	    halcmd_info("Component '%s' ready\n", new_comp_name);
-	} else {
-	    if ( retval < 0 ) {
-		halcmd_error("\nwaitpid(%d) failed\n", pid);
-	    } else {
-		halcmd_error("%s exited without becoming ready\n", prog_name);
-	    }
-	    return -1;
-	}
+	halcmd_info("Component '%s' ready\n", new_comp_name);
     }
     if ( wait_flag ) {
 	/* wait for child process to complete */
@@ -1642,6 +1737,188 @@ int do_loadusr_cmd(const char *args[])
     return 0;
 }
 
+/***********************************************************************
+*                         PARALLEL LOADING                             *
+************************************************************************/
+
+/* With 'halcmd -p', loadusr -W (or -Wn) does not wait for the component
+   to become ready, and loadrt does not wait for the module to load,
+   before going on to the next command.  Realtime modules are still
+   loaded one at a time and in order, since a module may need one loaded
+   before it (motmod needs the kinematics, for instance) and rtapi_app
+   loads them one at a time anyway.  So a run of load commands starts
+   every user component of the run right away, and they come up while
+   the realtime modules load.  Any other command, and the end of input,
+   waits for the whole run first; its errors are reported at the file
+   and line of the command that failed. */
+
+#include <list>
+
+int halcmd_parallel_mode = 0;
+
+namespace {
+
+std::list<pending_load> pending;
+
+/* haltcl does not set a file name */
+std::string parallel_filename() {
+    const char *filename = halcmd_get_filename();
+    return filename ? filename : "";
+}
+
+void parallel_locate(const pending_load &p) {
+    if(parallel_filename() != p.filename)
+        halcmd_set_filename(p.filename.c_str());
+    halcmd_set_linenumber(p.linenumber);
+}
+
+/* start the first queued loadrt, unless one is loading already */
+int parallel_start_rt() {
+    for(auto it = pending.begin(); it != pending.end(); ++it) {
+        if(it->rt_module.empty()) continue;
+        if(it->pid >= 0) return 0;
+        if(it->argv.empty()) continue;
+        std::vector<const char *> argv;
+        for(auto &a : it->argv) argv.push_back(a.c_str());
+        argv.push_back(NULL);
+        pid_t pid = load_start(*it, argv.data());
+        it->argv.clear();  /* only now, argv points into it */
+        if(pid < 0) {
+            parallel_locate(*it);
+            halcmd_error("insmod for %s failed\n", it->rt_module.c_str());
+            pending.erase(it);
+            return -1;
+        }
+        return 0;
+    }
+    return 0;
+}
+
+/* the component of p is ready, or its program gave up (ready < 0) */
+int parallel_done(pending_load &p, int ready) {
+    std::string name = (p.rt_module.empty() ? "loadusr " : "loadrt ")
+        + (p.rt_module.empty() ? p.prog_name : p.rt_module);
+    std::string where = p.filename + ":" + std::to_string(p.linenumber);
+    int retval = 0;
+
+    parallel_locate(p);
+    startup_trace_span("load", name.c_str(), p.start, p.pid, where.c_str());
+    if(ready < 0) {
+        if(!p.rt_module.empty()) {
+            halcmd_error("insmod for %s failed\n", p.rt_module.c_str());
+        } else if(p.exited) {
+            halcmd_error("%s exited without becoming ready\n",
+                p.prog_name.c_str());
+        }
+        return -1;
+    }
+    if(!p.rt_module.empty()) {
+        std::vector<char *> args;
+        for(auto &a : p.rt_args) args.push_back(&a[0]);
+        args.push_back(NULL);
+        retval = loadrt_finish(p.rt_module.c_str(), args.data());
+    } else {
+        halcmd_info("Component '%s' ready\n", p.comp_name.c_str());
+    }
+    return retval;
+}
+
+} // namespace
+
+static int parallel_rt_pending(void)
+{
+    for(auto &p : pending)
+        if(!p.rt_module.empty()) return 1;
+    return 0;
+}
+
+static int parallel_add(pending_load &&p)
+{
+    p.filename = parallel_filename();
+    p.linenumber = halcmd_get_linenumber();
+    pending.push_back(std::move(p));
+    return 0;
+}
+
+#if defined(RTAPI_USPACE)
+static int parallel_add_rt(char *mod_name, char *args[])
+{
+    pending_load p;
+
+    if (hal_get_lock()&HAL_LOCK_LOAD) {
+	halcmd_error("HAL is locked, loading of programs is not permitted\n");
+	return -EPERM;
+    }
+    p.argv = {EMC2_BIN_DIR "/rtapi_app", "load", mod_name};
+    for(int n = 0; args[n] && args[n][0]; n++) {
+        p.argv.push_back(args[n]);
+        p.rt_args.push_back(args[n]);
+    }
+    p.rt_module = p.prog_name = p.comp_name = mod_name;
+    p.pid = -1;
+    parallel_add(std::move(p));
+    return parallel_start_rt();
+}
+#endif
+
+int halcmd_parallel_accepts(const char *command)
+{
+    return !strcmp(command, "loadrt") || !strcmp(command, "loadusr");
+}
+
+int halcmd_parallel_flush(void)
+{
+    int retval = 0, pacified = 0;
+    long ns = 1000 * 1000;
+    double t0, next_dot;
+
+    if(pending.empty()) return 0;
+
+    std::string filename_save = parallel_filename();
+    int lineno_save = halcmd_get_linenumber();
+    t0 = startup_trace_now();
+    next_dot = t0 + 2e6;
+    while(!pending.empty() && !halcmd_done) {
+        int progress = 0;
+        for(auto it = pending.begin(); it != pending.end(); ) {
+            int ready = it->pid < 0 ? 0 : load_poll(*it);
+            if(ready == 0) {
+                ++it;
+                continue;
+            }
+            if(parallel_done(*it, ready) < 0) retval = -1;
+            it = pending.erase(it);
+            progress = 1;
+        }
+        if(parallel_start_rt() < 0) retval = -1;
+        if(pending.empty()) break;
+        if(progress) ns = 1000 * 1000;
+        load_nap(&ns);
+        /* pacify the user */
+        if(startup_trace_now() >= next_dot) {
+            if(!pacified) {
+                fprintf(stderr, "Waiting for");
+                for(auto &p : pending)
+                    fprintf(stderr, " '%s'", p.comp_name.c_str());
+                fprintf(stderr, " to become ready.");
+                pacified = 1;
+            } else {
+                fprintf(stderr, ".");
+            }
+            fflush(stderr);
+            next_dot += 1e5;
+        }
+    }
+    if(pacified) fprintf(stderr, "\n");
+    if(halcmd_done) {
+        pending.clear();
+        retval = -1;
+    }
+    startup_trace_span("halcmd", "wait for loads", t0, 0, NULL);
+    halcmd_set_filename(filename_save.c_str());
+    halcmd_set_linenumber(lineno_save);
+    return retval;
+}
 
 int do_waitusr_cmd(char *comp_name)
 {
@@ -1685,6 +1962,497 @@ int do_waitusr_cmd(char *comp_name)
 }
 
 
+/***********************************************************************
+*                         BATCH MODE                                   *
+************************************************************************/
+
+/* With 'halcmd -b', the commands that only create signals, link pins
+   and set values (net, newsig, linkps, linksp, setp, sets) are queued
+   instead of run.  When another command needs the HAL to be up to date,
+   or the input ends, the queue is flushed: the HAL mutex is taken once,
+   the pins, params and signals are indexed by name once, every queued
+   command is checked against that index (and against what the commands
+   before it in the batch will have done), and only if all of them pass
+   are they applied, in order.  A batch is all or nothing: each error is
+   reported at the file and line of the command that caused it, and
+   nothing from that batch is applied. */
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+int halcmd_batch_mode = 0;
+
+namespace {
+
+struct batch_cmd {
+    std::vector<std::string> args;	/* command name, then its arguments */
+    std::string filename;
+    int linenumber;
+};
+
+/* a signal as it will be once the batch before the current command
+   has been applied */
+struct batch_sig {
+    hal_sig_t *sig;		/* null if the batch creates it */
+    hal_type_t type;
+    int readers, writers, bidirs;
+    const char *writer_name, *bidir_name;
+};
+
+struct batch_state {
+    std::unordered_map<std::string, hal_pin_t *> pins;
+    std::unordered_map<std::string, hal_param_t *> params;
+    std::unordered_map<std::string, batch_sig> sigs;
+    /* signal each pin touched by the batch will be linked to */
+    std::unordered_map<hal_pin_t *, const std::string *> links;
+
+    hal_pin_t *find_pin(const std::string &name) {
+        auto it = pins.find(name);
+        return it == pins.end() ? nullptr : it->second;
+    }
+    hal_param_t *find_param(const std::string &name) {
+        auto it = params.find(name);
+        return it == params.end() ? nullptr : it->second;
+    }
+    batch_sig *find_sig(const std::string &name) {
+        auto it = sigs.find(name);
+        return it == sigs.end() ? nullptr : &it->second;
+    }
+    /* name of the signal 'pin' is linked to, or null */
+    const char *linked_to(hal_pin_t *pin) {
+        auto it = links.find(pin);
+        if(it != links.end()) return it->second->c_str();
+        if(pin->signal) return SHMPTR(pin->signal)->name;
+        return nullptr;
+    }
+};
+
+std::vector<batch_cmd> batch;
+double batch_total_time;
+int batch_total_commands;
+
+double batch_now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void batch_locate(const batch_cmd &cmd) {
+    if(strcmp(halcmd_get_filename(), cmd.filename.c_str()))
+        halcmd_set_filename(cmd.filename.c_str());
+    halcmd_set_linenumber(cmd.linenumber);
+}
+
+void batch_index(batch_state &st) {
+    for(auto next = hal_data->sig_list_ptr; next; next = next->next_ptr) {
+        hal_sig_t *sig = SHMPTR(next);
+        st.sigs[sig->name] = batch_sig{sig, sig->type,
+            sig->readers, sig->writers, sig->bidirs, nullptr, nullptr};
+    }
+    for(auto next = hal_data->pin_list_ptr; next; next = next->next_ptr) {
+        hal_pin_t *pin = SHMPTR(next);
+        st.pins[pin->name] = pin;
+        if(pin->signal) {
+            batch_sig &s = st.sigs[SHMPTR(pin->signal)->name];
+            if(pin->dir == HAL_OUT) s.writer_name = pin->name;
+            if(pin->dir == HAL_IO) s.bidir_name = s.writer_name = pin->name;
+        }
+    }
+    /* old names only where they don't hide a current name */
+    for(auto next = hal_data->pin_list_ptr; next; next = next->next_ptr) {
+        hal_pin_t *pin = SHMPTR(next);
+        if(pin->oldname) st.pins.emplace(SHMPTR(pin->oldname)->name, pin);
+    }
+    for(auto next = hal_data->param_list_ptr; next; next = next->next_ptr) {
+        hal_param_t *param = SHMPTR(next);
+        st.params[param->name] = param;
+    }
+    for(auto next = hal_data->param_list_ptr; next; next = next->next_ptr) {
+        hal_param_t *param = SHMPTR(next);
+        if(param->oldname) st.params.emplace(SHMPTR(param->oldname)->name, param);
+    }
+}
+
+int batch_check_config_lock(const char *what) {
+    if(hal_data->lock & HAL_LOCK_CONFIG) {
+        halcmd_error("%s: HAL is locked\n", what);
+        return -EPERM;
+    }
+    return 0;
+}
+
+/* the checks hal_link() makes, against the batch's view of 's' */
+int batch_check_dir(const std::string &signame, const batch_sig &s,
+        hal_pin_t *pin) {
+    if(pin->dir == HAL_OUT && (s.writers || s.bidirs)) {
+        halcmd_error(
+            "Signal '%s' can not add %s pin '%s', "
+            "it already has %s pin '%s'\n",
+            signame.c_str(), pin_data_dir(pin->dir), pin->name,
+            s.bidir_name ? pin_data_dir(HAL_IO) : pin_data_dir(HAL_OUT),
+            s.bidir_name ? s.bidir_name : s.writer_name);
+        return -EINVAL;
+    }
+    if(pin->dir == HAL_IO && pin->type == HAL_PORT) {
+        halcmd_error("Signal '%s' is a port and cannot have I/O pin(s)\n",
+            signame.c_str());
+        return -EINVAL;
+    }
+    if(pin->dir == HAL_IO && s.writers) {
+        halcmd_error(
+            "Signal '%s' can not add %s pin '%s', "
+            "it already has %s pin '%s'\n",
+            signame.c_str(), pin_data_dir(pin->dir), pin->name,
+            pin_data_dir(HAL_OUT), s.writer_name);
+        return -EINVAL;
+    }
+    if(pin->type == HAL_PORT && pin->dir == HAL_IN && s.readers) {
+        halcmd_error("Signal '%s' can only have one input pin\n",
+            signame.c_str());
+        return -EINVAL;
+    }
+    return 0;
+}
+
+void batch_add_link(batch_state &st, const std::string &signame,
+        batch_sig &s, hal_pin_t *pin) {
+    if(pin->dir & HAL_IN) s.readers++;
+    if(pin->dir == HAL_OUT) { s.writers++; s.writer_name = pin->name; }
+    if(pin->dir == HAL_IO) {
+        s.bidirs++; s.bidir_name = s.writer_name = pin->name;
+    }
+    st.links[pin] = &st.sigs.find(signame)->first;
+}
+
+int batch_check_value(hal_type_t type, std::string &value) {
+    char *cp;
+    if(type == HAL_PORT) {
+        strtoul(value.c_str(), &cp, 0);
+        if(*cp != '\0' && !isspace(*cp)) {
+            halcmd_error("value '%s' invalid for PORT\n", value.c_str());
+            return -EINVAL;
+        }
+        return 0;
+    }
+    hal_data_u scratch;
+    return set_common(type, &scratch, &value[0]);
+}
+
+int batch_check_net(batch_state &st, batch_cmd &cmd) {
+    const std::string &signame = cmd.args[1];
+    batch_sig *s = st.find_sig(signame);
+    batch_sig news{};
+    int type = s ? (int)s->type : -1, pincnt = 0;
+    std::vector<hal_pin_t *> adding;
+
+    if(!s && signame.size() > HAL_NAME_LEN) {
+        halcmd_error("signal name '%s' is too long\n", signame.c_str());
+        return -EINVAL;
+    }
+    if(st.find_pin(signame)) {
+        halcmd_error(
+                "Signal name '%s' must not be the same as a pin.  "
+                "Did you omit the signal name?\n",
+            signame.c_str());
+        return -ENOENT;
+    }
+    if(s) news = *s;
+    for(size_t i = 2; i < cmd.args.size(); i++) {
+        hal_pin_t *pin = st.find_pin(cmd.args[i]);
+        if(!pin) {
+            halcmd_error("Pin '%s' does not exist\n", cmd.args[i].c_str());
+            return -ENOENT;
+        }
+        const char *osig = st.linked_to(pin);
+        if((osig && signame == osig)
+                || std::find(adding.begin(), adding.end(), pin) != adding.end()) {
+            /* Already on this signal */
+            pincnt++;
+            continue;
+        } else if(osig) {
+            halcmd_error("Pin '%s' was already linked to signal '%s'\n",
+                pin->name, osig);
+            return -EINVAL;
+        }
+        if(type == -1) {
+            /* no pre-existing type, use this pin's type */
+            type = pin->type;
+            news.type = pin->type;
+        }
+        if(type != pin->type) {
+            halcmd_error(
+                "Signal '%s' of type '%s' cannot add pin '%s' of type '%s'\n",
+                signame.c_str(), data_type2(type), pin->name,
+                data_type2(pin->type));
+            return -EINVAL;
+        }
+        if(batch_check_dir(signame, news, pin) < 0) return -EINVAL;
+        if(pin->dir & HAL_IN) news.readers++;
+        if(pin->dir == HAL_OUT) { news.writers++; news.writer_name = pin->name; }
+        if(pin->dir == HAL_IO) {
+            news.bidirs++; news.bidir_name = news.writer_name = pin->name;
+        }
+        adding.push_back(pin);
+        pincnt++;
+    }
+    if(!pincnt) {
+        halcmd_error("'net' requires at least one pin, none given\n");
+        return -EINVAL;
+    }
+    if(adding.size() && batch_check_config_lock("net") < 0) return -EPERM;
+    /* everything matches up, so record what the net will do */
+    if(!s) s = &st.sigs.emplace(signame, news).first->second;
+    else *s = news;
+    for(hal_pin_t *pin : adding)
+        st.links[pin] = &st.sigs.find(signame)->first;
+    return 0;
+}
+
+int batch_check_link(batch_state &st, const std::string &pinname,
+        const std::string &signame) {
+    hal_pin_t *pin = st.find_pin(pinname);
+    batch_sig *s = st.find_sig(signame);
+    if(!pin) {
+        halcmd_error("pin '%s' not found\n", pinname.c_str());
+        return -EINVAL;
+    }
+    if(!s) {
+        halcmd_error("signal '%s' not found\n", signame.c_str());
+        return -EINVAL;
+    }
+    if(batch_check_config_lock("link") < 0) return -EPERM;
+    const char *osig = st.linked_to(pin);
+    if(osig && signame == osig) return 0;
+    if(osig) {
+        halcmd_error("pin '%s' is linked to '%s', cannot link to '%s'\n",
+            pin->name, osig, signame.c_str());
+        return -EINVAL;
+    }
+    if(pin->type != s->type) {
+        halcmd_error("type mismatch '%s' <- '%s'\n",
+            pin->name, signame.c_str());
+        return -EINVAL;
+    }
+    if(batch_check_dir(signame, *s, pin) < 0) return -EINVAL;
+    batch_add_link(st, signame, *s, pin);
+    return 0;
+}
+
+int batch_check_cmd(batch_state &st, batch_cmd &cmd) {
+    const std::string &name = cmd.args[0];
+
+    if(name == "net") {
+        return batch_check_net(st, cmd);
+    } else if(name == "linkps") {
+        return batch_check_link(st, cmd.args[1], cmd.args[2]);
+    } else if(name == "linksp") {
+        return batch_check_link(st, cmd.args[2], cmd.args[1]);
+    } else if(name == "newsig") {
+        const std::string &signame = cmd.args[1];
+        hal_type_t type;
+        if(parse_sig_type(cmd.args[2].c_str(), &type) < 0) {
+            halcmd_error("Unknown signal type '%s'\n", cmd.args[2].c_str());
+            return -EINVAL;
+        }
+        if(signame.size() > HAL_NAME_LEN) {
+            halcmd_error("signal name '%s' is too long\n", signame.c_str());
+            return -EINVAL;
+        }
+        if(st.find_sig(signame)) {
+            halcmd_error("duplicate signal '%s'\n", signame.c_str());
+            return -EINVAL;
+        }
+        if(batch_check_config_lock("newsig") < 0) return -EPERM;
+        st.sigs.emplace(signame,
+            batch_sig{nullptr, type, 0, 0, 0, nullptr, nullptr});
+        return 0;
+    } else if(name == "setp") {
+        hal_param_t *param = st.find_param(cmd.args[1]);
+        if(param) {
+            if(param->dir == HAL_RO) {
+                halcmd_error("param '%s' is not writable\n",
+                    cmd.args[1].c_str());
+                return -EINVAL;
+            }
+            return batch_check_value(param->type, cmd.args[2]);
+        }
+        hal_pin_t *pin = st.find_pin(cmd.args[1]);
+        if(!pin) {
+            halcmd_error("parameter or pin '%s' not found\n",
+                cmd.args[1].c_str());
+            return -EINVAL;
+        }
+        if(pin->dir == HAL_OUT) {
+            halcmd_error("pin '%s' is not writable\n", cmd.args[1].c_str());
+            return -EINVAL;
+        }
+        if(st.linked_to(pin)) {
+            halcmd_error("pin '%s' is connected to a signal\n",
+                cmd.args[1].c_str());
+            return -EINVAL;
+        }
+        return batch_check_value(pin->type, cmd.args[2]);
+    } else if(name == "sets") {
+        batch_sig *s = st.find_sig(cmd.args[1]);
+        if(!s) {
+            halcmd_error("signal '%s' not found\n", cmd.args[1].c_str());
+            return -EINVAL;
+        }
+        if(s->type != HAL_PORT && s->writers > 0) {
+            halcmd_error("signal '%s' already has writer(s)\n",
+                cmd.args[1].c_str());
+            return -EINVAL;
+        }
+        return batch_check_value(s->type, cmd.args[2]);
+    }
+    halcmd_error("BUG: '%s' queued in batch\n", name.c_str());
+    return -EINVAL;
+}
+
+/* create 'signame' if the batch made it up, and return it */
+hal_sig_t *batch_apply_sig(batch_state &st, const std::string &signame) {
+    batch_sig *s = st.find_sig(signame);
+    if(!s->sig && halpr_signal_new(signame.c_str(), s->type, &s->sig) < 0)
+        return nullptr;
+    return s->sig;
+}
+
+int batch_apply_link(batch_state &st, const std::string &pinname,
+        const std::string &signame) {
+    hal_sig_t *sig = batch_apply_sig(st, signame);
+    if(!sig || halpr_link(st.find_pin(pinname), sig) < 0) {
+        halcmd_error("link failed\n");
+        return -EINVAL;
+    }
+    halcmd_info("Pin '%s' linked to signal '%s'\n",
+        pinname.c_str(), signame.c_str());
+    return 0;
+}
+
+int batch_apply_cmd(batch_state &st, batch_cmd &cmd) {
+    const std::string &name = cmd.args[0];
+    int retval;
+
+    if(name == "net") {
+        for(size_t i = 2; i < cmd.args.size(); i++) {
+            retval = batch_apply_link(st, cmd.args[i], cmd.args[1]);
+            if(retval < 0) return retval;
+        }
+        return 0;
+    } else if(name == "linkps") {
+        return batch_apply_link(st, cmd.args[1], cmd.args[2]);
+    } else if(name == "linksp") {
+        return batch_apply_link(st, cmd.args[2], cmd.args[1]);
+    } else if(name == "newsig") {
+        if(!batch_apply_sig(st, cmd.args[1])) {
+            halcmd_error("newsig failed\n");
+            return -EINVAL;
+        }
+        return 0;
+    } else if(name == "setp") {
+        hal_param_t *param = st.find_param(cmd.args[1]);
+        if(param) {
+            retval = set_common(param->type, SHMPTR(param->data_ptr),
+                &cmd.args[2][0]);
+        } else {
+            hal_pin_t *pin = st.find_pin(cmd.args[1]);
+            retval = set_common(pin->type, &pin->dummysig, &cmd.args[2][0]);
+        }
+        if(retval < 0) {
+            halcmd_error("setp failed\n");
+            return retval;
+        }
+        halcmd_info("%s '%s' set to %s\n", param ? "Parameter" : "Pin",
+            cmd.args[1].c_str(), cmd.args[2].c_str());
+        return 0;
+    } else if(name == "sets") {
+        hal_sig_t *sig = st.find_sig(cmd.args[1])->sig;
+        retval = set_common(sig->type, SHMPTR(sig->data_ptr), &cmd.args[2][0]);
+        if(retval < 0) {
+            halcmd_error("sets failed\n");
+            return retval;
+        }
+        halcmd_info("Signal '%s' set to %s\n",
+            cmd.args[1].c_str(), cmd.args[2].c_str());
+        return 0;
+    }
+    return -EINVAL;
+}
+
+} // namespace
+
+int halcmd_batch_accepts(const char *command)
+{
+    return !strcmp(command, "net") || !strcmp(command, "newsig")
+        || !strcmp(command, "linkps") || !strcmp(command, "linksp")
+        || !strcmp(command, "setp") || !strcmp(command, "sets");
+}
+
+int halcmd_batch_add(const char *command, char *args[])
+{
+    batch_cmd cmd;
+    cmd.args.push_back(command);
+    for(int i = 0; args[i] && *args[i]; i++)
+        cmd.args.push_back(args[i]);
+    cmd.filename = halcmd_get_filename();
+    cmd.linenumber = halcmd_get_linenumber();
+    batch.push_back(std::move(cmd));
+    return 0;
+}
+
+int halcmd_batch_flush(void)
+{
+    int retval = 0, checked = 0;
+    double t0, t1, t2;
+
+    if(batch.empty()) return 0;
+
+    std::string filename_save = halcmd_get_filename();
+    int lineno_save = halcmd_get_linenumber();
+    batch_state st;
+
+    t0 = batch_now();
+    rtapi_mutex_get(&(hal_data->mutex));
+    batch_index(st);
+    for(auto &cmd : batch) {
+        batch_locate(cmd);
+        if(batch_check_cmd(st, cmd) < 0) retval = -EINVAL;
+    }
+    t1 = batch_now();
+    if(retval == 0) {
+        checked = 1;
+        for(auto &cmd : batch) {
+            batch_locate(cmd);
+            retval = batch_apply_cmd(st, cmd);
+            if(retval < 0) break;
+        }
+    }
+    rtapi_mutex_give(&(hal_data->mutex));
+    t2 = batch_now();
+
+    halcmd_set_filename(filename_save.c_str());
+    halcmd_set_linenumber(lineno_save);
+    if(retval == 0) {
+        halcmd_info("Batch of %zu commands checked in %.3f ms, "
+            "applied in %.3f ms\n", batch.size(),
+            (t1 - t0) * 1e3, (t2 - t1) * 1e3);
+        batch_total_commands += batch.size();
+        batch_total_time += t2 - t0;
+    } else if(!checked) {
+        halcmd_error("batch of %zu commands not applied\n", batch.size());
+    }
+    batch.clear();
+    return retval;
+}
+
+void halcmd_batch_report(void)
+{
+    if(batch_total_commands)
+        halcmd_info("%d batched commands applied in %.3f ms total\n",
+            batch_total_commands, batch_total_time * 1e3);
+}
+
 static void print_comp_info(char **patterns)
 {
     SHMFIELD(hal_comp_t) next;
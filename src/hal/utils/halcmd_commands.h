@@ -92,6 +92,18 @@ int hal_systemv(const char *const argv[]);
 
 extern int scriptmode, comp_id;
 
+/* batch mode (halcmd -b), see halcmd_commands.cc */
+extern int halcmd_batch_mode;
+extern int halcmd_batch_accepts(const char *command);
+extern int halcmd_batch_add(const char *command, char *args[]);
+extern int halcmd_batch_flush(void);
+extern void halcmd_batch_report(void);
+
+/* parallel loading (halcmd -p), see halcmd_commands.cc */
+extern int halcmd_parallel_mode;
+extern int halcmd_parallel_accepts(const char *command);
+extern int halcmd_parallel_flush(void);
+
 RTAPI_END_DECLS
 
 #endif
@@ -45,6 +45,7 @@
 #include "halcmd.h"
 #include "halcmd_commands.h"
 #include "halcmd_completion.h"
+#include "startup_trace.h"
 #include <rtapi_mutex.h>
 
 #include <stdio.h>
@@ -101,6 +102,7 @@ int main(int argc, char **argv)
     char raw_buf[MAX_CMD_LEN+1];
     int linenumber = 1;
     char *cf=NULL, *cw=NULL, *cl=NULL;
+    double start = startup_trace_now();
 
     if (argc < 2) {
 	/* no args specified, print help */
@@ -113,7 +115,7 @@ int main(int argc, char **argv)
     keep_going = 0;
     /* start parsing the command line, options first */
     while(1) {
-        c = getopt(argc, argv, "+RCfi:kqQsvVhe");
+        c = getopt(argc, argv, "+RCbpfi:kqQsvVhe");
         if(c == -1) break;
         switch(c) {
             case 'R':
@@ -160,6 +162,14 @@ int main(int argc, char **argv)
 	    case 'e':
                 echo_mode = 1;
 		break;
+	    case 'b':
+		/* -b = batch net, setp etc. and apply them under one lock */
+		halcmd_batch_mode = 1;
+		break;
+	    case 'p':
+		/* -p = don't wait for each loadrt and loadusr -W on its own */
+		halcmd_parallel_mode = 1;
+		break;
 	    case 'f':
                 filemode = 1;
 		break;
@@ -331,6 +341,24 @@ int main(int argc, char **argv)
 	} //while get_input()
         extend_ct=0;
     }
+    /* wait for whatever is still loading and apply whatever is still
+       queued, unless interrupted */
+    if (halcmd_parallel_mode && !halcmd_done) {
+	if (halcmd_parallel_flush() != 0) {
+	    errorcount++;
+	}
+    }
+    if (halcmd_batch_mode && !halcmd_done) {
+	if (halcmd_batch_flush() != 0) {
+	    errorcount++;
+	}
+	halcmd_batch_report();
+    }
+    if (startup_trace_enabled()) {
+	startup_trace_process("halcmd");
+	startup_trace_span("halcmd", filename ? filename :
+	    srcfile ? "<stdin>" : "<commandline>", start, 0, NULL);
+    }
     /* all done */
     halcmd_shutdown();
     if ( errorcount > 0 ) {
@@ -410,6 +438,8 @@ static void print_help_general(int showR)
     printf("\nUsage:   halcmd [options] [cmd [args]]\n\n");
     printf("\n         halcmd [options] -f [filename]\n\n");
     printf("options:\n\n");
+    printf("  -b             Batch net, newsig, linkps, linksp, setp and sets,\n");
+    printf("                 and apply each batch at once under a single lock.\n");
     printf("  -e             echo the commands from stdin to stderr\n");
     printf("  -f [filename]  Read commands from 'filename', not command\n");
     printf("                 line.  If no filename, read from stdin.\n");
@@ -417,6 +447,8 @@ static void print_help_general(int showR)
     printf("  -i filename    Open INI file 'filename', allow commands\n");
     printf("                 to get their values from INI file.\n");
 #endif
+    printf("  -p             Parallel loading: go on after loadrt and loadusr -W\n");
+    printf("                 without waiting, until a command of another kind.\n");
     printf("  -k             Keep going after failed command.  Default\n");
     printf("                 is to exit if any command fails. (Useful with -f)\n");
     printf("  -q             Quiet - print errors only (default).\n");
@@ -336,6 +336,8 @@ void start_capture(void)
 	}
     }
     ctrl_shm->pre_trig = (ctrl_shm->rec_len-2) * ctrl_usr->trig.position;
+    /* new record, old decimation data can't be extended */
+    invalidate_decimation();
     ctrl_shm->state = INIT;
 }
 
@@ -374,6 +376,8 @@ void capture_copy_data(void) {
 	    src = ctrl_usr->buffer;
 	}
     }
+    /* bring the min/max pyramids up to date with the new data */
+    update_decimation(ctrl_shm->start / samp_len, ctrl_usr->samples);
 }
 
 void capture_cont()
@@ -65,6 +65,7 @@ static void update_readout(void);
 static void draw_grid(void);
 static void draw_baseline(int chan_num, int highlight);
 static void draw_waveform(int chan_num, int highlight);
+static int draw_decimated(int chan_num, GdkPoint points[], int highlight);
 static void draw_triggerline(int chan_num, int highlight);
 static int handle_click(GtkWidget *widget, GdkEventButton *event, gpointer data);
 static int handle_release(GtkWidget *widget, GdkEventButton *event, gpointer data);
@@ -115,6 +116,229 @@ void invalidate_all_channels(void)
     for (n = 0; n < 16; n++) {
 	ctrl_usr->vert.data_offset[n] = -1;
     }
+    invalidate_decimation();
+}
+
+void invalidate_decimation(void)
+{
+    ctrl_usr->disp.decim_valid = 0;
+}
+
+/* returns the value of one sample as a double */
+static double sample_value(scope_data_t *dptr, hal_type_t type)
+{
+    switch (type) {
+    case HAL_BIT:
+	return dptr->d_u8 ? 1.0 : 0.0;
+    case HAL_FLOAT:
+	return dptr->d_real;
+    case HAL_S32:
+	return dptr->d_s32;
+    case HAL_U32:
+	return dptr->d_u32;
+    default:
+	return 0.0;
+    }
+}
+
+/* returns the value of display sample 'n' of channel 'chan' (0-15) */
+static double disp_sample(int chan, int n)
+{
+    scope_data_t *dptr = ctrl_usr->disp_buf + ctrl_usr->vert.data_offset[chan]
+	+ n * ctrl_shm->sample_len;
+
+    return sample_value(dptr, ctrl_usr->chan[chan].data_type);
+}
+
+/* sizes the pyramid arrays for a record of 'rec_len' samples */
+static void alloc_decimation(int rec_len)
+{
+    scope_disp_t *disp = &(ctrl_usr->disp);
+    scope_decim_t *d;
+    int n, lev, total;
+
+    for (n = 0; n < 16; n++) {
+	d = &(disp->decim[n]);
+	g_free(d->min);
+	g_free(d->max);
+	g_free(d->sum);
+	total = 0;
+	lev = 0;
+	while (lev < DECIM_MAX_LEVELS && (2L << lev) <= rec_len) {
+	    /* two spare blocks for the partial ones at each end */
+	    d->cap[lev] = rec_len / (2L << lev) + 2;
+	    d->offs[lev] = total;
+	    total += d->cap[lev];
+	    lev++;
+	}
+	d->levels = lev;
+	d->min = g_new(double, total + 1);
+	d->max = g_new(double, total + 1);
+	d->sum = g_new(double, total + 1);
+    }
+    disp->decim_rec_len = rec_len;
+}
+
+/* recomputes every block of channel 'chan' that contains any of the
+   absolute samples from 'lo' to 'hi' - 1 */
+static void decim_update_range(int chan, long long lo, long long hi)
+{
+    scope_disp_t *disp = &(ctrl_usr->disp);
+    scope_decim_t *d = &(disp->decim[chan]);
+    long long base, end, j, k, jlo, jhi, blk, first, last;
+    double v, mn, mx, sm;
+    int lev, slot, child;
+
+    base = disp->decim_base;
+    end = base + disp->decim_samples;
+    for (lev = 0; lev < d->levels; lev++) {
+	blk = 2LL << lev;
+	jlo = lo / blk;
+	jhi = (hi - 1) / blk;
+	for (j = jlo; j <= jhi; j++) {
+	    mn = HUGE_VAL;
+	    mx = -HUGE_VAL;
+	    sm = 0.0;
+	    if (lev == 0) {
+		/* level zero is built from the samples themselves */
+		first = j * blk < base ? base : j * blk;
+		last = (j + 1) * blk > end ? end : (j + 1) * blk;
+		for (k = first; k < last; k++) {
+		    v = disp_sample(chan, k - base);
+		    if (v < mn) mn = v;
+		    if (v > mx) mx = v;
+		    sm += v;
+		}
+	    } else {
+		/* higher levels combine the two blocks below, skipping
+		   any that lie entirely outside the record */
+		for (k = 2 * j; k <= 2 * j + 1; k++) {
+		    if ((k + 1) * (blk / 2) <= base || k * (blk / 2) >= end) {
+			continue;
+		    }
+		    child = d->offs[lev - 1] + k % d->cap[lev - 1];
+		    if (d->min[child] < mn) mn = d->min[child];
+		    if (d->max[child] > mx) mx = d->max[child];
+		    sm += d->sum[child];
+		}
+	    }
+	    slot = d->offs[lev] + j % d->cap[lev];
+	    d->min[slot] = mn;
+	    d->max[slot] = mx;
+	    d->sum[slot] = sm;
+	}
+    }
+}
+
+/* Brings the decimation pyramids up to date after new data has been
+   copied into the display buffer.  'start' is the ring index of the
+   first sample and 'samples' is the number of valid samples.  In roll
+   mode, the data since the last update usually just slides along the
+   ring, so only the blocks covering newly appended samples need to be
+   recomputed.  Anything else is treated as a brand new record.
+*/
+void update_decimation(int start, int samples)
+{
+    scope_disp_t *disp = &(ctrl_usr->disp);
+    int n, rec_len, dropped, appended;
+    long long end;
+
+    rec_len = ctrl_shm->rec_len;
+    if (rec_len != disp->decim_rec_len) {
+	alloc_decimation(rec_len);
+	disp->decim_valid = 0;
+    }
+    dropped = 0;
+    appended = samples;
+    if (disp->decim_valid && rec_len > 0) {
+	dropped = (start - disp->decim_start + rec_len) % rec_len;
+	appended = samples - (disp->decim_samples - dropped);
+	if (dropped > disp->decim_samples || appended < 0
+	    || appended > samples) {
+	    disp->decim_valid = 0;
+	}
+    }
+    if (!disp->decim_valid) {
+	/* full rebuild, restart the absolute sample numbering */
+	disp->decim_base = 0;
+	dropped = 0;
+	appended = samples;
+    }
+    disp->decim_base += dropped;
+    disp->decim_start = start;
+    disp->decim_samples = samples;
+    disp->decim_valid = 1;
+    if (appended <= 0) {
+	return;
+    }
+    end = disp->decim_base + samples;
+    for (n = 0; n < 16; n++) {
+	if (ctrl_usr->vert.data_offset[n] >= 0) {
+	    decim_update_range(n, end - appended, end);
+	}
+    }
+}
+
+/* Finds the minimum, maximum and sum of display samples 'lo' thru
+   'hi' - 1 of channel 'chan', using the largest aligned pyramid blocks
+   that fit.  Cost is proportional to the number of levels, not to the
+   number of samples.  Returns the number of samples covered.
+*/
+static int decim_query(int chan, int lo, int hi, double *min, double *max,
+    double *sum)
+{
+    scope_disp_t *disp = &(ctrl_usr->disp);
+    scope_decim_t *d = &(disp->decim[chan]);
+    long long a, b, blk;
+    double v, mn, mx, sm;
+    int lev, slot;
+
+    if (ctrl_usr->vert.data_offset[chan] < 0) {
+	return 0;
+    }
+    if (lo < 0) {
+	lo = 0;
+    }
+    if (hi > disp->decim_samples) {
+	hi = disp->decim_samples;
+    }
+    if (lo >= hi) {
+	return 0;
+    }
+    mn = HUGE_VAL;
+    mx = -HUGE_VAL;
+    sm = 0.0;
+    a = disp->decim_base + lo;
+    b = disp->decim_base + hi;
+    while (a < b) {
+	/* find the largest block that starts here and fits */
+	lev = -1;
+	while (lev + 1 < d->levels) {
+	    blk = 2LL << (lev + 1);
+	    if (a % blk != 0 || a + blk > b) {
+		break;
+	    }
+	    lev++;
+	}
+	if (lev < 0) {
+	    v = disp_sample(chan, a - disp->decim_base);
+	    if (v < mn) mn = v;
+	    if (v > mx) mx = v;
+	    sm += v;
+	    a++;
+	} else {
+	    blk = 2LL << lev;
+	    slot = d->offs[lev] + (a / blk) % d->cap[lev];
+	    if (d->min[slot] < mn) mn = d->min[slot];
+	    if (d->max[slot] > mx) mx = d->max[slot];
+	    sm += d->sum[slot];
+	    a += blk;
+	}
+    }
+    *min = mn;
+    *max = mx;
+    *sum = sm;
+    return hi - lo;
 }
 
 void request_display_refresh(int delay)
@@ -143,40 +367,13 @@ void redraw_window(void)
 static int motion_x = -1, motion_y = -1;
 
 static void calculate_offset(int chan_num) {
-    int n;
     scope_chan_t *chan = &(ctrl_usr->chan[chan_num]);
-    scope_data_t *dptr =
-        ctrl_usr->disp_buf + ctrl_usr->vert.data_offset[chan_num];
-    int type = chan->data_type;
-
-    double sum=0, value;
+    double min, max, sum;
+    int n;
 
     if(!chan->ac_offset) return;
 
-    for(n=0; n < ctrl_usr->samples; n++) {
-	switch (type) {
-	case HAL_BIT:
-	    if (dptr->d_u8) {
-		value = 1.0;
-	    } else {
-		value = 0.0;
-	    };
-	    break;
-	case HAL_FLOAT:
-	    value = dptr->d_real;
-	    break;
-	case HAL_S32:
-	    value = dptr->d_s32;
-	    break;
-	case HAL_U32:
-	    value = dptr->d_u32;
-	    break;
-	default:
-	    value = 0.0;
-	    break;
-        }
-        sum = sum + value;
-    }
+    n = decim_query(chan_num, 0, ctrl_usr->samples, &min, &max, &sum);
     if(n == 0) {
         chan->vert_offset = 0;
     } else {
@@ -750,6 +947,93 @@ void draw_baseline(int chan_num, int highlight) {
     line(chan_num | 0x100, 0, y1, disp->width, y1);
 }
 
+/* converts a sample value to a clipped y coordinate */
+static int value_to_y(scope_chan_t *chan, double fy)
+{
+    scope_disp_t *disp = &(ctrl_usr->disp);
+    double yscale = disp->height / (-10.0 * chan->scale);
+    int y;
+
+    y = ((fy - chan->vert_offset) * yscale) + chan->position * disp->height;
+    if (y < -disp->height) {
+	y = -disp->height;
+    } else if (y > 2 * disp->height) {
+	y = 2 * disp->height;
+    }
+    return COORDINATE_CLIP(y);
+}
+
+/* Builds the point list for a waveform that has more than two samples
+   per pixel.  Each pixel column gets at most two points, its min and
+   max, in whichever order joins up best with the previous column, so
+   the cost depends on the window width rather than the record length.
+   Returns the number of points.
+*/
+static int draw_decimated(int chan_num, GdkPoint points[], int highlight)
+{
+    scope_disp_t *disp = &(ctrl_usr->disp);
+    scope_horiz_t *horiz = &(ctrl_usr->horiz);
+    scope_chan_t *chan = &(ctrl_usr->chan[chan_num - 1]);
+    double xscale, xoffset, min, max, sum;
+    int x, lo, hi, first, last, ymin, ymax, pn, cn;
+
+    xscale = disp->pixels_per_sample;
+    xoffset = disp->horiz_offset;
+    first = disp->start_sample;
+    last = disp->end_sample + 1;
+    pn = 0;
+    /* samples that land in column x are those with x <= n * xscale -
+       xoffset < x + 1 */
+    lo = first;
+    x = floor((lo * xscale) - xoffset);
+    while (lo < last) {
+	hi = ceil((x + 1 + xoffset) / xscale);
+	if (hi <= lo) {
+	    hi = lo + 1;
+	}
+	if (hi > last) {
+	    hi = last;
+	}
+	if (decim_query(chan_num - 1, lo, hi, &min, &max, &sum) > 0) {
+	    /* larger values are higher on the screen, smaller y */
+	    ymin = value_to_y(chan, max);
+	    ymax = value_to_y(chan, min);
+	    cn = COORDINATE_CLIP(x);
+	    if (pn > 0 && abs(points[pn - 1].y - ymax) <
+		abs(points[pn - 1].y - ymin)) {
+		points[pn].x = cn; points[pn].y = ymax; pn++;
+		if (ymin != ymax) {
+		    points[pn].x = cn; points[pn].y = ymin; pn++;
+		}
+	    } else {
+		points[pn].x = cn; points[pn].y = ymin; pn++;
+		if (ymin != ymax) {
+		    points[pn].x = cn; points[pn].y = ymax; pn++;
+		}
+	    }
+	}
+	lo = hi;
+	x++;
+    }
+    if (highlight && DRAWING && pn > 0) {
+	/* cursor goes on the first sample at or right of the pointer */
+	lo = ceil((motion_x + xoffset) / xscale);
+	if (lo < first + 1) {
+	    lo = first + 1;
+	}
+	if (lo < last && lo < ctrl_usr->samples) {
+	    cursor_prev_value = disp_sample(chan_num - 1, lo - 1);
+	    cursor_value = disp_sample(chan_num - 1, lo);
+	    cursor_time = (lo - ctrl_shm->pre_trig) * horiz->sample_period;
+	    cursor_valid = 1;
+	    cairo_arc(disp->context, (lo * xscale) - xoffset,
+		value_to_y(chan, cursor_value), 5, 0.0, 2.0 * M_PI);
+	    cairo_fill(disp->context);
+	}
+    }
+    return pn;
+}
+
 /* waveform styles: if neither is defined, an intermediate style is used */
 // #define DRAW_STEPPED
 // #define DRAW_SMOOTH
@@ -766,6 +1050,9 @@ void draw_waveform(int chan_num, int highlight)
     int x1, y1, x2, y2, miny, maxy, midx, ct, pn;
     int first=1;
     scope_horiz_t *horiz = &(ctrl_usr->horiz);
+    /* grown as needed and kept, the record can be too long for the stack */
+    static GdkPoint *points = NULL;
+    static int points_len = 0;
 
     cursor_valid = 0;
     disp = &(ctrl_usr->disp);
@@ -786,7 +1073,10 @@ void draw_waveform(int chan_num, int highlight)
     start = disp->start_sample;
     end = disp->end_sample;
     ct = end - start + 1;
-    GdkPoint points[2*ct];
+    if (2 * ct > points_len) {
+	points_len = 2 * ct;
+	points = g_renew(GdkPoint, points, points_len);
+    }
     pn = 0;
     n = start;
     dptr += n * sample_len;
@@ -800,6 +1090,12 @@ void draw_waveform(int chan_num, int highlight)
     }
 
     x1 = y1 = 0;
+    if (xscale < 0.5) {
+	/* more than two samples per pixel, draw the min and max of each
+	   pixel column from the decimation pyramid instead */
+	pn = draw_decimated(chan_num, points, highlight);
+	n = end + 1;
+    }
     while (n <= end) {
 	/* calc x coordinate of this point */
 	x2 = (n * xscale) - xoffset;
@@ -156,6 +156,23 @@ typedef struct {
 
 
 
+/* this struct holds a min/max decimation pyramid for one channel */
+/* level L holds blocks of (2 << L) samples, indexed by absolute sample
+   number so that roll mode can append new samples and drop old ones
+   without rebuilding the whole pyramid.  Each level is a ring buffer
+   large enough to hold every block of a full record. */
+
+#define DECIM_MAX_LEVELS 30
+
+typedef struct {
+    int levels;			/* number of levels in use */
+    int cap[DECIM_MAX_LEVELS];	/* ring size of each level, in blocks */
+    int offs[DECIM_MAX_LEVELS];	/* start of each level in the arrays */
+    double *min;		/* block minimums, all levels */
+    double *max;		/* block maximums, all levels */
+    double *sum;		/* block sums, all levels */
+} scope_decim_t;
+
 /* this struct holds control data related to the display */
 /* it lives in user space (as part of the master control struct) */
 
@@ -167,6 +184,13 @@ typedef struct {
     double horiz_offset;		/* offset in pixels */
     int start_sample;		/* first displayable sample */
     int end_sample;		/* last displayable sample */
+    /* decimation data, rebuilt when a new record is copied */
+    scope_decim_t decim[16];	/* min/max pyramids for each channel */
+    int decim_valid;		/* zero forces a full rebuild */
+    int decim_rec_len;		/* record length the pyramids are sized for */
+    int decim_start;		/* first sample (ring index) at last update */
+    int decim_samples;		/* number of samples at last update */
+    long long decim_base;	/* absolute index of display sample 0 */
     /* widgets */
     GtkWidget *drawing;		/* drawing area for display */
     GtkTooltip *tip;		/* drawing area for display */
@@ -245,6 +269,8 @@ void refresh_display(void);
 void refresh_trigger(void);
 void invalidate_channel(int chan);
 void invalidate_all_channels(void);
+void invalidate_decimation(void);
+void update_decimation(int start, int samples);
 void channel_changed(void);
 void redraw_window(void);
 
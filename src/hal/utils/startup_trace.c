@@ -0,0 +1,130 @@
+/* Copyright (C) 2026
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of version 2 of the GNU General
+ *  Public License as published by the Free Software Foundation.
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "startup_trace.h"
+
+static int trace_fd = -2;	/* -2: not opened yet, -1: not tracing */
+
+static int trace_open(void)
+{
+    const char *path;
+    int fd;
+
+    if (trace_fd != -2) return trace_fd;
+    trace_fd = -1;
+    path = getenv("HAL_STARTUP_TRACE");
+    if (!path || !*path) return -1;
+    /* whoever creates the file opens the JSON array */
+    fd = open(path, O_WRONLY | O_APPEND | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+    if (fd >= 0) {
+	if (write(fd, "[\n", 2) != 2) {
+	    close(fd);
+	    fd = -1;
+	}
+    } else if (errno == EEXIST) {
+	fd = open(path, O_WRONLY | O_APPEND | O_CLOEXEC);
+    }
+    if (fd < 0)
+	fprintf(stderr, "HAL_STARTUP_TRACE: %s: %s\n", path, strerror(errno));
+    trace_fd = fd;
+    return fd;
+}
+
+int startup_trace_enabled(void)
+{
+    return trace_open() >= 0;
+}
+
+double startup_trace_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec * 1e-3;
+}
+
+/* append s as a JSON string to buf, return the new length */
+static size_t put_string(char *buf, size_t len, size_t size, const char *s)
+{
+    if (len < size) buf[len] = '"';
+    len++;
+    for (; *s; s++) {
+	unsigned char c = *s;
+	if (c == '"' || c == '\\') {
+	    if (len + 1 < size) { buf[len] = '\\'; buf[len + 1] = c; }
+	    len += 2;
+	} else if (c < 0x20) {
+	    if (len + 6 < size) snprintf(buf + len, 7, "\\u%04x", c);
+	    len += 6;
+	} else {
+	    if (len < size) buf[len] = c;
+	    len++;
+	}
+    }
+    if (len < size) buf[len] = '"';
+    return len + 1;
+}
+
+static void put_event(const char *head, const char *name, const char *tail)
+{
+    char buf[2048];
+    size_t len;
+    int fd = trace_open();
+
+    if (fd < 0) return;
+    len = snprintf(buf, sizeof(buf), "%s", head);
+    len = put_string(buf, len, sizeof(buf), name);
+    if (len < sizeof(buf))
+	len += snprintf(buf + len, sizeof(buf) - len, "%s", tail);
+    if (len >= sizeof(buf)) return;	/* a name too long to bother with */
+    /* one write, so lines of different processes do not mix */
+    if (write(fd, buf, len) != (ssize_t) len) {
+	close(fd);
+	trace_fd = -1;
+    }
+}
+
+void startup_trace_process(const char *name)
+{
+    char head[128];
+
+    snprintf(head, sizeof(head),
+	"{\"ph\":\"M\",\"pid\":%d,\"name\":\"process_name\",\"args\":{\"name\":",
+	(int) getpid());
+    put_event(head, name, "}},\n");
+}
+
+void startup_trace_span(const char *cat, const char *name, double start,
+    long lane, const char *detail)
+{
+    char head[256], tail[1024];
+    double end = startup_trace_now();
+    size_t len;
+
+    if (trace_open() < 0) return;
+    snprintf(head, sizeof(head),
+	"{\"ph\":\"X\",\"cat\":\"%s\",\"ts\":%.0f,\"dur\":%.0f,"
+	"\"pid\":%d,\"tid\":%ld,\"name\":",
+	cat, start, end - start, (int) getpid(), lane);
+    len = snprintf(tail, sizeof(tail), "%s", detail ? ",\"args\":{\"detail\":" : "");
+    if (detail)
+	len = put_string(tail, len, sizeof(tail), detail);
+    if (len + sizeof("}},\n") > sizeof(tail)) return;
+    snprintf(tail + len, sizeof(tail) - len, "%s", detail ? "}},\n" : "},\n");
+    put_event(head, name, tail);
+}
@@ -0,0 +1,45 @@
+/* Copyright (C) 2026
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of version 2 of the GNU General
+ *  Public License as published by the Free Software Foundation.
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+/* Startup timeline.  When HAL_STARTUP_TRACE names a file, halcmd and
+   rtapi_app append a record of each HAL file, command, component load
+   and wait to it, in the JSON array form of the Chrome trace event
+   format (chrome://tracing, https://ui.perfetto.dev).  Every process
+   appends whole lines with O_APPEND, so halcmd, rtapi_app and the
+   linuxcnc script can write to the same file.  Times are in
+   microseconds of CLOCK_REALTIME, which is what the shell can read
+   too ($EPOCHREALTIME). */
+
+#ifndef STARTUP_TRACE_H
+#define STARTUP_TRACE_H
+
+#include "rtapi.h"
+
+RTAPI_BEGIN_DECLS
+
+/* nonzero if HAL_STARTUP_TRACE is set and the file could be opened */
+extern int startup_trace_enabled(void);
+
+/* the current time in microseconds */
+extern double startup_trace_now(void);
+
+/* name the calling process in the trace */
+extern void startup_trace_process(const char *name);
+
+/* record a span from 'start' (from startup_trace_now()) until now.  The
+   span shows in the lane of this process numbered 'lane' (0 for the
+   main one); 'detail' may be NULL. */
+extern void startup_trace_span(const char *cat, const char *name,
+    double start, long lane, const char *detail);
+
+RTAPI_END_DECLS
+
+#endif
@@ -85,6 +85,17 @@ int recvn(int fd, void *vptr, int n, int flags, double _timeout,
     while (nleft > 0) {
 	if (_timeout > 0.0) {
             double timeleft;
+	    /* A reply is usually there already, in full or in part; only
+	       wait in select() for what is not. */
+	    nrecv = recv(fd, ptr, nleft, flags | MSG_DONTWAIT);
+	    if (nrecv > 0) {
+		nleft -= nrecv;
+		ptr += nrecv;
+		continue;
+	    } else if (nrecv == 0) {
+		rcs_print_error("recvn: Premature EOF received.\n");
+		return (-2);
+	    }
 	    timeleft = start_time + _timeout - etime();
 	    if (timeleft <= 0.0) {
 		if (print_recvn_timeout_errors) {
@@ -192,17 +203,6 @@ int recvn(int fd, void *vptr, int n, int flags, double _timeout,
 	}
 	nleft -= nrecv;
 	ptr += nrecv;
-	if (nleft > 0 && _timeout > 0.0) {
-	    esleep(0.001);
-	    if (etime() - start_time > _timeout) {
-		rcs_print_error("Recv timed out.\n");
-		recvn_timedout = 1;
-		if (NULL != bytes_read_ptr) {
-		    *bytes_read_ptr = (n - nleft);
-		}
-		return (-1);
-	    }
-	}
     }
     rcs_print_debug(PRINT_SOCKET_READ_SIZE, "read %d bytes from %d\n", n, fd);
     if (NULL != bytes_read_ptr) {
@@ -104,6 +104,7 @@ int sendn(int fd, const void *vptr, int n, int _flags, double _timeout)
 	}
 	nleft -= nwritten;
 	ptr += nwritten;
+	/* the select() above waits for room for the rest */
 	if (nleft > 0 && _timeout > 0.0) {
             double duration;
             duration = etime() - start_time;
@@ -111,7 +112,6 @@ int sendn(int fd, const void *vptr, int n, int _flags, double _timeout)
                 rcs_print_error("sendn: timed out after %f seconds.\n", duration);
 		return (-1);
 	    }
-	    esleep(0.001);
 	}
     }
     rcs_print_debug(PRINT_SOCKET_WRITE_SIZE, "wrote %d bytes to %d\n", n, fd);
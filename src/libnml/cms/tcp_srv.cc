@@ -31,6 +31,7 @@ extern "C" {
 #include <unistd.h>
 #include <sys/socket.h>
 #include <sys/ioctl.h>
+#include <sys/epoll.h>		/* epoll_create1(), epoll_wait() */
 #include <errno.h>		/* errno */
 #include <signal.h>		// SIGPIPE, signal()
 
@@ -62,6 +63,9 @@ int tcpsvr_threads_killed = 0;
 int tcpsvr_threads_exited = 0;
 int tcpsvr_threads_returned_early = 0;
 
+/* events taken from the kernel per epoll_wait() */
+#define MAX_TCP_EVENTS 64
+
 TCPSVR_BLOCKING_READ_REQUEST::TCPSVR_BLOCKING_READ_REQUEST()
 {
     access_type = CMS_READ_ACCESS;	/* read or just peek */
@@ -133,7 +137,7 @@ CMS_SERVER_REMOTE_PORT(_cms_server)
     client_ports = (LinkedList *) NULL;
     connection_socket = 0;
     connection_port = 0;
-    maxfdpl = 0;
+    epoll_fd = -1;
     dtimeout = 20.0;
 
     memset(&server_socket_address, 0, sizeof(server_socket_address));
@@ -147,13 +151,10 @@ CMS_SERVER_REMOTE_PORT(_cms_server)
 	return;
     }
     polling_enabled = 0;
-    memset(&select_timeout, 0, sizeof(select_timeout));
-    select_timeout.tv_sec = 30;
-    select_timeout.tv_usec = 30;
+    next_subscription_update = 0.0;
+    buffer_written = 0;
     subscription_buffers = NULL;
     current_poll_interval_millis = 30000;
-    memset(&read_fd_set, 0, sizeof(read_fd_set));
-    memset(&write_fd_set, 0, sizeof(write_fd_set));
 }
 
 CMS_SERVER_REMOTE_TCP_PORT::~CMS_SERVER_REMOTE_TCP_PORT()
@@ -219,6 +220,10 @@ void CMS_SERVER_REMOTE_TCP_PORT::unregister_port()
 	close(connection_socket);
 	connection_socket = 0;
     }
+    if (epoll_fd >= 0) {
+	close(epoll_fd);
+	epoll_fd = -1;
+    }
 }
 
 int CMS_SERVER_REMOTE_TCP_PORT::accept_local_port_cms(CMS * _cms)
@@ -301,206 +306,200 @@ static void handle_pipe_error(int signum)
     rcs_print_error("SIGPIPE intercepted.\n");
 }
 
+/* Serves every client from this one thread: epoll hands back the
+   CLIENT_TCP_PORT of each socket with a request waiting, so the cost of
+   a wakeup does not grow with the number of connected clients.
+   Subscriptions are brought up to date when they fall due and right
+   after a client wrote a buffer, not on every request. */
 void CMS_SERVER_REMOTE_TCP_PORT::run()
 {
+    struct epoll_event events[MAX_TCP_EVENTS];
+    struct epoll_event ev;
     int bytes_ready;
     int ready_descriptors;
     if (NULL == client_ports) {
 	rcs_print_error("CMS_SERVER: List of client ports is NULL.\n");
 	return;
     }
-    CLIENT_TCP_PORT *new_client_port, *client_port_to_check;
-    FD_ZERO(&read_fd_set);
-    FD_ZERO(&write_fd_set);
-    FD_SET(connection_socket, &read_fd_set);
-    maxfdpl = connection_socket + 1;
+    CLIENT_TCP_PORT *client_port_to_check;
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+	rcs_print_error("server: epoll_create1 error.(errno = %d | %s)\n",
+	    errno, strerror(errno));
+	return;
+    }
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;		/* the connection socket */
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, connection_socket, &ev) < 0) {
+	rcs_print_error("server: epoll_ctl error.(errno = %d | %s)\n",
+	    errno, strerror(errno));
+	return;
+    }
     signal(SIGPIPE, handle_pipe_error);
     rcs_print_debug(PRINT_CMS_CONFIG_INFO,
 	"running server for TCP port %d (connection_socket = %d).\n",
 	ntohs(server_socket_address.sin_port), connection_socket);
 
     cms_server_count++;
-    fd_set read_fd_set_copy, write_fd_set_copy;
-    FD_ZERO(&read_fd_set_copy);
-    FD_ZERO(&write_fd_set_copy);
-    FD_SET(connection_socket, &read_fd_set_copy);
 
     while (1) {
+	int timeout_millis = -1;
 	if (polling_enabled) {
-	    memcpy(&read_fd_set_copy, &read_fd_set, sizeof(fd_set));
-	    memcpy(&write_fd_set_copy, &write_fd_set, sizeof(fd_set));
-	    select_timeout.tv_sec = current_poll_interval_millis / 1000;
-	    select_timeout.tv_usec =
-		(current_poll_interval_millis % 1000) * 1000;
-	    ready_descriptors =
-		select(maxfdpl, &read_fd_set, &write_fd_set,
-		(fd_set *) NULL, (timeval *) & select_timeout);
-	    if (ready_descriptors == 0) {
-		update_subscriptions();
-		memcpy(&read_fd_set, &read_fd_set_copy, sizeof(fd_set));
-		memcpy(&write_fd_set, &write_fd_set_copy, sizeof(fd_set));
-		continue;
+	    timeout_millis =
+		(int) ((next_subscription_update - etime()) * 1000.0);
+	    if (timeout_millis < 0) {
+		timeout_millis = 0;
 	    }
-	} else {
-	    ready_descriptors =
-		select(maxfdpl, &read_fd_set, &write_fd_set,
-		(fd_set *) NULL, (timeval *) NULL);
-
 	}
+	ready_descriptors =
+	    epoll_wait(epoll_fd, events, MAX_TCP_EVENTS, timeout_millis);
 	if (ready_descriptors < 0) {
-	    rcs_print_error("server: select error.(errno = %d | %s)\n",
-		errno, strerror(errno));
+	    if (errno != EINTR) {
+		rcs_print_error("server: epoll_wait error.(errno = %d | %s)\n",
+		    errno, strerror(errno));
+	    }
+	    continue;
 	}
 	if (NULL == client_ports) {
 	    rcs_print_error("CMS_SERVER: List of client ports is NULL.\n");
 	    return;
 	}
-	client_port_to_check = (CLIENT_TCP_PORT *) client_ports->get_head();
-	while (NULL != client_port_to_check) {
-	    if (FD_ISSET(client_port_to_check->socket_fd, &read_fd_set)) {
-		ioctl(client_port_to_check->socket_fd, FIONREAD,
-		    (caddr_t) & bytes_ready);
-		if (bytes_ready <= 0) {
-		    rcs_print_debug(PRINT_SOCKET_CONNECT,
-			"Socket closed by host with IP address %s.\n",
-			inet_ntoa(client_port_to_check->address.sin_addr));
-		    if (NULL != client_port_to_check->subscriptions) {
-			TCP_CLIENT_SUBSCRIPTION_INFO *clnt_sub_info =
-			    (TCP_CLIENT_SUBSCRIPTION_INFO *)
-			    client_port_to_check->subscriptions->get_head();
-			while (NULL != clnt_sub_info) {
-			    if (NULL != clnt_sub_info->sub_buf_info &&
-				clnt_sub_info->subscription_list_id >= 0) {
-				if (NULL !=
-				    clnt_sub_info->sub_buf_info->
-				    sub_clnt_info) {
-				    clnt_sub_info->sub_buf_info->
-					sub_clnt_info->
-					delete_node(clnt_sub_info->
-					subscription_list_id);
-				    if (clnt_sub_info->sub_buf_info->
-					sub_clnt_info->list_size < 1) {
-					delete clnt_sub_info->sub_buf_info->
-					    sub_clnt_info;
-					clnt_sub_info->sub_buf_info->
-					    sub_clnt_info = NULL;
-					if (NULL != subscription_buffers
-					    && clnt_sub_info->sub_buf_info->
-					    list_id >= 0) {
-					    subscription_buffers->
-						delete_node(clnt_sub_info->
-						sub_buf_info->list_id);
-					    delete clnt_sub_info->
-						sub_buf_info;
-					    clnt_sub_info->sub_buf_info =
-						NULL;
-					}
-				    }
-				    clnt_sub_info->sub_buf_info = NULL;
-				}
-				delete clnt_sub_info;
-				clnt_sub_info =
-				    (TCP_CLIENT_SUBSCRIPTION_INFO *)
-				    client_port_to_check->subscriptions->
-				    get_next();
-			    }
-			    delete client_port_to_check->subscriptions;
-			    client_port_to_check->subscriptions = NULL;
-			    recalculate_polling_interval();
-			}
-		    }
-		    if (client_port_to_check->threadId > 0
-			&& client_port_to_check->blocking) {
-			blocking_thread_kill(client_port_to_check->threadId);
-		    }
-		    close(client_port_to_check->socket_fd);
-		    FD_CLR(client_port_to_check->socket_fd, &read_fd_set);
-		    client_port_to_check->socket_fd = -1;
-		    delete client_port_to_check;
-		    client_ports->delete_current_node();
-		} else {
-		    if (client_port_to_check->blocking) {
-			if (client_port_to_check->threadId > 0) {
-			    rcs_print_debug(PRINT_SERVER_THREAD_ACTIVITY,
-				"Data received from %s:%d when it should be blocking (bytes_ready=%d).\n",
-				inet_ntoa
-				(client_port_to_check->address.
-				    sin_addr),
-				client_port_to_check->socket_fd, bytes_ready);
-			    rcs_print_debug(PRINT_SERVER_THREAD_ACTIVITY,
-				"Killing handler %d.\n",
-				client_port_to_check->threadId);
-
-			    blocking_thread_kill
-				(client_port_to_check->threadId);
-#if 0
-			    *((uint32_t *) temp_buffer) =
-				htonl(client_port_to_check->serial_number);
-			    *((uint32_t *) temp_buffer + 1) =
-				htonl((unsigned long)
-				CMS_SERVER_SIDE_ERROR);
-			    putbe32(temp_buffer + 8, 0);	/* size
-									 */
-			    putbe32(temp_buffer + 12, 0);	/* write_id
-									 */
-			    putbe32(temp_buffer + 16, 0);	/* was_read
-									 */
-			    sendn(client_port_to_check->socket_fd,
-				temp_buffer, 20, 0, dtimeout);
-#endif
-			    client_port_to_check->threadId = 0;
-			    client_port_to_check->blocking = 0;
-			}
-		    }
-		    handle_request(client_port_to_check);
-		}
-		ready_descriptors--;
-	    } else {
-		FD_SET(client_port_to_check->socket_fd, &read_fd_set);
-	    }
-	    client_port_to_check =
-		(CLIENT_TCP_PORT *) client_ports->get_next();
-	}
-	if (FD_ISSET(connection_socket, &read_fd_set)
-	    && ready_descriptors > 0) {
-	    ready_descriptors--;
-	    socklen_t client_address_length;
-	    new_client_port = new CLIENT_TCP_PORT();
-	    client_address_length = sizeof(new_client_port->address);
-	    new_client_port->socket_fd = accept(connection_socket,
-		(struct sockaddr *)
-		&new_client_port->address, &client_address_length);
-	    current_clients++;
-	    if (current_clients > max_clients) {
-		max_clients = current_clients;
-	    }
-	    if (new_client_port->socket_fd < 0) {
-		rcs_print_error("server: accept error -- %d %s \n", errno,
-		    strerror(errno));
+	buffer_written = 0;
+	for (int i = 0; i < ready_descriptors; i++) {
+	    client_port_to_check = (CLIENT_TCP_PORT *) events[i].data.ptr;
+	    if (NULL == client_port_to_check) {
+		accept_client();
 		continue;
 	    }
-	    rcs_print_debug(PRINT_SOCKET_CONNECT,
-		"Socket opened by host with IP address %s.\n",
-		inet_ntoa(new_client_port->address.sin_addr));
-	    new_client_port->serial_number = 0;
-	    new_client_port->blocking = 0;
-	    if (NULL != client_ports) {
-		client_ports->store_at_tail(new_client_port,
-		    sizeof(new_client_port), 0);
+	    ioctl(client_port_to_check->socket_fd, FIONREAD,
+		(caddr_t) & bytes_ready);
+	    if (bytes_ready <= 0) {
+		rcs_print_debug(PRINT_SOCKET_CONNECT,
+		    "Socket closed by host with IP address %s.\n",
+		    inet_ntoa(client_port_to_check->address.sin_addr));
+		close_client(client_port_to_check);
+		continue;
 	    }
-	    if (maxfdpl < new_client_port->socket_fd + 1) {
-		maxfdpl = new_client_port->socket_fd + 1;
+	    if (client_port_to_check->blocking) {
+		if (client_port_to_check->threadId > 0) {
+		    rcs_print_debug(PRINT_SERVER_THREAD_ACTIVITY,
+			"Data received from %s:%d when it should be blocking (bytes_ready=%d).\n",
+			inet_ntoa(client_port_to_check->address.sin_addr),
+			client_port_to_check->socket_fd, bytes_ready);
+		    rcs_print_debug(PRINT_SERVER_THREAD_ACTIVITY,
+			"Killing handler %d.\n",
+			client_port_to_check->threadId);
+
+		    blocking_thread_kill(client_port_to_check->threadId);
+		    client_port_to_check->threadId = 0;
+		    client_port_to_check->blocking = 0;
+		}
 	    }
-	    FD_SET(new_client_port->socket_fd, &read_fd_set);
-	} else {
-	    FD_SET(connection_socket, &read_fd_set);
+	    handle_request(client_port_to_check);
+	}
+	if (buffer_written
+	    || (polling_enabled && etime() >= next_subscription_update)) {
+	    update_subscriptions();
+	    next_subscription_update =
+		etime() + current_poll_interval_millis / 1000.0;
 	}
-	if (0 != ready_descriptors) {
-	    rcs_print_error("%d descriptors ready but not serviced.\n",
-		ready_descriptors);
+    }
+}
+
+void CMS_SERVER_REMOTE_TCP_PORT::accept_client()
+{
+    socklen_t client_address_length;
+    struct epoll_event ev;
+    CLIENT_TCP_PORT *new_client_port = new CLIENT_TCP_PORT();
+    client_address_length = sizeof(new_client_port->address);
+    new_client_port->socket_fd = accept(connection_socket,
+	(struct sockaddr *) &new_client_port->address,
+	&client_address_length);
+    if (new_client_port->socket_fd < 0) {
+	rcs_print_error("server: accept error -- %d %s \n", errno,
+	    strerror(errno));
+	delete new_client_port;
+	return;
+    }
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.ptr = new_client_port;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, new_client_port->socket_fd,
+	    &ev) < 0) {
+	rcs_print_error("server: epoll_ctl error -- %d %s \n", errno,
+	    strerror(errno));
+	delete new_client_port;
+	return;
+    }
+    current_clients++;
+    if (current_clients > max_clients) {
+	max_clients = current_clients;
+    }
+    rcs_print_debug(PRINT_SOCKET_CONNECT,
+	"Socket opened by host with IP address %s.\n",
+	inet_ntoa(new_client_port->address.sin_addr));
+    new_client_port->serial_number = 0;
+    new_client_port->blocking = 0;
+    new_client_port->list_id =
+	client_ports->store_at_tail(new_client_port,
+	sizeof(new_client_port), 0);
+}
+
+/* Forgets a client that hung up, asked to close or made too many errors. */
+void CMS_SERVER_REMOTE_TCP_PORT::close_client(CLIENT_TCP_PORT *
+    _client_tcp_port)
+{
+    remove_client_subscriptions(_client_tcp_port);
+    if (_client_tcp_port->threadId > 0 && _client_tcp_port->blocking) {
+	blocking_thread_kill(_client_tcp_port->threadId);
+    }
+    /* a forked blocking read handler may still hold the socket open, so
+       closing it would not take it out of the epoll set */
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, _client_tcp_port->socket_fd, NULL);
+    close(_client_tcp_port->socket_fd);
+    _client_tcp_port->socket_fd = -1;
+    current_clients--;
+    client_ports->delete_node(_client_tcp_port->list_id);
+    delete _client_tcp_port;
+}
+
+void CMS_SERVER_REMOTE_TCP_PORT::remove_client_subscriptions(CLIENT_TCP_PORT *
+    client_port_to_check)
+{
+    if (NULL == client_port_to_check->subscriptions) {
+	return;
+    }
+    TCP_CLIENT_SUBSCRIPTION_INFO *clnt_sub_info =
+	(TCP_CLIENT_SUBSCRIPTION_INFO *)
+	client_port_to_check->subscriptions->get_head();
+    while (NULL != clnt_sub_info) {
+	if (NULL != clnt_sub_info->sub_buf_info &&
+	    clnt_sub_info->subscription_list_id >= 0) {
+	    if (NULL != clnt_sub_info->sub_buf_info->sub_clnt_info) {
+		clnt_sub_info->sub_buf_info->sub_clnt_info->
+		    delete_node(clnt_sub_info->subscription_list_id);
+		if (clnt_sub_info->sub_buf_info->sub_clnt_info->list_size < 1) {
+		    delete clnt_sub_info->sub_buf_info->sub_clnt_info;
+		    clnt_sub_info->sub_buf_info->sub_clnt_info = NULL;
+		    if (NULL != subscription_buffers
+			&& clnt_sub_info->sub_buf_info->list_id >= 0) {
+			subscription_buffers->
+			    delete_node(clnt_sub_info->sub_buf_info->list_id);
+			delete clnt_sub_info->sub_buf_info;
+			clnt_sub_info->sub_buf_info = NULL;
+		    }
+		}
+		clnt_sub_info->sub_buf_info = NULL;
+	    }
 	}
-	update_subscriptions();
+	delete clnt_sub_info;
+	clnt_sub_info = (TCP_CLIENT_SUBSCRIPTION_INFO *)
+	    client_port_to_check->subscriptions->get_next();
     }
+    delete client_port_to_check->subscriptions;
+    client_port_to_check->subscriptions = NULL;
+    recalculate_polling_interval();
 }
 
 static int tcpsvr_handle_blocking_request_sigint_count = 0;
@@ -603,8 +602,9 @@ void *tcpsvr_handle_blocking_request(void *_req)
 	}
     } else {
 	_client_tcp_port->blocking = 0;
-	if (sendn(_client_tcp_port->socket_fd, temp_buffer, 20, 0, dtimeout) <
-	    0) {
+	/* MSG_MORE holds the header back to go out with the data */
+	if (sendn(_client_tcp_port->socket_fd, temp_buffer, 20,
+		read_reply->size > 0 ? MSG_MORE : 0, dtimeout) < 0) {
 	    _client_tcp_port->blocking = 0;
 	    _client_tcp_port->errors++;
 	    _client_tcp_port->blocking_read_req = NULL;
@@ -644,7 +644,6 @@ void *tcpsvr_handle_blocking_request(void *_req)
 void CMS_SERVER_REMOTE_TCP_PORT::handle_request(CLIENT_TCP_PORT *
     _client_tcp_port)
 {
-    CLIENT_TCP_PORT *client_port_to_check = NULL;
     pid_t pid = getpid();
     pid_t tid = 0;
     CMS_SERVER *server;
@@ -663,20 +662,8 @@ void CMS_SERVER_REMOTE_TCP_PORT::handle_request(CLIENT_TCP_PORT *
     if (_client_tcp_port->errors >= _client_tcp_port->max_errors) {
 	rcs_print_error("Too many errors - closing connection(%d)\n",
 	    _client_tcp_port->socket_fd);
-	client_port_to_check = (CLIENT_TCP_PORT *) client_ports->get_head();
-	while (NULL != client_port_to_check) {
-	    if (client_port_to_check->socket_fd ==
-		_client_tcp_port->socket_fd) {
-		delete client_port_to_check;
-		client_ports->delete_current_node();
-	    }
-	    client_port_to_check =
-		(CLIENT_TCP_PORT *) client_ports->get_next();
-	}
-	close(_client_tcp_port->socket_fd);
-	current_clients--;
-	FD_CLR(_client_tcp_port->socket_fd, &read_fd_set);
-	_client_tcp_port->socket_fd = -1;
+	close_client(_client_tcp_port);
+	return;
     }
 
     if (recvn(_client_tcp_port->socket_fd, temp_buffer, 20, 0, -1, NULL) < 0) {
@@ -713,6 +700,9 @@ void CMS_SERVER_REMOTE_TCP_PORT::handle_request(CLIENT_TCP_PORT *
 
     switch_function(_client_tcp_port,
 	server, request_type, buffer_number, received_serial_number);
+    if (request_type == REMOTE_CMS_CLOSE_CHANNEL_REQUEST_TYPE) {
+	return;			/* _client_tcp_port is gone */
+    }
 
     if (NULL != _client_tcp_port->diag_info &&
 	NULL != server->last_local_port_used && server->diag_enabled) {
@@ -733,7 +723,6 @@ void CMS_SERVER_REMOTE_TCP_PORT::switch_function(CLIENT_TCP_PORT *
     long request_type, long buffer_number, long received_serial_number)
 {
     int total_subdivisions = 1;
-    CLIENT_TCP_PORT *client_port_to_check = NULL;
     switch (request_type) {
     case REMOTE_CMS_SET_DIAG_INFO_REQUEST_TYPE:
 	{
@@ -1162,8 +1151,10 @@ void CMS_SERVER_REMOTE_TCP_PORT::switch_function(CLIENT_TCP_PORT *
 		return;
 	    }
 	} else {
+	    /* MSG_MORE holds the header back to go out with the data */
 	    if (sendn
-		(_client_tcp_port->socket_fd, temp_buffer, 20, 0,
+		(_client_tcp_port->socket_fd, temp_buffer, 20,
+		    server->read_reply->size > 0 ? MSG_MORE : 0,
 		    dtimeout) < 0) {
 		_client_tcp_port->errors++;
 		return;
@@ -1212,6 +1203,7 @@ void CMS_SERVER_REMOTE_TCP_PORT::switch_function(CLIENT_TCP_PORT *
 		return;
 	    }
 	}
+	buffer_written = 1;
 	REMOTE_WRITE_REPLY *reply;
 	server->write_reply = reply =
 	    (REMOTE_WRITE_REPLY *) server->process_request(&server->
@@ -1372,24 +1364,7 @@ void CMS_SERVER_REMOTE_TCP_PORT::switch_function(CLIENT_TCP_PORT *
 	break;
 
     case REMOTE_CMS_CLOSE_CHANNEL_REQUEST_TYPE:
-	client_port_to_check = (CLIENT_TCP_PORT *) client_ports->get_head();
-	while (NULL != client_port_to_check) {
-	    if (client_port_to_check->socket_fd ==
-		_client_tcp_port->socket_fd) {
-		break;
-	    }
-	    client_port_to_check =
-		(CLIENT_TCP_PORT *) client_ports->get_next();
-	}
-	FD_CLR(_client_tcp_port->socket_fd, &read_fd_set);
-	close(_client_tcp_port->socket_fd);
-	current_clients--;
-	if (NULL != _client_tcp_port->subscriptions) {
-	    remove_subscription_client(_client_tcp_port, buffer_number);
-	}
-	_client_tcp_port->socket_fd = -1;
-	delete _client_tcp_port;
-	client_ports->delete_current_node();
+	close_client(_client_tcp_port);
 	break;
 
     case REMOTE_CMS_GET_KEYS_REQUEST_TYPE:
@@ -1551,10 +1526,12 @@ void CMS_SERVER_REMOTE_TCP_PORT::add_subscription_client(int buffer_number,
 	temp_clnt_info->sub_buf_info = buf_info;
 	temp_clnt_info->clnt_port = clnt;
 	temp_clnt_info->last_sub_sent_time = etime();
-	temp_clnt_info->subscription_list_id =
-	    clnt->subscriptions->store_at_tail(temp_clnt_info,
+	clnt->subscriptions->store_at_tail(temp_clnt_info,
 	    sizeof(*temp_clnt_info), 0);
-	buf_info->sub_clnt_info->store_at_tail(temp_clnt_info,
+	/* the id is that of the node in the buffer's list, which is the
+	   one removed when the client unsubscribes */
+	temp_clnt_info->subscription_list_id =
+	    buf_info->sub_clnt_info->store_at_tail(temp_clnt_info,
 	    sizeof(*temp_clnt_info), 0);
     }
     temp_clnt_info->subscription_type = subscription_type;
@@ -1584,6 +1561,7 @@ void CMS_SERVER_REMOTE_TCP_PORT::remove_subscription_client(CLIENT_TCP_PORT *
 		    }
 		}
 	    }
+	    clnt->subscriptions->delete_current_node();
 	    delete temp_clnt_info;
 	    temp_clnt_info = NULL;
 	    break;
@@ -1598,6 +1576,9 @@ void CMS_SERVER_REMOTE_TCP_PORT::recalculate_polling_interval()
 {
     int min_poll_interval_millis = 30000;
     polling_enabled = 0;
+    if (NULL == subscription_buffers) {
+	return;
+    }
     TCP_BUFFER_SUBSCRIPTION_INFO *buf_info =
 	(TCP_BUFFER_SUBSCRIPTION_INFO *) subscription_buffers->get_head();
     while (NULL != buf_info) {
@@ -1613,6 +1594,14 @@ void CMS_SERVER_REMOTE_TCP_PORT::recalculate_polling_interval()
 		    temp_clnt_info->poll_interval_millis;
 		polling_enabled = 1;
 	    }
+	    /* nothing tells the server a buffer changed but looking, so
+	       variable subscriptions are checked as often as possible
+	       to push each new message out promptly */
+	    if (temp_clnt_info->subscription_type ==
+		CMS_VARIABLE_SUBSCRIPTION) {
+		min_poll_interval_millis = 0;
+		polling_enabled = 1;
+	    }
 	    temp_clnt_info = (TCP_CLIENT_SUBSCRIPTION_INFO *)
 		buf_info->sub_clnt_info->get_next();
 	}
@@ -1624,8 +1613,7 @@ void CMS_SERVER_REMOTE_TCP_PORT::recalculate_polling_interval()
     } else {
 	current_poll_interval_millis = ((int) (clk_tck() * 1000.0));
     }
-    select_timeout.tv_sec = current_poll_interval_millis / 1000;
-    select_timeout.tv_usec = (current_poll_interval_millis % 1000) * 1000;
+    next_subscription_update = etime() + current_poll_interval_millis / 1000.0;
     dtimeout = (current_poll_interval_millis + 10) * 1000.0;
     if (dtimeout < 0.5) {
 	dtimeout = 0.5;
@@ -1705,7 +1693,9 @@ void CMS_SERVER_REMOTE_TCP_PORT::update_subscriptions()
 		    }
 		} else {
 		    if (sendn(temp_clnt_info->clnt_port->socket_fd,
-			    temp_buffer, 20, 0, dtimeout) < 0) {
+			    temp_buffer, 20,
+			    server->read_reply->size > 0 ? MSG_MORE : 0,
+			    dtimeout) < 0) {
 			temp_clnt_info->clnt_port->errors++;
 			return;
 		    }
@@ -54,9 +54,11 @@ class CMS_SERVER_REMOTE_TCP_PORT:public CMS_SERVER_REMOTE_PORT {
     void unregister_port();
     double dtimeout;
   protected:
-      fd_set read_fd_set, write_fd_set;
+    int epoll_fd;
     void handle_request(CLIENT_TCP_PORT *);
-    int maxfdpl;
+    void accept_client();
+    void close_client(CLIENT_TCP_PORT *);
+    void remove_client_subscriptions(CLIENT_TCP_PORT *);
     LinkedList *client_ports;
     LinkedList *subscription_buffers;
     int connection_socket;
@@ -66,7 +68,8 @@ class CMS_SERVER_REMOTE_TCP_PORT:public CMS_SERVER_REMOTE_PORT {
     char temp_buffer[0x2000];
     int current_poll_interval_millis;
     int polling_enabled;
-    struct timeval select_timeout;
+    double next_subscription_update;
+    int buffer_written;
     void update_subscriptions();
     void add_subscription_client(int buffer_number, int subscription_type,
 	int poll_interval_millis, CLIENT_TCP_PORT * clnt);
@@ -114,6 +117,7 @@ class CLIENT_TCP_PORT {
     int errors, max_errors;
     struct sockaddr_in address;
     int socket_fd;
+    int list_id;
     LinkedList *subscriptions;
     pid_t tid;
     pid_t pid;
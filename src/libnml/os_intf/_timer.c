@@ -26,8 +26,14 @@
 #include <sys/time.h>		/* struct timeval, gettimeofday(), struct
 				   itimerval, setitimer(), ITIMER_REAL */
 #include <sched.h>
+#include <stdlib.h>		/* getenv(), atexit() */
+#include <limits.h>		/* LLONG_MAX */
+#include <time.h>		/* nanosleep() */
+#include <sys/ipc.h>
+#include <sys/shm.h>		/* shmget(), shmat() */
 
 #include "_timer.h"
+#include "uspace_uuid.h"
 
 /* number of seconds in a system clock tick */
 double clk_tck()
@@ -43,12 +49,158 @@ double clk_tck()
 int etime_disabled = 0;
 double etime_disable_time = 0.0;
 
+/* With RTAPI_VIRTUAL_TIME=1, a non-realtime rtapi_app runs its threads on
+   a simulated clock, which it keeps in its uuid shared memory segment.
+   etime() and esleep() follow that clock then, and a process that called
+   esleep_in_step() also holds it while it runs. */
+static uuid_data_t *virtual_data;
+static virtual_time_user_t *virtual_user;
+static int virtual_user_pid;
+
+static double wall_time(void)
+{
+    struct timeval tp;
+
+    gettimeofday(&tp, NULL);
+    return ((double) tp.tv_sec) + ((double) tp.tv_usec) / 1000000.0;
+}
+
+/* the segment, while rtapi_app runs its threads on the simulated clock */
+static uuid_data_t *virtual_clock(void)
+{
+    static int enabled = -1;
+    static double next_try;
+
+    if (enabled < 0) {
+	const char *env = getenv("RTAPI_VIRTUAL_TIME");
+	enabled = env && atoi(env) > 0;
+    }
+    if (!enabled) {
+	return NULL;
+    }
+    if (virtual_data
+	&& !__atomic_load_n(&virtual_data->virtual_time, __ATOMIC_ACQUIRE)) {
+	/* rtapi_app stopped; a new one makes a new segment */
+	shmdt(virtual_data);
+	virtual_data = NULL;
+	virtual_user = NULL;
+    }
+    if (!virtual_data) {
+	/* not running yet, look again once a second */
+	double now = wall_time();
+	void *mem;
+	int id;
+	if (now < next_try) {
+	    return NULL;
+	}
+	next_try = now + 1.0;
+	id = shmget((key_t) UUID_KEY, 0, 0);
+	if (id < 0) {
+	    return NULL;
+	}
+	mem = shmat(id, NULL, 0);
+	if (mem == (void *) -1) {
+	    return NULL;
+	}
+	virtual_data = (uuid_data_t *) mem;
+	if (!__atomic_load_n(&virtual_data->virtual_time, __ATOMIC_ACQUIRE)) {
+	    shmdt(virtual_data);
+	    virtual_data = NULL;
+	}
+    }
+    return virtual_data;
+}
+
+static void esleep_leave_step(void)
+{
+    if (virtual_user && virtual_user_pid == getpid()) {
+	__atomic_store_n(&virtual_user->wake, LLONG_MAX, __ATOMIC_RELEASE);
+	__atomic_store_n(&virtual_user->pid, 0, __ATOMIC_RELEASE);
+    }
+    virtual_user = NULL;
+}
+
+/* From now on the simulated clock does not move while this process runs,
+   only while it is in esleep(), and then only up to when it wakes up.
+   For a process that does all its waiting in esleep() */
+void esleep_in_step(void)
+{
+    static int registered, warned;
+    virtual_time_user_t *user;
+    int pid = getpid();
+    uuid_data_t *clock = virtual_clock();
+
+    if (!clock || (virtual_user && virtual_user_pid == pid)) {
+	return;
+    }
+    for (user = clock->virtual_users;
+	user < clock->virtual_users + VIRTUAL_TIME_USERS; user++) {
+	int free_slot = 0;
+	if (__atomic_compare_exchange_n(&user->pid, &free_slot, pid, 0,
+		__ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+	    __atomic_store_n(&user->wake,
+		__atomic_load_n(&clock->virtual_now, __ATOMIC_ACQUIRE),
+		__ATOMIC_RELEASE);
+	    virtual_user = user;
+	    virtual_user_pid = pid;
+	    if (!registered) {
+		atexit(esleep_leave_step);
+		registered = 1;
+	    }
+	    return;
+	}
+    }
+    if (!warned) {
+	rcs_print_error("esleep: all %d places to run in step with the "
+	    "simulated clock are taken\n", VIRTUAL_TIME_USERS);
+	warned = 1;
+    }
+}
+
+static void virtual_sleep(uuid_data_t *clock, double seconds)
+{
+    virtual_time_user_t *user =
+	virtual_user_pid == getpid() ? virtual_user : NULL;
+    long long now = __atomic_load_n(&clock->virtual_now, __ATOMIC_ACQUIRE);
+    long long wake = now + (long long) (seconds * 1e9);
+    long long last = now;
+    double moved = wall_time();
+
+    if (user) {
+	__atomic_store_n(&user->wake, wake, __ATOMIC_RELEASE);
+    }
+    while (now < wake) {
+	struct timespec ts = { 0, 20000 };
+	nanosleep(&ts, NULL);
+	if (!__atomic_load_n(&clock->virtual_time, __ATOMIC_ACQUIRE)) {
+	    break;
+	}
+	now = __atomic_load_n(&clock->virtual_now, __ATOMIC_ACQUIRE);
+	if (now != last) {
+	    last = now;
+	    moved = wall_time();
+	} else if (wall_time() - moved > 1.0) {
+	    /* no threads left to move the clock */
+	    break;
+	}
+    }
+    if (user) {
+	__atomic_store_n(&user->wake,
+	    __atomic_load_n(&clock->virtual_now, __ATOMIC_ACQUIRE),
+	    __ATOMIC_RELEASE);
+    }
+}
+
 /* number of seconds from some epoch, to clock tick resolution */
 double etime()
 {
     struct timeval tp;
     double retval;
+    uuid_data_t *clock = virtual_clock();
 
+    if (clock) {
+	return __atomic_load_n(&clock->virtual_now, __ATOMIC_ACQUIRE) * 1e-9;
+    }
     if (0 != gettimeofday(&tp, NULL)) {
 	rcs_print_error("etime: can't get time\n");
 	return 0.0;
@@ -68,8 +220,14 @@ void esleep(double seconds_to_sleep)
     double total = seconds_to_sleep;	/* total sleep asked for */
     double started = etime();	/* time when called */
     double left = total;
+    uuid_data_t *clock;
     if (seconds_to_sleep <= 0.0)
 	return;
+    clock = virtual_clock();
+    if (clock) {
+	virtual_sleep(clock, seconds_to_sleep);
+	return;
+    }
     if (clk_tck_val <= 0) {
 	clk_tck_val = clk_tck();
     }
@@ -28,6 +28,8 @@ extern "C" {
     extern double etime(void);
 /* sleeps # of seconds, to clock tick resolution */
     extern void esleep(double secs);
+/* holds a simulated clock (RTAPI_VIRTUAL_TIME) while not in esleep() */
+    extern void esleep_in_step(void);
     void start_timer_server(int priority, int sem_id);
     void kill_timer_server(void);
     extern void print_etime(void);
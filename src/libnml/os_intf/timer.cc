@@ -139,6 +139,9 @@ int RCS_TIMER::wait()
        between this wakeup and the last wakeup.  For internal timers, this is 
        how long we need to sleep to make it to the next interval on time. */
     interval = time_in - last_time;
+    if (interval < 0.0) {
+	interval = 0.0;		/* etime() changed over to a simulated clock */
+    }
     numcycles = interval / timeout;
 
     /* synchronize and set last_time correctly; update idle time */
@@ -152,6 +155,9 @@ int RCS_TIMER::wait()
 	missed = (int) (numcycles); 
 	remaining = timeout * (1.0 - (numcycles - (int) numcycles));
 	idle += interval;
+	/* a process that waits for its cycles here runs in step with a
+	   simulated clock */
+	esleep_in_step();
     }
     esleep(remaining);
     last_time = etime();
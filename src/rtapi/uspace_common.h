@@ -29,6 +29,7 @@
 
 #include <rtapi_errno.h>
 #include <rtapi_mutex.h>
+#include "uspace_uuid.h"
 static int msg_level = RTAPI_MSG_ERR;	/* message printing level */
 
 #include <sys/ipc.h>		/* IPC_* */
@@ -57,6 +58,42 @@ typedef struct {
 
 static rtapi_shmem_handle shmem_array[MAX_SHM] = {{0},};
 
+/* With RTAPI_HUGEPAGES=1 in the environment, segments of at least this
+ * size (HAL data, the motion struct with its TC queue, scope buffers) go
+ * on huge pages, so the threads walking them need far fewer TLB entries.
+ * Huge pages have to be reserved (vm.nr_hugepages); otherwise, or if the
+ * segment already exists on normal pages, normal pages are used.
+ */
+#define HUGEPAGE_MIN_SEGMENT (256 * 1024)
+
+/* size of a huge page for a segment of 'size' bytes, or 0 to use normal pages */
+static unsigned long shmem_hugepage_size(unsigned long size)
+{
+#ifdef SHM_HUGETLB
+  static long hugepagesize = -1;
+  const char *env = getenv("RTAPI_HUGEPAGES");
+
+  if (!env || atoi(env) <= 0 || size < HUGEPAGE_MIN_SEGMENT)
+    return 0;
+  if (hugepagesize < 0) {
+    char line[128];
+    unsigned long kb;
+    FILE *f = fopen("/proc/meminfo", "r");
+    hugepagesize = 0;
+    while (f && fgets(line, sizeof(line), f)) {
+      if (sscanf(line, "Hugepagesize: %lu kB", &kb) == 1) {
+        hugepagesize = kb * 1024;
+        break;
+      }
+    }
+    if (f) fclose(f);
+  }
+  return hugepagesize;
+#else
+  return 0;
+#endif
+}
+
 int rtapi_shmem_new(int key, int module_id, unsigned long int size)
 {
 #ifdef RTAPI
@@ -82,9 +119,29 @@ int rtapi_shmem_new(int key, int module_id, unsigned long int size)
   }
 
   /* now get shared memory block from OS */
+  long pagesize = sysconf(_SC_PAGESIZE);
+  unsigned long hugepagesize = shmem_hugepage_size(size);
   int shmget_retries = 5;
+  shmem->id = -1;
+#ifdef SHM_HUGETLB
+  if (hugepagesize) {
+    /* only for a new segment: one that exists already, on whatever
+       pages and of whatever size, is attached by the plain shmget() */
+    unsigned long hugesize = (size + hugepagesize - 1) / hugepagesize * hugepagesize;
+    shmem->id = shmget((key_t) key, hugesize, IPC_CREAT | IPC_EXCL | SHM_HUGETLB | 0600);
+    if (shmem->id == -1 && errno == EEXIST) {
+      rtapi_print_msg(RTAPI_MSG_DBG, "rtapi_shmem_new: key=0x%08x exists already\n", key);
+    } else if (shmem->id == -1) {
+      rtapi_print_msg(RTAPI_MSG_INFO, "rtapi_shmem_new: key=0x%08x not on huge pages: %s\n", key, strerror(errno));
+    } else {
+      rtapi_print_msg(RTAPI_MSG_INFO, "rtapi_shmem_new: key=0x%08x on %lu kB pages\n", key, hugepagesize / 1024);
+      pagesize = hugepagesize;
+    }
+  }
+#endif
 shmget_again:
-  shmem->id = shmget((key_t) key, (int) size, IPC_CREAT | 0600);
+  if (shmem->id == -1)
+    shmem->id = shmget((key_t) key, (int) size, IPC_CREAT | 0600);
   if (shmem->id == -1) {
       // See below for explanation of why retry against -EPERM here
       if(shmget_retries-- && errno == -EPERM) {
@@ -142,8 +199,7 @@ shmget_again:
     return -errno;
   }
 
-  long pagesize = sysconf(_SC_PAGESIZE);
-  /* touch every page */
+  /* touch every page, so the servo thread never faults one in */
   for(size_t off = 0; off < size; off += pagesize)
   {
       volatile char i = ((char*)shmem->mem)[off];
@@ -283,6 +339,17 @@ int rtapi_get_msg_level() {
     return msg_level;
 }
 
+static         int  uuid_mem_id = 0;
+static uuid_data_t* uuid_data   = 0;
+
+/* the simulated time in ns, or -1 if the clock is the real one */
+static long long uuid_virtual_time(void)
+{
+    if (!uuid_data || !__atomic_load_n(&uuid_data->virtual_time, __ATOMIC_ACQUIRE))
+        return -1;
+    return __atomic_load_n(&uuid_data->virtual_now, __ATOMIC_ACQUIRE);
+}
+
 #if defined(__i386) || defined(__amd64)
 #define rdtscll(val) ((val) = __builtin_ia32_rdtsc())
 #else
@@ -293,24 +360,18 @@ long long rtapi_get_clocks(void)
 {
     long long int retval;
 
+    /* a simulated clock has no cycle counter, count its nanoseconds */
+    retval = uuid_virtual_time();
+    if (retval >= 0)
+        return retval;
     rdtscll(retval);
     return retval;
 }
 
-typedef struct {
-    rtapi_mutex_t mutex;
-    int           uuid;
-} uuid_data_t;
-
-#define UUID_KEY  0x48484c34 /* key for UUID for simulator */
-
-static         int  uuid_mem_id = 0;
 int rtapi_init(const char *modname)
 {
-    static uuid_data_t* uuid_data   = 0;
     const static   int  uuid_id     = 0;
 
-    static char* uuid_shmem_base = 0;
     int retval,id;
     void *uuid_mem;
 
@@ -328,10 +389,7 @@ int rtapi_init(const char *modname)
         rtapi_exit(uuid_id);
         return -EINVAL;
     }
-    if (uuid_shmem_base == 0) {
-        uuid_shmem_base =        (char *) uuid_mem;
-        uuid_data       = (uuid_data_t *) uuid_mem;
-    }
+    uuid_data = (uuid_data_t *) uuid_mem;
     rtapi_mutex_get(&uuid_data->mutex);
         uuid_data->uuid++;
         id = uuid_data->uuid;
@@ -343,6 +401,8 @@ int rtapi_init(const char *modname)
 int rtapi_exit(int module_id)
 {
   rtapi_shmem_delete(uuid_mem_id, module_id);
+  if (uuid_mem_id < 0 || shmem_array[uuid_mem_id].magic != SHMEM_MAGIC)
+    uuid_data = 0;
   return 0;
 }
 
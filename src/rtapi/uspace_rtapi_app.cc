@@ -38,6 +38,7 @@
 #include <time.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <limits.h>
 #ifdef HAVE_SYS_IO_H
 #include <sys/io.h>
 #endif
@@ -54,9 +55,13 @@
 #include "rtapi.h"
 #include "hal.h"
 #include "hal/hal_priv.h"
+#include "hal/utils/startup_trace.h"
 #include "rtapi_uspace.hh"
 
-#include <boost/lockfree/queue.hpp>
+#include <atomic>
+#include <semaphore.h>
+#include "dbuf.h"
+#include "stashf.h"
 
 std::atomic<int> WithRoot::level;
 static uid_t euid, ruid;
@@ -83,13 +88,110 @@ namespace
 {
 RtapiApp &App();
 
-struct message_t {
-    msg_level_t level;
-    char msg[1024-sizeof(level)];
+// Messages printed by threads other than the main one go through a ring
+// of variable-size records.  The printing thread only stashes the format
+// and its arguments (vstashf); queue_function does the formatting.
+//
+// Producers claim space by moving msg_head forward with a CAS, fill in
+// their record and publish it by storing its length last.  The consumer
+// zeroes what it has printed before giving the space back through
+// msg_tail, so a zero length means the record is not written yet.
+const size_t MSG_RING_SIZE = 256 * 1024;   // must be a power of two
+const size_t MSG_RECORD_MAX = 1024;
+
+struct msg_record {
+    uint32_t len;               // whole record, 8-byte aligned; 0 until published
+    int32_t level;              // msg_level_t, or -1 for padding to the ring end
+    unsigned char data[];       // vstashf() output
 };
 
-boost::lockfree::queue<message_t, boost::lockfree::capacity<128>>
-rtapi_msg_queue;
+alignas(8) unsigned char msg_ring[MSG_RING_SIZE];
+std::atomic<size_t> msg_head, msg_tail;
+std::atomic<unsigned> msg_dropped[RTAPI_MSG_ALL + 1];
+sem_t msg_sem;
+
+msg_record *msg_at(size_t pos) {
+    return reinterpret_cast<msg_record *>(msg_ring + (pos & (MSG_RING_SIZE - 1)));
+}
+
+void msg_publish(msg_record *r, size_t len) {
+    __atomic_store_n(&r->len, (uint32_t)len, __ATOMIC_RELEASE);
+}
+
+// Safe to call from realtime threads: no locks, no allocation, and
+// sem_post() only enters the kernel when the consumer is waiting.
+void msg_stash(msg_level_t level, const char *fmt, va_list ap) {
+    unsigned char data[MSG_RECORD_MAX - sizeof(msg_record)];
+    struct dbuf d = {sizeof(data), data};
+    struct dbuf_iter it;
+    va_list ap1;
+
+    dbuf_iter_init(&it, &d);
+    va_copy(ap1, ap);
+    int result = vstashf(&it, fmt, ap1);
+    va_end(ap1);
+    if(result < 0) {
+        // a conversion vstashf doesn't handle, or too long: format it
+        // here, truncated like it always was
+        char text[sizeof(data) - sizeof("%s")];
+        vsnprintf(text, sizeof(text), fmt, ap);
+        dbuf_iter_init(&it, &d);
+        stashf(&it, "%s", text);
+    }
+
+    size_t len = (sizeof(msg_record) + it.offset + 7) & ~(size_t)7;
+    size_t head = msg_head.load(std::memory_order_relaxed), pad;
+    do {
+        size_t room = MSG_RING_SIZE - (head & (MSG_RING_SIZE - 1));
+        pad = room < len ? room : 0;
+        if(head + pad + len - msg_tail.load(std::memory_order_acquire)
+                > MSG_RING_SIZE) {
+            msg_dropped[level].fetch_add(1, std::memory_order_relaxed);
+            sem_post(&msg_sem);
+            return;
+        }
+    } while(!msg_head.compare_exchange_weak(head, head + pad + len,
+                std::memory_order_relaxed));
+
+    if(pad) {
+        msg_record *p = msg_at(head);
+        p->level = -1;
+        msg_publish(p, pad);
+    }
+    msg_record *r = msg_at(head + pad);
+    r->level = level;
+    memcpy(r->data, data, it.offset);
+    msg_publish(r, len);
+    sem_post(&msg_sem);
+}
+
+// Print every published record, in order, up to the first one that is
+// still being written.
+void msg_drain() {
+    size_t tail = msg_tail.load(std::memory_order_relaxed);
+    while(1) {
+        msg_record *r = msg_at(tail);
+        size_t len = __atomic_load_n(&r->len, __ATOMIC_ACQUIRE);
+        if(!len) break;
+        if(r->level >= 0) {
+            char buf[4096];
+            struct dbuf d = {len - sizeof(msg_record), r->data};
+            struct dbuf_iter it;
+            dbuf_iter_init(&it, &d);
+            if(snprintdbuf(buf, sizeof(buf), &it) >= 0)
+                fputs(buf, r->level == RTAPI_MSG_ALL ? stdout : stderr);
+        }
+        memset(r, 0, len);
+        tail += len;
+        msg_tail.store(tail, std::memory_order_release);
+    }
+    for(int level = 0; level <= RTAPI_MSG_ALL; level++) {
+        unsigned dropped = msg_dropped[level].exchange(0);
+        if(dropped)
+            fprintf(stderr, "rtapi_app: %u level %d messages dropped, "
+                    "message ring full\n", dropped, level);
+    }
+}
 
 static void set_namef(const char *fmt, ...) {
     char *buf = NULL;
@@ -117,12 +219,10 @@ void *queue_function(void *arg) {
     while(1) {
         pthread_testcancel();
         pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, nullptr);
-        rtapi_msg_queue.consume_all([](const message_t &m) {
-            fputs(m.msg, m.level == RTAPI_MSG_ALL ? stdout : stderr);
-        });
+        msg_drain();
         pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, nullptr);
-        struct timespec ts = {0, 10000000};
-        rtapi_clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, NULL, NULL);
+        // woken by each message; a cancellation point
+        sem_wait(&msg_sem);
     }
     return nullptr;
 }
@@ -274,7 +374,9 @@ static int do_load_cmd(string name, vector<string> args) {
     if(w == NULL) {
         char what[LINELEN+1];
         snprintf(what, LINELEN, "%s/%s.so", EMC2_RTLIB_DIR, name.c_str());
+        double t_dlopen = startup_trace_now();
         void *module = modules[name] = dlopen(what, RTLD_GLOBAL | RTLD_NOW);
+        startup_trace_span("rtapi_app", ("dlopen " + name).c_str(), t_dlopen, 0, what);
         if(!module) {
             rtapi_print_msg(RTAPI_MSG_ERR, "%s: dlopen: %s\n", name.c_str(), dlerror());
             modules.erase(name);
@@ -297,7 +399,11 @@ static int do_load_cmd(string name, vector<string> args) {
             return -1;
         }
 
-        if ((result=start()) < 0) {
+        double t_main = startup_trace_now();
+        result = start();
+        startup_trace_span("rtapi_app", ("rtapi_app_main " + name).c_str(),
+                t_main, 0, NULL);
+        if (result < 0) {
             rtapi_print_msg(RTAPI_MSG_ERR, "%s: rtapi_app_main: %s (%d)\n",
                 name.c_str(), strerror(-result), result);
             dlclose(module);
@@ -451,6 +557,8 @@ static pthread_t main_thread{};
 
 static int master(int fd, vector<string> args) {
     main_thread = pthread_self();
+    startup_trace_process("rtapi_app");
+    sem_init(&msg_sem, 0, 0);
     if(pthread_create(&queue_thread, nullptr, &queue_function, nullptr) < 0) {
         perror("pthread_create (queue function)");
         return -1;
@@ -466,11 +574,12 @@ static int master(int fd, vector<string> args) {
     }
     sim_rtapi_run_threads(fd, callback);
 out:
+    // user space waiting on the simulated clock goes back to the real one
+    if(uuid_data)
+        __atomic_store_n(&uuid_data->virtual_time, 0, __ATOMIC_RELEASE);
     pthread_cancel(queue_thread);
     pthread_join(queue_thread, nullptr);
-    rtapi_msg_queue.consume_all([](const message_t &m) {
-        fputs(m.msg, m.level == RTAPI_MSG_ALL ? stdout : stderr);
-    });
+    msg_drain();
     return result;
 }
 
@@ -602,19 +711,57 @@ namespace
 {
 struct PosixTask : rtapi_task
 {
-    PosixTask() : rtapi_task{}, thr{}
+    PosixTask() : rtapi_task{}, thr{}, release{}, waiting{}
     {}
 
     pthread_t thr;                /* thread's context */
+    long long release;            /* virtual time: when it may run next */
+    bool waiting;                 /* virtual time: waiting for its turn */
 };
 
+/* With RTAPI_VIRTUAL_TIME=1, the non-realtime threads run on a simulated
+ * clock. The threads already take thread_lock in turns; here the turn also
+ * goes to the thread due first (faster thread, then lower id, on a tie), and
+ * the clock jumps to its release instead of sleeping until it. Runs are then
+ * the same from one to the next and as fast as the machine allows, or at
+ * most RTAPI_VIRTUAL_TIME_RATE times real time so that user space (task,
+ * UIs, polling on wall clock time) keeps up. */
+static bool virtual_time_enabled()
+{
+    const char *env = getenv("RTAPI_VIRTUAL_TIME");
+    return env && atoi(env) > 0;
+}
+
+/* user space reads the simulated clock from the uuid segment */
+static void virtual_time_publish(int enabled, long long now)
+{
+    if(!uuid_data) {
+        // a reference of our own, held for as long as rtapi_app runs
+        void *mem;
+        int id = rtapi_shmem_new(UUID_KEY, 0, sizeof(uuid_data_t));
+        if(id < 0 || rtapi_shmem_getptr(id, &mem) < 0) return;
+        uuid_data = (uuid_data_t *) mem;
+    }
+    __atomic_store_n(&uuid_data->virtual_now, now, __ATOMIC_RELEASE);
+    __atomic_store_n(&uuid_data->virtual_time, enabled, __ATOMIC_RELEASE);
+}
+
 struct Posix : RtapiApp
 {
-    Posix(int policy = SCHED_FIFO) : RtapiApp(policy), do_thread_lock(policy != SCHED_FIFO) {
+    Posix(int policy = SCHED_FIFO, bool virtual_time = false)
+        : RtapiApp(policy), do_thread_lock(policy != SCHED_FIFO),
+          virtual_time(virtual_time && policy != SCHED_FIFO),
+          virtual_rate(0), virtual_now(0), virtual_wall_start{}, turn(nullptr),
+          virtual_tasks{}, virtual_count(0), virtual_joining(0) {
         pthread_once(&key_once, init_key);
         if(do_thread_lock) {
             pthread_once(&lock_once, init_lock);
         }
+        if(this->virtual_time) {
+            virtual_time_init();
+        } else {
+            virtual_time_publish(0, 0);
+        }
     }
     int task_delete(int id);
     int task_start(int task_id, unsigned long period_nsec);
@@ -645,7 +792,26 @@ struct Posix : RtapiApp
         pthread_mutex_init(&thread_lock, NULL);
     }
 
+    bool virtual_time;
+    double virtual_rate;          // times real time at most, 0 for no limit
+    long long virtual_now;
+    struct timespec virtual_wall_start;
+    PosixTask *turn;              // the thread that may run, with thread_lock
+    // threads taking turns, kept by the threads themselves under thread_lock
+    PosixTask *virtual_tasks[MAX_TASKS];
+    int virtual_count;
+    int virtual_joining;          // threads starting, before they take thread_lock
+    static pthread_cond_t turn_cond;
+    void virtual_time_init();
+    void virtual_schedule();
+    void virtual_advance(long long target);
+    long long virtual_users_hold();
+    void virtual_wait(PosixTask *task, long long release);
+    static void virtual_wait_cancelled(void *arg);
+
     long long do_get_time(void) {
+        if(virtual_time)
+            return __atomic_load_n(&virtual_now, __ATOMIC_ACQUIRE);
         struct timespec ts;
         clock_gettime(CLOCK_MONOTONIC, &ts);
         return ts.tv_sec * 1000000000LL + ts.tv_nsec;
@@ -799,8 +965,11 @@ static RtapiApp *makeApp()
     if(euid != 0 || harden_rt() < 0)
     {
         rtapi_print_msg(RTAPI_MSG_ERR, "Note: Using POSIX non-realtime\n");
-        return new Posix(SCHED_OTHER);
+        return new Posix(SCHED_OTHER, virtual_time_enabled());
     }
+    if(virtual_time_enabled())
+        rtapi_print_msg(RTAPI_MSG_ERR,
+                "Note: RTAPI_VIRTUAL_TIME is ignored with realtime\n");
     WithRoot r;
     void *dll = nullptr;
     if(detect_xenomai()) {
@@ -952,6 +1121,20 @@ int Posix::task_delete(int id)
 
   pthread_cancel(task->thr);
   pthread_join(task->thr, 0);
+  if(virtual_time) {
+      pthread_mutex_lock(&thread_lock);
+      for(int i = 0; i < virtual_count; i++) {
+          if(virtual_tasks[i] == task) {
+              virtual_tasks[i] = virtual_tasks[--virtual_count];
+              break;
+          }
+      }
+      if(turn == task)
+          turn = nullptr;
+      if(!turn && !__atomic_load_n(&virtual_joining, __ATOMIC_ACQUIRE))
+          virtual_schedule();
+      pthread_mutex_unlock(&thread_lock);
+  }
   task->magic = 0;
   task_array[id] = 0;
   delete task;
@@ -1062,6 +1245,140 @@ pthread_once_t Posix::key_once = PTHREAD_ONCE_INIT;
 pthread_once_t Posix::lock_once = PTHREAD_ONCE_INIT;
 pthread_key_t Posix::key;
 pthread_mutex_t Posix::thread_lock;
+pthread_cond_t Posix::turn_cond = PTHREAD_COND_INITIALIZER;
+
+static void ns_to_timespec(struct timespec &ts, long long ns)
+{
+    ts.tv_sec = ns / 1000000000LL;
+    ts.tv_nsec = ns % 1000000000LL;
+}
+
+void Posix::virtual_time_init()
+{
+    const char *env = getenv("RTAPI_VIRTUAL_TIME_RATE");
+    if(env) virtual_rate = atof(env);
+    if(!(virtual_rate > 0)) virtual_rate = 0;
+    clock_gettime(RTAPI_CLOCK, &virtual_wall_start);
+    virtual_time_publish(1, virtual_now);
+    if(virtual_rate)
+        rtapi_print_msg(RTAPI_MSG_ERR,
+                "Note: Using virtual time, at most %g times real time\n", virtual_rate);
+    else
+        rtapi_print_msg(RTAPI_MSG_ERR, "Note: Using virtual time\n");
+}
+
+/* Give the turn to the waiting thread due first and move the clock to its
+ * release. Called with thread_lock held and nobody having the turn. */
+void Posix::virtual_schedule()
+{
+    PosixTask *next = nullptr;
+    for(int i = 0; i < virtual_count; i++) {
+        PosixTask *task = virtual_tasks[i];
+        if(!task->waiting) continue;
+        if(!next || task->release < next->release
+                || (task->release == next->release && (task->period < next->period
+                    || (task->period == next->period && task->id < next->id))))
+            next = task;
+    }
+    turn = next;
+    if(next && next->release > virtual_now) {
+        // not a place to be cancelled, with thread_lock taken
+        int state;
+        pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &state);
+        virtual_advance(next->release);
+        pthread_setcancelstate(state, nullptr);
+    }
+    pthread_cond_broadcast(&turn_cond);
+}
+
+/* The earliest time a user space process running in step with the clock
+ * (see esleep() in libnml) lets it move to, LLONG_MAX if there is none.
+ * The slot of a process that died holding the clock is freed. */
+long long Posix::virtual_users_hold()
+{
+    long long hold = LLONG_MAX;
+    if(!uuid_data) return hold;
+    for(auto &user : uuid_data->virtual_users) {
+        int pid = __atomic_load_n(&user.pid, __ATOMIC_ACQUIRE);
+        if(!pid) continue;
+        long long wake = __atomic_load_n(&user.wake, __ATOMIC_ACQUIRE);
+        if(wake <= virtual_now && kill(pid, 0) < 0 && errno == ESRCH) {
+            __atomic_store_n(&user.wake, LLONG_MAX, __ATOMIC_RELEASE);
+            __atomic_compare_exchange_n(&user.pid, &pid, 0, false,
+                    __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+            continue;
+        }
+        hold = std::min(hold, wake);
+    }
+    return hold;
+}
+
+/* Move the clock to 'target', no faster than virtual_rate allows, and
+ * stopping wherever a user space process in step with it wakes up, until
+ * it goes back to sleep.  Called with thread_lock held. */
+void Posix::virtual_advance(long long target)
+{
+    for(;;) {
+        long long to = std::min(target, virtual_users_hold());
+        if(to > virtual_now) {
+            if(virtual_rate) {
+                // not rtapi_timespec_advance(): its unsigned long
+                // wraps after 4.3 s on 32 bit hosts
+                struct timespec until;
+                ns_to_timespec(until, virtual_wall_start.tv_sec * 1000000000LL
+                        + virtual_wall_start.tv_nsec + (long long)(to / virtual_rate));
+                rtapi_clock_nanosleep(RTAPI_CLOCK, TIMER_ABSTIME, &until, nullptr, nullptr);
+            }
+            __atomic_store_n(&virtual_now, to, __ATOMIC_RELEASE);
+            virtual_time_publish(1, to);
+        }
+        if(to >= target)
+            return;
+        struct timespec ts = {0, 20000};
+        nanosleep(&ts, nullptr);
+    }
+}
+
+/* Wait, with thread_lock held, until it is this thread's turn to run again.
+ * Threads that are starting up and want thread_lock to join go first, or the
+ * thread due first would keep the lock for ever. */
+void Posix::virtual_wait(PosixTask *task, long long release)
+{
+    task->release = release;
+    task->waiting = true;
+    if(turn == task)
+        turn = nullptr;
+    // The thread is only cancelled here, where it gives up its turn; see
+    // wrapper().  The thread due first may not wait below, so it must be
+    // able to stop before.
+    int state;
+    pthread_cleanup_push(virtual_wait_cancelled, task);
+    pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, &state);
+    pthread_testcancel();
+    for(;;) {
+        if(!turn && !__atomic_load_n(&virtual_joining, __ATOMIC_ACQUIRE))
+            virtual_schedule();
+        if(turn == task)
+            break;
+        pthread_cond_wait(&turn_cond, &thread_lock);
+    }
+    pthread_setcancelstate(state, nullptr);
+    pthread_cleanup_pop(0);
+    task->waiting = false;
+}
+
+/* task_delete() cancelled the thread while it waited for its turn, which
+ * left thread_lock taken.  task_delete() takes the thread out of
+ * virtual_tasks. */
+void Posix::virtual_wait_cancelled(void *arg)
+{
+    PosixTask *task = static_cast<PosixTask*>(arg);
+    Posix &papp = reinterpret_cast<Posix&>(App());
+    task->waiting = false;
+    if(papp.turn == task)
+        papp.turn = nullptr;
+    pthread_mutex_unlock(&thread_lock);
+}
 
 void *Posix::wrapper(void *arg)
 {
@@ -1080,11 +1397,27 @@ void *Posix::wrapper(void *arg)
   set_namef("rtapi_app:T#%d", task->id);
 
   Posix &papp = reinterpret_cast<Posix&>(App());
+  if(papp.virtual_time) {
+      // Cancelled anywhere else, the thread would leave thread_lock taken
+      // and the turn with it
+      pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, nullptr);
+      __atomic_add_fetch(&papp.virtual_joining, 1, __ATOMIC_ACQ_REL);
+  }
   if(papp.do_thread_lock)
       pthread_mutex_lock(&papp.thread_lock);
 
   struct timespec now;
-  clock_gettime(RTAPI_CLOCK, &now);
+  if(papp.virtual_time) {
+      papp.virtual_tasks[papp.virtual_count++] = static_cast<PosixTask*>(task);
+      __atomic_sub_fetch(&papp.virtual_joining, 1, __ATOMIC_ACQ_REL);
+      // Start on a multiple of the period, so that how threads line up does
+      // not depend on when they were started
+      long long first = (papp.virtual_now + task->period - 1) / task->period * task->period;
+      papp.virtual_wait(static_cast<PosixTask*>(task), first);
+      ns_to_timespec(now, first);
+  } else {
+      clock_gettime(RTAPI_CLOCK, &now);
+  }
   rtapi_timespec_advance(task->nextstart, now, task->period + task->pll_correction);
 
   /* call the task function with the task argument */
@@ -1124,6 +1457,13 @@ int Posix::task_self() {
 }
 
 void Posix::wait() {
+    if(virtual_time) {
+        // keeps thread_lock, the next thread to run is picked with it held
+        PosixTask *task = reinterpret_cast<PosixTask*>(pthread_getspecific(key));
+        rtapi_timespec_advance(task->nextstart, task->nextstart, task->period + task->pll_correction);
+        virtual_wait(task, task->nextstart.tv_sec * 1000000000LL + task->nextstart.tv_nsec);
+        return;
+    }
     if(do_thread_lock)
         pthread_mutex_unlock(&thread_lock);
     pthread_testcancel();
@@ -1162,6 +1502,8 @@ void Posix::do_outb(unsigned char val, unsigned int port)
 }
 
 void Posix::do_delay(long ns) {
+    // the simulated clock stands still while a thread runs
+    if(virtual_time) return;
     struct timespec ts = {0, ns};
     rtapi_clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, NULL, NULL);
 }
@@ -1275,10 +1617,7 @@ long long rtapi_get_time() {
 
 void default_rtapi_msg_handler(msg_level_t level, const char *fmt, va_list ap) {
     if(main_thread && pthread_self() != main_thread) {
-        message_t m;
-        m.level = level;
-        vsnprintf(m.msg, sizeof(m.msg), fmt, ap);
-        rtapi_msg_queue.push(m);
+        msg_stash(level, fmt, ap);
     } else {
         vfprintf(level == RTAPI_MSG_ALL ? stdout : stderr, fmt, ap);
     }
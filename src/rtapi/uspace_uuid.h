@@ -0,0 +1,49 @@
+#ifndef USPACE_UUID_H
+#define USPACE_UUID_H
+
+//    Description:  uspace_uuid.h
+//              The uuid shared memory segment of uspace RTAPI: the
+//              module id counter, and the simulated clock rtapi_app
+//              runs its threads on with RTAPI_VIRTUAL_TIME.  Also read
+//              by libnml, which does not link with RTAPI.
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program; if not, write to the Free Software
+//    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <rtapi_mutex.h>
+
+#define UUID_KEY  0x48484c34 /* key for UUID for simulator */
+
+#define VIRTUAL_TIME_USERS 16
+
+/* A user space process that runs in step with the simulated clock.  The
+ * clock does not move past 'wake' while 'pid' is set: the process keeps
+ * it at the time it woke up while it runs, and moves it to when it wants
+ * to wake up next when it sleeps. */
+typedef struct {
+    int           pid;          /* 0 for a free slot */
+    long long     wake;
+} virtual_time_user_t;
+
+typedef struct {
+    rtapi_mutex_t mutex;
+    int           uuid;
+    /* Set by rtapi_app when its threads run on a simulated clock
+     * (RTAPI_VIRTUAL_TIME), so that user space reads the same clock */
+    int           virtual_time;
+    long long     virtual_now;
+    virtual_time_user_t virtual_users[VIRTUAL_TIME_USERS];
+} uuid_data_t;
+
+#endif
@@ -0,0 +1,11 @@
+#!/bin/sh
+$REALTIME start
+halcmd -b -f batch.hal
+halcmd -s show sig
+halcmd getp and2.2.in0
+halcmd getp and2.2.in1
+halcmd -b -f bad.hal 2>&1 || echo "bad.hal rejected"
+halcmd -s show sig c
+halcmd getp and2.2.in1
+halcmd unload all
+$REALTIME stop
@@ -0,0 +1,19 @@
+#!/usr/bin/env python3
+import json
+import sys
+
+# the trace may end with a comma and without the closing bracket
+text = open(sys.argv[1]).read().rstrip().rstrip(",")
+if not text.endswith("]"):
+    text += "]"
+spans = {}
+for e in json.loads(text):
+    if e.get("ph") == "X" and e.get("cat") == "load":
+        spans.setdefault(e["name"], []).append((e["ts"], e["ts"] + e["dur"]))
+
+(a0, a1), (b0, b1), (c0, c1) = sorted(spans["loadusr ./slow.py"])
+print("user components overlap:", a0 < b1 and b0 < a1)
+(and0, and1), = spans["loadrt and2"]
+(or0, or1), = spans["loadrt or2"]
+print("realtime modules in order:", and1 <= or0)
+print("user component after realtime modules:", or1 <= c0)
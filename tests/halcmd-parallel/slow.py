@@ -0,0 +1,14 @@
+#!/usr/bin/env python3
+import sys
+import time
+import hal
+
+c = hal.component(sys.argv[1])
+c.newpin("out", hal.HAL_BIT, hal.HAL_OUT)
+# long enough that loading one after the other would not overlap
+time.sleep(1)
+c.ready()
+
+try:
+    while 1: time.sleep(1)
+except KeyboardInterrupt: pass
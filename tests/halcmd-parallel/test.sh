@@ -0,0 +1,8 @@
+#!/bin/sh
+rm -f trace.json
+$REALTIME start
+HAL_STARTUP_TRACE=$PWD/trace.json halcmd -p -f parallel.hal
+halcmd -s show sig
+halcmd unload all
+$REALTIME stop
+python3 checktrace.py trace.json
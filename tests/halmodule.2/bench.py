@@ -0,0 +1,50 @@
+#!/usr/bin/env python3
+"""Pins per second of a pin group against h[name] access.
+
+Start realtime first, then run ./bench.py [pins] [seconds], or from
+halrun: loadusr -w ./bench.py [pins] [seconds]
+"""
+import sys
+import time
+import hal
+
+pins = int(sys.argv[1]) if len(sys.argv) > 1 else 80
+seconds = float(sys.argv[2]) if len(sys.argv) > 2 else 1.0
+
+h = hal.component("bench-pingroup")
+names = ["p{}".format(i) for i in range(pins)]
+for n in names:
+    h.newpin(n, hal.HAL_FLOAT, hal.HAL_OUT)
+h.ready()
+
+def rate(f):
+    n = 0
+    end = time.perf_counter() + seconds
+    while time.perf_counter() < end:
+        for _ in range(100):
+            f()
+        n += 100
+    return n * pins / seconds
+
+values = [float(i) for i in range(pins)]
+group = h.pingroup(names)
+
+def attr_read():
+    return [h[n] for n in names]
+
+def attr_write():
+    for n, v in zip(names, values):
+        h[n] = v
+
+try:
+    results = [
+        ("read, h[name]", rate(attr_read)),
+        ("read, pingroup.get()", rate(group.get)),
+        ("read, pingroup.getdict()", rate(group.getdict)),
+        ("write, h[name] = v", rate(attr_write)),
+        ("write, pingroup.set()", rate(lambda: group.set(values))),
+    ]
+    for what, r in results:
+        print("{:28} {:12.0f} pins/s".format(what, r))
+finally:
+    h.exit()
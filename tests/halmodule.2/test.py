@@ -0,0 +1,45 @@
+#!/usr/bin/env python3
+import hal
+
+h = hal.component("x")
+try:
+    h.newpin("f", hal.HAL_FLOAT, hal.HAL_OUT)
+    h.newpin("b", hal.HAL_BIT, hal.HAL_OUT)
+    h.newpin("s", hal.HAL_S32, hal.HAL_OUT)
+    h.newpin("u", hal.HAL_U32, hal.HAL_OUT)
+    h.newparam("param", hal.HAL_FLOAT, hal.HAL_RW)
+    h.ready()
+
+    def show(what, f):
+        try:
+            print("{} {}".format(what, f()))
+        except (AttributeError, TypeError, ValueError, OverflowError,
+                RuntimeError) as e:
+            print("{} {}".format(what, type(e).__name__))
+
+    g = h.pingroup()
+    print("all {} {}".format(len(g), g.names))
+    g.set([True, 1.5, 2.25, -3, 4])
+    print("get {}".format(g.get()))
+    print("attr {} {} {} {} {}".format(h.b, h.f, h.param, h.s, h.u))
+    print("getpins {}".format(sorted(h.getpins().items())))
+
+    o = h.pingroup(("u", "f"))
+    o.set((7, -0.5))
+    print("order {} {}".format(o.names, o.get()))
+    print("getdict {}".format(sorted(o.getdict().items())))
+    print("attr {} {}".format(h.u, h.f))
+
+    show("missing", lambda: h.pingroup(["f", "not-found"]))
+    show("not-str", lambda: h.pingroup([1]))
+    show("short", lambda: o.set([1]))
+    show("range", lambda: o.set([-1, 0.0]))
+    show("after-range", o.get)
+except:
+    import traceback
+    print("Exception: {}".format(traceback.format_exc()))
+    raise
+finally:
+    h.exit()
+
+show("closed", o.get)
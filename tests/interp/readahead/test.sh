@@ -0,0 +1,11 @@
+#!/bin/bash
+# Run the programs through the read ahead queue, and check that the
+# interpreter does exactly what it does when it reads the lines itself.
+# The PRINTs show #<_line>, where the interpreter thinks it is in the
+# file after each jump.
+for f in test.ngc fanuc.ngc; do
+    rs274 -i test.ini -g $f > $f.out || exit 1
+    cat $f.out
+    rs274 -i no-readahead.ini -g $f | diff -u - $f.out || exit 1
+    rm -f $f.out
+done
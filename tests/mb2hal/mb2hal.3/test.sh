@@ -0,0 +1,25 @@
+#!/bin/bash
+set -e
+
+TMPDIR=$(mktemp -d /tmp/mb2hal.XXXXXX)
+trap "rm -rf $TMPDIR" 0 1 2 3 15
+
+python3 ../modbus-standin.py $TMPDIR/port > $TMPDIR/requests &
+SERVER=$!
+while [ ! -e $TMPDIR/port ]; do sleep 0.1; done
+sed "s/@PORT@/$(cat $TMPDIR/port)/" mb2hal.ini > $TMPDIR/mb2hal.ini
+
+cat > $TMPDIR/test.hal <<HAL
+loadusr -W mb2hal config=$TMPDIR/mb2hal.ini
+loadusr -w sleep 1
+getp mb2hal.in03.03.int
+getp mb2hal.in05.05.int
+getp mb2hal.far.01.int
+setp mb2hal.out.01.int 7
+loadusr -w sleep 1
+HAL
+halrun -f $TMPDIR/test.hal
+
+kill -TERM $SERVER
+wait $SERVER
+cat $TMPDIR/requests
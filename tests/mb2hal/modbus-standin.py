@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+# Minimal Modbus TCP slave standing in for a real PLC in the mb2hal tests.
+#
+# Serves the function codes mb2hal uses (01, 02, 03, 04, 05, 06, 15, 16)
+# from one in-memory table of coils and registers, register N and coil N
+# preset to N and N & 1.  It records which requests were made, so a test
+# can check what mb2hal put on the wire, and measures the request rate
+# for throughput benchmarks.
+#
+# usage: modbus-standin.py PORTFILE
+# Listens on a free local port and writes its number to PORTFILE.  On
+# SIGTERM, prints the distinct read ranges and all the writes to stdout,
+# and the request rate to stderr.
+
+import os
+import signal
+import socket
+import socketserver
+import struct
+import sys
+import threading
+import time
+
+registers = list(range(65536))
+coils = [n & 1 for n in range(65536)]
+
+lock = threading.Lock()
+reads = set()
+writes = []
+requests = 0
+first_request = None
+last_request = None
+
+def pack_bits(bits):
+    out = bytearray((len(bits) + 7) // 8)
+    for n, b in enumerate(bits):
+        if b:
+            out[n // 8] |= 1 << (n % 8)
+    return bytes(out)
+
+def unpack_bits(data, qty):
+    return [(data[n // 8] >> (n % 8)) & 1 for n in range(qty)]
+
+def execute(pdu):
+    fnct = pdu[0]
+    if fnct in (1, 2, 3, 4):
+        addr, qty = struct.unpack(">HH", pdu[1:5])
+        reads.add((fnct, addr, qty))
+        if fnct in (1, 2):
+            data = pack_bits(coils[addr:addr + qty])
+        else:
+            data = struct.pack(">%dH" % qty, *registers[addr:addr + qty])
+        return bytes([fnct, len(data)]) + data
+    if fnct in (5, 6):
+        addr, value = struct.unpack(">HH", pdu[1:5])
+        if fnct == 5:
+            value = 1 if value == 0xff00 else 0
+            coils[addr] = value
+        else:
+            registers[addr] = value
+        writes.append((fnct, addr, [value]))
+        return pdu[:5]
+    if fnct in (15, 16):
+        addr, qty, count = struct.unpack(">HHB", pdu[1:6])
+        if fnct == 15:
+            values = unpack_bits(pdu[6:6 + count], qty)
+            coils[addr:addr + qty] = values
+        else:
+            values = list(struct.unpack(">%dH" % qty, pdu[6:6 + count]))
+            registers[addr:addr + qty] = values
+        writes.append((fnct, addr, values))
+        return pdu[:5]
+    return bytes([fnct | 0x80, 1]) # illegal function
+
+def recv_exactly(sock, n):
+    data = b""
+    while len(data) < n:
+        chunk = sock.recv(n - len(data))
+        if not chunk:
+            raise EOFError
+        data += chunk
+    return data
+
+class Handler(socketserver.BaseRequestHandler):
+    def handle(self):
+        global requests, first_request, last_request
+        sock = self.request
+        sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        try:
+            while True:
+                tid, pid, length, unit = struct.unpack(">HHHB", recv_exactly(sock, 7))
+                pdu = recv_exactly(sock, length - 1)
+                with lock:
+                    reply = execute(pdu)
+                    requests += 1
+                    last_request = time.monotonic()
+                    if first_request is None:
+                        first_request = last_request
+                sock.sendall(struct.pack(">HHHB", tid, pid, len(reply) + 1, unit) + reply)
+        except (EOFError, ConnectionError):
+            pass
+
+class Server(socketserver.ThreadingTCPServer):
+    allow_reuse_address = True
+    daemon_threads = True
+
+def report(signum, frame):
+    with lock:
+        for fnct, addr, qty in sorted(reads):
+            print("read fnct %02d addr %d nelem %d" % (fnct, addr, qty))
+        for fnct, addr, values in writes:
+            print("write fnct %02d addr %d values %s" % (fnct, addr, values))
+        if requests > 1:
+            rate = (requests - 1) / (last_request - first_request)
+            print("%d requests, %.0f requests/s" % (requests, rate), file=sys.stderr)
+    sys.stdout.flush()
+    sys.exit(0)
+
+server = Server(("127.0.0.1", 0), Handler)
+signal.signal(signal.SIGTERM, report)
+with open(sys.argv[1] + ".tmp", "w") as f:
+    f.write("%d\n" % server.server_address[1])
+os.rename(sys.argv[1] + ".tmp", sys.argv[1])
+server.serve_forever()
@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+
+import linuxcnc
+import hal
+
+import time
+import sys
+import subprocess
+import os
+
+comp = hal.component("test-ui")
+comp.newpin("reopen-log", hal.HAL_BIT, hal.HAL_IO)
+comp.ready()
+
+os.system("halcmd net reopen-log test-ui.reopen-log motion-logger.reopen-log")
+
+# This will be the return value of this program.
+# Any failure sets it to 1.
+retval = 0
+
+
+def fail(msg):
+    global retval
+    print(msg)
+    retval = 1
+    sys.stdout.flush()
+
+
+def end_log(logfile_name):
+    comp['reopen-log'] = True
+    while comp['reopen-log']: time.sleep(.01)
+    os.rename("out.motion-logger", 'result.%s' % logfile_name)
+    status = subprocess.call(['diff', '-u', 'expected.%s' % logfile_name, 'result.%s' % logfile_name], shell=False)
+    if status == 0:
+        print("sub-test %s ok" % logfile_name)
+    else:
+        fail("unexpected output in logfile '%s'" % logfile_name)
+    sys.stdout.flush()
+
+
+def wait_state(state):
+    timeout = time.time() + 10
+    while time.time() < timeout:
+        s.poll()
+        if s.interp_state == state:
+            return
+        time.sleep(.01)
+    fail("interpreter did not get to state %d" % state)
+
+
+def wait_idle():
+    wait_state(linuxcnc.INTERP_IDLE)
+
+
+def set_parameter(value):
+    c.mode(linuxcnc.MODE_MDI)
+    c.wait_complete()
+    c.mdi("#1000=%s" % value)
+    c.wait_complete()
+    wait_idle()
+    c.mode(linuxcnc.MODE_AUTO)
+    c.wait_complete()
+
+
+def write_sub(scale):
+    with open("sub.ngc", "w") as f:
+        f.write("o<sub> sub\ng1 x[#1 * %s] y2\no<sub> endsub\nm2\n" % scale)
+
+
+# when the run was stored: a run that is interpreted again is stored
+# again when the next one starts
+def cache_mtime():
+    files = os.listdir("cache")
+    if len(files) != 1:
+        fail("expected one file in the cache, found %s" % files)
+        return None
+    return os.stat(os.path.join("cache", files[0])).st_mtime_ns
+
+
+# run the program, going on after its M0
+def run(logfile_name):
+    c.program_open('prog.ngc')
+    c.auto(linuxcnc.AUTO_RUN, 0)
+    c.wait_complete()
+    wait_state(linuxcnc.INTERP_PAUSED)
+    c.auto(linuxcnc.AUTO_RESUME)
+    c.wait_complete()
+    wait_idle()
+    end_log(logfile_name)
+
+
+# run the program and step through the rest of it from its M0.  With
+# INTERP_MAX_LEN this short, a replay has not got to the end by then.
+def step(logfile_name):
+    c.program_open('prog.ngc')
+    c.auto(linuxcnc.AUTO_RUN, 0)
+    c.wait_complete()
+    wait_state(linuxcnc.INTERP_PAUSED)
+    for i in range(20):
+        c.auto(linuxcnc.AUTO_STEP)
+        c.wait_complete()
+        time.sleep(.1)
+        s.poll()
+        if s.interp_state == linuxcnc.INTERP_IDLE:
+            break
+    else:
+        fail("stepping did not get to the end of the program")
+    end_log(logfile_name)
+
+
+#
+# connect to LinuxCNC
+#
+
+c = linuxcnc.command()
+s = linuxcnc.stat()
+e = linuxcnc.error_channel()
+
+
+#
+# Come out of E-stop, turn the machine on, and switch to Auto mode.
+#
+
+c.state(linuxcnc.STATE_ESTOP_RESET)
+c.state(linuxcnc.STATE_ON)
+c.mode(linuxcnc.MODE_AUTO)
+c.wait_complete()
+
+write_sub(2)
+set_parameter(1)
+end_log('startup')
+
+# the first run starts in the startup modes, the second in the ones the
+# first left.  The third starts like the second did, so the second is
+# stored then, and replayed.
+run('one')
+run('one')
+run('one')
+stored = cache_mtime()
+
+run('one')
+run('one')
+if cache_mtime() != stored:
+    fail("unchanged program was not replayed")
+
+# stepping interprets the rest of the stored run, line by line
+step('step')
+run('one')
+if cache_mtime() != stored:
+    fail("stepping stored the run again")
+
+# a parameter the program reads has changed: the output has to follow
+set_parameter(2)
+end_log('mdi')
+run('two')
+run('two')
+run('two')
+if cache_mtime() == stored:
+    fail("program was not stored again after a parameter changed")
+stored = cache_mtime()
+
+# a subroutine file has changed
+write_sub(3)
+run('three')
+run('three')
+run('three')
+if cache_mtime() == stored:
+    fail("program was not stored again after a subroutine changed")
+
+sys.exit(retval)
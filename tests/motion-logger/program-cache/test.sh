@@ -0,0 +1,6 @@
+#!/bin/bash
+
+rm -rf out.motion-logger result.* sub.ngc cache
+mkdir cache
+
+linuxcnc -r test.ini
@@ -0,0 +1,5 @@
+#!/bin/sh
+# The "display" of this config: eight remote status readers load the
+# NML server through tcp.nml for two seconds, then LinuxCNC shuts down.
+nml-tcp-load -n 8 -t 2 tcp.nml > load.out 2>&1
+echo $? > load.status
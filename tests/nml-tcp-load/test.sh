@@ -0,0 +1,8 @@
+#!/bin/bash
+
+rm -f load.out load.status
+
+linuxcnc -r test.ini
+
+cat load.out
+test "$(cat load.status)" = 0 && grep -q "errors: 0" load.out
@@ -0,0 +1,6 @@
+oword_calls = 0
+
+def square(self, x):
+    global oword_calls
+    oword_calls += 1
+    return x * x
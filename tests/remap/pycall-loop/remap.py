@@ -0,0 +1,26 @@
+import interpreter
+
+prolog_calls = 0
+epilog_calls = 0
+body_calls = 0
+psum = 0.0
+
+def count_prolog(self, **words):
+    global prolog_calls, psum
+    # go through self.blocks like real handlers do
+    c = self.blocks[self.remap_level]
+    if c.p_flag and c.p_number == words['p']:
+        prolog_calls += 1
+    psum += words['p']
+    return interpreter.INTERP_OK
+
+def count_epilog(self, **words):
+    global epilog_calls
+    epilog_calls += 1
+    return interpreter.INTERP_OK
+
+def count_body(self, **words):
+    global body_calls
+    if self.blocks[self.remap_level].executing_remap.name.lower() == 'm411':
+        body_calls += 1
+    return interpreter.INTERP_OK
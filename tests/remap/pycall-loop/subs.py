@@ -0,0 +1,2 @@
+import remap
+import oword
@@ -0,0 +1,12 @@
+#!/bin/bash
+# the elapsed time goes to stderr, so it is not part of the result
+export PYTHONUNBUFFERED=1
+OUT=$(mktemp)
+START=$(date +%s%N)
+rs274 -i test.ini -n 0 -g test.ngc > $OUT 2>&1
+STATUS=$?
+END=$(date +%s%N)
+echo "pycall-loop: $(( (END - START) / 1000000 )) ms for 2000 iterations" >&2
+grep -E '^(calls|psum)|sum=' $OUT | sed 's/^ *[0-9]* N\.\.\.\.\. //'
+rm -f $OUT
+exit $STATUS
@@ -0,0 +1,10 @@
+#!/bin/sh
+${SUDO} halcompile --install test_shmem_walk.comp > /dev/null || exit 1
+
+for hp in 0 1; do
+    RTAPI_HUGEPAGES=$hp halrun -f walk.hal > walk.$hp || exit 1
+    set -- $(cat walk.$hp)
+    echo "RTAPI_HUGEPAGES=$hp: $1 walks, last $2 ns, max $3 ns" >&2
+    [ "$1" -gt 0 ] && echo "RTAPI_HUGEPAGES=$hp walked"
+done
+rm -f walk.0 walk.1
@@ -0,0 +1,4 @@
+#!/bin/sh
+for rate in 0 4; do
+    RTAPI_VIRTUAL_TIME=1 RTAPI_VIRTUAL_TIME_RATE=$rate halrun -f timing.hal || exit 1
+done
@@ -0,0 +1,152 @@
+#include "greatest.h"
+#include "rtapi.h"
+#include "hal.h"
+
+// the layout functions are static
+#include "hal/drivers/mesa-hostmot2/tram.c"
+
+/* Expand to all the definitions that need to be in
+   the test runner's main file. */
+GREATEST_MAIN_DEFS();
+
+// KLUDGE fix link errors the ugly way
+void rtapi_print_msg(msg_level_t level, const char *fmt, ...)
+{
+}
+
+void *hal_malloc(long int size)
+{
+    return calloc(1, size);
+}
+
+int hal_pin_u32_newf(hal_pin_dir_t dir, hal_u32_t ** data_ptr_addr, int comp_id, const char *fmt, ...)
+{
+    return 0;
+}
+
+static hm2_lowlevel_io_t llio = { .name = "hm2_test.0" };
+
+static hostmot2_t *tramSetup(int gap)
+{
+    hostmot2_t *hm2 = calloc(1, sizeof(hostmot2_t));
+    hm2->llio = &llio;
+    hm2->config.tram_read_gap = gap;
+    RTAPI_INIT_LIST_HEAD(&hm2->tram_read_entries);
+    RTAPI_INIT_LIST_HEAD(&hm2->tram_write_entries);
+    return hm2;
+}
+
+static void tramTeardown(hostmot2_t *hm2)
+{
+    hm2_tram_cleanup(hm2);
+    free(hm2);
+}
+
+/**
+ * Check that every entry's buffer lies inside one of the read bursts.
+ */
+static enum greatest_test_res checkReadBuffers(hostmot2_t *hm2, rtapi_u32 **buffers, int num)
+{
+    int i, b;
+    for (i = 0; i < num; i ++) {
+        int found = 0;
+        for (b = 0; b < hm2->num_tram_read_bursts; b ++) {
+            hm2_tram_burst_t *burst = &hm2->tram_read_bursts[b];
+            rtapi_u8 *start = (rtapi_u8 *)burst->buffer;
+            rtapi_u8 *p = (rtapi_u8 *)buffers[i];
+            if (p >= start && p < start + burst->size) {
+                found = 1;
+            }
+        }
+        ASSERT(found);
+    }
+    PASS();
+}
+
+TEST tramGapStaysBelowMaxBurst() {
+    // eight register blocks at 0x100 strides, like encoders and stepgens
+    hostmot2_t *hm2 = tramSetup(0x100);
+    rtapi_u32 *buffers[8];
+    int i;
+    for (i = 0; i < 8; i ++) {
+        ASSERT_EQ(0, hm2_register_tram_read_region(hm2, 0x3000 + 0x100 * i, 16, &buffers[i]));
+    }
+    ASSERT_EQ(0, hm2_allocate_tram_regions(hm2));
+
+    // without the limit this is one 0x710 byte burst
+    ASSERT_EQ(4, hm2->num_tram_read_bursts);
+    for (i = 0; i < 4; i ++) {
+        ASSERT_EQ(0x3000 + 0x200 * i, hm2->tram_read_bursts[i].addr);
+        ASSERT_EQ(0x110, hm2->tram_read_bursts[i].size);
+        ASSERT(hm2->tram_read_bursts[i].size <= HM2_TRAM_MAX_BURST);
+    }
+    for (i = 0; i < 8; i ++) {
+        rtapi_u8 *start = (rtapi_u8 *)hm2->tram_read_bursts[i / 2].buffer;
+        ASSERT_EQ(start + 0x100 * (i % 2), (rtapi_u8 *)buffers[i]);
+    }
+    CHECK_CALL(checkReadBuffers(hm2, buffers, 8));
+    tramTeardown(hm2);
+    PASS();
+}
+
+TEST tramContiguousSplitsAtMaxBurst() {
+    hostmot2_t *hm2 = tramSetup(0);
+    rtapi_u32 *buffers[200];
+    int i;
+    for (i = 0; i < 200; i ++) {
+        ASSERT_EQ(0, hm2_register_tram_read_region(hm2, 0x1000 + 4 * i, 4, &buffers[i]));
+    }
+    ASSERT_EQ(0, hm2_allocate_tram_regions(hm2));
+
+    ASSERT_EQ(2, hm2->num_tram_read_bursts);
+    ASSERT_EQ(HM2_TRAM_MAX_BURST, hm2->tram_read_bursts[0].size);
+    ASSERT_EQ(800 - HM2_TRAM_MAX_BURST, hm2->tram_read_bursts[1].size);
+    ASSERT_EQ(0x1000 + HM2_TRAM_MAX_BURST, hm2->tram_read_bursts[1].addr);
+    ASSERT_EQ(800, hm2->tram_read_size);
+    CHECK_CALL(checkReadBuffers(hm2, buffers, 200));
+    tramTeardown(hm2);
+    PASS();
+}
+
+TEST tramLargeEntryIsNotMerged() {
+    // an entry that is too large on its own keeps a burst of its own
+    hostmot2_t *hm2 = tramSetup(0x100);
+    rtapi_u32 *buffers[3];
+    ASSERT_EQ(0, hm2_register_tram_read_region(hm2, 0x2000, 4, &buffers[0]));
+    ASSERT_EQ(0, hm2_register_tram_read_region(hm2, 0x2004, 1024, &buffers[1]));
+    ASSERT_EQ(0, hm2_register_tram_read_region(hm2, 0x2404, 4, &buffers[2]));
+    ASSERT_EQ(0, hm2_allocate_tram_regions(hm2));
+
+    ASSERT_EQ(3, hm2->num_tram_read_bursts);
+    ASSERT_EQ(1024, hm2->tram_read_bursts[1].size);
+    CHECK_CALL(checkReadBuffers(hm2, buffers, 3));
+    tramTeardown(hm2);
+    PASS();
+}
+
+TEST tramWritesAreNotGapped() {
+    // the read gap never applies to writes
+    hostmot2_t *hm2 = tramSetup(0x100);
+    rtapi_u32 *buffers[2];
+    ASSERT_EQ(0, hm2_register_tram_write_region(hm2, 0x4000, 4, &buffers[0]));
+    ASSERT_EQ(0, hm2_register_tram_write_region(hm2, 0x4100, 4, &buffers[1]));
+    ASSERT_EQ(0, hm2_allocate_tram_regions(hm2));
+
+    ASSERT_EQ(2, hm2->num_tram_write_bursts);
+    ASSERT_EQ(8, hm2->tram_write_size);
+    tramTeardown(hm2);
+    PASS();
+}
+
+SUITE(tram) {
+    RUN_TEST(tramGapStaysBelowMaxBurst);
+    RUN_TEST(tramContiguousSplitsAtMaxBurst);
+    RUN_TEST(tramLargeEntryIsNotMerged);
+    RUN_TEST(tramWritesAreNotGapped);
+}
+
+int main(int argc, char **argv) {
+    GREATEST_MAIN_BEGIN();      /* command-line arguments, initialization. */
+    RUN_SUITE(tram);   /* run a suite */
+    GREATEST_MAIN_END();        /* display results */
+}
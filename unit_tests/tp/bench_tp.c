@@ -0,0 +1,560 @@
+/********************************************************************
+* Description: bench_tp.c
+*   Benchmark of the trajectory planner. Segment streams are fed to
+*   tpAddLine/tpAddCircle as fast as the queue takes them, and
+*   tpRunCycle is run until the planner is done, the way motion does it
+*   but without the rest of motion: emcmot status and config are
+*   plain structs here, and the spindle is simulated.
+*
+*   bench_tp [-n] [-e] [-c cycle-time] [-f file] [corpus...]
+*
+*   The built-in corpora are dense-linear, arc-heavy, 5-axis and
+*   spindle-synced; without arguments all of them run. -f replays a
+*   segment stream from a file, with one command per line:
+*
+*       feed <vel> <acc>
+*       line <x> <y> <z> [<a> <b> <c> [<u> <v> <w>]]
+*       arc <x> <y> <z> <cx> <cy> <cz> <nx> <ny> <nz> <turn>
+*       sync <units-per-rev>        (0 ends spindle synchronization)
+*
+*   For each stream, the CPU time of the add and run-cycle calls, and
+*   the planned duration and velocity profile of the program are
+*   reported. The planned figures depend only on the planner, so they
+*   are the same from run to run and machine to machine; -n leaves out
+*   the timings so that the output can be compared as it is. -e
+*   evicts the L1 and L2 caches before each call, as the rest of the
+*   servo thread and other threads do between two cycles of motion;
+*   the timings are then closer to what the servo thread sees.
+*
+* License: GPL Version 2
+* System: Linux
+*
+* Copyright (c) 2026 All rights reserved.
+********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <time.h>
+#include <math.h>
+
+#include "rtapi.h"
+#include "motion.h"
+#include "motion_types.h"
+#include "tp.h"
+#include "tcq.h"
+#include "tp_types.h"
+
+// KLUDGE fix link errors the ugly way, like test_blendmath
+void rtapi_print_msg(msg_level_t level, const char *fmt, ...)
+{
+    va_list args;
+
+    if (level > RTAPI_MSG_ERR) {
+        return;
+    }
+    va_start(args, fmt);
+    vfprintf(stderr, fmt, args);
+    va_end(args);
+}
+
+void rtapi_print(const char *fmt, ...)
+{
+    va_list args;
+
+    va_start(args, fmt);
+    vfprintf(stderr, fmt, args);
+    va_end(args);
+}
+
+#define NUM_AXES 9
+#define MAX_CYCLES 100000000L
+
+// Machine limits, per axis XYZABCUVW
+static double axis_vel[NUM_AXES] = {100, 100, 100, 360, 360, 360, 100, 100, 100};
+static double axis_acc[NUM_AXES] = {1000, 1000, 1000, 3600, 3600, 3600, 1000, 1000, 1000};
+
+static emcmot_status_t status;
+static emcmot_config_t config;
+static TP_STRUCT tp;
+
+static void dio_write(int index, char value) {}
+static void aio_write(int index, double value) {}
+static void set_rotary_unlock(int axis, int unlock) {}
+static int get_rotary_is_unlocked(int axis) { return 1; }
+static double get_vel_limit(int axis) { return axis_vel[axis]; }
+static double get_acc_limit(int axis) { return axis_acc[axis]; }
+
+// Twice the L2 cache of most machines. Between two cycles of motion, the
+// rest of the servo thread and the other threads on the core leave little
+// of the planner's data in L1 and L2, but usually some of it in L3.
+#define EVICT_SIZE (4 << 20)
+static char *evict_buf;
+
+static void evict(void)
+{
+    size_t i;
+
+    if (!evict_buf) {
+        return;
+    }
+    for (i = 0; i < EVICT_SIZE; i += 64) {
+        evict_buf[i]++;
+    }
+}
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* A segment of a stream */
+typedef struct {
+    enum { SEG_LINE, SEG_ARC, SEG_FEED, SEG_SYNC } type;
+    EmcPose end;
+    PmCartesian center, normal;
+    int turn;
+    double vel, acc, sync;
+} segment_t;
+
+typedef struct {
+    segment_t *seg;
+    int len, size;
+} stream_t;
+
+static segment_t *stream_add(stream_t *s, int type)
+{
+    if (s->len == s->size) {
+        s->size = s->size ? 2 * s->size : 1024;
+        s->seg = realloc(s->seg, s->size * sizeof(segment_t));
+        if (!s->seg) {
+            perror("bench_tp");
+            exit(1);
+        }
+    }
+    segment_t *seg = &s->seg[s->len++];
+    memset(seg, 0, sizeof(*seg));
+    seg->type = type;
+    return seg;
+}
+
+static void stream_feed(stream_t *s, double vel, double acc)
+{
+    segment_t *seg = stream_add(s, SEG_FEED);
+    seg->vel = vel;
+    seg->acc = acc;
+}
+
+static void stream_line(stream_t *s, double x, double y, double z, double a, double b)
+{
+    segment_t *seg = stream_add(s, SEG_LINE);
+    seg->end.tran.x = x;
+    seg->end.tran.y = y;
+    seg->end.tran.z = z;
+    seg->end.a = a;
+    seg->end.b = b;
+}
+
+static void stream_arc(stream_t *s, double x, double y, double cx, double cy, double nz)
+{
+    segment_t *seg = stream_add(s, SEG_ARC);
+    seg->end.tran.x = x;
+    seg->end.tran.y = y;
+    seg->center.x = cx;
+    seg->center.y = cy;
+    seg->normal.z = nz;
+}
+
+static void stream_sync(stream_t *s, double sync)
+{
+    stream_add(s, SEG_SYNC)->sync = sync;
+}
+
+/* Many short lines along a wavy path, as from CAM with a small tolerance */
+static void corpus_dense_linear(stream_t *s)
+{
+    int i;
+
+    stream_feed(s, 50, 1000);
+    for (i = 1; i <= 5000; i++) {
+        double x = 0.2 * i;
+        stream_line(s, x, 5 * sin(x / 10), 0, 0, 0);
+    }
+}
+
+/* Tangent half circles in a wave, with a short line across every few */
+static void corpus_arc_heavy(stream_t *s)
+{
+    double x = 0, r = 2;
+    int i;
+
+    stream_feed(s, 50, 1000);
+    for (i = 0; i < 1000; i++) {
+        stream_arc(s, x + 2 * r, 0, x + r, 0, i % 2 ? -1 : 1);
+        x += 2 * r;
+        if (i % 8 == 7) {
+            stream_line(s, x + 0.5, 0.5, 0, 0, 0);
+            stream_line(s, x + 1, 0, 0, 0, 0);
+            x += 1;
+        }
+    }
+}
+
+/* Short XYZ moves with slowly turning A and B, as for an impeller */
+static void corpus_5axis(stream_t *s)
+{
+    int i;
+
+    stream_feed(s, 30, 1000);
+    for (i = 1; i <= 3000; i++) {
+        double t = i * 0.02;
+        stream_line(s, 20 * cos(t) - 20, 20 * sin(t), 2 * sin(3 * t),
+                i * 0.1, 15 * sin(t));
+    }
+}
+
+/* Threading passes: synchronized cuts along Z, unsynchronized returns */
+static void corpus_spindle_synced(stream_t *s)
+{
+    int pass;
+
+    for (pass = 1; pass <= 20; pass++) {
+        double depth = -0.05 * pass;
+        stream_feed(s, 100, 1000);
+        stream_line(s, depth, 0, 0, 0, 0);
+        stream_sync(s, 1.5);
+        stream_line(s, depth, 0, -30, 0, 0);
+        stream_sync(s, 0);
+        stream_line(s, 1, 0, -30, 0, 0);
+        stream_line(s, 1, 0, 0, 0, 0);
+    }
+}
+
+static int stream_read(stream_t *s, const char *name)
+{
+    FILE *f = fopen(name, "r");
+    char buf[512], cmd[16];
+    int lineno = 0;
+
+    if (!f) {
+        perror(name);
+        return -1;
+    }
+    while (fgets(buf, sizeof(buf), f)) {
+        double v[10] = {0};
+        int n;
+        lineno++;
+        if (sscanf(buf, "%15s", cmd) != 1 || cmd[0] == '#') {
+            continue;
+        }
+        n = sscanf(buf, "%*s %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf",
+                &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6], &v[7], &v[8], &v[9]);
+        if (!strcmp(cmd, "feed") && n == 2) {
+            stream_feed(s, v[0], v[1]);
+        } else if (!strcmp(cmd, "line") && (n == 3 || n == 6 || n == 9)) {
+            segment_t *seg = stream_add(s, SEG_LINE);
+            seg->end.tran.x = v[0];
+            seg->end.tran.y = v[1];
+            seg->end.tran.z = v[2];
+            seg->end.a = v[3];
+            seg->end.b = v[4];
+            seg->end.c = v[5];
+            seg->end.u = v[6];
+            seg->end.v = v[7];
+            seg->end.w = v[8];
+        } else if (!strcmp(cmd, "arc") && n == 10) {
+            segment_t *seg = stream_add(s, SEG_ARC);
+            seg->end.tran.x = v[0];
+            seg->end.tran.y = v[1];
+            seg->end.tran.z = v[2];
+            seg->center.x = v[3];
+            seg->center.y = v[4];
+            seg->center.z = v[5];
+            seg->normal.x = v[6];
+            seg->normal.y = v[7];
+            seg->normal.z = v[8];
+            seg->turn = (int) v[9];
+        } else if (!strcmp(cmd, "sync") && n == 1) {
+            stream_sync(s, v[0]);
+        } else {
+            fprintf(stderr, "%s:%d: bad command\n", name, lineno);
+            fclose(f);
+            return -1;
+        }
+    }
+    fclose(f);
+    return 0;
+}
+
+/* Figures of one run */
+typedef struct {
+    long adds, cycles, stops, accel_violations;
+    double add_time, add_max;
+    double cycle_time, cycle_max;
+    double path_length, vel_sum, vel_max, vel_req_sum, accel_ratio_max;
+} result_t;
+
+static void reset_planner(double cycle_time)
+{
+    memset(&status, 0, sizeof(status));
+    memset(&config, 0, sizeof(config));
+    status.net_feed_scale = 1.0;
+    status.enables_new = FS_ENABLED;
+    status.spindle_status[0].at_speed = 1;
+    status.spindle_status[0].direction = 1;
+    config.numSpindles = 1;
+    config.maxFeedScale = 1.0;
+    config.arcBlendEnable = 1;
+    config.arcBlendOptDepth = 50;
+    config.arcBlendGapCycles = 4;
+    config.arcBlendRampFreq = 100.0;
+    config.arcBlendTangentKinkRatio = 0.1;
+
+    tpMotFunctions(dio_write, aio_write, set_rotary_unlock,
+            get_rotary_is_unlocked, get_vel_limit, get_acc_limit);
+    tpMotData(&status, &config);
+    tpCreate(&tp, DEFAULT_TC_QUEUE_SIZE, 0);
+    tpSetCycleTime(&tp, cycle_time);
+    tpSetVmax(&tp, axis_vel[0], axis_vel[0]);
+    tpSetVlimit(&tp, axis_vel[0]);
+    tpSetAmax(&tp, axis_acc[0]);
+    tpSetTermCond(&tp, TC_TERM_COND_PARABOLIC, 0.0);
+}
+
+static int add_segment(segment_t const *seg, int id, double vel, double acc)
+{
+    struct state_tag_t tag = {{0}};
+
+    tpSetId(&tp, id);
+    switch (seg->type) {
+    case SEG_LINE:
+        return tpAddLine(&tp, seg->end, EMC_MOTION_TYPE_FEED, vel, axis_vel[0],
+                acc, status.enables_new, 0, -1, tag);
+    case SEG_ARC:
+        return tpAddCircle(&tp, seg->end, seg->center, seg->normal, seg->turn,
+                EMC_MOTION_TYPE_ARC, vel, axis_vel[0], acc, status.enables_new,
+                0, tag);
+    default:
+        return 0;
+    }
+}
+
+static double pose_axis(EmcPose const *p, int axis)
+{
+    switch (axis) {
+    case 0: return p->tran.x;
+    case 1: return p->tran.y;
+    case 2: return p->tran.z;
+    case 3: return p->a;
+    case 4: return p->b;
+    case 5: return p->c;
+    case 6: return p->u;
+    case 7: return p->v;
+    default: return p->w;
+    }
+}
+
+static int run(stream_t const *s, double cycle_time, result_t *r)
+{
+    EmcPose pos[3];
+    double vel = 0, acc = 0, spindle_speed = 10.0;
+    int next = 0, axis;
+    int moving = 0; // 1 moving, -1 at rest after moving
+
+    memset(r, 0, sizeof(*r));
+    memset(pos, 0, sizeof(pos));
+    reset_planner(cycle_time);
+
+    while (next < s->len || !tpIsDone(&tp)) {
+        // Feed the queue as far as it takes segments, like task does
+        while (next < s->len && !tcqFull(&tp.queue)) {
+            segment_t const *seg = &s->seg[next++];
+            double start, t;
+            int res;
+
+            if (seg->type == SEG_FEED) {
+                vel = seg->vel;
+                acc = seg->acc;
+                continue;
+            } else if (seg->type == SEG_SYNC) {
+                tpSetSpindleSync(&tp, 0, seg->sync, 0);
+                continue;
+            }
+            evict();
+            start = now();
+            res = add_segment(seg, next, vel, acc);
+            t = now() - start;
+            if (res < 0) {
+                fprintf(stderr, "bench_tp: segment %d not added, error %d\n", next, res);
+                return -1;
+            }
+            r->adds++;
+            r->add_time += t;
+            if (t > r->add_max) {
+                r->add_max = t;
+            }
+        }
+
+        // The spindle turns steadily, and its index resets the revolutions
+        spindle_status_t *spindle = &status.spindle_status[0];
+        spindle->spindleSpeedIn = spindle_speed;
+        spindle->speed = spindle_speed * 60;
+        spindle->spindleRevs += spindle_speed * cycle_time;
+        if (spindle->spindle_index_enable) {
+            spindle->spindleRevs -= floor(spindle->spindleRevs);
+            spindle->spindle_index_enable = 0;
+        }
+
+        evict();
+        double start = now();
+        tpRunCycle(&tp, (long) (cycle_time * 1e9));
+        double t = now() - start;
+        r->cycles++;
+        r->cycle_time += t;
+        if (t > r->cycle_max) {
+            r->cycle_max = t;
+        }
+        if (r->cycles > MAX_CYCLES) {
+            fprintf(stderr, "bench_tp: planner did not finish\n");
+            return -1;
+        }
+
+        // Velocity profile
+        pos[2] = pos[1];
+        pos[1] = pos[0];
+        tpGetPos(&tp, &pos[0]);
+        double v = status.current_vel;
+        r->path_length += v * cycle_time;
+        r->vel_sum += v;
+        r->vel_req_sum += status.requested_vel;
+        if (v > r->vel_max) {
+            r->vel_max = v;
+        }
+        // A stop is coming to rest and then moving on; the end of the
+        // program is not one
+        if (v > TP_VEL_EPSILON) {
+            if (moving < 0) {
+                r->stops++;
+            }
+            moving = 1;
+        } else if (moving > 0) {
+            moving = -1;
+        }
+        if (r->cycles >= 3) {
+            for (axis = 0; axis < NUM_AXES; axis++) {
+                double a = (pose_axis(&pos[0], axis) - 2 * pose_axis(&pos[1], axis)
+                        + pose_axis(&pos[2], axis)) / (cycle_time * cycle_time);
+                double ratio = fabs(a) / axis_acc[axis];
+                if (ratio > r->accel_ratio_max) {
+                    r->accel_ratio_max = ratio;
+                }
+                if (ratio > 1.0 + 1e-6) {
+                    r->accel_violations++;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+static void report(const char *name, result_t const *r, double cycle_time, int timings)
+{
+    printf("%s:\n", name);
+    printf("  segments         %ld\n", r->adds);
+    printf("  duration         %.6f s (%ld cycles)\n", r->cycles * cycle_time, r->cycles);
+    printf("  mean velocity    %.6f (%.2f%% of requested)\n", r->vel_sum / r->cycles,
+            r->vel_req_sum > 0 ? 100.0 * r->vel_sum / r->vel_req_sum : 0.0);
+    printf("  max velocity     %.6f\n", r->vel_max);
+    printf("  stops            %ld\n", r->stops);
+    printf("  max axis accel   %.4f of limit (%ld cycles over)\n",
+            r->accel_ratio_max, r->accel_violations);
+    if (timings) {
+        printf("  add              mean %.2f us, max %.2f us\n",
+                r->adds ? 1e6 * r->add_time / r->adds : 0.0, 1e6 * r->add_max);
+        printf("  run cycle        mean %.2f us, max %.2f us\n",
+                1e6 * r->cycle_time / r->cycles, 1e6 * r->cycle_max);
+    }
+}
+
+static struct {
+    const char *name;
+    void (*make)(stream_t *s);
+} corpora[] = {
+    {"dense-linear", corpus_dense_linear},
+    {"arc-heavy", corpus_arc_heavy},
+    {"5-axis", corpus_5axis},
+    {"spindle-synced", corpus_spindle_synced},
+};
+#define NUM_CORPORA (sizeof(corpora) / sizeof(corpora[0]))
+
+static int bench(const char *name, stream_t *s, double cycle_time, int timings)
+{
+    result_t r;
+    int res = run(s, cycle_time, &r);
+
+    if (res == 0) {
+        report(name, &r, cycle_time, timings);
+    }
+    free(s->seg);
+    return res;
+}
+
+int main(int argc, char **argv)
+{
+    double cycle_time = 0.001;
+    const char *file = NULL;
+    int timings = 1, failed = 0, opt;
+    unsigned i;
+
+    while ((opt = getopt(argc, argv, "nec:f:")) != -1) {
+        switch (opt) {
+        case 'n':
+            timings = 0;
+            break;
+        case 'e':
+            evict_buf = calloc(EVICT_SIZE, 1);
+            if (!evict_buf) {
+                fprintf(stderr, "bench_tp: out of memory\n");
+                return 1;
+            }
+            break;
+        case 'c':
+            cycle_time = atof(optarg);
+            break;
+        case 'f':
+            file = optarg;
+            break;
+        default:
+            fprintf(stderr, "usage: bench_tp [-n] [-e] [-c cycle-time] [-f file] [corpus...]\n");
+            return 1;
+        }
+    }
+    if (cycle_time <= 0) {
+        fprintf(stderr, "bench_tp: bad cycle time\n");
+        return 1;
+    }
+
+    if (file) {
+        stream_t s = {0};
+        if (stream_read(&s, file) < 0) {
+            return 1;
+        }
+        failed |= bench(file, &s, cycle_time, timings);
+    }
+    for (i = 0; i < NUM_CORPORA; i++) {
+        int j, wanted = optind == argc && !file;
+        for (j = optind; j < argc; j++) {
+            wanted |= !strcmp(argv[j], corpora[i].name);
+        }
+        if (wanted) {
+            stream_t s = {0};
+            corpora[i].make(&s);
+            failed |= bench(corpora[i].name, &s, cycle_time, timings);
+        }
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,145 @@
+#include "tp_debug.h"
+#include "greatest.h"
+#include "spline.h"
+#include "tp_types.h"
+#include "math.h"
+#include "rtapi.h"
+
+/* Expand to all the definitions that need to be in
+   the test runner's main file. */
+GREATEST_MAIN_DEFS();
+
+// KLUDGE fix link error the ugly way
+void rtapi_print_msg(msg_level_t level, const char *fmt, ...)
+{
+    va_list args;
+
+    va_start(args, fmt);
+    printf(fmt, args);
+    va_end(args);
+}
+
+/**
+ * Raise a rational quadratic Bezier curve (control points P, weights w) to a
+ * cubic, the way canon does it for G5.1 and order 3 G5.2 spans.
+ */
+static void elevateQuadratic(PmCartesian const * const P, double const * const w,
+        PmCartesian * const P3, double * const w3)
+{
+    PmCartesian Q[3];
+    int i;
+    for (i = 0; i < 3; ++i) {
+        pmCartScalMult(&P[i], w[i], &Q[i]);
+    }
+
+    P3[0] = P[0];
+    w3[0] = w[0];
+    P3[3] = P[2];
+    w3[3] = w[2];
+    for (i = 0; i < 2; ++i) {
+        // Inner points are 2/3 of the way from the ends towards Q1
+        PmCartesian const * const end = &Q[2 * i];
+        double w_end = w[2 * i];
+        PmCartesian diff;
+        pmCartCartSub(&Q[1], end, &diff);
+        pmCartScalMultEq(&diff, 2.0 / 3.0);
+        pmCartCartAdd(end, &diff, &diff);
+        w3[i + 1] = w_end + 2.0 / 3.0 * (w[1] - w_end);
+        pmCartScalMult(&diff, 1.0 / w3[i + 1], &P3[i + 1]);
+    }
+}
+
+TEST splineQuarterCircle() {
+    // A quarter of the unit circle is exactly a rational quadratic
+    PmCartesian P2[3] = {{1, 0, 0}, {1, 1, 0}, {0, 1, 0}};
+    double w2[3] = {1, M_SQRT1_2, 1};
+    PmCartesian P[4];
+    double w[4];
+    elevateQuadratic(P2, w2, P, w);
+
+    Spline spline;
+    ASSERT_EQ(TP_ERR_OK, splineInit(&spline, P, w));
+    ASSERT_IN_RANGE(M_PI_2, splineLength(&spline), 1e-9);
+    ASSERT_IN_RANGE(1.0, spline.min_radius, 1e-6);
+
+    // On a unit circle, arc length is the angle
+    double s;
+    for (s = 0.0; s <= M_PI_2; s += M_PI_2 / 37.0) {
+        double u;
+        PmCartesian pt;
+        ASSERT_EQ(TP_ERR_OK, splineParamFromProgress(&spline, s, &u));
+        splinePoint(&spline, u, &pt);
+        ASSERT_IN_RANGE(1.0, hypot(pt.x, pt.y), 1e-12);
+        ASSERT_IN_RANGE(s, atan2(pt.y, pt.x), 1e-9);
+    }
+
+    PmCartesian tan;
+    splineTangent(&spline, 0.0, &tan);
+    ASSERT_IN_RANGE(1.0, tan.y, 1e-12);
+    splineTangent(&spline, 1.0, &tan);
+    ASSERT_IN_RANGE(-1.0, tan.x, 1e-12);
+    PASS();
+}
+
+TEST splineStraight() {
+    // Uneven control points on a line, so the parameter is not arc length
+    PmCartesian P[4] = {{0, 0, 0}, {0.1, 0.2, 0.2}, {2.0, 4.0, 4.0}, {3, 6, 6}};
+    double w[4] = {1, 2, 0.5, 1};
+
+    Spline spline;
+    ASSERT_EQ(TP_ERR_OK, splineInit(&spline, P, w));
+    ASSERT_IN_RANGE(9.0, splineLength(&spline), 1e-6);
+    ASSERT(spline.min_radius >= TP_BIG_NUM);
+
+    double s;
+    for (s = 0.0; s <= 9.0; s += 0.25) {
+        double u;
+        PmCartesian pt;
+        splineParamFromProgress(&spline, s, &u);
+        splinePoint(&spline, u, &pt);
+        ASSERT_IN_RANGE(s / 3.0, pt.x, 1e-6);
+    }
+    PASS();
+}
+
+TEST splineRepeatedEndPoints() {
+    // The curve stops at both ends, the tangent follows the next point
+    PmCartesian P[4] = {{0, 0, 0}, {0, 0, 0}, {1, 1, 0}, {1, 1, 0}};
+    double w[4] = {1, 1, 1, 1};
+
+    Spline spline;
+    ASSERT_EQ(TP_ERR_OK, splineInit(&spline, P, w));
+
+    PmCartesian tan;
+    ASSERT_EQ(TP_ERR_OK, splineTangent(&spline, 0.0, &tan));
+    ASSERT_IN_RANGE(M_SQRT1_2, tan.x, 1e-12);
+    ASSERT_IN_RANGE(M_SQRT1_2, tan.y, 1e-12);
+    ASSERT_EQ(TP_ERR_OK, splineTangent(&spline, 1.0, &tan));
+    ASSERT_IN_RANGE(M_SQRT1_2, tan.x, 1e-12);
+    ASSERT_IN_RANGE(M_SQRT1_2, tan.y, 1e-12);
+    PASS();
+}
+
+TEST splineBadWeight() {
+    PmCartesian P[4] = {{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}};
+    double w[4] = {1, 0, 1, 1};
+
+    Spline spline;
+    ASSERT(splineInit(&spline, P, w) < 0);
+    w[1] = NAN;
+    ASSERT(splineInit(&spline, P, w) < 0);
+    PASS();
+}
+
+SUITE(spline) {
+    RUN_TEST(splineQuarterCircle);
+    RUN_TEST(splineStraight);
+    RUN_TEST(splineRepeatedEndPoints);
+    RUN_TEST(splineBadWeight);
+}
+
+int main(int argc, char **argv) {
+    GREATEST_MAIN_BEGIN();      /* command-line arguments, initialization. */
+    RUN_SUITE(spline);   /* run a suite */
+    GREATEST_MAIN_END();        /* display results */
+}